@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    AnalysisBenchmark.cpp
+    Created: 16 Oct 2026 11:48:12pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "AnalysisBenchmark.h"
+
+/**
+ * Constructor that configures the tracks every thread count analyses
+ *
+ * @param _trackFolder                Folder of audio tracks to analyse, or a nonexistent file to generate synthetic tracks
+ * @param _numTracks                  Number of synthetic tracks, or zero for two per core
+ * @param _secondsPerTrack            Length of each synthetic track in seconds
+ *
+ * @return                            None
+ */
+AnalysisBenchmark::AnalysisBenchmark(const File& _trackFolder, int _numTracks, double _secondsPerTrack)
+    : trackFolder(_trackFolder),
+      numTracks(_numTracks > 0 ? _numTracks : 2 * SystemStats::getNumCpus()),
+      secondsPerTrack(_secondsPerTrack)
+{
+}
+
+/**
+ * Destructor that deletes the synthetic tracks
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+AnalysisBenchmark::~AnalysisBenchmark()
+{
+    if (syntheticFolder != File())
+    {
+        syntheticFolder.deleteRecursively();
+    }
+}
+
+/**
+ * Analyse the same tracks with every thread count from one up to the number of cores
+ *
+ * @param                             None
+ *
+ * @return                            Report listing the time, throughput, speedup and efficiency of each thread count
+ */
+String AnalysisBenchmark::run()
+{
+    String report;
+
+    // Real tracks give real decoding costs, synthetic ones make runs comparable between machines
+    if (trackFolder.isDirectory())
+    {
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        tracks = trackFolder.findChildFiles(File::findFiles, true, formatManager.getWildcardForAllFormats());
+
+        report << "Analysis scaling benchmark: " << tracks.size() << " tracks from " << trackFolder.getFullPathName() << newLine;
+    }
+    else if (writeSyntheticTracks())
+    {
+        report << "Analysis scaling benchmark: " << tracks.size() << " synthetic tracks of "
+            << secondsPerTrack << " s, 44100 Hz stereo" << newLine;
+    }
+
+    if (tracks.isEmpty())
+    {
+        return report + "No tracks to analyse" + newLine;
+    }
+
+    double singleThreadSeconds = 0.0;
+
+    for (int numThreads = 1; numThreads <= SystemStats::getNumCpus(); ++numThreads)
+    {
+        const double seconds = measure(numThreads);
+
+        if (numThreads == 1)
+        {
+            singleThreadSeconds = seconds;
+        }
+
+        // Efficiency is the speedup shared out over the threads, so perfect scaling stays at 100 %
+        const double speedup = seconds > 0.0 ? singleThreadSeconds / seconds : 0.0;
+
+        report << (String(numThreads) + (numThreads == 1 ? " thread" : " threads")).paddedRight(' ', 12)
+            << String(seconds, 3) << " s, "
+            << String(seconds > 0.0 ? tracks.size() / seconds : 0.0, 2) << " tracks/s, "
+            << "speedup " << String(speedup, 2) << "x, "
+            << "efficiency " << String(100.0 * speedup / numThreads, 1) << " %" << newLine;
+    }
+
+    return report;
+}
+
+/**
+ * Write stereo tracks of chords over a steady kick, each at a different tempo and root note
+ *
+ * @param                             None
+ *
+ * @return                            True if every track was written, false otherwise
+ */
+bool AnalysisBenchmark::writeSyntheticTracks()
+{
+    const double sampleRate = 44100.0;
+    const int numSamples = (int)(secondsPerTrack * sampleRate);
+
+    syntheticFolder = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("OtoDecksAnalysisBenchmark", "");
+
+    if (syntheticFolder.createDirectory().failed())
+    {
+        syntheticFolder = File();
+        return false;
+    }
+
+    AudioBuffer<float> buffer(2, numSamples);
+    Random random(1234);
+
+    for (int trackIndex = 0; trackIndex < numTracks; ++trackIndex)
+    {
+        // Spread the tempos and roots so every analysis has different work to do
+        const double beatsPerMinute = 110.0 + (trackIndex * 7) % 30;
+        const double rootFrequency = 220.0 * std::pow(2.0, (trackIndex * 5 % 12) / 12.0);
+        const int samplesPerBeat = (int)(sampleRate * 60.0 / beatsPerMinute);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double time = i / sampleRate;
+            const double twoPiTime = MathConstants<double>::twoPi * time;
+
+            // A major triad, with a decaying low sine on every beat and a little noise
+            double sample = 0.1 * (std::sin(twoPiTime * rootFrequency)
+                + std::sin(twoPiTime * rootFrequency * 1.259921)
+                + std::sin(twoPiTime * rootFrequency * 1.498307));
+
+            const double beatTime = (i % samplesPerBeat) / sampleRate;
+            sample += 0.5 * std::exp(-beatTime * 30.0) * std::sin(MathConstants<double>::twoPi * 55.0 * beatTime);
+            sample += 0.02 * (random.nextFloat() * 2.0f - 1.0f);
+
+            buffer.setSample(0, i, (float)sample);
+            buffer.setSample(1, i, (float)sample);
+        }
+
+        const File track = syntheticFolder.getChildFile("track" + String(trackIndex + 1) + ".wav");
+        std::unique_ptr<FileOutputStream> outputStream(track.createOutputStream());
+
+        if (outputStream == nullptr)
+        {
+            return false;
+        }
+
+        WavAudioFormat wavFormat;
+        std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), sampleRate, 2, 16, {}, 0));
+
+        if (writer == nullptr)
+        {
+            return false;
+        }
+
+        // The writer now owns the stream
+        outputStream.release();
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        {
+            return false;
+        }
+
+        tracks.add(track);
+    }
+
+    return true;
+}
+
+/**
+ * Analyse every track with a fresh analyser and wait for it to finish
+ *
+ * @param numThreads                  Number of analysis threads
+ *
+ * @return                            Wall clock time in seconds
+ */
+double AnalysisBenchmark::measure(int numThreads)
+{
+    LibraryAnalyser libraryAnalyser(numThreads);
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    for (const auto& track : tracks)
+    {
+        libraryAnalyser.analyseTrack(track, AnalysisScheduler::Priority::library);
+    }
+
+    // Poll as the progress label does, often enough not to add noticeably to short runs
+    while (true)
+    {
+        const AnalysisScheduler::Progress progress = libraryAnalyser.getProgress();
+
+        if (progress.numQueued + progress.numRunning == 0)
+        {
+            break;
+        }
+
+        Thread::sleep(10);
+    }
+
+    const double elapsedSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+
+    libraryAnalyser.takeFinishedAnalyses();
+
+    return elapsedSeconds;
+}
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    AnalysisBenchmark.h
+    Created: 16 Oct 2026 11:48:12pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "LibraryAnalyser.h"
+
+using namespace juce;
+
+class AnalysisBenchmark
+{
+public:
+    /**
+     * Constructor that configures the tracks every thread count analyses
+     *
+     * @param _trackFolder                Folder of audio tracks to analyse, or a nonexistent file to generate synthetic tracks
+     * @param _numTracks                  Number of synthetic tracks, or zero for two per core
+     * @param _secondsPerTrack            Length of each synthetic track in seconds
+     *
+     * @return                            None
+     */
+    AnalysisBenchmark(const File& _trackFolder = File(), int _numTracks = 0, double _secondsPerTrack = 30.0);
+
+    /**
+     * Destructor that deletes the synthetic tracks
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~AnalysisBenchmark();
+
+    /**
+     * Analyse the same tracks with every thread count from one up to the number of cores
+     *
+     * @param                             None
+     *
+     * @return                            Report listing the time, throughput, speedup and efficiency of each thread count
+     */
+    String run();
+
+private:
+    /**
+     * Write stereo tracks of chords over a steady kick, each at a different tempo and root note
+     *
+     * @param                             None
+     *
+     * @return                            True if every track was written, false otherwise
+     */
+    bool writeSyntheticTracks();
+
+    /**
+     * Analyse every track with a fresh analyser and wait for it to finish
+     *
+     * @param numThreads                  Number of analysis threads
+     *
+     * @return                            Wall clock time in seconds
+     */
+    double measure(int numThreads);
+
+    File trackFolder;
+    int numTracks;
+    double secondsPerTrack;
+
+    // Tracks analysed at every thread count, and the folder to delete if they were generated
+    Array<File> tracks;
+    File syntheticFolder;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisBenchmark)
+};
@@ -0,0 +1,417 @@
+/*
+  ==============================================================================
+
+    AnalysisScheduler.cpp
+    Created: 16 Oct 2026 11:02:58pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "AnalysisScheduler.h"
+
+constexpr int AnalysisScheduler::numPriorities;
+
+class AnalysisScheduler::Worker : public Thread
+{
+public:
+    /**
+     * Constructor for one worker thread of the scheduler
+     *
+     * @param _owner                      Scheduler that hands out the jobs
+     * @param _index                      Position of the worker in the scheduler
+     *
+     * @return                            None
+     */
+    Worker(AnalysisScheduler& _owner, int _index)
+        : Thread("Analysis worker " + String(_index + 1)), owner(_owner), index(_index)
+    {
+    }
+
+    /**
+     * Destructor that waits for the job being run to return
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~Worker() override
+    {
+        stopThread(4000);
+    }
+
+    /**
+     * Run jobs until the thread is asked to exit, sleeping while there is nothing to take
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            QueuedJob queuedJob;
+            std::shared_ptr<std::atomic<bool>> cancelled;
+
+            if (!owner.takeJob(index, queuedJob, cancelled))
+            {
+                wait(250);
+                continue;
+            }
+
+            (*queuedJob.job)([this, cancelled] { return threadShouldExit() || cancelled->load(); });
+
+            owner.finishJob(queuedJob, threadShouldExit() || cancelled->load());
+        }
+    }
+
+    // Jobs pushed to this worker, one queue per priority, taken from the front by the worker and from the back by thieves
+    std::deque<QueuedJob> queues[numPriorities];
+    CriticalSection queueLock;
+
+private:
+    AnalysisScheduler& owner;
+    const int index;
+};
+
+/**
+ * Constructor that starts the worker threads at a low priority
+ *
+ * @param numThreads                  Number of worker threads, limited to the number of cores
+ *
+ * @return                            None
+ */
+AnalysisScheduler::AnalysisScheduler(int numThreads)
+    : nextTicket(0), nextWorker(0), busySinceMilliseconds(0.0), lastFinishMilliseconds(0.0), numFinished(0)
+{
+    const int numWorkers = jlimit(1, SystemStats::getNumCpus(), numThreads);
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.add(new Worker(*this, i));
+    }
+
+    // Analysis must never take time from the audio and streaming threads
+    for (auto* worker : workers)
+    {
+        worker->startThread(2);
+    }
+}
+
+/**
+ * Destructor that cancels every job and stops the worker threads
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+AnalysisScheduler::~AnalysisScheduler()
+{
+    cancelAllJobs();
+
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    // Every worker has stopped before any is deleted, since a running worker can steal from the others
+    for (auto* worker : workers)
+    {
+        worker->stopThread(4000);
+    }
+
+    workers.clear(true);
+}
+
+/**
+ * Queue a job, or move it up the queue if a job with the same identifier is already waiting at a lower priority
+ *
+ * @param jobId                       Identifier used to cancel or reprioritise the job
+ * @param priority                    Priority the job waits at
+ * @param job                         Work to run, ignored if the identifier is already queued or running
+ *
+ * @return                            None
+ */
+void AnalysisScheduler::addJob(const String& jobId, Priority priority, Job job)
+{
+    const ScopedLock scopedLock(stateLock);
+
+    auto found = jobs.find(jobId);
+
+    // A cancelled job that is still returning is replaced, so adding it again is never lost
+    if (found != jobs.end() && !(found->second.running && found->second.cancelled->load()))
+    {
+        raisePriority(jobId, priority);
+        return;
+    }
+
+    // A job added to an idle scheduler starts a new busy period for the throughput
+    if (jobs.empty())
+    {
+        busySinceMilliseconds = Time::getMillisecondCounterHiRes();
+        lastFinishMilliseconds = busySinceMilliseconds;
+        numFinished = 0;
+    }
+
+    JobState& state = jobs[jobId];
+    state.running = false;
+    state.ticket = nextTicket++;
+    state.priority = priority;
+    state.job = std::make_shared<Job>(std::move(job));
+    state.cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    enqueue(jobId, state);
+}
+
+/**
+ * Move a waiting job up the queue, leaving running jobs and jobs already at a higher priority alone
+ *
+ * @param jobId                       Identifier of the job
+ * @param priority                    Priority the job should wait at
+ *
+ * @return                            True if the job is still waiting to run, false otherwise
+ */
+bool AnalysisScheduler::raisePriority(const String& jobId, Priority priority)
+{
+    const ScopedLock scopedLock(stateLock);
+
+    auto found = jobs.find(jobId);
+
+    if (found == jobs.end() || found->second.running)
+    {
+        return false;
+    }
+
+    // The entry already queued goes stale and is skipped when a worker reaches it
+    if ((int)priority < (int)found->second.priority)
+    {
+        found->second.priority = priority;
+        found->second.ticket = nextTicket++;
+        enqueue(jobId, found->second);
+    }
+
+    return true;
+}
+
+/**
+ * Remove a waiting job or ask a running job to return early
+ *
+ * @param jobId                       Identifier of the job
+ *
+ * @return                            True if the job was queued or running, false otherwise
+ */
+bool AnalysisScheduler::cancelJob(const String& jobId)
+{
+    const ScopedLock scopedLock(stateLock);
+
+    auto found = jobs.find(jobId);
+
+    if (found == jobs.end())
+    {
+        return false;
+    }
+
+    // A running job is forgotten when it returns, a waiting one straight away
+    if (found->second.running)
+    {
+        found->second.cancelled->store(true);
+    }
+    else
+    {
+        jobs.erase(found);
+    }
+
+    return true;
+}
+
+/**
+ * Remove every waiting job and ask every running job to return early
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void AnalysisScheduler::cancelAllJobs()
+{
+    const ScopedLock scopedLock(stateLock);
+
+    for (auto iterator = jobs.begin(); iterator != jobs.end();)
+    {
+        if (iterator->second.running)
+        {
+            iterator->second.cancelled->store(true);
+            ++iterator;
+        }
+        else
+        {
+            iterator = jobs.erase(iterator);
+        }
+    }
+}
+
+/**
+ * Getter method that retrieves the number of worker threads
+ *
+ * @param                             None
+ *
+ * @return                            Number of threads
+ */
+int AnalysisScheduler::getNumThreads() const
+{
+    return workers.size();
+}
+
+/**
+ * Getter method that retrieves the progress and throughput of the jobs added since the scheduler was last idle
+ *
+ * @param                             None
+ *
+ * @return                            Progress snapshot
+ */
+AnalysisScheduler::Progress AnalysisScheduler::getProgress() const
+{
+    const ScopedLock scopedLock(stateLock);
+
+    Progress progress;
+
+    for (const auto& job : jobs)
+    {
+        if (job.second.running)
+        {
+            ++progress.numRunning;
+        }
+        else
+        {
+            ++progress.numQueued;
+        }
+    }
+
+    progress.numFinished = numFinished;
+
+    // Throughput keeps counting while jobs are waiting, and is frozen at the last job once the scheduler is idle
+    const double endMilliseconds = jobs.empty() ? lastFinishMilliseconds : Time::getMillisecondCounterHiRes();
+    const double elapsedSeconds = (endMilliseconds - busySinceMilliseconds) / 1000.0;
+    progress.jobsPerSecond = elapsedSeconds > 0.0 ? numFinished / elapsedSeconds : 0.0;
+
+    return progress;
+}
+
+/**
+ * Push a job onto the next worker's queue in turn and wake the workers, called with the state lock held
+ *
+ * @param jobId                       Identifier of the job
+ * @param state                       State of the job, holding its ticket and priority
+ *
+ * @return                            None
+ */
+void AnalysisScheduler::enqueue(const String& jobId, const JobState& state)
+{
+    QueuedJob queuedJob;
+    queuedJob.jobId = jobId;
+    queuedJob.ticket = state.ticket;
+    queuedJob.job = state.job;
+
+    Worker& worker = *workers[nextWorker];
+    nextWorker = (nextWorker + 1) % workers.size();
+
+    {
+        const ScopedLock queueScopedLock(worker.queueLock);
+        worker.queues[(int)state.priority].push_back(queuedJob);
+    }
+
+    // Every worker is woken, so idle ones can steal the job if its owner is busy
+    for (auto* waitingWorker : workers)
+    {
+        waitingWorker->notify();
+    }
+}
+
+/**
+ * Take the highest priority job, from the worker's own queue first and then from the back of the others
+ *
+ * @param workerIndex                 Index of the worker looking for a job
+ * @param queuedJob                   Receives the job
+ * @param cancelled                   Receives the flag that cancels the job while it runs
+ *
+ * @return                            True if a job was taken, false if every queue is empty
+ */
+bool AnalysisScheduler::takeJob(int workerIndex, QueuedJob& queuedJob, std::shared_ptr<std::atomic<bool>>& cancelled)
+{
+    const int numWorkers = workers.size();
+
+    for (int priority = 0; priority < numPriorities; ++priority)
+    {
+        for (int offset = 0; offset < numWorkers; ++offset)
+        {
+            Worker& victim = *workers[(workerIndex + offset) % numWorkers];
+            const bool ownQueue = offset == 0;
+
+            while (true)
+            {
+                {
+                    const ScopedLock queueScopedLock(victim.queueLock);
+                    std::deque<QueuedJob>& queue = victim.queues[priority];
+
+                    if (queue.empty())
+                    {
+                        break;
+                    }
+
+                    // The owner works through its queue in order, thieves take the job its owner would reach last
+                    if (ownQueue)
+                    {
+                        queuedJob = queue.front();
+                        queue.pop_front();
+                    }
+                    else
+                    {
+                        queuedJob = queue.back();
+                        queue.pop_back();
+                    }
+                }
+
+                const ScopedLock scopedLock(stateLock);
+
+                auto found = jobs.find(queuedJob.jobId);
+
+                // Entries of cancelled jobs and jobs that moved to a higher priority are dropped
+                if (found != jobs.end() && found->second.ticket == queuedJob.ticket && !found->second.running)
+                {
+                    found->second.running = true;
+                    cancelled = found->second.cancelled;
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Forget a job that has returned and count it towards the throughput unless it was cancelled
+ *
+ * @param queuedJob                   Job that has returned
+ * @param wasCancelled                Whether the job returned early because it was cancelled
+ *
+ * @return                            None
+ */
+void AnalysisScheduler::finishJob(const QueuedJob& queuedJob, bool wasCancelled)
+{
+    const ScopedLock scopedLock(stateLock);
+
+    auto found = jobs.find(queuedJob.jobId);
+
+    if (found != jobs.end() && found->second.ticket == queuedJob.ticket)
+    {
+        jobs.erase(found);
+    }
+
+    if (!wasCancelled)
+    {
+        ++numFinished;
+        lastFinishMilliseconds = Time::getMillisecondCounterHiRes();
+    }
+}
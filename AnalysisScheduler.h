@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    AnalysisScheduler.h
+    Created: 16 Oct 2026 11:02:58pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <deque>
+#include <map>
+
+using namespace juce;
+
+class AnalysisScheduler
+{
+public:
+    /** Order in which waiting jobs are started, highest priority first */
+    enum class Priority
+    {
+        loadedTrack,
+        queuedTrack,
+        library
+    };
+
+    static constexpr int numPriorities = 3;
+
+    /** Work run on a worker thread, which should return early once shouldCancel returns true */
+    typedef std::function<void(const std::function<bool()>& shouldCancel)> Job;
+
+    /** Snapshot of the jobs added since the scheduler was last idle */
+    struct Progress
+    {
+        int numQueued = 0;
+        int numRunning = 0;
+        int numFinished = 0;
+
+        // Jobs finished per second since the scheduler became busy, kept once it is idle again
+        double jobsPerSecond = 0.0;
+    };
+
+    /**
+     * Constructor that starts the worker threads at a low priority
+     *
+     * @param numThreads                  Number of worker threads, limited to the number of cores
+     *
+     * @return                            None
+     */
+    explicit AnalysisScheduler(int numThreads);
+
+    /**
+     * Destructor that cancels every job and stops the worker threads
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~AnalysisScheduler();
+
+    /**
+     * Queue a job, or move it up the queue if a job with the same identifier is already waiting at a lower priority
+     *
+     * @param jobId                       Identifier used to cancel or reprioritise the job
+     * @param priority                    Priority the job waits at
+     * @param job                         Work to run, ignored if the identifier is already queued or running
+     *
+     * @return                            None
+     */
+    void addJob(const String& jobId, Priority priority, Job job);
+
+    /**
+     * Move a waiting job up the queue, leaving running jobs and jobs already at a higher priority alone
+     *
+     * @param jobId                       Identifier of the job
+     * @param priority                    Priority the job should wait at
+     *
+     * @return                            True if the job is still waiting to run, false otherwise
+     */
+    bool raisePriority(const String& jobId, Priority priority);
+
+    /**
+     * Remove a waiting job or ask a running job to return early
+     *
+     * @param jobId                       Identifier of the job
+     *
+     * @return                            True if the job was queued or running, false otherwise
+     */
+    bool cancelJob(const String& jobId);
+
+    /**
+     * Remove every waiting job and ask every running job to return early
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void cancelAllJobs();
+
+    /**
+     * Getter method that retrieves the number of worker threads
+     *
+     * @param                             None
+     *
+     * @return                            Number of threads
+     */
+    int getNumThreads() const;
+
+    /**
+     * Getter method that retrieves the progress and throughput of the jobs added since the scheduler was last idle
+     *
+     * @param                             None
+     *
+     * @return                            Progress snapshot
+     */
+    Progress getProgress() const;
+
+private:
+    class Worker;
+
+    /** Entry in a worker's queue, which is stale once its ticket no longer matches the job's */
+    struct QueuedJob
+    {
+        String jobId;
+        int ticket = 0;
+        std::shared_ptr<Job> job;
+    };
+
+    /** State of a job from the moment it is added until it finishes or is cancelled */
+    struct JobState
+    {
+        int ticket = 0;
+        Priority priority = Priority::library;
+        bool running = false;
+        std::shared_ptr<Job> job;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    /**
+     * Push a job onto the next worker's queue in turn and wake the workers, called with the state lock held
+     *
+     * @param jobId                       Identifier of the job
+     * @param state                       State of the job, holding its ticket and priority
+     *
+     * @return                            None
+     */
+    void enqueue(const String& jobId, const JobState& state);
+
+    /**
+     * Take the highest priority job, from the worker's own queue first and then from the back of the others
+     *
+     * @param workerIndex                 Index of the worker looking for a job
+     * @param queuedJob                   Receives the job
+     * @param cancelled                   Receives the flag that cancels the job while it runs
+     *
+     * @return                            True if a job was taken, false if every queue is empty
+     */
+    bool takeJob(int workerIndex, QueuedJob& queuedJob, std::shared_ptr<std::atomic<bool>>& cancelled);
+
+    /**
+     * Forget a job that has returned and count it towards the throughput unless it was cancelled
+     *
+     * @param queuedJob                   Job that has returned
+     * @param wasCancelled                Whether the job returned early because it was cancelled
+     *
+     * @return                            None
+     */
+    void finishJob(const QueuedJob& queuedJob, bool wasCancelled);
+
+    // Every job that is waiting or running, guarded by the state lock
+    std::map<String, JobState> jobs;
+    int nextTicket;
+    int nextWorker;
+    CriticalSection stateLock;
+
+    // Start of the current busy period and the jobs finished in it
+    double busySinceMilliseconds;
+    double lastFinishMilliseconds;
+    int numFinished;
+
+    // Each worker owns one queue per priority, which idle workers steal from
+    OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisScheduler)
+};
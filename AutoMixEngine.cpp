@@ -0,0 +1,700 @@
+/*
+  ==============================================================================
+
+    AutoMixEngine.cpp
+    Created: 16 Oct 2026 5:12:36pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "AutoMixEngine.h"
+#include "RealtimeSafetyChecker.h"
+
+constexpr double AutoMixEngine::defaultBeatsPerMinute;
+
+/**
+ * Constructor that initializes a manual mix of every deck with the crossfader at the centre, where auto-mix moves between the decks on sides A and B
+ *
+ * @param _deckCollection             Decks to mix, each on the crossfader side it is assigned to
+ *
+ * @return                            None
+ */
+AutoMixEngine::AutoMixEngine(DeckCollection& _deckCollection)
+    : deckCollection(_deckCollection),
+    sideDecks{ -1, -1 },
+    mixerInputs((size_t)_deckCollection.getNumDecks()),
+    outputSampleRate(44100.0),
+    renderPool(_deckCollection.getNumDecks() - 1),
+    sectionSamples(0),
+    sectionIncomingStart(-1),
+    position(0.5),
+    targetPosition(0.5),
+    autoMixEnabled(false),
+    transitionLength(16.0),
+    transitionLengthInBeats(true),
+    transitionRequested(false),
+    cancelRequested(false),
+    crossfadeCurve(MixerBus::Curve::equalPower),
+    masterGain(1.0f),
+    latchedPosition(0.5),
+    latchedAutoMix(false),
+    latchedTransitionLength(16.0),
+    latchedLengthInBeats(true),
+    latchedTempos((size_t)_deckCollection.getNumDecks(), true),
+    journal(nullptr),
+    transitionActive(false),
+    incomingSide(1),
+    transitionStartPosition(0.5),
+    transitionElapsed(0),
+    transitionLengthInSamples(1),
+    crossfaderPosition(0.5),
+    transitioningFlag(false)
+{
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        deckBuffers.add(new AudioBuffer<float>());
+        deckLoadMeasurers.add(new AudioProcessLoadMeasurer());
+    }
+
+    // Built once so the audio thread never copies or allocates it
+    renderTask = [this](int deck) { renderDeck(deck); };
+}
+
+/**
+ * Destructor for the auto-mix engine
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+AutoMixEngine::~AutoMixEngine()
+{
+}
+
+/**
+ * Allocate the buffers that each deck is rendered into before it is mixed
+ *
+ * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is rendered
+ * @param sampleRate                  Number of sound samples taken per second by the audio device
+ *
+ * @return                            None
+ */
+void AutoMixEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    outputSampleRate = sampleRate;
+
+    // A replay prepares the decks and mixer again at the same point, since preparing resets the state of every deck
+    if (journal != nullptr)
+    {
+        journal->recordPrepare(sampleRate, samplesPerBlockExpected);
+    }
+
+    // Larger blocks than expected are mixed in several sections rather than reallocating on the audio thread
+    for (auto* buffer : deckBuffers)
+    {
+        buffer->setSize(2, jmax(samplesPerBlockExpected, 512));
+    }
+
+    positionBuffer.setSize(1, jmax(samplesPerBlockExpected, 512));
+    mixerBus.prepare(jmax(samplesPerBlockExpected, 512));
+
+    // Every section is timed against its own length, so the block size here only sets the measurers' defaults
+    for (auto* measurer : deckLoadMeasurers)
+    {
+        measurer->reset(sampleRate, samplesPerBlockExpected);
+    }
+
+    renderLoadMeasurer.reset(sampleRate, samplesPerBlockExpected);
+    mixLoadMeasurer.reset(sampleRate, samplesPerBlockExpected);
+
+    // Workers only spin around the time each block is expected, so they need to know how long a block lasts
+    renderPool.prepare(samplesPerBlockExpected, sampleRate);
+}
+
+/**
+ * Render every deck and mix them with crossfader gains evaluated for every sample, starting scheduled transitions on time
+ *
+ * @param bufferToFill                Buffer that must be filled with audio data
+ *
+ * @return                            None
+ */
+void AutoMixEngine::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+
+    // Every callback moves the journal on, so each event is stamped with the first sample of its block
+    if (journal != nullptr)
+    {
+        journal->beginBlock(bufferToFill.numSamples);
+    }
+
+    const int sectionSize = positionBuffer.getNumSamples();
+
+    if (sectionSize == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    bool startRequested = latchSettings();
+
+    for (int numDone = 0; numDone < bufferToFill.numSamples; )
+    {
+        const int numSamples = jmin(sectionSize, bufferToFill.numSamples - numDone);
+        mixSection(bufferToFill, bufferToFill.startSample + numDone, numSamples, startRequested);
+
+        startRequested = false;
+        numDone += numSamples;
+    }
+
+    crossfaderPosition = position;
+    transitioningFlag = transitionActive;
+}
+
+/**
+ * Release the deck buffers after playback has stopped
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void AutoMixEngine::releaseResources()
+{
+    for (auto* buffer : deckBuffers)
+    {
+        buffer->setSize(2, 0);
+    }
+
+    positionBuffer.setSize(1, 0);
+    mixerBus.release();
+}
+
+/**
+ * Setter method that sets the crossfader position chosen by the user, cancelling a transition that is running
+ *
+ * @param newPosition                 Position from zero for deck A only to one for deck B only
+ *
+ * @return                            None
+ */
+void AutoMixEngine::setCrossfaderPosition(double newPosition)
+{
+    targetPosition = jlimit(0.0, 1.0, newPosition);
+    cancelRequested = true;
+}
+
+/**
+ * Getter method that retrieves the crossfader position reached by the last block, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Position from zero for deck A only to one for deck B only
+ */
+double AutoMixEngine::getCrossfaderPosition() const
+{
+    return crossfaderPosition;
+}
+
+/**
+ * Setter method that sets whether transitions are started automatically as the audible deck nears the end of its track
+ *
+ * @param shouldAutoMix               True to mix unattended, false to leave the crossfader to the user
+ *
+ * @return                            None
+ */
+void AutoMixEngine::setAutoMixEnabled(bool shouldAutoMix)
+{
+    autoMixEnabled = shouldAutoMix && hasOneDeckPerSide();
+}
+
+/**
+ * Determine whether transitions are started automatically, which the audio thread turns off when the decks cannot be mixed
+ *
+ * @param                             None
+ *
+ * @return                            True if auto-mix is enabled, false otherwise
+ */
+bool AutoMixEngine::isAutoMixEnabled() const
+{
+    return autoMixEnabled;
+}
+
+/**
+ * Determine whether transitions can run, which needs exactly one deck on side A and one on side B of the crossfader
+ *
+ * @param                             None
+ *
+ * @return                            True if each side has exactly one deck, false otherwise
+ */
+bool AutoMixEngine::hasOneDeckPerSide() const
+{
+    int numOnSideA = 0;
+    int numOnSideB = 0;
+
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        const MixerBus::Side side = deckCollection.getDeck(deck).getCrossfaderSide();
+        numOnSideA += side == MixerBus::Side::a ? 1 : 0;
+        numOnSideB += side == MixerBus::Side::b ? 1 : 0;
+    }
+
+    return numOnSideA == 1 && numOnSideB == 1;
+}
+
+/**
+ * Setter method that sets the length of the next transitions
+ *
+ * @param length                      Length in beats or seconds
+ * @param lengthInBeats               True if the length is counted in beats of the outgoing deck's beat grid, false for seconds
+ *
+ * @return                            None
+ */
+void AutoMixEngine::setTransitionLength(double length, bool lengthInBeats)
+{
+    transitionLength = jmax(0.0, length);
+    transitionLengthInBeats = lengthInBeats;
+}
+
+/**
+ * Start a transition to the deck that is not audible at the beginning of the next block
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void AutoMixEngine::startTransition()
+{
+    transitionRequested = true;
+}
+
+/**
+ * Determine whether the crossfader is being moved by a transition, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            True if a transition is running, false otherwise
+ */
+bool AutoMixEngine::isTransitioning() const
+{
+    return transitioningFlag;
+}
+
+/**
+ * Setter method that sets the shape of the gains applied as the crossfader moves
+ *
+ * @param curve                       Crossfade curve to use from the next block
+ *
+ * @return                            None
+ */
+void AutoMixEngine::setCrossfadeCurve(MixerBus::Curve curve)
+{
+    crossfadeCurve = curve;
+}
+
+/**
+ * Getter method that retrieves the shape of the gains applied as the crossfader moves
+ *
+ * @param                             None
+ *
+ * @return                            Crossfade curve in use
+ */
+MixerBus::Curve AutoMixEngine::getCrossfadeCurve() const
+{
+    return crossfadeCurve;
+}
+
+/**
+ * Setter method that sets the gain of the whole mix
+ *
+ * @param gain                        Linear master gain, ramped over the next block
+ *
+ * @return                            None
+ */
+void AutoMixEngine::setMasterGain(float gain)
+{
+    masterGain = gain;
+}
+
+/**
+ * Setter method that sets whether the decks are rendered concurrently on the render workers before they are mixed
+ *
+ * @param shouldRenderInParallel      True to render each deck on its own core, false to render them one after another
+ *
+ * @return                            None
+ */
+void AutoMixEngine::setParallelRendering(bool shouldRenderInParallel)
+{
+    renderPool.setEnabled(shouldRenderInParallel);
+}
+
+/**
+ * Determine whether the decks are rendered concurrently
+ *
+ * @param                             None
+ *
+ * @return                            True if parallel rendering is enabled, false otherwise
+ */
+bool AutoMixEngine::isParallelRendering() const
+{
+    return renderPool.isEnabled();
+}
+
+/**
+ * Getter method that retrieves how much of each section's duration one deck has recently taken to render, safe to call from any thread
+ *
+ * @param deck                        Index of the deck in the collection
+ *
+ * @return                            Smoothed render time as a proportion of real time
+ */
+double AutoMixEngine::getDeckLoad(int deck) const
+{
+    return deckLoadMeasurers.getUnchecked(deck)->getLoadAsProportion();
+}
+
+/**
+ * Getter method that retrieves how much of each section's duration all decks have recently taken to render, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Smoothed wall clock time as a proportion of real time, below the sum of the decks when rendering in parallel
+ */
+double AutoMixEngine::getRenderLoad() const
+{
+    return renderLoadMeasurer.getLoadAsProportion();
+}
+
+/**
+ * Getter method that retrieves how much of each section's duration the crossfader and mixer have recently taken, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Smoothed mixing time as a proportion of real time
+ */
+double AutoMixEngine::getMixLoad() const
+{
+    return mixLoadMeasurer.getLoadAsProportion();
+}
+
+/**
+ * Setter method that sets the journal every block and the settings it was mixed with are recorded in, called before the audio device starts
+ *
+ * @param newJournal                  Journal to record in, or nullptr to stop journaling
+ *
+ * @return                            None
+ */
+void AutoMixEngine::setControlJournal(ControlJournal* newJournal)
+{
+    journal = newJournal;
+}
+
+/**
+ * Read every setting made on the message thread once for the whole block, journaling the ones that changed
+ *
+ * @param                             None
+ *
+ * @return                            True if the user asked for a transition to start with this block, false otherwise
+ */
+bool AutoMixEngine::latchSettings()
+{
+    // The user moving the crossfader takes over from a running transition
+    if (cancelRequested.exchange(false))
+    {
+        transitionActive = false;
+        latchedPosition = targetPosition;
+
+        if (journal != nullptr)
+        {
+            journal->recordMixerEvent(ControlJournal::EventType::crossfader, latchedPosition);
+        }
+    }
+
+    bool startRequested = transitionRequested.exchange(false);
+
+    latchedTransitionLength = transitionLength;
+    latchedLengthInBeats = transitionLengthInBeats;
+
+    const MixerBus::Curve curve = crossfadeCurve;
+    const float gain = masterGain;
+    mixerBus.setCurve(curve);
+    mixerBus.setMasterGain(gain);
+
+    // Deck sides and tempos are set on the message thread as well, so they are read here rather than in every section
+    int numOnSide[2] = { 0, 0 };
+
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        const DJAudioPlayer& player = deckCollection.getDeck(deck);
+        mixerInputs[deck].side = player.getCrossfaderSide();
+        latchedTempos[deck] = player.getBeatsPerMinute();
+
+        if (mixerInputs[deck].side != MixerBus::Side::thru)
+        {
+            const int side = mixerInputs[deck].side == MixerBus::Side::a ? 0 : 1;
+            sideDecks[side] = deck;
+            ++numOnSide[side];
+        }
+    }
+
+    // Transitions move from the deck on one side to the deck on the other, so they need exactly one deck on each
+    for (int side = 0; side < 2; ++side)
+    {
+        if (numOnSide[side] != 1)
+        {
+            sideDecks[side] = -1;
+        }
+    }
+
+    const bool sidesMixable = sideDecks[0] >= 0 && sideDecks[1] >= 0;
+
+    if (!sidesMixable)
+    {
+        // Turned off rather than paused, so the user sees that it is off and chooses when to mix unattended again
+        autoMixEnabled = false;
+        startRequested = false;
+    }
+
+    latchedAutoMix = sidesMixable && autoMixEnabled;
+
+    if (journal == nullptr)
+    {
+        return startRequested;
+    }
+
+    // Settings are journaled only when they change, so a block where nothing is touched costs nothing
+    if (startRequested)
+    {
+        journal->recordMixerEvent(ControlJournal::EventType::transitionStart, 0.0);
+    }
+
+    journal->recordSetting(ControlJournal::EventType::autoMix, -1, latchedAutoMix ? 1.0 : 0.0);
+    journal->recordSetting(ControlJournal::EventType::transitionLength, -1, latchedTransitionLength);
+    journal->recordSetting(ControlJournal::EventType::transitionInBeats, -1, latchedLengthInBeats ? 1.0 : 0.0);
+    journal->recordSetting(ControlJournal::EventType::curve, -1, (double)(int)curve);
+    journal->recordSetting(ControlJournal::EventType::masterGain, -1, (double)gain);
+
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        journal->recordSetting(ControlJournal::EventType::side, deck, (double)(int)mixerInputs[deck].side);
+        journal->recordSetting(ControlJournal::EventType::beatsPerMinute, deck, latchedTempos[deck]);
+    }
+
+    return startRequested;
+}
+
+/**
+ * Render and mix one section of a block that fits the deck buffers
+ *
+ * @param bufferToFill                Buffer that must be filled with audio data
+ * @param startSample                 First sample of the section in the buffer
+ * @param numSamples                  Number of samples in the section
+ * @param startRequested              True if the user asked for a transition to start with this section
+ *
+ * @return                            None
+ */
+void AutoMixEngine::mixSection(const AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples, bool startRequested)
+{
+    int incomingStart = -1;
+
+    if (!transitionActive && sideDecks[0] >= 0 && sideDecks[1] >= 0)
+    {
+        int startOffset = 0;
+        int64 lengthInSamples = getTransitionLengthInSamples();
+
+        if (startRequested || (latchedAutoMix && findTransitionStart(numSamples, startOffset, lengthInSamples)))
+        {
+            beginTransition(startOffset, lengthInSamples);
+            incomingStart = startOffset;
+        }
+    }
+
+    // Render every deck, concurrently if the render workers are enabled, before any of them is mixed
+    sectionSamples = numSamples;
+    sectionIncomingStart = incomingStart;
+
+    {
+        const AudioProcessLoadMeasurer::ScopedTimer renderTimer(renderLoadMeasurer, numSamples);
+        renderPool.run(renderTask, deckCollection.getNumDecks());
+    }
+
+    // The crossfader, the mixer and the auto-mix bookkeeping after them are timed together as the mix stage
+    const AudioProcessLoadMeasurer::ScopedTimer mixTimer(mixLoadMeasurer, numSamples);
+
+    // Evaluate the crossfader for every sample, ramping manual moves across the section to avoid zipper noise
+    float* positions = positionBuffer.getWritePointer(0);
+
+    if (transitionActive)
+    {
+        const double endPosition = (double)incomingSide;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double progress = jlimit(0.0, 1.0, (double)(transitionElapsed + i + 1) / (double)transitionLengthInSamples);
+            positions[i] = (float)(transitionStartPosition + (endPosition - transitionStartPosition) * progress);
+        }
+
+        transitionElapsed += numSamples;
+
+        if (transitionElapsed >= transitionLengthInSamples)
+        {
+            transitionActive = false;
+            latchedPosition = endPosition;
+        }
+    }
+    else
+    {
+        const double endPosition = latchedPosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            positions[i] = (float)(position + (endPosition - position) * (double)(i + 1) / (double)numSamples);
+        }
+    }
+
+    position = positions[numSamples - 1];
+
+    // Every deck is summed on the side latched for the block, so the mix costs one pass per deck
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        mixerInputs[deck].buffer = deckBuffers.getUnchecked(deck);
+    }
+
+    mixerBus.mix(mixerInputs, deckCollection.getNumDecks(), positions, *bufferToFill.buffer, startSample, numSamples);
+
+    // While mixing unattended, a deck that cannot be heard waits stopped so that the next transition starts it on cue
+    if (latchedAutoMix && !transitionActive)
+    {
+        DJAudioPlayer& deckA = deckCollection.getDeck(sideDecks[0]);
+        DJAudioPlayer& deckB = deckCollection.getDeck(sideDecks[1]);
+
+        if (position >= 1.0 && deckA.isPlaying())
+        {
+            deckA.stopImmediately();
+        }
+        if (position <= 0.0 && deckB.isPlaying())
+        {
+            deckB.stopImmediately();
+        }
+    }
+}
+
+/**
+ * Render one deck into its buffer for the current section and time it, called on the audio thread or a render worker
+ *
+ * @param deck                        Index of the deck in the collection
+ *
+ * @return                            None
+ */
+void AutoMixEngine::renderDeck(int deck)
+{
+    DJAudioPlayer& player = deckCollection.getDeck(deck);
+    AudioBuffer<float>* buffer = deckBuffers.getUnchecked(deck);
+    const AudioProcessLoadMeasurer::ScopedTimer deckTimer(*deckLoadMeasurers.getUnchecked(deck), sectionSamples);
+
+    // Render workers are real-time threads as well, so their share of the decks is checked too
+    const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+
+    // The deck on the incoming side of a transition starts on the first sample of the transition
+    if (deck == sideDecks[incomingSide] && sectionIncomingStart >= 0 && !player.isPlaying())
+    {
+        if (sectionIncomingStart > 0)
+        {
+            player.getNextAudioBlock(AudioSourceChannelInfo(buffer, 0, sectionIncomingStart));
+        }
+
+        player.startImmediately();
+        player.getNextAudioBlock(AudioSourceChannelInfo(buffer, sectionIncomingStart, sectionSamples - sectionIncomingStart));
+    }
+    else
+    {
+        player.getNextAudioBlock(AudioSourceChannelInfo(buffer, 0, sectionSamples));
+    }
+}
+
+/**
+ * Find where in the next section a transition has to start so that it ends with the audible deck's track
+ *
+ * @param numSamples                  Number of samples in the next section
+ * @param startOffset                 Receives the sample of the section the transition starts at
+ * @param lengthInSamples             Transition length, shortened if the track ends sooner than it would finish
+ *
+ * @return                            True if a transition starts in the next section, false otherwise
+ */
+bool AutoMixEngine::findTransitionStart(int numSamples, int& startOffset, int64& lengthInSamples)
+{
+    const int audibleSide = getAudibleSide();
+    DJAudioPlayer& outgoing = deckCollection.getDeck(sideDecks[audibleSide]);
+    DJAudioPlayer& incoming = deckCollection.getDeck(sideDecks[1 - audibleSide]);
+
+    // Nothing is playing to mix out of, or there is no track to mix into
+    if (!outgoing.isPlaying() || incoming.getSongLengthInSeconds() <= 0.0 || incoming.finishedPlaying())
+    {
+        return false;
+    }
+
+    // Output samples left before the outgoing track ends at its current speed
+    const double remainingSeconds = outgoing.getSongLengthInSeconds() * (1.0 - outgoing.getPositionRelative());
+    const int64 remaining = (int64)(remainingSeconds / jmax(outgoing.getSpeed(), 1.0e-3) * outputSampleRate);
+
+    if (remaining - lengthInSamples >= numSamples)
+    {
+        return false;
+    }
+
+    // Finish exactly as the outgoing track ends, or as soon as possible if auto-mix was enabled too late for the full length
+    startOffset = (int)jmax((int64)0, remaining - lengthInSamples);
+    lengthInSamples = jmax((int64)1, jmin(lengthInSamples, remaining - startOffset));
+    return true;
+}
+
+/**
+ * Begin moving the crossfader towards the deck that is not audible
+ *
+ * @param startOffset                 Sample of the current section the transition starts at
+ * @param lengthInSamples             Number of samples the crossfader takes to reach the other deck
+ *
+ * @return                            None
+ */
+void AutoMixEngine::beginTransition(int startOffset, int64 lengthInSamples)
+{
+    incomingSide = 1 - getAudibleSide();
+    transitionStartPosition = position;
+    transitionElapsed = -startOffset;
+    transitionLengthInSamples = jmax((int64)1, lengthInSamples);
+    transitionActive = true;
+}
+
+/**
+ * Getter method that retrieves the transition length at the current speed of the audible deck
+ *
+ * @param                             None
+ *
+ * @return                            Transition length in output samples
+ */
+int64 AutoMixEngine::getTransitionLengthInSamples() const
+{
+    double seconds = latchedTransitionLength;
+
+    if (latchedLengthInBeats)
+    {
+        const int outgoingDeck = sideDecks[getAudibleSide()];
+        const double analysedTempo = latchedTempos[outgoingDeck];
+        const double tempo = analysedTempo > 0.0 ? analysedTempo : defaultBeatsPerMinute;
+
+        // Beats go by faster when the outgoing deck is sped up
+        seconds = latchedTransitionLength * 60.0 / (tempo * jmax(deckCollection.getDeck(outgoingDeck).getSpeed(), 1.0e-3));
+    }
+
+    return jmax((int64)1, (int64)(seconds * outputSampleRate));
+}
+
+/**
+ * Getter method that retrieves the side of the crossfader that is heard the most at its current position
+ *
+ * @param                             None
+ *
+ * @return                            Zero for side A, one for side B
+ */
+int AutoMixEngine::getAudibleSide() const
+{
+    return position <= 0.5 ? 0 : 1;
+}
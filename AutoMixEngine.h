@@ -0,0 +1,361 @@
+/*
+  ==============================================================================
+
+    AutoMixEngine.h
+    Created: 16 Oct 2026 5:12:36pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ControlJournal.h"
+#include "DeckCollection.h"
+#include "MixerBus.h"
+#include "DeckRenderPool.h"
+
+using namespace juce;
+
+class AutoMixEngine : public AudioSource
+{
+public:
+    /**
+     * Constructor that initializes a manual mix of every deck with the crossfader at the centre, where auto-mix moves between the decks on sides A and B
+     *
+     * @param _deckCollection             Decks to mix, each on the crossfader side it is assigned to
+     *
+     * @return                            None
+     */
+    explicit AutoMixEngine(DeckCollection& _deckCollection);
+
+    /**
+     * Destructor for the auto-mix engine
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~AutoMixEngine() override;
+
+    /**
+     * Allocate the buffers that each deck is rendered into before it is mixed
+     *
+     * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is rendered
+     * @param sampleRate                  Number of sound samples taken per second by the audio device
+     *
+     * @return                            None
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * Render every deck and mix them with crossfader gains evaluated for every sample, starting scheduled transitions on time
+     *
+     * @param bufferToFill                Buffer that must be filled with audio data
+     *
+     * @return                            None
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    /**
+     * Release the deck buffers after playback has stopped
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void releaseResources() override;
+
+    /**
+     * Setter method that sets the crossfader position chosen by the user, cancelling a transition that is running
+     *
+     * @param newPosition                 Position from zero for deck A only to one for deck B only
+     *
+     * @return                            None
+     */
+    void setCrossfaderPosition(double newPosition);
+
+    /**
+     * Getter method that retrieves the crossfader position reached by the last block, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Position from zero for deck A only to one for deck B only
+     */
+    double getCrossfaderPosition() const;
+
+    /**
+     * Setter method that sets whether transitions are started automatically as the audible deck nears the end of its track
+     *
+     * @param shouldAutoMix               True to mix unattended, false to leave the crossfader to the user
+     *
+     * @return                            None
+     */
+    void setAutoMixEnabled(bool shouldAutoMix);
+
+    /**
+     * Determine whether transitions are started automatically, which the audio thread turns off when the decks cannot be mixed
+     *
+     * @param                             None
+     *
+     * @return                            True if auto-mix is enabled, false otherwise
+     */
+    bool isAutoMixEnabled() const;
+
+    /**
+     * Determine whether transitions can run, which needs exactly one deck on side A and one on side B of the crossfader
+     *
+     * @param                             None
+     *
+     * @return                            True if each side has exactly one deck, false otherwise
+     */
+    bool hasOneDeckPerSide() const;
+
+    /**
+     * Setter method that sets the length of the next transitions
+     *
+     * @param length                      Length in beats or seconds
+     * @param lengthInBeats               True if the length is counted in beats of the outgoing deck's beat grid, false for seconds
+     *
+     * @return                            None
+     */
+    void setTransitionLength(double length, bool lengthInBeats);
+
+    /**
+     * Start a transition to the deck that is not audible at the beginning of the next block
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void startTransition();
+
+    /**
+     * Determine whether the crossfader is being moved by a transition, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            True if a transition is running, false otherwise
+     */
+    bool isTransitioning() const;
+
+    /**
+     * Setter method that sets the shape of the gains applied as the crossfader moves
+     *
+     * @param curve                       Crossfade curve to use from the next block
+     *
+     * @return                            None
+     */
+    void setCrossfadeCurve(MixerBus::Curve curve);
+
+    /**
+     * Getter method that retrieves the shape of the gains applied as the crossfader moves
+     *
+     * @param                             None
+     *
+     * @return                            Crossfade curve in use
+     */
+    MixerBus::Curve getCrossfadeCurve() const;
+
+    /**
+     * Setter method that sets the gain of the whole mix
+     *
+     * @param gain                        Linear master gain, ramped over the next block
+     *
+     * @return                            None
+     */
+    void setMasterGain(float gain);
+
+    /**
+     * Setter method that sets whether the decks are rendered concurrently on the render workers before they are mixed
+     *
+     * @param shouldRenderInParallel      True to render each deck on its own core, false to render them one after another
+     *
+     * @return                            None
+     */
+    void setParallelRendering(bool shouldRenderInParallel);
+
+    /**
+     * Determine whether the decks are rendered concurrently
+     *
+     * @param                             None
+     *
+     * @return                            True if parallel rendering is enabled, false otherwise
+     */
+    bool isParallelRendering() const;
+
+    /**
+     * Getter method that retrieves how much of each section's duration one deck has recently taken to render, safe to call from any thread
+     *
+     * @param deck                        Index of the deck in the collection
+     *
+     * @return                            Smoothed render time as a proportion of real time
+     */
+    double getDeckLoad(int deck) const;
+
+    /**
+     * Getter method that retrieves how much of each section's duration all decks have recently taken to render, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Smoothed wall clock time as a proportion of real time, below the sum of the decks when rendering in parallel
+     */
+    double getRenderLoad() const;
+
+    /**
+     * Getter method that retrieves how much of each section's duration the crossfader and mixer have recently taken, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Smoothed mixing time as a proportion of real time
+     */
+    double getMixLoad() const;
+
+    /**
+     * Setter method that sets the journal every block and the settings it was mixed with are recorded in, called before the audio device starts
+     *
+     * @param newJournal                  Journal to record in, or nullptr to stop journaling
+     *
+     * @return                            None
+     */
+    void setControlJournal(ControlJournal* newJournal);
+
+    // Tempo assumed for tracks whose tempo is unknown when a transition is counted in beats
+    static constexpr double defaultBeatsPerMinute = 120.0;
+
+private:
+    /**
+     * Read every setting made on the message thread once for the whole block, journaling the ones that changed
+     *
+     * @param                             None
+     *
+     * @return                            True if the user asked for a transition to start with this block, false otherwise
+     */
+    bool latchSettings();
+
+    /**
+     * Render and mix one section of a block that fits the deck buffers
+     *
+     * @param bufferToFill                Buffer that must be filled with audio data
+     * @param startSample                 First sample of the section in the buffer
+     * @param numSamples                  Number of samples in the section
+     * @param startRequested              True if the user asked for a transition to start with this section
+     *
+     * @return                            None
+     */
+    void mixSection(const AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples, bool startRequested);
+
+    /**
+     * Render one deck into its buffer for the current section and time it, called on the audio thread or a render worker
+     *
+     * @param deck                        Index of the deck in the collection
+     *
+     * @return                            None
+     */
+    void renderDeck(int deck);
+
+    /**
+     * Find where in the next section a transition has to start so that it ends with the audible deck's track
+     *
+     * @param numSamples                  Number of samples in the next section
+     * @param startOffset                 Receives the sample of the section the transition starts at
+     * @param lengthInSamples             Transition length, shortened if the track ends sooner than it would finish
+     *
+     * @return                            True if a transition starts in the next section, false otherwise
+     */
+    bool findTransitionStart(int numSamples, int& startOffset, int64& lengthInSamples);
+
+    /**
+     * Begin moving the crossfader towards the deck that is not audible
+     *
+     * @param startOffset                 Sample of the current section the transition starts at
+     * @param lengthInSamples             Number of samples the crossfader takes to reach the other deck
+     *
+     * @return                            None
+     */
+    void beginTransition(int startOffset, int64 lengthInSamples);
+
+    /**
+     * Getter method that retrieves the transition length at the current speed of the audible deck
+     *
+     * @param                             None
+     *
+     * @return                            Transition length in output samples
+     */
+    int64 getTransitionLengthInSamples() const;
+
+    /**
+     * Getter method that retrieves the side of the crossfader that is heard the most at its current position
+     *
+     * @param                             None
+     *
+     * @return                            Zero for side A, one for side B
+     */
+    int getAudibleSide() const;
+
+    DeckCollection& deckCollection;
+
+    // Deck latched on each side of the crossfader for the block, or -1 unless that side has exactly one deck to mix between
+    int sideDecks[2];
+
+    // Each deck is rendered here before the crossfader gains are applied, and handed to the mixer with its side
+    OwnedArray<AudioBuffer<float>> deckBuffers;
+    HeapBlock<MixerBus::Input> mixerInputs;
+    double outputSampleRate;
+
+    // Renders the decks of a section concurrently when parallel rendering is enabled
+    DeckRenderPool renderPool;
+    DeckRenderPool::Task renderTask;
+
+    // Section being rendered, where the incoming start is negative unless a transition starts the incoming deck in it
+    int sectionSamples;
+    int sectionIncomingStart;
+
+    // Time taken by each deck and by each stage of a section, published for the message thread
+    OwnedArray<AudioProcessLoadMeasurer> deckLoadMeasurers;
+    AudioProcessLoadMeasurer renderLoadMeasurer;
+    AudioProcessLoadMeasurer mixLoadMeasurer;
+
+    // Crossfader position for every sample of the section being mixed
+    AudioBuffer<float> positionBuffer;
+
+    // Applies the crossfade curve and master gain while summing the decks
+    MixerBus mixerBus;
+
+    // Crossfader position at the start of the next section, owned by the audio thread
+    double position;
+
+    // Written by the message thread and read at the start of every block
+    std::atomic<double> targetPosition;
+    std::atomic<bool> autoMixEnabled;
+    std::atomic<double> transitionLength;
+    std::atomic<bool> transitionLengthInBeats;
+    std::atomic<bool> transitionRequested;
+    std::atomic<bool> cancelRequested;
+    std::atomic<MixerBus::Curve> crossfadeCurve;
+    std::atomic<float> masterGain;
+
+    // Settings in effect for the current block, so every section of it sees the same values whenever the message thread changes them
+    double latchedPosition;
+    bool latchedAutoMix;
+    double latchedTransitionLength;
+    bool latchedLengthInBeats;
+    HeapBlock<double> latchedTempos;
+
+    // Records the settings of every block, if the session is journaled
+    ControlJournal* journal;
+
+    // Running transition, where the elapsed count is negative until its first sample
+    bool transitionActive;
+    int incomingSide;
+    double transitionStartPosition;
+    int64 transitionElapsed;
+    int64 transitionLengthInSamples;
+
+    // Published for the message thread
+    std::atomic<double> crossfaderPosition;
+    std::atomic<bool> transitioningFlag;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoMixEngine)
+};
@@ -0,0 +1,367 @@
+/*
+  ==============================================================================
+
+    BeatAnalyser.cpp
+    Created: 16 Oct 2026 6:48:51pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "BeatAnalyser.h"
+
+constexpr double BeatAnalyser::minimumBeatsPerMinute;
+constexpr double BeatAnalyser::maximumBeatsPerMinute;
+
+/**
+ * Constructor that initializes an analyser that has not been prepared
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+BeatAnalyser::BeatAnalyser() : sampleRate(0.0), hopSize(0), numFrameSamples(0), beatsPerMinute(0.0), downbeatSeconds(0.0)
+{
+}
+
+/**
+ * Destructor for the beat analyser
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+BeatAnalyser::~BeatAnalyser()
+{
+}
+
+/**
+ * Allocate the working arrays for a sample rate and discard the audio analysed so far
+ *
+ * @param newSampleRate               Sample rate of the audio track being analysed
+ *
+ * @return                            None
+ */
+void BeatAnalyser::prepare(double newSampleRate)
+{
+    // One onset value every 10 ms whatever the sample rate, from frames twice as long as the hop
+    const int newHopSize = jmax(1, roundToInt(newSampleRate / 100.0));
+
+    if (newHopSize != hopSize || fft == nullptr)
+    {
+        hopSize = newHopSize;
+        fft = std::make_unique<dsp::FFT>(roundToInt(std::log2((double)nextPowerOfTwo(hopSize * 2))));
+
+        const int fftSize = fft->getSize();
+
+        frame.allocate((size_t)fftSize, true);
+        window.allocate((size_t)fftSize, true);
+        spectrum.allocate((size_t)fftSize * 2, true);
+        previousMagnitudes.allocate((size_t)(fftSize / 2 + 1), true);
+
+        for (int i = 0; i < fftSize; ++i)
+        {
+            window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float)i / (float)fftSize);
+        }
+    }
+
+    sampleRate = newSampleRate;
+
+    // The first frame is padded with silence so that it ends after the first hop
+    const int fftSize = fft->getSize();
+    FloatVectorOperations::clear(frame, fftSize);
+    FloatVectorOperations::clear(previousMagnitudes, fftSize / 2 + 1);
+    numFrameSamples = fftSize - hopSize;
+
+    onsetEnvelope.clearQuick();
+    bassEnvelope.clearQuick();
+    beatsPerMinute = 0.0;
+    downbeatSeconds = 0.0;
+}
+
+/**
+ * Add the next samples of the track to the onset envelope
+ *
+ * @param samples                     Mono samples following the ones already processed
+ * @param numSamples                  Number of samples
+ *
+ * @return                            None
+ */
+void BeatAnalyser::process(const float* samples, int numSamples)
+{
+    jassert(fft != nullptr);
+
+    const int fftSize = fft->getSize();
+    const int numBins = fftSize / 2 + 1;
+
+    // Kick drums, which usually mark the start of a bar, sit below about 150 Hz
+    const int numBassBins = jmax(1, roundToInt(150.0 * fftSize / sampleRate));
+
+    while (numSamples > 0)
+    {
+        const int numToCopy = jmin(numSamples, fftSize - numFrameSamples);
+        FloatVectorOperations::copy(frame + numFrameSamples, samples, numToCopy);
+        numFrameSamples += numToCopy;
+        samples += numToCopy;
+        numSamples -= numToCopy;
+
+        if (numFrameSamples < fftSize)
+        {
+            break;
+        }
+
+        FloatVectorOperations::multiply(spectrum, frame, window, fftSize);
+        FloatVectorOperations::clear(spectrum + fftSize, fftSize);
+        fft->performFrequencyOnlyForwardTransform(spectrum);
+
+        // Sum the rises in log magnitude, which mark note onsets and drum hits whatever their loudness
+        float flux = 0.0f;
+        float bassFlux = 0.0f;
+
+        for (int bin = 1; bin < numBins; ++bin)
+        {
+            const float magnitude = std::log1p(spectrum[bin]);
+            const float rise = jmax(0.0f, magnitude - previousMagnitudes[bin]);
+            previousMagnitudes[bin] = magnitude;
+
+            flux += rise;
+
+            if (bin <= numBassBins)
+            {
+                bassFlux += rise;
+            }
+        }
+
+        onsetEnvelope.add(flux);
+        bassEnvelope.add(bassFlux);
+
+        // Keep the overlapping part of the frame for the next hop
+        std::memmove(frame, frame + hopSize, sizeof(float) * (size_t)(fftSize - hopSize));
+        numFrameSamples = fftSize - hopSize;
+    }
+}
+
+/**
+ * Estimate the tempo and beat grid from the onset envelope of the whole track
+ *
+ * @param                             None
+ *
+ * @return                            True if the track was long enough and rhythmic enough to find a tempo, false otherwise
+ */
+bool BeatAnalyser::finish()
+{
+    const double framesPerSecond = sampleRate / hopSize;
+    const int numFrames = onsetEnvelope.size();
+
+    // A few bars are needed before a tempo means anything
+    if (numFrames < roundToInt(framesPerSecond * 8.0))
+    {
+        return false;
+    }
+
+    // Subtract a moving average so that only the peaks above the local level count
+    const int averageRadius = jmax(1, roundToInt(framesPerSecond * 0.25));
+    Array<double> runningSum;
+    runningSum.resize(numFrames + 1);
+    runningSum.set(0, 0.0);
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        runningSum.set(i + 1, runningSum[i] + onsetEnvelope[i]);
+    }
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        const int first = jmax(0, i - averageRadius);
+        const int last = jmin(numFrames, i + averageRadius + 1);
+        const double average = (runningSum[last] - runningSum[first]) / (last - first);
+        onsetEnvelope.set(i, jmax(0.0f, (float)(onsetEnvelope[i] - average)));
+    }
+
+    // Autocorrelate over a wider range than the result is folded into, weighted towards the tempos listeners tap along to
+    const int minimumLag = jmax(1, (int)std::floor(framesPerSecond * 60.0 / (maximumBeatsPerMinute * 1.25)));
+    const int maximumLag = jmin(numFrames / 4, (int)std::ceil(framesPerSecond * 60.0 / (minimumBeatsPerMinute * 0.8)));
+    const float* envelope = onsetEnvelope.getRawDataPointer();
+
+    Array<double> correlation;
+    correlation.resize(maximumLag + 2);
+    int bestLag = 0;
+    double bestWeightedCorrelation = 0.0;
+
+    for (int lag = minimumLag; lag <= maximumLag + 1; ++lag)
+    {
+        double sum = 0.0;
+
+        for (int i = 0; i + lag < numFrames; ++i)
+        {
+            sum += (double)envelope[i] * envelope[i + lag];
+        }
+
+        correlation.set(lag, sum / (numFrames - lag));
+
+        if (lag > maximumLag)
+        {
+            continue;
+        }
+
+        const double octavesFromCentre = std::log2(framesPerSecond * 60.0 / lag / 120.0);
+        const double weightedCorrelation = correlation[lag] * std::exp(-0.5 * octavesFromCentre * octavesFromCentre);
+
+        if (weightedCorrelation > bestWeightedCorrelation)
+        {
+            bestWeightedCorrelation = weightedCorrelation;
+            bestLag = lag;
+        }
+    }
+
+    if (bestLag == 0)
+    {
+        return false;
+    }
+
+    // Interpolate between lags with a parabola through the peak and its neighbours
+    double period = bestLag;
+
+    if (bestLag > minimumLag)
+    {
+        const double previous = correlation[bestLag - 1];
+        const double peak = correlation[bestLag];
+        const double next = correlation[bestLag + 1];
+        const double curvature = previous - 2.0 * peak + next;
+
+        if (curvature < 0.0)
+        {
+            period += jlimit(-0.5, 0.5, 0.5 * (previous - next) / curvature);
+        }
+    }
+
+    // Fold the tempo into the usual range
+    while (framesPerSecond * 60.0 / period < minimumBeatsPerMinute)
+    {
+        period *= 0.5;
+    }
+    while (framesPerSecond * 60.0 / period > maximumBeatsPerMinute)
+    {
+        period *= 2.0;
+    }
+
+    // Refine the period against the whole track, where a small error adds up to a whole beat over a few minutes
+    double bestPeriod = period;
+    double phase = 0.0;
+    double bestScore = scoreBeatPeriod(period, phase);
+
+    for (int step = -40; step <= 40; ++step)
+    {
+        const double candidatePeriod = period * (1.0 + step * 0.0005);
+        double candidatePhase = 0.0;
+        const double score = scoreBeatPeriod(candidatePeriod, candidatePhase);
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestPeriod = candidatePeriod;
+            phase = candidatePhase;
+        }
+    }
+
+    if (bestScore <= 0.0)
+    {
+        return false;
+    }
+
+    // Take the beat of the bar with the strongest bass onsets as the downbeat
+    int bestBeatOfBar = 0;
+    double bestBarScore = -1.0;
+
+    for (int beatOfBar = 0; beatOfBar < 4; ++beatOfBar)
+    {
+        double barScore = 0.0;
+
+        for (double position = phase + beatOfBar * bestPeriod; position < numFrames - 0.5; position += bestPeriod * 4.0)
+        {
+            barScore += bassEnvelope[roundToInt(position)];
+        }
+
+        if (barScore > bestBarScore)
+        {
+            bestBarScore = barScore;
+            bestBeatOfBar = beatOfBar;
+        }
+    }
+
+    beatsPerMinute = framesPerSecond * 60.0 / bestPeriod;
+
+    // The log magnitude picks up an onset as soon as it enters the frame, so each value is timed at the end of its frame
+    const double barSeconds = 4.0 * 60.0 / beatsPerMinute;
+    const double downbeatFrame = phase + bestBeatOfBar * bestPeriod;
+    downbeatSeconds = (downbeatFrame + 1.0) * hopSize / sampleRate;
+
+    // Extend the grid back to the first bar of the track
+    while (downbeatSeconds >= barSeconds)
+    {
+        downbeatSeconds -= barSeconds;
+    }
+
+    return true;
+}
+
+/**
+ * Getter method that retrieves the tempo found by the last call to finish()
+ *
+ * @param                             None
+ *
+ * @return                            Tempo in beats per minute
+ */
+double BeatAnalyser::getBeatsPerMinute() const
+{
+    return beatsPerMinute;
+}
+
+/**
+ * Getter method that retrieves the first downbeat found by the last call to finish()
+ *
+ * @param                             None
+ *
+ * @return                            Time of the first downbeat in seconds, within the first bar of the track
+ */
+double BeatAnalyser::getDownbeatSeconds() const
+{
+    return downbeatSeconds;
+}
+
+/**
+ * Measure how well a beat period fits the onset envelope and find the phase that fits it best
+ *
+ * @param period                      Beat period in envelope frames
+ * @param phase                       Receives the envelope frame of the first beat
+ *
+ * @return                            Mean onset strength on the beats
+ */
+double BeatAnalyser::scoreBeatPeriod(double period, double& phase) const
+{
+    const int numFrames = onsetEnvelope.size();
+    const float* envelope = onsetEnvelope.begin();
+    double bestScore = 0.0;
+
+    for (int candidatePhase = 0; candidatePhase < (int)std::ceil(period); ++candidatePhase)
+    {
+        double sum = 0.0;
+        int numBeats = 0;
+
+        for (double position = candidatePhase; position < numFrames - 0.5; position += period)
+        {
+            sum += envelope[roundToInt(position)];
+            ++numBeats;
+        }
+
+        const double score = numBeats > 0 ? sum / numBeats : 0.0;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            phase = candidatePhase;
+        }
+    }
+
+    return bestScore;
+}
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    BeatAnalyser.h
+    Created: 16 Oct 2026 6:48:51pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class BeatAnalyser
+{
+public:
+    /**
+     * Constructor that initializes an analyser that has not been prepared
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    BeatAnalyser();
+
+    /**
+     * Destructor for the beat analyser
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~BeatAnalyser();
+
+    /**
+     * Allocate the working arrays for a sample rate and discard the audio analysed so far
+     *
+     * @param newSampleRate               Sample rate of the audio track being analysed
+     *
+     * @return                            None
+     */
+    void prepare(double newSampleRate);
+
+    /**
+     * Add the next samples of the track to the onset envelope
+     *
+     * @param samples                     Mono samples following the ones already processed
+     * @param numSamples                  Number of samples
+     *
+     * @return                            None
+     */
+    void process(const float* samples, int numSamples);
+
+    /**
+     * Estimate the tempo and beat grid from the onset envelope of the whole track
+     *
+     * @param                             None
+     *
+     * @return                            True if the track was long enough and rhythmic enough to find a tempo, false otherwise
+     */
+    bool finish();
+
+    /**
+     * Getter method that retrieves the tempo found by the last call to finish()
+     *
+     * @param                             None
+     *
+     * @return                            Tempo in beats per minute
+     */
+    double getBeatsPerMinute() const;
+
+    /**
+     * Getter method that retrieves the first downbeat found by the last call to finish()
+     *
+     * @param                             None
+     *
+     * @return                            Time of the first downbeat in seconds, within the first bar of the track
+     */
+    double getDownbeatSeconds() const;
+
+    // Range that tempos are folded into, since a tempo and its double both fit the same onsets
+    static constexpr double minimumBeatsPerMinute = 70.0;
+    static constexpr double maximumBeatsPerMinute = 180.0;
+
+private:
+    /**
+     * Measure how well a beat period fits the onset envelope and find the phase that fits it best
+     *
+     * @param period                      Beat period in envelope frames
+     * @param phase                       Receives the envelope frame of the first beat
+     *
+     * @return                            Mean onset strength on the beats
+     */
+    double scoreBeatPeriod(double period, double& phase) const;
+
+    double sampleRate;
+    int hopSize;
+
+    // Samples of the frame being collected, the most recent at the end
+    HeapBlock<float> frame;
+    int numFrameSamples;
+
+    // Spectral flux working arrays, each twice the FFT size for the transform
+    std::unique_ptr<dsp::FFT> fft;
+    HeapBlock<float> window;
+    HeapBlock<float> spectrum;
+    HeapBlock<float> previousMagnitudes;
+
+    // Spectral flux at every hop of the track, over all frequencies and over the bass only
+    Array<float> onsetEnvelope;
+    Array<float> bassEnvelope;
+
+    double beatsPerMinute;
+    double downbeatSeconds;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BeatAnalyser)
+};
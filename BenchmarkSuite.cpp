@@ -0,0 +1,599 @@
+/*
+  ==============================================================================
+
+    BenchmarkSuite.cpp
+    Created: 17 Oct 2026 4:22:37am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "BenchmarkSuite.h"
+#include "DataSorter.h"
+#include "DecodedTrackCache.h"
+#include "DeckRenderer.h"
+
+/**
+ * Constructor that configures the simulated audio device and the synthetic libraries used for every measurement
+ *
+ * @param _librarySizes               Number of tracks in each synthetic library the library operations are timed on
+ * @param _sampleRate                 Output sample rate of the simulated audio device
+ * @param _blockSize                  Number of samples rendered per simulated audio callback
+ * @param _secondsPerCase             Seconds of audio rendered for each audio measurement
+ *
+ * @return                            None
+ */
+BenchmarkSuite::BenchmarkSuite(const Array<int>& _librarySizes, double _sampleRate, int _blockSize, double _secondsPerCase)
+    : librarySizes(_librarySizes), sampleRate(_sampleRate), blockSize(_blockSize), secondsPerCase(_secondsPerCase)
+{
+    formatManager.registerBasicFormats();
+}
+
+/**
+ * Destructor that deletes the synthetic track
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+BenchmarkSuite::~BenchmarkSuite()
+{
+    if (workingFolder.isDirectory())
+    {
+        workingFolder.deleteRecursively();
+    }
+}
+
+/**
+ * Time a deck's audio callback under different speed and filter settings and the library sort comparator,
+ * then the full mixer with 2, 4 and 8 decks, the library restore, search and sort on each synthetic
+ * library, and how long a track takes to load streamed, decoded into RAM and from the RAM cache
+ *
+ * @param                             None
+ *
+ * @return                            JSON document of every result, so results from different builds can be compared
+ */
+String BenchmarkSuite::run()
+{
+    DynamicObject::Ptr results = new DynamicObject();
+
+    // Results only compare fairly between runs on the same machine and build type
+    DynamicObject::Ptr environment = new DynamicObject();
+    environment->setProperty("version", ProjectInfo::versionString);
+#if JUCE_DEBUG
+    environment->setProperty("build", "debug");
+#else
+    environment->setProperty("build", "release");
+#endif
+    environment->setProperty("operatingSystem", SystemStats::getOperatingSystemName());
+    environment->setProperty("cpu", SystemStats::getCpuModel());
+    environment->setProperty("cores", SystemStats::getNumCpus());
+    environment->setProperty("timestamp", Time::getCurrentTime().toISO8601(true));
+    environment->setProperty("sampleRate", sampleRate);
+    environment->setProperty("blockSize", blockSize);
+    environment->setProperty("secondsPerCase", secondsPerCase);
+    results->setProperty("environment", environment.get());
+
+    if (!writeTestTrack())
+    {
+        results->setProperty("error", "The synthetic track could not be written");
+        return JSON::toString(var(results.get()));
+    }
+
+    // Neutral matches a freshly loaded deck, the others move one group of dials at a time
+    const PlayerSettings playerCases[] = {
+        { "neutral", 1.0, 0.0, DeckRenderer::lowPassNeutralFrequency, DeckRenderer::highPassNeutralFrequency, false },
+        { "faster", 1.08, 0.0, DeckRenderer::lowPassNeutralFrequency, DeckRenderer::highPassNeutralFrequency, false },
+        { "slower", 0.92, 0.0, DeckRenderer::lowPassNeutralFrequency, DeckRenderer::highPassNeutralFrequency, false },
+        { "filters", 1.0, 500.0, 8000.0, 200.0, false },
+        { "fasterWithFilters", 1.08, 500.0, 8000.0, 200.0, false },
+        { "keyLock", 1.08, 0.0, DeckRenderer::lowPassNeutralFrequency, DeckRenderer::highPassNeutralFrequency, true }
+    };
+
+    DynamicObject::Ptr micro = new DynamicObject();
+    var playerResults;
+
+    for (const auto& settings : playerCases)
+    {
+        playerResults.append(measurePlayerBlocks(settings));
+    }
+
+    micro->setProperty("playerBlock", playerResults);
+    micro->setProperty("sorterComparison", measureSorterComparisons());
+    results->setProperty("micro", micro.get());
+
+    DynamicObject::Ptr macro = new DynamicObject();
+    var mixerResults;
+
+    for (int numDecks : { 2, 4, 8 })
+    {
+        mixerResults.append(measureMixer(numDecks, false));
+        mixerResults.append(measureMixer(numDecks, true));
+    }
+
+    macro->setProperty("mixer", mixerResults);
+
+    var libraryResults;
+
+    for (int numTracks : librarySizes)
+    {
+        libraryResults.append(measureLibrary(numTracks));
+    }
+
+    macro->setProperty("library", libraryResults);
+    macro->setProperty("trackLoad", measureTrackLoads());
+    results->setProperty("macro", macro.get());
+
+    return JSON::toString(var(results.get()));
+}
+
+/**
+ * Time DJAudioPlayer::getNextAudioBlock on a track held in RAM under one set of deck settings
+ *
+ * @param settings                    Deck settings to render with
+ *
+ * @return                            Result object holding the settings, blocks per second and CPU cost
+ */
+var BenchmarkSuite::measurePlayerBlocks(const PlayerSettings& settings)
+{
+    // A track in RAM keeps the disk and the read-ahead thread out of the measurement
+    DJAudioPlayer player(formatManager);
+    player.setRamMode(true);
+    player.prepareToPlay(blockSize, sampleRate);
+    player.loadURL(URL(testTrack));
+
+    player.setKeyLock(settings.keyLock);
+    player.setSpeed(settings.speed);
+
+    if (settings.bandPassFrequency > 0.0)
+    {
+        player.setBandPassFrequency(settings.bandPassFrequency);
+    }
+
+    player.setLowPassFrequency(settings.lowPassFrequency);
+    player.setHighPassFrequency(settings.highPassFrequency);
+    player.start();
+
+    AudioBuffer<float> buffer(2, blockSize);
+    const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+
+    // The first blocks apply the queued settings and let caches and branch predictors settle
+    for (int block = 0; block < 64; ++block)
+    {
+        player.getNextAudioBlock(info);
+    }
+
+    const int numBlocks = jmax(1, (int)(secondsPerCase * sampleRate / blockSize));
+
+    const double milliseconds = timeMilliseconds([&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                player.getNextAudioBlock(info);
+            }
+        });
+
+    player.releaseResources();
+
+    const double audioMilliseconds = 1000.0 * numBlocks * blockSize / sampleRate;
+
+    DynamicObject::Ptr result = new DynamicObject();
+    result->setProperty("name", settings.name);
+    result->setProperty("speed", settings.speed);
+    result->setProperty("bandPassFrequency", settings.bandPassFrequency);
+    result->setProperty("lowPassFrequency", settings.lowPassFrequency);
+    result->setProperty("highPassFrequency", settings.highPassFrequency);
+    result->setProperty("keyLock", settings.keyLock);
+    result->setProperty("blocksPerSecond", 1000.0 * numBlocks / milliseconds);
+    result->setProperty("microsecondsPerBlock", 1000.0 * milliseconds / numBlocks);
+    result->setProperty("cpuPercent", 100.0 * milliseconds / audioMilliseconds);
+    return var(result.get());
+}
+
+/**
+ * Time DataSorter::compareElements on random pairs of synthetic tracks for each sortable attribute
+ *
+ * @param                             None
+ *
+ * @return                            Array of result objects, one per attribute
+ */
+var BenchmarkSuite::measureSorterComparisons()
+{
+    const int numComparisons = 1000000;
+    std::unique_ptr<XmlElement> library = createLibrary(10000);
+
+    Array<XmlElement*> tracks;
+
+    for (auto* element : library->getChildIterator())
+    {
+        tracks.add(element);
+    }
+
+    // Pick the pairs up front so the random numbers are not timed
+    Random random(1234);
+    HeapBlock<int> firstIndices((size_t)numComparisons);
+    HeapBlock<int> secondIndices((size_t)numComparisons);
+
+    for (int i = 0; i < numComparisons; ++i)
+    {
+        firstIndices[i] = random.nextInt(tracks.size());
+        secondIndices[i] = random.nextInt(tracks.size());
+    }
+
+    var results;
+
+    for (const char* attribute : { "title", "length", "format", "bpm", "key" })
+    {
+        const DataSorter dataSorter(attribute, true);
+        int64 checksum = 0;
+
+        const double milliseconds = timeMilliseconds([&]
+            {
+                for (int i = 0; i < numComparisons; ++i)
+                {
+                    checksum += dataSorter.compareElements(tracks.getUnchecked(firstIndices[i]), tracks.getUnchecked(secondIndices[i]));
+                }
+            });
+
+        ignoreUnused(checksum);
+
+        DynamicObject::Ptr result = new DynamicObject();
+        result->setProperty("attribute", attribute);
+        result->setProperty("comparisons", numComparisons);
+        result->setProperty("comparisonsPerSecond", 1000.0 * numComparisons / milliseconds);
+        result->setProperty("nanosecondsPerComparison", 1000000.0 * milliseconds / numComparisons);
+        results.append(var(result.get()));
+    }
+
+    return results;
+}
+
+/**
+ * Time the mixer's audio callback with a set of playing decks with mixed speeds, filters and key lock
+ *
+ * @param numDecks                    Number of decks, alternately assigned to sides A and B of the crossfader
+ * @param parallel                    True to render the decks on the render pool, false to render them one after another
+ *
+ * @return                            Result object holding the average and worst callback cost
+ */
+var BenchmarkSuite::measureMixer(int numDecks, bool parallel)
+{
+    DeckCollection deckCollection(formatManager, numDecks);
+    AutoMixEngine autoMixEngine(deckCollection);
+
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        deckCollection.getDeck(deck).setRamMode(true);
+    }
+
+    deckCollection.prepareToPlay(blockSize, sampleRate);
+    autoMixEngine.prepareToPlay(blockSize, sampleRate);
+    autoMixEngine.setParallelRendering(parallel);
+
+    // Every deck plays, so the crossfader in the middle lets each one be heard
+    autoMixEngine.setCrossfaderPosition(0.5);
+
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        DJAudioPlayer& player = deckCollection.getDeck(deck);
+        player.loadURL(URL(testTrack));
+        player.setCrossfaderSide(deck % 2 == 0 ? MixerBus::Side::a : MixerBus::Side::b);
+        player.setKeyLock(deck % 2 == 1);
+        player.setSpeed(0.96 + 0.12 * deck / jmax(1, numDecks - 1));
+        player.setLowPassFrequency(12000.0);
+        player.setHighPassFrequency(60.0);
+        player.start();
+    }
+
+    AudioBuffer<float> output(2, blockSize);
+    const AudioSourceChannelInfo info(&output, 0, blockSize);
+    const int numBlocks = jmax(1, (int)(secondsPerCase * sampleRate / blockSize));
+    const double blockMilliseconds = 1000.0 * blockSize / sampleRate;
+    double totalMilliseconds = 0.0;
+    double worstMilliseconds = 0.0;
+
+    for (int block = -64; block < numBlocks; ++block)
+    {
+        const double milliseconds = timeMilliseconds([&] { autoMixEngine.getNextAudioBlock(info); });
+
+        // The first blocks only apply the queued settings, settle the caches and wake the workers
+        if (block >= 0)
+        {
+            totalMilliseconds += milliseconds;
+            worstMilliseconds = jmax(worstMilliseconds, milliseconds);
+        }
+    }
+
+    autoMixEngine.releaseResources();
+    deckCollection.releaseResources();
+
+    DynamicObject::Ptr result = new DynamicObject();
+    result->setProperty("decks", numDecks);
+    result->setProperty("parallel", parallel);
+    result->setProperty("averageCpuPercent", 100.0 * totalMilliseconds / (numBlocks * blockMilliseconds));
+    result->setProperty("worstCpuPercent", 100.0 * worstMilliseconds / blockMilliseconds);
+    result->setProperty("worstMilliseconds", worstMilliseconds);
+    return var(result.get());
+}
+
+/**
+ * Time restoreLibrary, setSearchResults and sortOrderChanged on a synthetic library
+ *
+ * @param numTracks                   Number of tracks in the library
+ *
+ * @return                            Result object holding the timing of each operation
+ */
+var BenchmarkSuite::measureLibrary(int numTracks)
+{
+    const int repetitions = 3;
+    const File sourceLibrary = workingFolder.getChildFile("library" + String(numTracks) + ".xml");
+
+    // The component saves to its own file, so the user's library is never read or replaced
+    const File componentLibrary = workingFolder.getChildFile("component.xml");
+
+    DynamicObject::Ptr result = new DynamicObject();
+    result->setProperty("tracks", numTracks);
+
+    // Generate the library and let it go before the component reads it, so only one copy is held at a time
+    {
+        std::unique_ptr<XmlElement> library = createLibrary(numTracks);
+
+        if (!library->writeTo(sourceLibrary))
+        {
+            result->setProperty("error", "The synthetic library could not be written");
+            return var(result.get());
+        }
+    }
+
+    result->setProperty("fileBytes", sourceLibrary.getSize());
+
+    Label searchInput;
+    PlaylistComponent playlistComponent(&searchInput, componentLibrary);
+
+    Array<double> restoreMilliseconds;
+
+    for (int repetition = 0; repetition < repetitions; ++repetition)
+    {
+        restoreMilliseconds.add(timeMilliseconds([&] { playlistComponent.restoreLibrary(sourceLibrary); }));
+    }
+
+    result->setProperty("restoreLibrary", var(summarise(restoreMilliseconds).get()));
+
+    // A common word, a narrow match, and a term that matches nothing so every title is scanned to the end
+    var searchResults;
+
+    for (const char* term : { "Deep", "Track 4242", "no such title" })
+    {
+        Array<double> searchMilliseconds;
+
+        for (int repetition = 0; repetition < repetitions; ++repetition)
+        {
+            searchMilliseconds.add(timeMilliseconds([&] { playlistComponent.setSearchResults(term); }));
+        }
+
+        DynamicObject::Ptr searchResult = summarise(searchMilliseconds);
+        searchResult->setProperty("term", term);
+        searchResults.append(var(searchResult.get()));
+    }
+
+    result->setProperty("setSearchResults", searchResults);
+
+    // Track title, duration, BPM and key, alternating direction so no sort starts from its own output
+    var sortResults;
+
+    for (int columnId : { 2, 3, 7, 8 })
+    {
+        Array<double> sortMilliseconds;
+
+        for (int repetition = 0; repetition < repetitions; ++repetition)
+        {
+            sortMilliseconds.add(timeMilliseconds([&] { playlistComponent.sortOrderChanged(columnId, repetition % 2 == 0); }));
+        }
+
+        DynamicObject::Ptr sortResult = summarise(sortMilliseconds);
+        sortResult->setProperty("column", playlistComponent.getAttributeNameForColumnId(columnId));
+        sortResults.append(var(sortResult.get()));
+    }
+
+    result->setProperty("sortOrderChanged", sortResults);
+
+    sourceLibrary.deleteFile();
+    componentLibrary.deleteFile();
+
+    return var(result.get());
+}
+
+/**
+ * Time loading the synthetic track into a deck as a stream, decoded into RAM, and from the RAM cache
+ *
+ * @param                             None
+ *
+ * @return                            Array of result objects, one per load mode
+ */
+var BenchmarkSuite::measureTrackLoads()
+{
+    const int repetitions = 10;
+    SharedResourcePointer<DecodedTrackCache> decodedTrackCache;
+    const int64 memoryBudget = decodedTrackCache->getMemoryBudget();
+
+    DJAudioPlayer player(formatManager);
+    player.prepareToPlay(blockSize, sampleRate);
+
+    var results;
+
+    for (const char* mode : { "streamed", "ramDecode", "ramCached" })
+    {
+        const bool ramMode = String(mode) != "streamed";
+        player.setRamMode(ramMode);
+
+        // Without a budget every decoded track is evicted as soon as it is handed over, so each load decodes again
+        decodedTrackCache->setMemoryBudget(String(mode) == "ramDecode" ? 0 : memoryBudget);
+
+        if (String(mode) == "ramCached")
+        {
+            player.loadURL(URL(testTrack));
+        }
+
+        Array<double> loadMilliseconds;
+
+        for (int repetition = 0; repetition < repetitions; ++repetition)
+        {
+            loadMilliseconds.add(timeMilliseconds([&] { player.loadURL(URL(testTrack)); }));
+        }
+
+        DynamicObject::Ptr result = summarise(loadMilliseconds);
+        result->setProperty("mode", mode);
+        results.append(var(result.get()));
+    }
+
+    decodedTrackCache->setMemoryBudget(memoryBudget);
+    player.releaseResources();
+
+    return results;
+}
+
+/**
+ * Write the synthetic track every deck measurement plays, long enough to outlast a measurement at the fastest speed
+ *
+ * @param                             None
+ *
+ * @return                            True if the track was written, false otherwise
+ */
+bool BenchmarkSuite::writeTestTrack()
+{
+    // Leave room for the warm up blocks and the fastest deck speed
+    const int numSamples = (int)((secondsPerCase * 1.25 + 5.0) * sampleRate);
+
+    workingFolder = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("OtoDecksBenchmarkSuite", "");
+
+    if (workingFolder.createDirectory().failed())
+    {
+        workingFolder = File();
+        return false;
+    }
+
+    // Repeatable noise keeps every filter and the time-stretcher busy
+    Random random(1234);
+    AudioBuffer<float> buffer(2, numSamples);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        float* samples = buffer.getWritePointer(channel);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            samples[i] = (random.nextFloat() * 2.0f - 1.0f) * 0.5f;
+        }
+    }
+
+    testTrack = workingFolder.getChildFile("track.wav");
+    std::unique_ptr<FileOutputStream> outputStream(testTrack.createOutputStream());
+
+    if (outputStream == nullptr)
+    {
+        return false;
+    }
+
+    WavAudioFormat wavFormat;
+    std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), sampleRate, 2, 16, {}, 0));
+
+    if (writer == nullptr)
+    {
+        return false;
+    }
+
+    // The writer now owns the stream
+    outputStream.release();
+
+    return writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+}
+
+/**
+ * Build a library of tracks with repeatable titles, lengths, formats, tempos and keys, all already analysed
+ *
+ * @param numTracks                   Number of tracks in the library
+ *
+ * @return                            Library element in the format restoreLibrary reads
+ */
+std::unique_ptr<XmlElement> BenchmarkSuite::createLibrary(int numTracks)
+{
+    const char* const words[] = { "Deep", "Night", "Drive", "Sunrise", "Echo", "Motion", "Velvet", "Signal", "Horizon", "Pulse" };
+    const char* const formats[] = { ".mp3", ".wav", ".flac", ".aiff" };
+    const int numWords = (int)(sizeof(words) / sizeof(words[0]));
+    const int numFormats = (int)(sizeof(formats) / sizeof(formats[0]));
+
+    // The tracks never exist, but their paths must still be absolute on every platform
+    const String folder = File::getSpecialLocation(File::userMusicDirectory).getChildFile("Benchmark").getFullPathName()
+        + File::getSeparatorString();
+
+    Random random(numTracks);
+    std::unique_ptr<XmlElement> library(new XmlElement("TrackMetaData"));
+
+    for (int i = 0; i < numTracks; ++i)
+    {
+        const String title = String(words[random.nextInt(numWords)]) + " " + words[random.nextInt(numWords)] + " Track " + String(i);
+        const String format = formats[random.nextInt(numFormats)];
+        const int seconds = 120 + random.nextInt(360);
+
+        // Camelot keys run from 1A to 12B
+        const String key = String(1 + random.nextInt(12)) + (random.nextBool() ? "A" : "B");
+
+        // Tempo, key and loudness are present, so restoring the library queues no analysis
+        XmlElement* track = library->createNewChildElement("Track");
+        track->setAttribute("customId", i);
+        track->setAttribute("title", title);
+        track->setAttribute("length", String(seconds / 60) + ":" + String(seconds % 60).paddedLeft('0', 2));
+        track->setAttribute("format", format);
+        track->setAttribute("absolutePath", folder + title + format);
+        track->setAttribute("bpm", String(80.0 + random.nextDouble() * 100.0, 2));
+        track->setAttribute("downbeat", String(random.nextDouble(), 4));
+        track->setAttribute("key", key);
+        track->setAttribute("loudness", String(-14.0 - random.nextDouble() * 6.0, 1));
+        track->setAttribute("truePeak", String(-random.nextDouble(), 2));
+    }
+
+    return library;
+}
+
+/**
+ * Summarise repeated timings of one operation
+ *
+ * @param milliseconds                Time each repetition took
+ *
+ * @return                            Result object holding the best, mean and worst time
+ */
+DynamicObject::Ptr BenchmarkSuite::summarise(const Array<double>& milliseconds)
+{
+    double best = milliseconds.isEmpty() ? 0.0 : milliseconds.getFirst();
+    double worst = best;
+    double total = 0.0;
+
+    for (double value : milliseconds)
+    {
+        best = jmin(best, value);
+        worst = jmax(worst, value);
+        total += value;
+    }
+
+    DynamicObject::Ptr summary = new DynamicObject();
+    summary->setProperty("repetitions", milliseconds.size());
+    summary->setProperty("bestMilliseconds", best);
+    summary->setProperty("meanMilliseconds", milliseconds.isEmpty() ? 0.0 : total / milliseconds.size());
+    summary->setProperty("worstMilliseconds", worst);
+    return summary;
+}
+
+/**
+ * Time one call of an operation
+ *
+ * @param operation                   Callable to time
+ *
+ * @return                            Wall clock time in milliseconds
+ */
+template <typename Operation>
+double BenchmarkSuite::timeMilliseconds(Operation operation)
+{
+    const int64 startTicks = Time::getHighResolutionTicks();
+    operation();
+    return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+    BenchmarkSuite.h
+    Created: 17 Oct 2026 4:22:37am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AutoMixEngine.h"
+#include "DeckCollection.h"
+#include "PlaylistComponent.h"
+
+using namespace juce;
+
+class BenchmarkSuite
+{
+public:
+    /**
+     * Constructor that configures the simulated audio device and the synthetic libraries used for every measurement
+     *
+     * @param _librarySizes               Number of tracks in each synthetic library the library operations are timed on
+     * @param _sampleRate                 Output sample rate of the simulated audio device
+     * @param _blockSize                  Number of samples rendered per simulated audio callback
+     * @param _secondsPerCase             Seconds of audio rendered for each audio measurement
+     *
+     * @return                            None
+     */
+    BenchmarkSuite(const Array<int>& _librarySizes = { 10000, 100000, 1000000 }, double _sampleRate = 44100.0,
+        int _blockSize = 512, double _secondsPerCase = 10.0);
+
+    /**
+     * Destructor that deletes the synthetic track
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~BenchmarkSuite();
+
+    /**
+     * Time a deck's audio callback under different speed and filter settings and the library sort comparator,
+     * then the full mixer with 2, 4 and 8 decks, the library restore, search and sort on each synthetic
+     * library, and how long a track takes to load streamed, decoded into RAM and from the RAM cache
+     *
+     * @param                             None
+     *
+     * @return                            JSON document of every result, so results from different builds can be compared
+     */
+    String run();
+
+private:
+    /** Deck settings applied before a callback is timed */
+    struct PlayerSettings
+    {
+        String name;
+        double speed;
+        double bandPassFrequency;
+        double lowPassFrequency;
+        double highPassFrequency;
+        bool keyLock;
+    };
+
+    /**
+     * Time DJAudioPlayer::getNextAudioBlock on a track held in RAM under one set of deck settings
+     *
+     * @param settings                    Deck settings to render with
+     *
+     * @return                            Result object holding the settings, blocks per second and CPU cost
+     */
+    var measurePlayerBlocks(const PlayerSettings& settings);
+
+    /**
+     * Time DataSorter::compareElements on random pairs of synthetic tracks for each sortable attribute
+     *
+     * @param                             None
+     *
+     * @return                            Array of result objects, one per attribute
+     */
+    var measureSorterComparisons();
+
+    /**
+     * Time the mixer's audio callback with a set of playing decks with mixed speeds, filters and key lock
+     *
+     * @param numDecks                    Number of decks, alternately assigned to sides A and B of the crossfader
+     * @param parallel                    True to render the decks on the render pool, false to render them one after another
+     *
+     * @return                            Result object holding the average and worst callback cost
+     */
+    var measureMixer(int numDecks, bool parallel);
+
+    /**
+     * Time restoreLibrary, setSearchResults and sortOrderChanged on a synthetic library
+     *
+     * @param numTracks                   Number of tracks in the library
+     *
+     * @return                            Result object holding the timing of each operation
+     */
+    var measureLibrary(int numTracks);
+
+    /**
+     * Time loading the synthetic track into a deck as a stream, decoded into RAM, and from the RAM cache
+     *
+     * @param                             None
+     *
+     * @return                            Array of result objects, one per load mode
+     */
+    var measureTrackLoads();
+
+    /**
+     * Write the synthetic track every deck measurement plays, long enough to outlast a measurement at the fastest speed
+     *
+     * @param                             None
+     *
+     * @return                            True if the track was written, false otherwise
+     */
+    bool writeTestTrack();
+
+    /**
+     * Build a library of tracks with repeatable titles, lengths, formats, tempos and keys, all already analysed
+     *
+     * @param numTracks                   Number of tracks in the library
+     *
+     * @return                            Library element in the format restoreLibrary reads
+     */
+    static std::unique_ptr<XmlElement> createLibrary(int numTracks);
+
+    /**
+     * Summarise repeated timings of one operation
+     *
+     * @param milliseconds                Time each repetition took
+     *
+     * @return                            Result object holding the best, mean and worst time
+     */
+    static DynamicObject::Ptr summarise(const Array<double>& milliseconds);
+
+    /**
+     * Time one call of an operation
+     *
+     * @param operation                   Callable to time
+     *
+     * @return                            Wall clock time in milliseconds
+     */
+    template <typename Operation>
+    static double timeMilliseconds(Operation operation);
+
+    const Array<int> librarySizes;
+    const double sampleRate;
+    const int blockSize;
+    const double secondsPerCase;
+
+    AudioFormatManager formatManager;
+
+    // Folder holding the synthetic track and libraries, deleted with the suite
+    File workingFolder;
+    File testTrack;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkSuite)
+};
@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    CallbackDiagnosticsComponent.cpp
+    Created: 17 Oct 2026 2:58:17am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "CallbackDiagnosticsComponent.h"
+
+/**
+ * Constructor that sets up the report view and its buttons
+ *
+ * @param _callbackLoadMonitor        Timing of the whole audio callback
+ * @param _autoMixEngine              Mixer whose stages and decks are timed
+ * @param _deckCollection             Decks listed in the per-deck breakdown
+ * @param _deviceManager              Device whose settings and driver-reported xruns are shown
+ *
+ * @return                            None
+ */
+CallbackDiagnosticsComponent::CallbackDiagnosticsComponent(CallbackLoadMonitor& _callbackLoadMonitor, AutoMixEngine& _autoMixEngine,
+    DeckCollection& _deckCollection, AudioDeviceManager& _deviceManager)
+    : callbackLoadMonitor(_callbackLoadMonitor),
+      autoMixEngine(_autoMixEngine),
+      deckCollection(_deckCollection),
+      deviceManager(_deviceManager)
+{
+    // Set up the report, in a fixed width font so the histogram columns line up
+    addAndMakeVisible(reportView);
+    reportView.setMultiLine(true);
+    reportView.setReadOnly(true);
+    reportView.setCaretVisible(false);
+    reportView.setFont(Font(Font::getDefaultMonospacedFontName(), 12.0f, Font::plain));
+
+    // Set up the button that writes the report to a file
+    addAndMakeVisible(saveReportButton);
+    saveReportButton.addListener(this);
+    saveReportButton.setColour(TextButton::ColourIds::buttonColourId, Colour(68, 73, 240));
+
+    // Set up the button that starts the histogram and watermarks again, such as after changing the buffer size
+    addAndMakeVisible(resetButton);
+    resetButton.addListener(this);
+    resetButton.setColour(TextButton::ColourIds::buttonColourId, Colour(22, 22, 22));
+}
+
+/**
+ * Destructor for the diagnostics panel
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+CallbackDiagnosticsComponent::~CallbackDiagnosticsComponent()
+{
+    stopTimer();
+}
+
+/**
+ * Redraw the background of the panel
+ *
+ * @param g                           Graphics context for drawing a component or image
+ *
+ * @return                            None
+ */
+void CallbackDiagnosticsComponent::paint(Graphics& g)
+{
+    g.fillAll(Colour(18, 6, 46));
+}
+
+/**
+ * Lay out the report view above its buttons
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void CallbackDiagnosticsComponent::resized()
+{
+    const int buttonHeight = jmin(26, getHeight() / 6);
+
+    reportView.setBounds(5, 5, getWidth() - 10, getHeight() - buttonHeight - 15);
+    saveReportButton.setBounds(5, getHeight() - buttonHeight - 5, getWidth() / 5, buttonHeight);
+    resetButton.setBounds(10 + getWidth() / 5, getHeight() - buttonHeight - 5, getWidth() / 8, buttonHeight);
+}
+
+/**
+ * Refresh the report only while the panel can be seen
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void CallbackDiagnosticsComponent::visibilityChanged()
+{
+    if (isVisible())
+    {
+        timerCallback();
+        startTimerHz(4);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+/**
+ * Called when the 'Save Report' or 'Reset' buttons are clicked
+ *
+ * @param button                      Button base class
+ *
+ * @return                            None
+ */
+void CallbackDiagnosticsComponent::buttonClicked(Button* button)
+{
+    if (button == &saveReportButton)
+    {
+        // Take the snapshot before the chooser opens, so the report shows the moment the user asked for
+        const String report = createReport();
+
+        FileChooser reportFile{ "Save Callback Report",
+            File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("OtoDecks callback report.txt"), "*.txt" };
+
+        if (reportFile.browseForFileToSave(true))
+        {
+            reportFile.getResult().replaceWithText(report);
+        }
+    }
+    else if (button == &resetButton)
+    {
+        callbackLoadMonitor.reset();
+        timerCallback();
+    }
+}
+
+/**
+ * Describe the callback timing, its histogram and the per-stage and per-deck loads
+ *
+ * @param                             None
+ *
+ * @return                            Plain text report
+ */
+String CallbackDiagnosticsComponent::createReport() const
+{
+    String report;
+    report << "Audio callback diagnostics, " << Time::getCurrentTime().toString(true, true) << newLine << newLine;
+
+    // The device's own view of its settings and, where the driver reports them, of its xruns
+    const double sampleRate = callbackLoadMonitor.getSampleRate();
+    const int blockSize = callbackLoadMonitor.getBlockSize();
+    const double periodMilliseconds = sampleRate > 0.0 ? 1000.0 * blockSize / sampleRate : 0.0;
+
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+    {
+        const int deviceXRuns = device->getXRunCount();
+
+        report << "Device           " << device->getName() << ", " << device->getTypeName() << newLine
+            << "Buffer           " << blockSize << " samples at " << sampleRate << " Hz, " << String(periodMilliseconds, 2) << " ms per block" << newLine
+            << "Output latency   " << device->getOutputLatencyInSamples() << " samples" << newLine
+            << "Driver xruns     " << (deviceXRuns >= 0 ? String(deviceXRuns) : String("not reported by this driver")) << newLine;
+    }
+    else
+    {
+        report << "Device           none open" << newLine;
+    }
+
+    // Timing of the whole callback against its deadline
+    const int64 numBlocks = callbackLoadMonitor.getNumBlocks();
+    const double maxMilliseconds = callbackLoadMonitor.getMaxMilliseconds();
+
+    report << newLine
+        << "Blocks           " << numBlocks << newLine
+        << "Load             " << String(100.0 * callbackLoadMonitor.getLoad(), 1) << " % of the period" << newLine
+        << "Longest block    " << String(maxMilliseconds, 3) << " ms";
+
+    if (periodMilliseconds > 0.0)
+    {
+        report << ", " << String(100.0 * maxMilliseconds / periodMilliseconds, 1) << " % of the period";
+    }
+
+    report << newLine
+        << "Longest gap      " << String(callbackLoadMonitor.getMaxIntervalMilliseconds(), 3) << " ms between callback starts" << newLine
+        << "Missed deadline  " << callbackLoadMonitor.getNumOverruns() << " blocks took longer than they last" << newLine
+        << "Late callbacks   " << callbackLoadMonitor.getNumLateCallbacks() << " started more than 1.5 periods after the one before" << newLine;
+
+    // Histogram of callback time as a share of the period, with bars scaled to the fullest bucket
+    int64 largestBucket = 0;
+
+    for (int bucket = 0; bucket < CallbackLoadMonitor::numBuckets; ++bucket)
+    {
+        largestBucket = jmax(largestBucket, callbackLoadMonitor.getBucketCount(bucket));
+    }
+
+    report << newLine << "Callback time as a share of the period" << newLine;
+
+    for (int bucket = 0; bucket < CallbackLoadMonitor::numBuckets; ++bucket)
+    {
+        const int64 count = callbackLoadMonitor.getBucketCount(bucket);
+        const int lowerPercent = bucket * CallbackLoadMonitor::bucketPercent;
+
+        const String range = bucket < CallbackLoadMonitor::numBuckets - 1
+            ? String(lowerPercent) + "-" + String(lowerPercent + CallbackLoadMonitor::bucketPercent) + " %"
+            : String(lowerPercent) + " %+";
+
+        const int barLength = largestBucket > 0 ? (int)((count * 40 + largestBucket - 1) / largestBucket) : 0;
+
+        report << range.paddedLeft(' ', 10) << String(count).paddedLeft(' ', 10) << "  " << String::repeatedString("#", barLength) << newLine;
+    }
+
+    // Where the time goes inside the callback, each as a share of the real time it rendered
+    report << newLine << "Stages, share of real time" << (autoMixEngine.isParallelRendering() ? " with parallel decks" : "") << newLine
+        << "  Render decks   " << String(100.0 * autoMixEngine.getRenderLoad(), 2).paddedLeft(' ', 7) << " %" << newLine
+        << "  Mix            " << String(100.0 * autoMixEngine.getMixLoad(), 2).paddedLeft(' ', 7) << " %" << newLine;
+
+    for (int deck = 0; deck < deckCollection.getNumDecks(); ++deck)
+    {
+        const DJAudioPlayer& player = deckCollection.getDeck(deck);
+
+        report << ("  Deck " + String(deck + 1)).paddedRight(' ', 17)
+            << String(100.0 * autoMixEngine.getDeckLoad(deck), 2).paddedLeft(' ', 7) << " %"
+            << "  side " << MixerBus::getSideName(player.getCrossfaderSide())
+            << (player.isKeyLockEnabled() ? ", key lock" : "") << newLine;
+    }
+
+    return report;
+}
+
+/**
+ * Callback routine that gets called periodically to refresh the report
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void CallbackDiagnosticsComponent::timerCallback()
+{
+    reportView.setText(createReport(), false);
+}
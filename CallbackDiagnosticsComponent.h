@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    CallbackDiagnosticsComponent.h
+    Created: 17 Oct 2026 2:58:17am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AutoMixEngine.h"
+#include "CallbackLoadMonitor.h"
+#include "DeckCollection.h"
+
+using namespace juce;
+
+class CallbackDiagnosticsComponent : public Component,
+    public Button::Listener,
+    private Timer
+{
+public:
+    /**
+     * Constructor that sets up the report view and its buttons
+     *
+     * @param _callbackLoadMonitor        Timing of the whole audio callback
+     * @param _autoMixEngine              Mixer whose stages and decks are timed
+     * @param _deckCollection             Decks listed in the per-deck breakdown
+     * @param _deviceManager              Device whose settings and driver-reported xruns are shown
+     *
+     * @return                            None
+     */
+    CallbackDiagnosticsComponent(CallbackLoadMonitor& _callbackLoadMonitor, AutoMixEngine& _autoMixEngine,
+        DeckCollection& _deckCollection, AudioDeviceManager& _deviceManager);
+
+    /**
+     * Destructor for the diagnostics panel
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~CallbackDiagnosticsComponent() override;
+
+    /**
+     * Redraw the background of the panel
+     *
+     * @param g                           Graphics context for drawing a component or image
+     *
+     * @return                            None
+     */
+    void paint(Graphics& g) override;
+
+    /**
+     * Lay out the report view above its buttons
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void resized() override;
+
+    /**
+     * Refresh the report only while the panel can be seen
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void visibilityChanged() override;
+
+    /**
+     * Called when the 'Save Report' or 'Reset' buttons are clicked
+     *
+     * @param button                      Button base class
+     *
+     * @return                            None
+     */
+    void buttonClicked(Button* button) override;
+
+    /**
+     * Describe the callback timing, its histogram and the per-stage and per-deck loads
+     *
+     * @param                             None
+     *
+     * @return                            Plain text report
+     */
+    String createReport() const;
+
+private:
+    /**
+     * Callback routine that gets called periodically to refresh the report
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void timerCallback() override;
+
+    CallbackLoadMonitor& callbackLoadMonitor;
+    AutoMixEngine& autoMixEngine;
+    DeckCollection& deckCollection;
+    AudioDeviceManager& deviceManager;
+
+    TextEditor reportView;
+    TextButton saveReportButton{ "Save Report" };
+    TextButton resetButton{ "Reset" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CallbackDiagnosticsComponent)
+};
@@ -0,0 +1,273 @@
+/*
+  ==============================================================================
+
+    CallbackLoadMonitor.cpp
+    Created: 17 Oct 2026 2:26:51am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "CallbackLoadMonitor.h"
+
+constexpr int CallbackLoadMonitor::numBuckets;
+constexpr int CallbackLoadMonitor::bucketPercent;
+
+/**
+ * Constructor that starts timing a block
+ *
+ * @param _monitor                    Monitor the block is recorded with
+ * @param _numSamples                 Number of samples in the block, which sets its deadline
+ *
+ * @return                            None
+ */
+CallbackLoadMonitor::ScopedBlockTimer::ScopedBlockTimer(CallbackLoadMonitor& _monitor, int _numSamples)
+    : monitor(_monitor), numSamples(_numSamples), startTicks(Time::getHighResolutionTicks())
+{
+}
+
+/**
+ * Destructor that records how long the block took
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+CallbackLoadMonitor::ScopedBlockTimer::~ScopedBlockTimer()
+{
+    monitor.registerBlock(startTicks, Time::getHighResolutionTicks(), numSamples);
+}
+
+/**
+ * Constructor for a monitor with nothing recorded
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+CallbackLoadMonitor::CallbackLoadMonitor()
+    : sampleRate(0.0), blockSize(0)
+{
+    reset();
+}
+
+/**
+ * Destructor for the monitor
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+CallbackLoadMonitor::~CallbackLoadMonitor()
+{
+}
+
+/**
+ * Set the period blocks are measured against and forget everything recorded, called before the audio device starts
+ *
+ * @param _sampleRate                 Number of sound samples taken per second by the audio device
+ * @param _blockSize                  Number of samples the device is expected to ask for in each callback
+ *
+ * @return                            None
+ */
+void CallbackLoadMonitor::prepare(double _sampleRate, int _blockSize)
+{
+    sampleRate = _sampleRate;
+    blockSize = _blockSize;
+
+    reset();
+}
+
+/**
+ * Forget every block recorded so far, safe to call from the message thread while the device is running
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void CallbackLoadMonitor::reset()
+{
+    loadMeasurer.reset(sampleRate, blockSize);
+
+    // A block being recorded as this runs may land on either side of the reset, which is harmless for a diagnostic
+    for (auto& bucket : buckets)
+    {
+        bucket = 0;
+    }
+
+    numBlocks = 0;
+    numLateCallbacks = 0;
+    maxMilliseconds = 0.0;
+    maxIntervalMilliseconds = 0.0;
+    previousStartTicks = 0;
+}
+
+/**
+ * Getter method that retrieves the sample rate blocks are measured against
+ *
+ * @param                             None
+ *
+ * @return                            Sample rate in Hz, or zero before the device starts
+ */
+double CallbackLoadMonitor::getSampleRate() const
+{
+    return sampleRate;
+}
+
+/**
+ * Getter method that retrieves the block size the device was prepared with
+ *
+ * @param                             None
+ *
+ * @return                            Expected number of samples per callback
+ */
+int CallbackLoadMonitor::getBlockSize() const
+{
+    return blockSize;
+}
+
+/**
+ * Getter method that retrieves how much of each block's period the callback has recently taken
+ *
+ * @param                             None
+ *
+ * @return                            Smoothed callback time as a proportion of real time
+ */
+double CallbackLoadMonitor::getLoad() const
+{
+    return loadMeasurer.getLoadAsProportion();
+}
+
+/**
+ * Getter method that retrieves the number of blocks the callback took longer to render than they last
+ *
+ * @param                             None
+ *
+ * @return                            Number of blocks that missed their deadline since the last reset
+ */
+int CallbackLoadMonitor::getNumOverruns() const
+{
+    return loadMeasurer.getXRunCount();
+}
+
+/**
+ * Getter method that retrieves the number of callbacks that started well after the previous block ran out
+ *
+ * @param                             None
+ *
+ * @return                            Number of callbacks started more than one and a half periods after the one before
+ */
+int64 CallbackLoadMonitor::getNumLateCallbacks() const
+{
+    return numLateCallbacks;
+}
+
+/**
+ * Getter method that retrieves the number of blocks recorded
+ *
+ * @param                             None
+ *
+ * @return                            Number of callbacks since the last reset
+ */
+int64 CallbackLoadMonitor::getNumBlocks() const
+{
+    return numBlocks;
+}
+
+/**
+ * Getter method that retrieves the longest time the callback has taken
+ *
+ * @param                             None
+ *
+ * @return                            Longest callback in milliseconds since the last reset
+ */
+double CallbackLoadMonitor::getMaxMilliseconds() const
+{
+    return maxMilliseconds;
+}
+
+/**
+ * Getter method that retrieves the longest gap between the starts of two callbacks
+ *
+ * @param                             None
+ *
+ * @return                            Longest gap in milliseconds since the last reset
+ */
+double CallbackLoadMonitor::getMaxIntervalMilliseconds() const
+{
+    return maxIntervalMilliseconds;
+}
+
+/**
+ * Getter method that retrieves the number of blocks in one bucket of the histogram
+ *
+ * @param bucket                      Index of the bucket, covering bucketPercent of the period from bucket * bucketPercent
+ *
+ * @return                            Number of blocks whose callback time fell in the bucket
+ */
+int64 CallbackLoadMonitor::getBucketCount(int bucket) const
+{
+    return buckets[jlimit(0, numBuckets - 1, bucket)];
+}
+
+/**
+ * Record one block in the histogram, the watermarks and the load measurer, called on the audio thread
+ *
+ * @param startTicks                  High resolution ticks when the callback started
+ * @param endTicks                    High resolution ticks when the callback returned
+ * @param numSamples                  Number of samples in the block
+ *
+ * @return                            None
+ */
+void CallbackLoadMonitor::registerBlock(int64 startTicks, int64 endTicks, int numSamples)
+{
+    const double rate = sampleRate.load(std::memory_order_relaxed);
+
+    if (rate <= 0.0 || numSamples <= 0)
+    {
+        return;
+    }
+
+    const double milliseconds = Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1000.0;
+    const double periodMilliseconds = 1000.0 * numSamples / rate;
+
+    loadMeasurer.registerRenderTime(milliseconds, numSamples);
+
+    // Blocks are bucketed by the share of their own period they took, so blocks of different sizes compare fairly
+    const int bucket = jmin(numBuckets - 1, (int)(100.0 * milliseconds / (periodMilliseconds * bucketPercent)));
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    numBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    raiseWatermark(maxMilliseconds, milliseconds);
+
+    // A long gap since the previous callback means the device or the system held the audio thread up before it reached us
+    const int64 previousTicks = previousStartTicks.exchange(startTicks, std::memory_order_relaxed);
+
+    if (previousTicks != 0)
+    {
+        const double intervalMilliseconds = Time::highResolutionTicksToSeconds(startTicks - previousTicks) * 1000.0;
+        raiseWatermark(maxIntervalMilliseconds, intervalMilliseconds);
+
+        if (intervalMilliseconds > periodMilliseconds * 1.5)
+        {
+            numLateCallbacks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Raise a watermark to a new value unless another thread has already raised it further
+ *
+ * @param watermark                   Watermark to raise
+ * @param value                       Value just measured
+ *
+ * @return                            None
+ */
+void CallbackLoadMonitor::raiseWatermark(std::atomic<double>& watermark, double value)
+{
+    double current = watermark.load(std::memory_order_relaxed);
+
+    while (value > current && !watermark.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
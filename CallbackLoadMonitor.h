@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    CallbackLoadMonitor.h
+    Created: 17 Oct 2026 2:26:51am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class CallbackLoadMonitor
+{
+public:
+    // Histogram buckets, each a tenth of the block's period wide, with the last counting every block at twice its period or more
+    static constexpr int numBuckets = 21;
+    static constexpr int bucketPercent = 10;
+
+    /** Times the audio callback from construction to destruction and records the block with the monitor */
+    class ScopedBlockTimer
+    {
+    public:
+        /**
+         * Constructor that starts timing a block
+         *
+         * @param _monitor                    Monitor the block is recorded with
+         * @param _numSamples                 Number of samples in the block, which sets its deadline
+         *
+         * @return                            None
+         */
+        ScopedBlockTimer(CallbackLoadMonitor& _monitor, int _numSamples);
+
+        /**
+         * Destructor that records how long the block took
+         *
+         * @param                             None
+         *
+         * @return                            None
+         */
+        ~ScopedBlockTimer();
+
+    private:
+        CallbackLoadMonitor& monitor;
+        const int numSamples;
+        const int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlockTimer)
+    };
+
+    /**
+     * Constructor for a monitor with nothing recorded
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    CallbackLoadMonitor();
+
+    /**
+     * Destructor for the monitor
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~CallbackLoadMonitor();
+
+    /**
+     * Set the period blocks are measured against and forget everything recorded, called before the audio device starts
+     *
+     * @param _sampleRate                 Number of sound samples taken per second by the audio device
+     * @param _blockSize                  Number of samples the device is expected to ask for in each callback
+     *
+     * @return                            None
+     */
+    void prepare(double _sampleRate, int _blockSize);
+
+    /**
+     * Forget every block recorded so far, safe to call from the message thread while the device is running
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void reset();
+
+    /**
+     * Getter method that retrieves the sample rate blocks are measured against
+     *
+     * @param                             None
+     *
+     * @return                            Sample rate in Hz, or zero before the device starts
+     */
+    double getSampleRate() const;
+
+    /**
+     * Getter method that retrieves the block size the device was prepared with
+     *
+     * @param                             None
+     *
+     * @return                            Expected number of samples per callback
+     */
+    int getBlockSize() const;
+
+    /**
+     * Getter method that retrieves how much of each block's period the callback has recently taken
+     *
+     * @param                             None
+     *
+     * @return                            Smoothed callback time as a proportion of real time
+     */
+    double getLoad() const;
+
+    /**
+     * Getter method that retrieves the number of blocks the callback took longer to render than they last
+     *
+     * @param                             None
+     *
+     * @return                            Number of blocks that missed their deadline since the last reset
+     */
+    int getNumOverruns() const;
+
+    /**
+     * Getter method that retrieves the number of callbacks that started well after the previous block ran out
+     *
+     * @param                             None
+     *
+     * @return                            Number of callbacks started more than one and a half periods after the one before
+     */
+    int64 getNumLateCallbacks() const;
+
+    /**
+     * Getter method that retrieves the number of blocks recorded
+     *
+     * @param                             None
+     *
+     * @return                            Number of callbacks since the last reset
+     */
+    int64 getNumBlocks() const;
+
+    /**
+     * Getter method that retrieves the longest time the callback has taken
+     *
+     * @param                             None
+     *
+     * @return                            Longest callback in milliseconds since the last reset
+     */
+    double getMaxMilliseconds() const;
+
+    /**
+     * Getter method that retrieves the longest gap between the starts of two callbacks
+     *
+     * @param                             None
+     *
+     * @return                            Longest gap in milliseconds since the last reset
+     */
+    double getMaxIntervalMilliseconds() const;
+
+    /**
+     * Getter method that retrieves the number of blocks in one bucket of the histogram
+     *
+     * @param bucket                      Index of the bucket, covering bucketPercent of the period from bucket * bucketPercent
+     *
+     * @return                            Number of blocks whose callback time fell in the bucket
+     */
+    int64 getBucketCount(int bucket) const;
+
+private:
+    /**
+     * Record one block in the histogram, the watermarks and the load measurer, called on the audio thread
+     *
+     * @param startTicks                  High resolution ticks when the callback started
+     * @param endTicks                    High resolution ticks when the callback returned
+     * @param numSamples                  Number of samples in the block
+     *
+     * @return                            None
+     */
+    void registerBlock(int64 startTicks, int64 endTicks, int numSamples);
+
+    /**
+     * Raise a watermark to a new value unless another thread has already raised it further
+     *
+     * @param watermark                   Watermark to raise
+     * @param value                       Value just measured
+     *
+     * @return                            None
+     */
+    static void raiseWatermark(std::atomic<double>& watermark, double value);
+
+    // Smoothed load and blocks past their deadline
+    AudioProcessLoadMeasurer loadMeasurer;
+
+    std::atomic<double> sampleRate;
+    std::atomic<int> blockSize;
+
+    // Written only by the audio thread and read by the message thread, so the callback never waits for the reader
+    std::atomic<int64> buckets[numBuckets];
+    std::atomic<int64> numBlocks;
+    std::atomic<int64> numLateCallbacks;
+    std::atomic<double> maxMilliseconds;
+    std::atomic<double> maxIntervalMilliseconds;
+
+    // Start of the previous callback, or zero after a reset so the gap to it is not counted
+    std::atomic<int64> previousStartTicks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CallbackLoadMonitor)
+};
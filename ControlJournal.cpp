@@ -0,0 +1,592 @@
+/*
+  ==============================================================================
+
+    ControlJournal.cpp
+    Created: 17 Oct 2026 5:41:12am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "ControlJournal.h"
+
+constexpr int ControlJournal::eventsPerChannel;
+constexpr int ControlJournal::magicNumber;
+constexpr int ControlJournal::formatVersion;
+
+// Number of event types, which sizes the table of last journaled settings
+static constexpr int numEventTypes = (int)ControlJournal::EventType::end + 1;
+
+// Samples between two events beyond which the absolute position is written instead, so the gap always fits a compressed int
+static constexpr int64 largestPositionDelta = 1 << 30;
+
+/**
+ * Build an event stamped with a position
+ *
+ * @param samplePosition              First output sample of the block the event took effect in
+ * @param type                        Kind of event
+ * @param deck                        Deck the event belongs to, or -1 for the mixer
+ * @param value                       Value of the event
+ *
+ * @return                            Event holding the given fields
+ */
+static ControlJournal::Event makeEvent(int64 samplePosition, ControlJournal::EventType type, int deck, double value)
+{
+    ControlJournal::Event event;
+    event.samplePosition = samplePosition;
+    event.type = type;
+    event.deck = deck;
+    event.value = value;
+
+    return event;
+}
+
+/**
+ * Constructor for a journal that is not recording
+ *
+ * @param _numDecks                   Number of decks whose controls are journaled
+ *
+ * @return                            None
+ */
+ControlJournal::ControlJournal(int _numDecks)
+    : numDecks(_numDecks),
+      fifoEvents((size_t)((_numDecks + 1) * eventsPerChannel)),
+      lastWrittenPosition(0),
+      blockStart(0),
+      nextBlockStart(0),
+      lastBlockSize(-1),
+      lastSettings((size_t)(numEventTypes * (_numDecks + 1))),
+      numDroppedEvents(0)
+{
+    for (int channel = 0; channel <= numDecks; ++channel)
+    {
+        fifos.add(new AbstractFifo(eventsPerChannel));
+    }
+
+    // Allocated once, so writing the journal never grows it
+    pendingEvents.reserve(fifoEvents.size());
+}
+
+/**
+ * Destructor that closes any journal being written
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+ControlJournal::~ControlJournal()
+{
+    stop();
+}
+
+/**
+ * Start a journal file, called on the message thread before the audio device starts so the session is recorded from its first sample
+ *
+ * @param outputFile                  File to write, replaced if it exists
+ *
+ * @return                            True if the journal started, false otherwise with the reason in getError
+ */
+bool ControlJournal::start(const File& outputFile)
+{
+    stop();
+    error.clear();
+
+    outputFile.getParentDirectory().createDirectory();
+    outputFile.deleteFile();
+    outputStream = outputFile.createOutputStream();
+
+    if (outputStream == nullptr)
+    {
+        error = "Could not write to " + outputFile.getFullPathName();
+        return false;
+    }
+
+    // The header holds what a replay needs before the first event, the rest of the file is a stream of records
+    outputStream->writeInt(magicNumber);
+    outputStream->writeInt(formatVersion);
+    outputStream->writeCompressedInt(numDecks);
+    outputStream->writeInt64(Time::currentTimeMillis());
+
+    trackPaths.clear();
+    lastWrittenPosition = 0;
+    blockStart = 0;
+    nextBlockStart = 0;
+    lastBlockSize = -1;
+    numDroppedEvents = 0;
+
+    // Not a number compares unequal to every value, so every setting is journaled with the first block
+    for (int i = 0; i < numEventTypes * (numDecks + 1); ++i)
+    {
+        lastSettings[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    for (auto* fifo : fifos)
+    {
+        fifo->reset();
+    }
+
+    startTimer(200);
+
+    return true;
+}
+
+/**
+ * Write every event still waiting and close the journal, called on the message thread after the audio device has stopped
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void ControlJournal::stop()
+{
+    if (outputStream == nullptr)
+    {
+        return;
+    }
+
+    stopTimer();
+    writePendingEvents();
+
+    // The end record marks the last sample of the session and how many events it lost
+    writeEvent(makeEvent(nextBlockStart, EventType::end, -1, (double)numDroppedEvents.load()));
+
+    outputStream->flush();
+    outputStream.reset();
+}
+
+/**
+ * Determine whether a journal is being written
+ *
+ * @param                             None
+ *
+ * @return                            True while recording, false otherwise
+ */
+bool ControlJournal::isRecording() const
+{
+    return outputStream != nullptr;
+}
+
+/**
+ * Getter method that retrieves why the journal last failed to start
+ *
+ * @param                             None
+ *
+ * @return                            Description of the failure, or an empty string
+ */
+String ControlJournal::getError() const
+{
+    return error;
+}
+
+/**
+ * Getter method that retrieves the number of events lost because a thread's FIFO was full
+ *
+ * @param                             None
+ *
+ * @return                            Number of dropped events since the journal started
+ */
+int64 ControlJournal::getNumDroppedEvents() const
+{
+    return numDroppedEvents;
+}
+
+/**
+ * Give a track the id that its loads are journaled with, called on the message thread as the track is swapped into a deck
+ *
+ * @param audioURL                    Track being loaded
+ *
+ * @return                            Id of the track, the same for every load of the same file
+ */
+int ControlJournal::registerTrack(const URL& audioURL)
+{
+    const String path = audioURL.isLocalFile() ? audioURL.getLocalFile().getFullPathName() : audioURL.toString(false);
+    const int existingId = trackPaths.indexOf(path);
+
+    if (existingId >= 0)
+    {
+        return existingId;
+    }
+
+    // Paths are written once, so a load costs a few bytes however often the track is loaded
+    const int trackId = trackPaths.size();
+    trackPaths.add(path);
+
+    if (outputStream != nullptr)
+    {
+        outputStream->writeByte((char)EventType::track);
+        outputStream->writeCompressedInt(trackId);
+        outputStream->writeString(path);
+    }
+
+    return trackId;
+}
+
+/**
+ * Advance the journal clock to the next audio callback, called on the audio thread before anything else in the block
+ *
+ * @param numSamples                  Number of samples in the callback
+ *
+ * @return                            None
+ */
+void ControlJournal::beginBlock(int numSamples)
+{
+    blockStart = nextBlockStart;
+    nextBlockStart += numSamples;
+
+    // A replay renders blocks of the same sizes, so every control change lands between the same two samples
+    if (numSamples != lastBlockSize)
+    {
+        lastBlockSize = numSamples;
+        push(0, makeEvent(blockStart, EventType::blockSize, -1, (double)numSamples));
+    }
+}
+
+/**
+ * Getter method that retrieves the position of the block being rendered, called on the audio thread or a render worker
+ *
+ * @param                             None
+ *
+ * @return                            Output sample the current callback starts at
+ */
+int64 ControlJournal::getBlockStart() const
+{
+    return blockStart;
+}
+
+/**
+ * Journal the settings the mixer and decks are being prepared with, called before the audio thread starts or restarts
+ *
+ * @param sampleRate                  Sample rate of the audio device
+ * @param samplesPerBlockExpected     Number of samples the device expects to request per callback
+ *
+ * @return                            None
+ */
+void ControlJournal::recordPrepare(double sampleRate, int samplesPerBlockExpected)
+{
+    // Preparing happens between callbacks, so it takes effect with the next one
+    blockStart = nextBlockStart;
+
+    push(0, makeEvent(blockStart, EventType::sampleRate, -1, sampleRate));
+    push(0, makeEvent(blockStart, EventType::preparedBlockSize, -1, (double)samplesPerBlockExpected));
+}
+
+/**
+ * Journal a mixer action taken at the start of the current block, called on the audio thread
+ *
+ * @param type                        Crossfader move or transition start
+ * @param value                       Crossfader position, or zero
+ *
+ * @return                            None
+ */
+void ControlJournal::recordMixerEvent(EventType type, double value)
+{
+    push(0, makeEvent(blockStart, type, -1, value));
+}
+
+/**
+ * Journal a setting read at the start of the current block if it differs from the value last journaled, called on the audio thread
+ *
+ * @param type                        Setting that was read
+ * @param deck                        Deck the setting belongs to, or -1 for the mixer
+ * @param value                       Value in effect for the block
+ *
+ * @return                            None
+ */
+void ControlJournal::recordSetting(EventType type, int deck, double value)
+{
+    double& lastValue = lastSettings[(int)type * (numDecks + 1) + deck + 1];
+
+    if (value != lastValue)
+    {
+        lastValue = value;
+        push(0, makeEvent(blockStart, type, deck, value));
+    }
+}
+
+/**
+ * Journal the first block a deck played a newly loaded track in, called on the audio thread or a render worker
+ *
+ * @param deck                        Deck the track was loaded into
+ * @param trackId                     Id given to the track by registerTrack
+ *
+ * @return                            None
+ */
+void ControlJournal::recordLoad(int deck, int trackId)
+{
+    push(deck + 1, makeEvent(blockStart, EventType::load, deck, (double)trackId));
+}
+
+/**
+ * Journal a command a deck has applied at the start of the current block, called on the audio thread or a render worker
+ *
+ * @param deck                        Deck that applied the command
+ * @param command                     Command taken from the deck's queue
+ *
+ * @return                            None
+ */
+void ControlJournal::recordCommand(int deck, const DeckCommandQueue::Command& command)
+{
+    Event event = makeEvent(blockStart, EventType::command, deck, command.value);
+    event.commandType = (int)command.type;
+
+    push(deck + 1, event);
+}
+
+/**
+ * Read a journal file back in the order its events took effect
+ *
+ * @param journalFile                 File written by a previous session
+ * @param contents                    Receives the session's settings, tracks and events
+ * @param error                       Receives the reason the file could not be read
+ *
+ * @return                            True if the file was read, false otherwise
+ */
+bool ControlJournal::readFile(const File& journalFile, Contents& contents, String& error)
+{
+    contents = Contents();
+
+    FileInputStream input(journalFile);
+
+    if (!input.openedOk())
+    {
+        error = "Could not read " + journalFile.getFullPathName();
+        return false;
+    }
+
+    if (input.readInt() != magicNumber || input.readInt() != formatVersion)
+    {
+        error = journalFile.getFileName() + " is not a control journal written by this version";
+        return false;
+    }
+
+    contents.numDecks = input.readCompressedInt();
+    input.readInt64();
+
+    if (contents.numDecks < 2)
+    {
+        error = journalFile.getFileName() + " is damaged, it journals " + String(contents.numDecks) + " decks";
+        return false;
+    }
+
+    int64 position = 0;
+
+    while (!input.isExhausted())
+    {
+        const int typeNumber = (uint8)input.readByte();
+
+        if (typeNumber >= numEventTypes)
+        {
+            error = journalFile.getFileName() + " is damaged, it holds an unknown record at byte " + String(input.getPosition() - 1);
+            return false;
+        }
+
+        const EventType type = (EventType)typeNumber;
+
+        if (type == EventType::track)
+        {
+            // Track ids are handed out in order, so each path follows the one before it
+            const int trackId = input.readCompressedInt();
+
+            if (trackId != contents.tracks.size())
+            {
+                error = journalFile.getFileName() + " is damaged, track " + String(trackId) + " is out of order";
+                return false;
+            }
+
+            contents.tracks.add(input.readString());
+            continue;
+        }
+
+        if (type == EventType::position)
+        {
+            position = input.readInt64();
+            continue;
+        }
+
+        position += input.readCompressedInt();
+
+        // A session that crashed can stop mid-record, and everything before it is still replayed
+        if (input.getNumBytesRemaining() < (type == EventType::command ? 10 : 9))
+        {
+            break;
+        }
+
+        Event event;
+        event.samplePosition = position;
+        event.type = type;
+        event.deck = (int)(uint8)input.readByte() - 1;
+        event.commandType = type == EventType::command ? (int)(uint8)input.readByte() : 0;
+        event.value = input.readDouble();
+
+        if (event.deck < -1 || event.deck >= contents.numDecks
+            || event.commandType > (int)DeckCommandQueue::Command::Type::stop)
+        {
+            error = journalFile.getFileName() + " is damaged, it addresses deck " + String(event.deck + 1) + " at sample " + String(position);
+            return false;
+        }
+
+        if (type == EventType::end)
+        {
+            contents.endSamplePosition = position;
+            contents.numDroppedEvents = (int64)event.value;
+            contents.finished = true;
+            break;
+        }
+
+        // The first preparation is the audio device the session opened with
+        if (type == EventType::sampleRate && contents.sampleRate <= 0.0)
+        {
+            contents.sampleRate = event.value;
+        }
+        else if (type == EventType::preparedBlockSize && contents.blockSize <= 0)
+        {
+            contents.blockSize = (int)event.value;
+        }
+
+        contents.endSamplePosition = jmax(contents.endSamplePosition, position);
+        contents.events.push_back(event);
+    }
+
+    if (contents.sampleRate <= 0.0 || contents.blockSize <= 0)
+    {
+        error = journalFile.getFileName() + " ends before the audio device started";
+        return false;
+    }
+
+    // Decks are written out after the mixer on each pass, so events are put back in the order they took effect
+    std::stable_sort(contents.events.begin(), contents.events.end(), [](const Event& first, const Event& second)
+        {
+            return first.samplePosition < second.samplePosition;
+        });
+
+    return true;
+}
+
+/**
+ * Getter method that retrieves the journal file requested on the command line
+ *
+ * @param                             None
+ *
+ * @return                            File following the --journal argument, or File() if the session is not journaled
+ */
+File ControlJournal::getDefaultJournalFile()
+{
+    const StringArray arguments = JUCEApplicationBase::getCommandLineParameterArray();
+    const int journalIndex = arguments.indexOf("--journal");
+
+    if (journalIndex >= 0 && journalIndex + 1 < arguments.size())
+    {
+        return File::getCurrentWorkingDirectory().getChildFile(arguments[journalIndex + 1].unquoted());
+    }
+
+    return File();
+}
+
+/**
+ * Write the events waiting in every FIFO to the file every few hundred milliseconds
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void ControlJournal::timerCallback()
+{
+    writePendingEvents();
+}
+
+/**
+ * Add an event to one thread's FIFO without blocking, counting it as dropped if the FIFO is full
+ *
+ * @param channel                     Zero for the mixer, or one more than the deck whose thread journals it
+ * @param event                       Event to add
+ *
+ * @return                            None
+ */
+void ControlJournal::push(int channel, const Event& event)
+{
+    AbstractFifo& fifo = *fifos.getUnchecked(channel);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    // The message thread has fallen behind, so the event is counted rather than waited for
+    if (size1 + size2 == 0)
+    {
+        numDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    fifoEvents[(size_t)(channel * eventsPerChannel + (size1 > 0 ? start1 : start2))] = event;
+    fifo.finishedWrite(1);
+}
+
+/**
+ * Move the events waiting in every FIFO to the file in the order they took effect, called on the message thread
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void ControlJournal::writePendingEvents()
+{
+    pendingEvents.clear();
+
+    for (int channel = 0; channel <= numDecks; ++channel)
+    {
+        AbstractFifo& fifo = *fifos.getUnchecked(channel);
+        const Event* channelEvents = fifoEvents.data() + channel * eventsPerChannel;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+        pendingEvents.insert(pendingEvents.end(), channelEvents + start1, channelEvents + start1 + size1);
+        pendingEvents.insert(pendingEvents.end(), channelEvents + start2, channelEvents + start2 + size2);
+
+        fifo.finishedRead(size1 + size2);
+    }
+
+    // Each FIFO is already in order, and events at the same position keep the mixer ahead of the decks
+    std::stable_sort(pendingEvents.begin(), pendingEvents.end(), [](const Event& first, const Event& second)
+        {
+            return first.samplePosition < second.samplePosition;
+        });
+
+    for (const auto& event : pendingEvents)
+    {
+        writeEvent(event);
+    }
+
+    // A session that crashes still leaves everything up to the last pass on disk
+    outputStream->flush();
+}
+
+/**
+ * Write one event as its type, the samples since the previous event, its deck and its value
+ *
+ * @param event                       Event to write
+ *
+ * @return                            None
+ */
+void ControlJournal::writeEvent(const Event& event)
+{
+    // Deck events written on a later pass can sit a little before the last mixer event, so the gap may be negative
+    if (std::abs(event.samplePosition - lastWrittenPosition) >= largestPositionDelta)
+    {
+        outputStream->writeByte((char)EventType::position);
+        outputStream->writeInt64(event.samplePosition);
+        lastWrittenPosition = event.samplePosition;
+    }
+
+    outputStream->writeByte((char)event.type);
+    outputStream->writeCompressedInt((int)(event.samplePosition - lastWrittenPosition));
+    outputStream->writeByte((char)(event.deck + 1));
+
+    if (event.type == EventType::command)
+    {
+        outputStream->writeByte((char)event.commandType);
+    }
+
+    outputStream->writeDouble(event.value);
+
+    lastWrittenPosition = event.samplePosition;
+}
@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+
+    ControlJournal.h
+    Created: 17 Oct 2026 5:41:12am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DeckCommandQueue.h"
+
+using namespace juce;
+
+class ControlJournal : private Timer
+{
+public:
+    /** Kind of journal record, numbered as it is stored in the file */
+    enum class EventType
+    {
+        track = 0,
+        position,
+        sampleRate,
+        preparedBlockSize,
+        blockSize,
+        load,
+        command,
+        crossfader,
+        autoMix,
+        transitionLength,
+        transitionInBeats,
+        transitionStart,
+        curve,
+        masterGain,
+        side,
+        beatsPerMinute,
+        end
+    };
+
+    /** Control change, stamped with the first output sample of the block it took effect in */
+    struct Event
+    {
+        int64 samplePosition = 0;
+        EventType type = EventType::end;
+
+        // Deck the change was made to, or -1 for the mixer
+        int deck = -1;
+
+        // Deck command type for command events
+        int commandType = 0;
+
+        // Setting, command value, track id or block size depending on the event type
+        double value = 0.0;
+    };
+
+    /** Session read back from a journal file */
+    struct Contents
+    {
+        int numDecks = 0;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+
+        // Path of every track loaded during the session, indexed by track id
+        StringArray tracks;
+
+        // Every control change in the order it took effect
+        std::vector<Event> events;
+        int64 endSamplePosition = 0;
+
+        // False if the session never closed the journal, in which case it ends at its last event
+        bool finished = false;
+        int64 numDroppedEvents = 0;
+    };
+
+    // Events each thread can have waiting to be written, enough for several seconds of continuous slider moves on every deck
+    static constexpr int eventsPerChannel = 8192;
+
+    // First bytes of every journal file and the version of the layout that follows them
+    static constexpr int magicNumber = 0x4a6f744f;
+    static constexpr int formatVersion = 1;
+
+    /**
+     * Constructor for a journal that is not recording
+     *
+     * @param _numDecks                   Number of decks whose controls are journaled
+     *
+     * @return                            None
+     */
+    explicit ControlJournal(int _numDecks);
+
+    /**
+     * Destructor that closes any journal being written
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~ControlJournal() override;
+
+    /**
+     * Start a journal file, called on the message thread before the audio device starts so the session is recorded from its first sample
+     *
+     * @param outputFile                  File to write, replaced if it exists
+     *
+     * @return                            True if the journal started, false otherwise with the reason in getError
+     */
+    bool start(const File& outputFile);
+
+    /**
+     * Write every event still waiting and close the journal, called on the message thread after the audio device has stopped
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void stop();
+
+    /**
+     * Determine whether a journal is being written
+     *
+     * @param                             None
+     *
+     * @return                            True while recording, false otherwise
+     */
+    bool isRecording() const;
+
+    /**
+     * Getter method that retrieves why the journal last failed to start
+     *
+     * @param                             None
+     *
+     * @return                            Description of the failure, or an empty string
+     */
+    String getError() const;
+
+    /**
+     * Getter method that retrieves the number of events lost because a thread's FIFO was full
+     *
+     * @param                             None
+     *
+     * @return                            Number of dropped events since the journal started
+     */
+    int64 getNumDroppedEvents() const;
+
+    /**
+     * Give a track the id that its loads are journaled with, called on the message thread as the track is swapped into a deck
+     *
+     * @param audioURL                    Track being loaded
+     *
+     * @return                            Id of the track, the same for every load of the same file
+     */
+    int registerTrack(const URL& audioURL);
+
+    /**
+     * Advance the journal clock to the next audio callback, called on the audio thread before anything else in the block
+     *
+     * @param numSamples                  Number of samples in the callback
+     *
+     * @return                            None
+     */
+    void beginBlock(int numSamples);
+
+    /**
+     * Getter method that retrieves the position of the block being rendered, called on the audio thread or a render worker
+     *
+     * @param                             None
+     *
+     * @return                            Output sample the current callback starts at
+     */
+    int64 getBlockStart() const;
+
+    /**
+     * Journal the settings the mixer and decks are being prepared with, called before the audio thread starts or restarts
+     *
+     * @param sampleRate                  Sample rate of the audio device
+     * @param samplesPerBlockExpected     Number of samples the device expects to request per callback
+     *
+     * @return                            None
+     */
+    void recordPrepare(double sampleRate, int samplesPerBlockExpected);
+
+    /**
+     * Journal a mixer action taken at the start of the current block, called on the audio thread
+     *
+     * @param type                        Crossfader move or transition start
+     * @param value                       Crossfader position, or zero
+     *
+     * @return                            None
+     */
+    void recordMixerEvent(EventType type, double value);
+
+    /**
+     * Journal a setting read at the start of the current block if it differs from the value last journaled, called on the audio thread
+     *
+     * @param type                        Setting that was read
+     * @param deck                        Deck the setting belongs to, or -1 for the mixer
+     * @param value                       Value in effect for the block
+     *
+     * @return                            None
+     */
+    void recordSetting(EventType type, int deck, double value);
+
+    /**
+     * Journal the first block a deck played a newly loaded track in, called on the audio thread or a render worker
+     *
+     * @param deck                        Deck the track was loaded into
+     * @param trackId                     Id given to the track by registerTrack
+     *
+     * @return                            None
+     */
+    void recordLoad(int deck, int trackId);
+
+    /**
+     * Journal a command a deck has applied at the start of the current block, called on the audio thread or a render worker
+     *
+     * @param deck                        Deck that applied the command
+     * @param command                     Command taken from the deck's queue
+     *
+     * @return                            None
+     */
+    void recordCommand(int deck, const DeckCommandQueue::Command& command);
+
+    /**
+     * Read a journal file back in the order its events took effect
+     *
+     * @param journalFile                 File written by a previous session
+     * @param contents                    Receives the session's settings, tracks and events
+     * @param error                       Receives the reason the file could not be read
+     *
+     * @return                            True if the file was read, false otherwise
+     */
+    static bool readFile(const File& journalFile, Contents& contents, String& error);
+
+    /**
+     * Getter method that retrieves the journal file requested on the command line
+     *
+     * @param                             None
+     *
+     * @return                            File following the --journal argument, or File() if the session is not journaled
+     */
+    static File getDefaultJournalFile();
+
+private:
+    /**
+     * Write the events waiting in every FIFO to the file every few hundred milliseconds
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void timerCallback() override;
+
+    /**
+     * Add an event to one thread's FIFO without blocking, counting it as dropped if the FIFO is full
+     *
+     * @param channel                     Zero for the mixer, or one more than the deck whose thread journals it
+     * @param event                       Event to add
+     *
+     * @return                            None
+     */
+    void push(int channel, const Event& event);
+
+    /**
+     * Move the events waiting in every FIFO to the file in the order they took effect, called on the message thread
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void writePendingEvents();
+
+    /**
+     * Write one event as its type, the samples since the previous event, its deck and its value
+     *
+     * @param event                       Event to write
+     *
+     * @return                            None
+     */
+    void writeEvent(const Event& event);
+
+    const int numDecks;
+
+    // One single producer FIFO for the mixer and one for each deck, since each deck can be rendered on its own worker
+    OwnedArray<AbstractFifo> fifos;
+    std::vector<Event> fifoEvents;
+
+    // Events taken from the FIFOs and sorted before they are written, owned by the message thread
+    std::vector<Event> pendingEvents;
+
+    std::unique_ptr<FileOutputStream> outputStream;
+    StringArray trackPaths;
+    int64 lastWrittenPosition;
+    String error;
+
+    // Owned by the audio thread, except that render workers read the position of the block being rendered
+    std::atomic<int64> blockStart;
+    int64 nextBlockStart;
+    int lastBlockSize;
+
+    // Last value journaled for every setting of the mixer and of each deck, so unchanged settings cost nothing
+    HeapBlock<double> lastSettings;
+
+    std::atomic<int64> numDroppedEvents;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ControlJournal)
+};
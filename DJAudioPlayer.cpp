@@ -9,6 +9,14 @@ Author:  Jonathan
 */
 
 #include "DJAudioPlayer.h"
+
+constexpr double DJAudioPlayer::minimumLoopBeats;
+constexpr double DJAudioPlayer::maximumLoopBeats;
+constexpr double DJAudioPlayer::unknownTempoBeatsPerMinute;
+constexpr double DJAudioPlayer::targetLoudness;
+constexpr double DJAudioPlayer::truePeakCeiling;
+constexpr double DJAudioPlayer::maximumTrimCut;
+
 /**
  * Constructor for audio player that initializes the format manager to recognize audio formats
  *
@@ -17,7 +25,7 @@ Author:  Jonathan
  * @return                        None
  */
 DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager)
-    : formatManager(_formatManager), loopTrackAudio(false)
+    : formatManager(_formatManager), readAheadSeconds(0.0), ramMode(false), readAheadSource(nullptr), trackSourceSampleRate(0.0), nextTrackSourceSampleRate(0.0), currentSampleRate(44100.0), currentBlockSize(0), loopTrackAudio(false), beatsPerMinute(0.0), downbeatSeconds(0.0), trimDecibels(0.0), crossfaderSide(MixerBus::Side::a), loopInSeconds(-1.0), loopOutSeconds(0.0), beatLoopActive(false), pendingLoopStart(0.0), journal(nullptr), journalDeck(0), lastCommandBlockStart(-1), loadGeneration(0), loadInProgress(false), loadedSourceSampleRate(0.0), nextTrackGeneration(0), preparedNextSourceSampleRate(0.0)
 {
 }
 
@@ -30,6 +38,10 @@ DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager)
  */
 DJAudioPlayer::~DJAudioPlayer()
 {
+    // Cancel background loads and wait for one that is already running
+    ++loadGeneration;
+    ++nextTrackGeneration;
+    loadingPool.removeAllJobs(true, 4000);
 }
 
 /**
@@ -42,14 +54,10 @@ DJAudioPlayer::~DJAudioPlayer()
  */
 void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    bandIIRFilterSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    lowIIRFilterSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    highIIRFilterSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    renderer.prepareToPlay(samplesPerBlockExpected, sampleRate);
 
     currentSampleRate = sampleRate;
+    currentBlockSize = samplesPerBlockExpected;
 }
 
 /**
@@ -62,7 +70,9 @@ void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate
  */
 void DJAudioPlayer::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
 {
-    highIIRFilterSource.getNextAudioBlock(bufferToFill);
+    // Apply user interface changes inside the render critical section so they never wait for a track swap,
+    // while the end of the track and track changes are left in flags for the deck interface to poll, as posting a message would allocate
+    renderer.render(bufferToFill, this);
 }
 
 /**
@@ -74,16 +84,11 @@ void DJAudioPlayer::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill
  */
 void DJAudioPlayer::releaseResources()
 {
-    transportSource.releaseResources();
-    resampleSource.releaseResources();
-
-    bandIIRFilterSource.releaseResources();
-    lowIIRFilterSource.releaseResources();
-    highIIRFilterSource.releaseResources();
+    renderer.releaseResources();
 }
 
 /**
- * Create suitable reader for input stream to audio sources
+ * Create suitable reader for input stream to audio sources, blocking until it is ready
  *
  * @param audioURL                    URL used to create an input stream
  *
@@ -91,22 +96,196 @@ void DJAudioPlayer::releaseResources()
  */
 void DJAudioPlayer::loadURL(URL audioURL)
 {
-    // Create suitable reader for input stream based on known formats
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    // Supersede any load that is still running in the background
+    ++loadGeneration;
+    loadInProgress = false;
+    discardNextTrack();
+
+    double sourceSampleRate = 0.0;
+    std::unique_ptr<PositionableAudioSource> newSource(createTrackSource(audioURL, sourceSampleRate, loadGeneration));
 
     // Valid reader
-    if (reader != nullptr)
+    if (newSource != nullptr)
+    {
+        swapInSource(std::move(newSource), sourceSampleRate, audioURL);
+    }
+}
+
+/**
+ * Open and prepare a reader on a background thread, then swap it into the deck on the message thread
+ *
+ * @param audioURL                    URL used to create an input stream
+ * @param onLoaded                    Called on the message thread with true if the track was loaded, skipped if a newer load supersedes this one
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::loadURLAsync(URL audioURL, std::function<void(bool)> onLoaded)
+{
+    // A newer request cancels any load that has not finished yet
+    const int generation = ++loadGeneration;
+    loadingPool.removeAllJobs(false, 0);
+    loadInProgress = true;
+
+    // The queued track is opened again once the new track has loaded
+    discardNextTrack();
+
+    WeakReference<DJAudioPlayer> weakThis(this);
+
+    loadingPool.addJob([this, weakThis, audioURL, onLoaded, generation]
+        {
+            if (generation != loadGeneration)
+            {
+                return;
+            }
+
+            // Probe formats, open the stream and fill the read ahead buffer away from the message thread
+            double sourceSampleRate = 0.0;
+            std::unique_ptr<PositionableAudioSource> newSource(createTrackSource(audioURL, sourceSampleRate, generation));
+
+            {
+                const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType lock(loadedSourceLock);
+
+                // Discard the source if the user asked for another track in the meantime
+                if (generation != loadGeneration)
+                {
+                    return;
+                }
+
+                loadedSource = std::move(newSource);
+                loadedSourceURL = audioURL;
+                loadedSourceSampleRate = sourceSampleRate;
+            }
+
+            MessageManager::callAsync([weakThis, generation, onLoaded]
+                {
+                    if (auto* player = weakThis.get())
+                    {
+                        player->finishAsyncLoad(generation, onLoaded);
+                    }
+                });
+        });
+}
+
+/**
+ * Determine whether a background load has been requested and has not finished yet
+ *
+ * @param                             None
+ *
+ * @return                            True if a track is loading, false otherwise
+ */
+bool DJAudioPlayer::isLoading() const
+{
+    return loadInProgress;
+}
+
+/**
+ * Open and pre-buffer the track that follows the loaded one on a background thread, so the audio thread can switch to it at the last sample
+ *
+ * @param audioURL                    URL of the queued track
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::prepareNextTrack(URL audioURL)
+{
+    // The track is already open or being opened
+    if (audioURL == nextTrackURL)
     {
-        // Wrap format reader in audio source that integrates with audio system life cycle
-        std::unique_ptr<AudioFormatReaderSource> newSource(new AudioFormatReaderSource(reader,
-            true));
+        return;
+    }
+
+    discardNextTrack();
+    nextTrackURL = audioURL;
+
+    const int generation = nextTrackGeneration;
+    const int loadRequest = loadGeneration;
+
+    WeakReference<DJAudioPlayer> weakThis(this);
+
+    // Runs after any load of the current track that is still in progress
+    loadingPool.addJob([this, weakThis, audioURL, generation, loadRequest]
+        {
+            if (generation != nextTrackGeneration)
+            {
+                return;
+            }
+
+            double sourceSampleRate = 0.0;
+            std::unique_ptr<PositionableAudioSource> newSource(createTrackSource(audioURL, sourceSampleRate, loadRequest));
+
+            {
+                const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType lock(loadedSourceLock);
 
-        // Set reader used as input source to the transport source, which controls playback
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
+                if (generation != nextTrackGeneration)
+                {
+                    return;
+                }
 
-        // Pass ownership of audio format reader source to class scope variable to keep playing it
-        readerSource.reset(newSource.release());
+                preparedNextSource = std::move(newSource);
+                preparedNextSourceSampleRate = sourceSampleRate;
+            }
+
+            MessageManager::callAsync([weakThis, generation]
+                {
+                    if (auto* player = weakThis.get())
+                    {
+                        player->finishPrepareNextTrack(generation);
+                    }
+                });
+        });
+}
+
+/**
+ * Take ownership of the queued track once the audio thread has switched to it, releasing the track that ended
+ *
+ * @param                             None
+ *
+ * @return                            True if the queued track has taken over since the last call, false otherwise
+ */
+bool DJAudioPlayer::advanceToNextTrack()
+{
+    if (nextTrackSource == nullptr || !renderer.hasStartedNextSource())
+    {
+        return false;
     }
+
+    // The renderer no longer reads the track that ended, so it can be released here
+    trackSource = std::move(nextTrackSource);
+    readAheadSource = dynamic_cast<ReadAheadAudioSource*>(trackSource.get());
+    trackSourceSampleRate = nextTrackSourceSampleRate;
+    nextTrackURL = URL();
+
+    // A loop start marked in the previous track means nothing in this one
+    loopInSeconds = -1.0;
+
+    return true;
+}
+
+/**
+ * Check whether the track has ended or the queued track has taken over since the last check, polled by the deck interface
+ *
+ * @param                             None
+ *
+ * @return                            True if either happened since the last call, false otherwise
+ */
+bool DJAudioPlayer::consumeTrackEvents()
+{
+    // Both flags are cleared, since one check deals with either
+    const bool trackChanged = renderer.consumeTrackChange();
+    const bool endReached = renderer.consumeEndOfTrack();
+
+    return trackChanged || endReached;
+}
+
+/**
+ * Setter method that sets how long the end of each track overlaps the start of the queued track
+ *
+ * @param seconds                     Length of the crossfade in seconds, or zero for gapless playback
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::setQueueOverlapSeconds(double seconds)
+{
+    commandQueue.push(DeckCommandQueue::Command::Type::setQueueOverlap, jmax(0.0, seconds));
 }
 
 /**
@@ -118,7 +297,8 @@ void DJAudioPlayer::loadURL(URL audioURL)
  */
 double DJAudioPlayer::getPositionRelative()
 {
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+    const double length = renderer.getLengthInSeconds();
+    return length > 0.0 ? renderer.getCurrentPosition() / length : 0.0;
 }
 
 /**
@@ -132,7 +312,7 @@ void DJAudioPlayer::setGain(double gain)
 {
     if (gain >= 0 && gain <= 1.0)
     {
-        transportSource.setGain(gain);
+        commandQueue.push(DeckCommandQueue::Command::Type::setGain, gain);
     }
 }
 
@@ -147,7 +327,7 @@ void DJAudioPlayer::setSpeed(double ratio)
 {
     if (ratio >= 0 && ratio <= 5.0)
     {
-        resampleSource.setResamplingRatio(ratio);
+        commandQueue.push(DeckCommandQueue::Command::Type::setSpeed, ratio);
     }
 }
 
@@ -160,7 +340,8 @@ void DJAudioPlayer::setSpeed(double ratio)
  */
 void DJAudioPlayer::setPosition(double posInSecs)
 {
-    transportSource.setPosition(posInSecs);
+    prepareSeek(posInSecs);
+    commandQueue.push(DeckCommandQueue::Command::Type::setPosition, posInSecs);
 }
 
 /**
@@ -174,7 +355,7 @@ void DJAudioPlayer::setPositionRelative(double posRelative)
 {
     if (posRelative >= 0 && posRelative <= 1.0)
     {
-        double posInSecs = transportSource.getLengthInSeconds() * posRelative;
+        double posInSecs = renderer.getLengthInSeconds() * posRelative;
         setPosition(posInSecs);
     }
 }
@@ -188,10 +369,7 @@ void DJAudioPlayer::setPositionRelative(double posRelative)
  */
 void DJAudioPlayer::setBandPassFrequency(double _bandPassFrequency)
 {
-    bandPassFrequency = _bandPassFrequency;
-
-    // Set coefficients for a band pass filter
-    bandIIRFilterSource.setCoefficients(IIRCoefficients::makeBandPass(currentSampleRate, bandPassFrequency));
+    commandQueue.push(DeckCommandQueue::Command::Type::setBandPassFrequency, _bandPassFrequency);
 }
 
 /**
@@ -203,10 +381,7 @@ void DJAudioPlayer::setBandPassFrequency(double _bandPassFrequency)
  */
 void DJAudioPlayer::setLowPassFrequency(double _lowPassFrequency)
 {
-    lowPassFrequency = _lowPassFrequency;
-
-    // Set coefficients for a low pass filter
-    lowIIRFilterSource.setCoefficients(IIRCoefficients::makeLowPass(currentSampleRate, lowPassFrequency));
+    commandQueue.push(DeckCommandQueue::Command::Type::setLowPassFrequency, _lowPassFrequency);
 }
 
 /**
@@ -218,10 +393,7 @@ void DJAudioPlayer::setLowPassFrequency(double _lowPassFrequency)
  */
 void DJAudioPlayer::setHighPassFrequency(double _highPassFrequency)
 {
-    highPassFrequency = _highPassFrequency;
-
-    // Set coefficients for a high pass filter
-    highIIRFilterSource.setCoefficients(IIRCoefficients::makeHighPass(currentSampleRate, highPassFrequency));
+    commandQueue.push(DeckCommandQueue::Command::Type::setHighPassFrequency, _highPassFrequency);
 }
 
 /**
@@ -233,8 +405,10 @@ void DJAudioPlayer::setHighPassFrequency(double _highPassFrequency)
  */
 void DJAudioPlayer::movePositionBack()
 {
-    double backwardPosition = (transportSource.getCurrentPosition() - 2) >= 0 ? transportSource.getCurrentPosition() - 2 : 0;
-    transportSource.setPosition(backwardPosition);
+    prepareSeek(renderer.getCurrentPosition() - 2.0);
+
+    // Resolve the new position against the playhead when the command is applied
+    commandQueue.push(DeckCommandQueue::Command::Type::movePosition, -2.0);
 }
 
 /**
@@ -246,8 +420,10 @@ void DJAudioPlayer::movePositionBack()
  */
 void DJAudioPlayer::movePositionForward()
 {
-    double forwardPosition = (transportSource.getCurrentPosition() + 2) <= transportSource.getLengthInSeconds() ? transportSource.getCurrentPosition() + 2 : transportSource.getLengthInSeconds();
-    transportSource.setPosition(forwardPosition);
+    prepareSeek(renderer.getCurrentPosition() + 2.0);
+
+    // Resolve the new position against the playhead when the command is applied
+    commandQueue.push(DeckCommandQueue::Command::Type::movePosition, 2.0);
 }
 
 /**
@@ -259,8 +435,8 @@ void DJAudioPlayer::movePositionForward()
  */
 void DJAudioPlayer::backToStart()
 {
-    double startPosition = 0;
-    transportSource.setPosition(0);
+    prepareSeek(0.0);
+    commandQueue.push(DeckCommandQueue::Command::Type::setPosition, 0.0);
 }
 
 /**
@@ -272,7 +448,7 @@ void DJAudioPlayer::backToStart()
  */
 double DJAudioPlayer::getSongLengthInSeconds()
 {
-    return transportSource.getLengthInSeconds();
+    return renderer.getLengthInSeconds();
 }
 
 /**
@@ -284,7 +460,7 @@ double DJAudioPlayer::getSongLengthInSeconds()
  */
 void DJAudioPlayer::start()
 {
-    transportSource.start();
+    commandQueue.push(DeckCommandQueue::Command::Type::start);
 }
 
 /**
@@ -296,42 +472,868 @@ void DJAudioPlayer::start()
  */
 void DJAudioPlayer::stop()
 {
-    transportSource.stop();
+    commandQueue.push(DeckCommandQueue::Command::Type::stop);
 }
 
 /**
- * Determine whether the audio track has ended
+ * Play the audio track from the next sample rendered, called on the audio thread between two parts of a block
  *
- * @param                              None
+ * @param                             None
  *
- * @return                             True if the track has ended, false otherwise
+ * @return                            None
  */
-bool DJAudioPlayer::finishedPlaying()
+void DJAudioPlayer::startImmediately()
 {
-    // Account for floating point rounding errors
-    return abs(getPositionRelative() - 1.00) < 1e-2;
+    // The audio thread cannot push to the command queue, which only has room for one producer, and must not wait for a track swap
+    renderer.requestStart();
 }
 
 /**
- * Loop the audio source
+ * Stop the audio track with a fade over the next block, called on the audio thread
  *
- * @param                              None
+ * @param                             None
  *
- * @return                             None
+ * @return                            None
  */
-void DJAudioPlayer::toggleAudioLoop()
+void DJAudioPlayer::stopImmediately()
 {
-    loopTrackAudio = !loopTrackAudio;
+    renderer.requestStop();
 }
 
 /**
- * Determines if the audio track is currently set to loop
+ * Determine whether the deck is currently producing audio
  *
- * @param                              None
+ * @param                             None
  *
- * @return                             True if the audio track is set to loop
+ * @return                            True if the audio track is playing, false otherwise
  */
-bool DJAudioPlayer::isLooping()
+bool DJAudioPlayer::isPlaying() const
 {
-    return loopTrackAudio;
-}
\ No newline at end of file
+    return renderer.isPlaying();
+}
+
+/**
+ * Getter method that retrieves the playback speed, called on the audio thread
+ *
+ * @param                             None
+ *
+ * @return                            Playback speed where 1.0 is the original speed
+ */
+double DJAudioPlayer::getSpeed() const
+{
+    return renderer.getSpeed();
+}
+
+/**
+ * Setter method that sets the beat grid of the loaded track, found by analysing it
+ *
+ * @param _beatsPerMinute             Tempo at the original speed, or zero if it is unknown
+ * @param _downbeatSeconds            Time of the first downbeat in the track
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::setBeatGrid(double _beatsPerMinute, double _downbeatSeconds)
+{
+    beatsPerMinute = jmax(0.0, _beatsPerMinute);
+    downbeatSeconds = jmax(0.0, _downbeatSeconds);
+}
+
+/**
+ * Getter method that retrieves the tempo of the loaded track at its original speed, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Tempo in beats per minute, or zero if it is unknown
+ */
+double DJAudioPlayer::getBeatsPerMinute() const
+{
+    return beatsPerMinute;
+}
+
+/**
+ * Getter method that retrieves the time of the first downbeat of the loaded track, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Time in seconds from the start of the track
+ */
+double DJAudioPlayer::getDownbeatSeconds() const
+{
+    return downbeatSeconds;
+}
+
+/**
+ * Setter method that sets the trim of the loaded track from its loudness, bringing it towards the target loudness
+ *
+ * @param integratedLoudness          Integrated loudness of the track in LUFS
+ * @param truePeak                    True peak of the track in dBTP, which limits how far a quiet track is raised
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::setTrackLoudness(double integratedLoudness, double truePeak)
+{
+    // A quiet track is only raised as far as its peaks allow, while a loud track is always brought down
+    const double headroom = jmax(0.0, truePeakCeiling - truePeak);
+    setTrim(jmax(-maximumTrimCut, jmin(targetLoudness - integratedLoudness, headroom)));
+}
+
+/**
+ * Setter method that sets the trim applied before the volume slider, ramped in the audio thread to avoid clicks
+ *
+ * @param decibels                    Trim in decibels, where zero leaves the track unchanged
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::setTrim(double decibels)
+{
+    trimDecibels = decibels;
+    commandQueue.push(DeckCommandQueue::Command::Type::setTrim, Decibels::decibelsToGain(decibels));
+}
+
+/**
+ * Getter method that retrieves the trim applied before the volume slider
+ *
+ * @param                             None
+ *
+ * @return                            Trim in decibels
+ */
+double DJAudioPlayer::getTrim() const
+{
+    return trimDecibels;
+}
+
+/**
+ * Mark the start of a beat loop at the beat nearest the playhead, leaving any loop that is playing
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::setLoopIn()
+{
+    exitLoop();
+
+    loopInSeconds = snapToBeat(renderer.getCurrentPosition());
+}
+
+/**
+ * Close the beat loop at the beat nearest the playhead and start repeating it
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::setLoopOut()
+{
+    if (loopInSeconds < 0.0)
+    {
+        return;
+    }
+
+    // Round the loop to whole beats between the shortest and longest loop lengths
+    const double beatSeconds = getBeatSeconds();
+    const double numBeats = std::round((snapToBeat(renderer.getCurrentPosition()) - loopInSeconds) / beatSeconds);
+
+    loopOutSeconds = loopInSeconds + jlimit(1.0, maximumLoopBeats, numBeats) * beatSeconds;
+    applyBeatLoop();
+}
+
+/**
+ * Start repeating a number of beats from the beat nearest the playhead
+ *
+ * @param numBeats                    Length of the loop in beats, from a quarter of a beat to 32 beats
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::startAutoLoop(double numBeats)
+{
+    loopInSeconds = snapToBeat(renderer.getCurrentPosition());
+    loopOutSeconds = loopInSeconds + jlimit(minimumLoopBeats, maximumLoopBeats, numBeats) * getBeatSeconds();
+    applyBeatLoop();
+}
+
+/**
+ * Halve the length of the beat loop that is playing, keeping its start
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::halveLoop()
+{
+    if (!beatLoopActive || getLoopLengthInBeats() / 2.0 < minimumLoopBeats)
+    {
+        return;
+    }
+
+    // The renderer jumps to the same place in the shorter loop if the playhead is already past its end
+    loopOutSeconds = loopInSeconds + (loopOutSeconds - loopInSeconds) / 2.0;
+    applyBeatLoop();
+}
+
+/**
+ * Double the length of the beat loop that is playing, keeping its start
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::doubleLoop()
+{
+    if (!beatLoopActive || getLoopLengthInBeats() * 2.0 > maximumLoopBeats
+        || loopInSeconds + (loopOutSeconds - loopInSeconds) * 2.0 > getSongLengthInSeconds())
+    {
+        return;
+    }
+
+    loopOutSeconds = loopInSeconds + (loopOutSeconds - loopInSeconds) * 2.0;
+    applyBeatLoop();
+}
+
+/**
+ * Leave the beat loop and play on through its end
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::exitLoop()
+{
+    if (!beatLoopActive)
+    {
+        return;
+    }
+
+    beatLoopActive = false;
+    commandQueue.push(DeckCommandQueue::Command::Type::exitLoop);
+}
+
+/**
+ * Determine whether a beat loop is playing
+ *
+ * @param                             None
+ *
+ * @return                            True if a beat loop is active, false otherwise
+ */
+bool DJAudioPlayer::isBeatLoopActive() const
+{
+    return beatLoopActive;
+}
+
+/**
+ * Getter method that retrieves the length of the beat loop
+ *
+ * @param                             None
+ *
+ * @return                            Length in beats of the loaded track, or zero if no loop is active
+ */
+double DJAudioPlayer::getLoopLengthInBeats() const
+{
+    return beatLoopActive ? (loopOutSeconds - loopInSeconds) / getBeatSeconds() : 0.0;
+}
+
+/**
+ * Getter method that retrieves the length of one beat of the loaded track at its original speed
+ *
+ * @param                             None
+ *
+ * @return                            Beat length in seconds
+ */
+double DJAudioPlayer::getBeatSeconds() const
+{
+    const double tempo = beatsPerMinute;
+
+    return 60.0 / (tempo > 0.0 ? tempo : unknownTempoBeatsPerMinute);
+}
+
+/**
+ * Move a position in the loaded track to the nearest beat of its beat grid, unchanged if the track has no beat grid
+ *
+ * @param seconds                     Position in seconds
+ *
+ * @return                            Position of the nearest beat in seconds
+ */
+double DJAudioPlayer::snapToBeat(double seconds) const
+{
+    if (beatsPerMinute <= 0.0)
+    {
+        return seconds;
+    }
+
+    // Beats before the first downbeat are part of the grid too
+    const double beatSeconds = getBeatSeconds();
+    double beat = downbeatSeconds + std::round((seconds - downbeatSeconds) / beatSeconds) * beatSeconds;
+
+    while (beat < 0.0)
+    {
+        beat += beatSeconds;
+    }
+
+    return beat;
+}
+
+/**
+ * Send the beat loop to the audio thread, which starts repeating it or changes the loop already playing
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::applyBeatLoop()
+{
+    beatLoopActive = true;
+
+    // The audio thread applies both boundaries in order, the loop only changes once the end arrives
+    commandQueue.push(DeckCommandQueue::Command::Type::setLoopStart, loopInSeconds);
+    commandQueue.push(DeckCommandQueue::Command::Type::setLoopEnd, loopOutSeconds);
+}
+
+/**
+ * Determine whether the audio track has ended, which the audio thread also announces with a change message
+ *
+ * @param                              None
+ *
+ * @return                             True if the last sample of the track has been played, false otherwise
+ */
+bool DJAudioPlayer::finishedPlaying()
+{
+    return renderer.hasReachedEnd();
+}
+
+/**
+ * Loop the audio source seamlessly at its last sample, or stop looping it
+ *
+ * @param                              None
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::toggleAudioLoop()
+{
+    loopTrackAudio = !loopTrackAudio;
+
+    // A streamed track that has wrapped around moves back to the same place in the track once it stops looping,
+    // which has to be read before the audio thread gets there
+    if (!loopTrackAudio)
+    {
+        prepareSeek(renderer.getCurrentPosition());
+    }
+
+    // The renderer wraps around in the audio thread, so there is no gap at the loop point
+    commandQueue.push(DeckCommandQueue::Command::Type::setLooping, loopTrackAudio ? 1.0 : 0.0);
+}
+
+/**
+ * Determines if the audio track is currently set to loop
+ *
+ * @param                              None
+ *
+ * @return                             True if the audio track is set to loop
+ */
+bool DJAudioPlayer::isLooping()
+{
+    return loopTrackAudio;
+}
+
+/**
+ * Setter method that sets how much audio this deck reads ahead of its playhead, applied when the next track loads
+ *
+ * @param seconds                      Read ahead in seconds, or zero to use the streaming pool default
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::setReadAheadSeconds(double seconds)
+{
+    readAheadSeconds = jmax(0.0, seconds);
+}
+
+/**
+ * Getter method that retrieves the buffer underrun counters of the loaded track
+ *
+ * @param                              None
+ *
+ * @return                             Streaming statistics, all zero if no track is loaded
+ */
+ReadAheadAudioSource::Statistics DJAudioPlayer::getStreamingStatistics() const
+{
+    // Tracks played from memory never touch the disk
+    if (readAheadSource != nullptr)
+    {
+        return readAheadSource->getStatistics();
+    }
+
+    return {};
+}
+
+/**
+ * Open an audio track as a streaming source, or as a decoded track in RAM deck mode, prepared for the current audio device
+ *
+ * @param audioURL                    URL used to create an input stream
+ * @param sourceSampleRate            Receives the sample rate of the audio track
+ * @param generation                  Load request that wants the track, decoding stops early once it is superseded
+ *
+ * @return                            Prepared source owned by the caller, or nullptr if no format could read the track
+ */
+PositionableAudioSource* DJAudioPlayer::createTrackSource(URL audioURL, double& sourceSampleRate, int generation)
+{
+    // Opening a track waits on the disk and the decoder, so it must never happen while rendering
+    RealtimeSafetyChecker::noteBlockingCall("DJAudioPlayer::createTrackSource");
+
+    // Decode the whole track into memory, reusing it if it was played recently
+    if (ramMode && audioURL.isLocalFile())
+    {
+        DecodedTrackCache::DecodedTrack::Ptr track = decodedTrackCache->getOrDecode(audioURL.getLocalFile(), formatManager,
+            [this, generation] { return generation != loadGeneration; },
+            pcmDiskCache->createMappedReader(audioURL.getLocalFile()));
+
+        if (track != nullptr)
+        {
+            sourceSampleRate = track->sampleRate;
+            return new MemoryTrackSource(track);
+        }
+
+        // A superseded load gives up, anything else that cannot be held in memory is streamed instead
+        if (generation != loadGeneration)
+        {
+            return nullptr;
+        }
+    }
+
+    // Read the decoded copy of the track if the library cache has one, so loading and seeking skip the decoder
+    AudioFormatReader* reader = nullptr;
+
+    if (audioURL.isLocalFile())
+    {
+        reader = pcmDiskCache->createMappedReader(audioURL.getLocalFile());
+    }
+
+    // Create suitable reader for input stream based on known formats
+    if (reader == nullptr)
+    {
+        reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    }
+
+    if (reader == nullptr)
+    {
+        return nullptr;
+    }
+
+    sourceSampleRate = reader->sampleRate;
+
+    // Wrap format reader in audio source that integrates with audio system life cycle
+    auto* readerSource = new AudioFormatReaderSource(reader, true);
+
+    // Decode on a shared streaming thread so that the audio callback never waits for the disk
+    const double seconds = readAheadSeconds > 0.0 ? readAheadSeconds : streamingPool->getDefaultReadAheadSeconds();
+    auto* newSource = new ReadAheadAudioSource(readerSource,
+        streamingPool->getThreadForNewSource(),
+        (int)(seconds * reader->sampleRate));
+
+    // Prepare the new source before the audio thread can see it
+    const int blockSize = currentBlockSize;
+
+    if (blockSize > 0)
+    {
+        newSource->prepareToPlay(blockSize, currentSampleRate);
+
+        // Give the streaming thread a head start so that playing straight away does not underrun
+        newSource->waitUntilBuffered(blockSize * 4, 200);
+    }
+
+    return newSource;
+}
+
+/**
+ * Swap a prepared source into the renderer and release the previous one, called on the message thread
+ *
+ * @param newSource                   Prepared source to play
+ * @param sourceSampleRate            Sample rate of the audio track
+ * @param audioURL                    URL the source was opened from
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::swapInSource(std::unique_ptr<PositionableAudioSource> newSource, double sourceSampleRate, const URL& audioURL)
+{
+    // A journaled session tags the source with its track, which the audio thread journals once it plays from it
+    const int trackId = journal != nullptr ? journal->registerTrack(audioURL) : 0;
+
+    // Swap the reader into the renderer, which controls playback
+    renderer.setSource(newSource.get(), sourceSampleRate, trackId);
+
+    // The renderer drops the loop of the previous track
+    loopInSeconds = -1.0;
+    beatLoopActive = false;
+
+    // Only streamed tracks can underrun
+    readAheadSource = dynamic_cast<ReadAheadAudioSource*>(newSource.get());
+    trackSourceSampleRate = sourceSampleRate;
+
+    // Pass ownership of the track source to class scope variable to keep playing it
+    trackSource = std::move(newSource);
+}
+
+/**
+ * Have a streamed track read the audio at a position before the audio thread jumps there, called on the message thread
+ *
+ * @param posInSecs                   Position the playhead is about to move to
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::prepareSeek(double posInSecs)
+{
+    // Tracks in memory can jump anywhere without waiting
+    if (readAheadSource == nullptr || trackSourceSampleRate <= 0.0)
+    {
+        return;
+    }
+
+    // If the disk is too slow the position command is still queued, and the jump waits for the background thread as before
+    readAheadSource->prepareSeek((int64)(jlimit(0.0, renderer.getLengthInSeconds(), posInSecs) * trackSourceSampleRate), 200);
+}
+
+/**
+ * Swap in the source prepared by a background load unless a newer load has been requested
+ *
+ * @param generation                  Load request that prepared the source
+ * @param onLoaded                    Called with true if the track was loaded
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::finishAsyncLoad(int generation, std::function<void(bool)> onLoaded)
+{
+    std::unique_ptr<PositionableAudioSource> newSource;
+    URL audioURL;
+    double sourceSampleRate;
+
+    {
+        const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType lock(loadedSourceLock);
+
+        if (generation != loadGeneration)
+        {
+            return;
+        }
+
+        newSource = std::move(loadedSource);
+        audioURL = loadedSourceURL;
+        sourceSampleRate = loadedSourceSampleRate;
+    }
+
+    const bool loaded = newSource != nullptr;
+
+    if (loaded)
+    {
+        swapInSource(std::move(newSource), sourceSampleRate, audioURL);
+    }
+
+    loadInProgress = false;
+
+    if (onLoaded != nullptr)
+    {
+        onLoaded(loaded);
+    }
+}
+
+/**
+ * Hand the source opened for the queued track to the renderer unless another track has been queued since
+ *
+ * @param generation                  Request that opened the source
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::finishPrepareNextTrack(int generation)
+{
+    std::unique_ptr<PositionableAudioSource> newSource;
+    double sourceSampleRate;
+
+    {
+        const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType lock(loadedSourceLock);
+
+        if (generation != nextTrackGeneration)
+        {
+            return;
+        }
+
+        newSource = std::move(preparedNextSource);
+        sourceSampleRate = preparedNextSourceSampleRate;
+    }
+
+    // A track that cannot be opened is loaded the usual way when the current one ends
+    if (newSource == nullptr)
+    {
+        nextTrackURL = URL();
+        return;
+    }
+
+    renderer.setNextSource(newSource.get(), sourceSampleRate);
+    nextTrackSource = std::move(newSource);
+    nextTrackSourceSampleRate = sourceSampleRate;
+}
+
+/**
+ * Detach and release the queued track, keeping it as the loaded track if the audio thread has already switched to it
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::discardNextTrack()
+{
+    // Cancel a queued track that is still being opened
+    ++nextTrackGeneration;
+    nextTrackURL = URL();
+
+    if (nextTrackSource == nullptr)
+    {
+        return;
+    }
+
+    // Once detached under the renderer's lock the audio thread can no longer switch to it
+    renderer.setNextSource(nullptr, 0.0);
+
+    if (!advanceToNextTrack())
+    {
+        nextTrackSource.reset();
+    }
+}
+
+/**
+ * Setter method that sets whether tracks are decoded fully into memory, applied when the next track loads
+ *
+ * @param shouldUseRam                 True to play tracks from memory, false to stream them from disk
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::setRamMode(bool shouldUseRam)
+{
+    ramMode = shouldUseRam;
+}
+
+/**
+ * Determine whether tracks are decoded fully into memory
+ *
+ * @param                              None
+ *
+ * @return                             True if RAM deck mode is enabled, false otherwise
+ */
+bool DJAudioPlayer::isRamMode() const
+{
+    return ramMode;
+}
+
+/**
+ * Setter method that sets whether speed changes keep the original pitch of the track
+ *
+ * @param shouldLockKey                True to time-stretch the track, false to let the pitch follow the speed
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::setKeyLock(bool shouldLockKey)
+{
+    commandQueue.push(DeckCommandQueue::Command::Type::setKeyLock, shouldLockKey ? 1.0 : 0.0);
+}
+
+/**
+ * Determine whether speed changes keep the original pitch of the track
+ *
+ * @param                              None
+ *
+ * @return                             True if key lock is enabled, false otherwise
+ */
+bool DJAudioPlayer::isKeyLockEnabled() const
+{
+    return renderer.isKeyLockEnabled();
+}
+
+/**
+ * Setter method that sets the interpolator used for the speed and sample rate conversion
+ *
+ * @param quality                      Interpolator to use, from cheap linear to windowed-sinc
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::setResamplerQuality(Resampler::Quality quality)
+{
+    commandQueue.push(DeckCommandQueue::Command::Type::setResamplerQuality, (double)(int)quality);
+}
+
+/**
+ * Getter method that retrieves the interpolator used for the speed and sample rate conversion
+ *
+ * @param                              None
+ *
+ * @return                             Interpolator in use
+ */
+Resampler::Quality DJAudioPlayer::getResamplerQuality() const
+{
+    return renderer.getResamplerQuality();
+}
+
+/**
+ * Setter method that sets the side of the crossfader the deck is mixed on
+ *
+ * @param side                         Side A, side B, or thru to ignore the crossfader
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::setCrossfaderSide(MixerBus::Side side)
+{
+    crossfaderSide = side;
+}
+
+/**
+ * Getter method that retrieves the side of the crossfader the deck is mixed on, safe to call from any thread
+ *
+ * @param                              None
+ *
+ * @return                             Side the mixer assigns the deck to
+ */
+MixerBus::Side DJAudioPlayer::getCrossfaderSide() const
+{
+    return crossfaderSide;
+}
+
+/**
+ * Setter method that sets the journal this deck's applied commands and track loads are recorded in, called before the audio device starts
+ *
+ * @param newJournal                   Journal to record in, or nullptr to stop journaling
+ * @param deckIndex                    Index of the deck in the collection
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::setControlJournal(ControlJournal* newJournal, int deckIndex)
+{
+    journal = newJournal;
+    journalDeck = deckIndex;
+}
+
+/**
+ * Apply a command read back from a control journal straight away, called between blocks while nothing is rendering
+ *
+ * @param command                      Command the deck applied in the journaled session
+ *
+ * @return                             None
+ */
+void DJAudioPlayer::applyJournaledCommand(const DeckCommandQueue::Command& command)
+{
+    applyCommand(command);
+}
+
+/**
+ * Journal the first block the renderer plays a newly swapped in track in, called while render holds the source lock
+ *
+ * @param sourceTag                   Track id the source was set with
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::sourceChanged(int sourceTag)
+{
+    // The load is journaled ahead of the commands drained after it, so a replay applies both in the same order
+    if (journal != nullptr)
+    {
+        journal->recordLoad(journalDeck, sourceTag);
+    }
+}
+
+/**
+ * Apply every parameter and transport command queued by the message thread, called while render holds the source lock
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::applyPendingCommands()
+{
+    // A journaled deck only takes commands on its first render of each callback, so every one takes effect on the sample it is stamped with,
+    // and a command pushed while the mixer is part way through a callback waits for the next one
+    if (journal != nullptr)
+    {
+        const int64 blockStart = journal->getBlockStart();
+
+        if (blockStart == lastCommandBlockStart)
+        {
+            return;
+        }
+
+        lastCommandBlockStart = blockStart;
+    }
+
+    DeckCommandQueue::Command command;
+
+    // Drain the queue in the order the user made the changes
+    while (commandQueue.pop(command))
+    {
+        applyCommand(command);
+
+        if (journal != nullptr)
+        {
+            journal->recordCommand(journalDeck, command);
+        }
+    }
+}
+
+/**
+ * Apply a single queued command to the audio sources on the audio thread
+ *
+ * @param command                     Command popped from the deck command queue
+ *
+ * @return                            None
+ */
+void DJAudioPlayer::applyCommand(const DeckCommandQueue::Command& command)
+{
+    switch (command.type)
+    {
+    case DeckCommandQueue::Command::Type::setGain:
+        renderer.setGain((float)command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setTrim:
+        renderer.setTrim((float)command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setSpeed:
+        renderer.setSpeed(command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setBandPassFrequency:
+        renderer.setBandPassFrequency(command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setLowPassFrequency:
+        renderer.setLowPassFrequency(command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setHighPassFrequency:
+        renderer.setHighPassFrequency(command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setKeyLock:
+        renderer.setKeyLock(command.value != 0.0);
+        break;
+    case DeckCommandQueue::Command::Type::setResamplerQuality:
+        renderer.setResamplerQuality((Resampler::Quality)(int)command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setLooping:
+        renderer.setLooping(command.value != 0.0);
+        break;
+    case DeckCommandQueue::Command::Type::setQueueOverlap:
+        renderer.setQueueOverlap(command.value);
+        break;
+    case DeckCommandQueue::Command::Type::setLoopStart:
+        pendingLoopStart = command.value;
+        break;
+    case DeckCommandQueue::Command::Type::setLoopEnd:
+        renderer.setLoopRegion(pendingLoopStart, command.value);
+        break;
+    case DeckCommandQueue::Command::Type::exitLoop:
+        renderer.clearLoopRegion();
+        break;
+    case DeckCommandQueue::Command::Type::setPosition:
+        renderer.setPosition(command.value);
+        break;
+    case DeckCommandQueue::Command::Type::movePosition:
+        // Keep the playhead between the start and end of the audio track
+        renderer.setPosition(jlimit(0.0, renderer.getLengthInSeconds(), renderer.getCurrentPosition() + command.value));
+        break;
+    case DeckCommandQueue::Command::Type::start:
+        renderer.start();
+        break;
+    case DeckCommandQueue::Command::Type::stop:
+        renderer.stop();
+        break;
+    default:
+        break;
+    }
+}
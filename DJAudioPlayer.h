@@ -11,10 +11,21 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "ControlJournal.h"
+#include "DeckCommandQueue.h"
+#include "DeckRenderer.h"
+#include "DeckStreamingPool.h"
+#include "DecodedTrackCache.h"
+#include "MixerBus.h"
+#include "MemoryTrackSource.h"
+#include "PcmDiskCache.h"
+#include "ReadAheadAudioSource.h"
+#include "RealtimeSafetyChecker.h"
 
 using namespace juce;
 
-class DJAudioPlayer : public AudioSource
+class DJAudioPlayer : public AudioSource,
+    private DeckRenderer::Controller
 {
 public:
     /**
@@ -65,7 +76,7 @@ public:
     void releaseResources() override;
 
     /**
-     * Create suitable reader for input stream to audio sources
+     * Create suitable reader for input stream to audio sources, blocking until it is ready
      *
      * @param audioURL                    URL used to create an input stream
      *
@@ -73,6 +84,61 @@ public:
      */
     void loadURL(URL audioURL);
 
+    /**
+     * Open and prepare a reader on a background thread, then swap it into the deck on the message thread
+     *
+     * @param audioURL                    URL used to create an input stream
+     * @param onLoaded                    Called on the message thread with true if the track was loaded, skipped if a newer load supersedes this one
+     *
+     * @return                            None
+     */
+    void loadURLAsync(URL audioURL, std::function<void(bool)> onLoaded = nullptr);
+
+    /**
+     * Determine whether a background load has been requested and has not finished yet
+     *
+     * @param                             None
+     *
+     * @return                            True if a track is loading, false otherwise
+     */
+    bool isLoading() const;
+
+    /**
+     * Open and pre-buffer the track that follows the loaded one on a background thread, so the audio thread can switch to it at the last sample
+     *
+     * @param audioURL                    URL of the queued track
+     *
+     * @return                            None
+     */
+    void prepareNextTrack(URL audioURL);
+
+    /**
+     * Take ownership of the queued track once the audio thread has switched to it, releasing the track that ended
+     *
+     * @param                             None
+     *
+     * @return                            True if the queued track has taken over since the last call, false otherwise
+     */
+    bool advanceToNextTrack();
+
+    /**
+     * Check whether the track has ended or the queued track has taken over since the last check, polled by the deck interface
+     *
+     * @param                             None
+     *
+     * @return                            True if either happened since the last call, false otherwise
+     */
+    bool consumeTrackEvents();
+
+    /**
+     * Setter method that sets how long the end of each track overlaps the start of the queued track
+     *
+     * @param seconds                     Length of the crossfade in seconds, or zero for gapless playback
+     *
+     * @return                            None
+     */
+    void setQueueOverlapSeconds(double seconds);
+
     /**
      * Getter method that retrieves the relative position of the playhead
      *
@@ -200,16 +266,194 @@ public:
     void stop();
 
     /**
-    * Determine whether the audio track has ended
+     * Play the audio track from the next sample rendered, called on the audio thread between two parts of a block
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void startImmediately();
+
+    /**
+     * Stop the audio track with a fade over the next block, called on the audio thread
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void stopImmediately();
+
+    /**
+     * Determine whether the deck is currently producing audio
+     *
+     * @param                             None
+     *
+     * @return                            True if the audio track is playing, false otherwise
+     */
+    bool isPlaying() const;
+
+    /**
+     * Getter method that retrieves the playback speed, called on the audio thread
+     *
+     * @param                             None
+     *
+     * @return                            Playback speed where 1.0 is the original speed
+     */
+    double getSpeed() const;
+
+    /**
+     * Setter method that sets the beat grid of the loaded track, found by analysing it
+     *
+     * @param _beatsPerMinute             Tempo at the original speed, or zero if it is unknown
+     * @param _downbeatSeconds            Time of the first downbeat in the track
+     *
+     * @return                            None
+     */
+    void setBeatGrid(double _beatsPerMinute, double _downbeatSeconds);
+
+    /**
+     * Getter method that retrieves the tempo of the loaded track at its original speed, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Tempo in beats per minute, or zero if it is unknown
+     */
+    double getBeatsPerMinute() const;
+
+    /**
+     * Getter method that retrieves the time of the first downbeat of the loaded track, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Time in seconds from the start of the track
+     */
+    double getDownbeatSeconds() const;
+
+    /**
+     * Setter method that sets the trim of the loaded track from its loudness, bringing it towards the target loudness
+     *
+     * @param integratedLoudness          Integrated loudness of the track in LUFS
+     * @param truePeak                    True peak of the track in dBTP, which limits how far a quiet track is raised
+     *
+     * @return                            None
+     */
+    void setTrackLoudness(double integratedLoudness, double truePeak);
+
+    /**
+     * Setter method that sets the trim applied before the volume slider, ramped in the audio thread to avoid clicks
+     *
+     * @param decibels                    Trim in decibels, where zero leaves the track unchanged
+     *
+     * @return                            None
+     */
+    void setTrim(double decibels);
+
+    /**
+     * Getter method that retrieves the trim applied before the volume slider
+     *
+     * @param                             None
+     *
+     * @return                            Trim in decibels
+     */
+    double getTrim() const;
+
+    /**
+     * Mark the start of a beat loop at the beat nearest the playhead, leaving any loop that is playing
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void setLoopIn();
+
+    /**
+     * Close the beat loop at the beat nearest the playhead and start repeating it
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void setLoopOut();
+
+    /**
+     * Start repeating a number of beats from the beat nearest the playhead
+     *
+     * @param numBeats                    Length of the loop in beats, from a quarter of a beat to 32 beats
+     *
+     * @return                            None
+     */
+    void startAutoLoop(double numBeats);
+
+    /**
+     * Halve the length of the beat loop that is playing, keeping its start
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void halveLoop();
+
+    /**
+     * Double the length of the beat loop that is playing, keeping its start
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void doubleLoop();
+
+    /**
+     * Leave the beat loop and play on through its end
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void exitLoop();
+
+    /**
+     * Determine whether a beat loop is playing
+     *
+     * @param                             None
+     *
+     * @return                            True if a beat loop is active, false otherwise
+     */
+    bool isBeatLoopActive() const;
+
+    /**
+     * Getter method that retrieves the length of the beat loop
+     *
+     * @param                             None
+     *
+     * @return                            Length in beats of the loaded track, or zero if no loop is active
+     */
+    double getLoopLengthInBeats() const;
+
+    // Shortest and longest beat loops
+    static constexpr double minimumLoopBeats = 0.25;
+    static constexpr double maximumLoopBeats = 32.0;
+
+    // Tempo that beat loops assume for tracks without a beat grid
+    static constexpr double unknownTempoBeatsPerMinute = 120.0;
+
+    // Loudness that the trim brings every track to, and the true peak a raised track may reach
+    static constexpr double targetLoudness = -14.0;
+    static constexpr double truePeakCeiling = -1.0;
+
+    // Largest cut the trim applies to a loud track
+    static constexpr double maximumTrimCut = 12.0;
+
+    /**
+    * Determine whether the audio track has ended, which the audio thread also announces with a change message
     *
     * @param                              None
     *
-    * @return                             True if the track has ended, false otherwise
+    * @return                             True if the last sample of the track has been played, false otherwise
     */
     bool finishedPlaying();
 
     /**
-    * Loop the audio source
+    * Loop the audio source seamlessly at its last sample, or stop looping it
     *
     * @param                              None
     *
@@ -226,26 +470,306 @@ public:
     */
     bool isLooping();
 
+    /**
+    * Setter method that sets how much audio this deck reads ahead of its playhead, applied when the next track loads
+    *
+    * @param seconds                      Read ahead in seconds, or zero to use the streaming pool default
+    *
+    * @return                             None
+    */
+    void setReadAheadSeconds(double seconds);
+
+    /**
+    * Getter method that retrieves the buffer underrun counters of the loaded track
+    *
+    * @param                              None
+    *
+    * @return                             Streaming statistics, all zero if no track is loaded
+    */
+    ReadAheadAudioSource::Statistics getStreamingStatistics() const;
+
+    /**
+    * Setter method that sets whether tracks are decoded fully into memory, applied when the next track loads
+    *
+    * @param shouldUseRam                 True to play tracks from memory, false to stream them from disk
+    *
+    * @return                             None
+    */
+    void setRamMode(bool shouldUseRam);
+
+    /**
+    * Determine whether tracks are decoded fully into memory
+    *
+    * @param                              None
+    *
+    * @return                             True if RAM deck mode is enabled, false otherwise
+    */
+    bool isRamMode() const;
+
+    /**
+    * Setter method that sets whether speed changes keep the original pitch of the track
+    *
+    * @param shouldLockKey                True to time-stretch the track, false to let the pitch follow the speed
+    *
+    * @return                             None
+    */
+    void setKeyLock(bool shouldLockKey);
+
+    /**
+    * Determine whether speed changes keep the original pitch of the track
+    *
+    * @param                              None
+    *
+    * @return                             True if key lock is enabled, false otherwise
+    */
+    bool isKeyLockEnabled() const;
+
+    /**
+    * Setter method that sets the interpolator used for the speed and sample rate conversion
+    *
+    * @param quality                      Interpolator to use, from cheap linear to windowed-sinc
+    *
+    * @return                             None
+    */
+    void setResamplerQuality(Resampler::Quality quality);
+
+    /**
+    * Getter method that retrieves the interpolator used for the speed and sample rate conversion
+    *
+    * @param                              None
+    *
+    * @return                             Interpolator in use
+    */
+    Resampler::Quality getResamplerQuality() const;
+
+    /**
+    * Setter method that sets the side of the crossfader the deck is mixed on
+    *
+    * @param side                         Side A, side B, or thru to ignore the crossfader
+    *
+    * @return                             None
+    */
+    void setCrossfaderSide(MixerBus::Side side);
+
+    /**
+    * Getter method that retrieves the side of the crossfader the deck is mixed on, safe to call from any thread
+    *
+    * @param                              None
+    *
+    * @return                             Side the mixer assigns the deck to
+    */
+    MixerBus::Side getCrossfaderSide() const;
+
+    /**
+    * Setter method that sets the journal this deck's applied commands and track loads are recorded in, called before the audio device starts
+    *
+    * @param newJournal                   Journal to record in, or nullptr to stop journaling
+    * @param deckIndex                    Index of the deck in the collection
+    *
+    * @return                             None
+    */
+    void setControlJournal(ControlJournal* newJournal, int deckIndex);
+
+    /**
+    * Apply a command read back from a control journal straight away, called between blocks while nothing is rendering
+    *
+    * @param command                      Command the deck applied in the journaled session
+    *
+    * @return                             None
+    */
+    void applyJournaledCommand(const DeckCommandQueue::Command& command);
+
 private:
+    /**
+     * Journal the first block the renderer plays a newly swapped in track in, called while render holds the source lock
+     *
+     * @param sourceTag                   Track id the source was set with
+     *
+     * @return                            None
+     */
+    void sourceChanged(int sourceTag) override;
+
+    /**
+     * Apply every parameter and transport command queued by the message thread, called while render holds the source lock
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void applyPendingCommands() override;
+
+    /**
+     * Apply a single queued command to the audio sources on the audio thread
+     *
+     * @param command                     Command popped from the deck command queue
+     *
+     * @return                            None
+     */
+    void applyCommand(const DeckCommandQueue::Command& command);
+
+    /**
+     * Getter method that retrieves the length of one beat of the loaded track at its original speed
+     *
+     * @param                             None
+     *
+     * @return                            Beat length in seconds
+     */
+    double getBeatSeconds() const;
+
+    /**
+     * Move a position in the loaded track to the nearest beat of its beat grid, unchanged if the track has no beat grid
+     *
+     * @param seconds                     Position in seconds
+     *
+     * @return                            Position of the nearest beat in seconds
+     */
+    double snapToBeat(double seconds) const;
+
+    /**
+     * Send the beat loop to the audio thread, which starts repeating it or changes the loop already playing
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void applyBeatLoop();
+
+    /**
+     * Open an audio track as a streaming source, or as a decoded track in RAM deck mode, prepared for the current audio device
+     *
+     * @param audioURL                    URL used to create an input stream
+     * @param sourceSampleRate            Receives the sample rate of the audio track
+     * @param generation                  Load request that wants the track, decoding stops early once it is superseded
+     *
+     * @return                            Prepared source owned by the caller, or nullptr if no format could read the track
+     */
+    PositionableAudioSource* createTrackSource(URL audioURL, double& sourceSampleRate, int generation);
+
+    /**
+     * Swap a prepared source into the renderer and release the previous one, called on the message thread
+     *
+     * @param newSource                   Prepared source to play
+     * @param sourceSampleRate            Sample rate of the audio track
+     * @param audioURL                    URL the source was opened from
+     *
+     * @return                            None
+     */
+    void swapInSource(std::unique_ptr<PositionableAudioSource> newSource, double sourceSampleRate, const URL& audioURL);
+
+    /**
+     * Have a streamed track read the audio at a position before the audio thread jumps there, called on the message thread
+     *
+     * @param posInSecs                   Position the playhead is about to move to
+     *
+     * @return                            None
+     */
+    void prepareSeek(double posInSecs);
+
+    /**
+     * Swap in the source prepared by a background load unless a newer load has been requested
+     *
+     * @param generation                  Load request that prepared the source
+     * @param onLoaded                    Called with true if the track was loaded
+     *
+     * @return                            None
+     */
+    void finishAsyncLoad(int generation, std::function<void(bool)> onLoaded);
+
+    /**
+     * Hand the source opened for the queued track to the renderer unless another track has been queued since
+     *
+     * @param generation                  Request that opened the source
+     *
+     * @return                            None
+     */
+    void finishPrepareNextTrack(int generation);
+
+    /**
+     * Detach and release the queued track, keeping it as the loaded track if the audio thread has already switched to it
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void discardNextTrack();
+
     AudioFormatManager& formatManager;
-    std::unique_ptr<AudioFormatReaderSource> readerSource;
 
-    // Apply multiple audio filters to the audio source by chaining them sequentially
+    // Disk streaming threads shared by every deck
+    SharedResourcePointer<DeckStreamingPool> streamingPool;
+    double readAheadSeconds;
+
+    // Recently decoded tracks shared by every deck in RAM deck mode
+    SharedResourcePointer<DecodedTrackCache> decodedTrackCache;
+    std::atomic<bool> ramMode;
 
-    // Chain the source that enables playback control into the source that enables sample rate modification 
-    AudioTransportSource transportSource;
-    ResamplingAudioSource resampleSource{ &transportSource, false, 2 };
+    // Decoded copies of library tracks that are played through memory mapped readers
+    SharedResourcePointer<PcmDiskCache> pcmDiskCache;
 
-    // Chain sources that apply signal attenuation at varying frequencies into one another 
-    IIRFilterAudioSource bandIIRFilterSource{ &resampleSource, false };
-    IIRFilterAudioSource lowIIRFilterSource{ &bandIIRFilterSource, false };
-    IIRFilterAudioSource highIIRFilterSource{ &lowIIRFilterSource, false };
+    // Source of the loaded track, and the same source if it is streamed from disk
+    std::unique_ptr<PositionableAudioSource> trackSource;
+    ReadAheadAudioSource* readAheadSource;
+    double trackSourceSampleRate;
 
-    double bandPassFrequency;
-    double lowPassFrequency;
-    double highPassFrequency;
+    // Source of the queued track that the renderer switches to at the end of the loaded track
+    std::unique_ptr<PositionableAudioSource> nextTrackSource;
+    double nextTrackSourceSampleRate;
+    URL nextTrackURL;
 
-    double currentSampleRate;
+    // Read, resample, filter and apply gain to the audio track in a single pass per block
+    DeckRenderer renderer;
+
+    // Written by the audio thread and read by the loading thread
+    std::atomic<double> currentSampleRate;
+    std::atomic<int> currentBlockSize;
     bool loopTrackAudio;
+
+    // Beat grid of the loaded track, set by the deck interface and read by the mixer
+    std::atomic<double> beatsPerMinute;
+    std::atomic<double> downbeatSeconds;
+
+    // Trim of the loaded track in decibels, set by the deck interface
+    std::atomic<double> trimDecibels;
+
+    // Channel assignment set by the deck interface and read by the mixer every section
+    std::atomic<MixerBus::Side> crossfaderSide;
+
+    // Beat loop set on the message thread, where loopInSeconds is -1 until a loop start is marked
+    double loopInSeconds;
+    double loopOutSeconds;
+    bool beatLoopActive;
+
+    // Loop start received by the audio thread, waiting for the loop end that follows it in the queue
+    double pendingLoopStart;
+
+    // Commands pushed by the deck user interface and drained by the audio callback
+    DeckCommandQueue commandQueue;
+
+    // Records the commands the audio thread applies and the tracks it starts playing, if the session is journaled
+    ControlJournal* journal;
+    int journalDeck;
+
+    // Callback the queue was last drained in, since a deck renders in several sections of a callback but its commands are journaled at the start
+    int64 lastCommandBlockStart;
+
+    // Incremented by every load so that a newer request cancels an older one
+    std::atomic<int> loadGeneration;
+    bool loadInProgress;
+
+    // Source prepared by the loading thread, waiting to be swapped in on the message thread
+    RealtimeSafetyChecker::CheckedCriticalSection loadedSourceLock{ "DJAudioPlayer::loadedSourceLock" };
+    std::unique_ptr<PositionableAudioSource> loadedSource;
+    URL loadedSourceURL;
+    double loadedSourceSampleRate;
+
+    // Incremented whenever a different track is queued, guarded by the same lock while it is handed over
+    std::atomic<int> nextTrackGeneration;
+    std::unique_ptr<PositionableAudioSource> preparedNextSource;
+    double preparedNextSourceSampleRate;
+
+    // Opens tracks off the message thread, destroyed first so no job outlives the deck
+    ThreadPool loadingPool{ 1 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(DJAudioPlayer)
 };
 
@@ -18,7 +18,7 @@
  *
  * @return                        None
  */
-DataSorter::DataSorter(String& attributeToSortBy, bool forwards) : attributeToSort(attributeToSortBy), direction(forwards ? 1 : -1)
+DataSorter::DataSorter(const String& attributeToSortBy, bool forwards) : attributeToSort(attributeToSortBy), direction(forwards ? 1 : -1)
 {
 }
 
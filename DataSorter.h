@@ -25,7 +25,7 @@ public:
     *
     * @return                        None
     */
-    DataSorter(String& attributeToSortBy, bool forwards);
+    DataSorter(const String& attributeToSortBy, bool forwards);
 
     /**
     * Sort two XML elements based on a sorting attribute comparator
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    DeckCollection.cpp
+    Created: 17 Oct 2026 12:21:05am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "DeckCollection.h"
+
+constexpr int DeckCollection::minimumDecks;
+constexpr int DeckCollection::maximumDecks;
+
+/**
+ * Constructor that creates the decks, assigning odd decks to side A of the crossfader and even decks to side B
+ *
+ * @param formatManager               Format manager shared by every deck
+ * @param numDecks                    Number of decks, between minimumDecks and maximumDecks
+ *
+ * @return                            None
+ */
+DeckCollection::DeckCollection(AudioFormatManager& formatManager, int numDecks)
+{
+    for (int i = 0; i < jlimit(minimumDecks, maximumDecks, numDecks); ++i)
+    {
+        auto* deck = decks.add(new DJAudioPlayer(formatManager));
+        deck->setCrossfaderSide(i % 2 == 0 ? MixerBus::Side::a : MixerBus::Side::b);
+    }
+}
+
+/**
+ * Destructor that deletes the decks
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DeckCollection::~DeckCollection()
+{
+}
+
+/**
+ * Getter method that retrieves the number of decks
+ *
+ * @param                             None
+ *
+ * @return                            Number of decks
+ */
+int DeckCollection::getNumDecks() const
+{
+    return decks.size();
+}
+
+/**
+ * Getter method that retrieves one deck
+ *
+ * @param index                       Index of the deck, from zero
+ *
+ * @return                            Audio player of the deck
+ */
+DJAudioPlayer& DeckCollection::getDeck(int index) const
+{
+    return *decks.getUnchecked(index);
+}
+
+/**
+ * Move every deck into its prepared state before the mixer fetches blocks from them
+ *
+ * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is rendered
+ * @param sampleRate                  Number of sound samples taken per second by the audio device
+ *
+ * @return                            None
+ */
+void DeckCollection::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    for (auto* deck : decks)
+    {
+        deck->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+}
+
+/**
+ * Allow every deck to release anything it no longer needs after playback has stopped
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckCollection::releaseResources()
+{
+    for (auto* deck : decks)
+    {
+        deck->releaseResources();
+    }
+}
+
+/**
+ * Getter method that retrieves the number of decks to create when none is given
+ *
+ * @param                             None
+ *
+ * @return                            Count from the --decks argument, or two
+ */
+int DeckCollection::getDefaultNumDecks()
+{
+    const StringArray arguments = JUCEApplicationBase::getCommandLineParameterArray();
+    const int argumentIndex = arguments.indexOf("--decks");
+
+    if (argumentIndex >= 0 && argumentIndex + 1 < arguments.size())
+    {
+        return jlimit(minimumDecks, maximumDecks, arguments[argumentIndex + 1].getIntValue());
+    }
+
+    return minimumDecks;
+}
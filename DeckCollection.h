@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    DeckCollection.h
+    Created: 17 Oct 2026 12:21:05am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DJAudioPlayer.h"
+
+using namespace juce;
+
+class DeckCollection
+{
+public:
+    /**
+     * Constructor that creates the decks, assigning odd decks to side A of the crossfader and even decks to side B
+     *
+     * @param formatManager               Format manager shared by every deck
+     * @param numDecks                    Number of decks, between minimumDecks and maximumDecks
+     *
+     * @return                            None
+     */
+    DeckCollection(AudioFormatManager& formatManager, int numDecks);
+
+    /**
+     * Destructor that deletes the decks
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~DeckCollection();
+
+    /**
+     * Getter method that retrieves the number of decks
+     *
+     * @param                             None
+     *
+     * @return                            Number of decks
+     */
+    int getNumDecks() const;
+
+    /**
+     * Getter method that retrieves one deck
+     *
+     * @param index                       Index of the deck, from zero
+     *
+     * @return                            Audio player of the deck
+     */
+    DJAudioPlayer& getDeck(int index) const;
+
+    /**
+     * Move every deck into its prepared state before the mixer fetches blocks from them
+     *
+     * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is rendered
+     * @param sampleRate                  Number of sound samples taken per second by the audio device
+     *
+     * @return                            None
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /**
+     * Allow every deck to release anything it no longer needs after playback has stopped
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void releaseResources();
+
+    /**
+     * Getter method that retrieves the number of decks to create when none is given
+     *
+     * @param                             None
+     *
+     * @return                            Count from the --decks argument, or two
+     */
+    static int getDefaultNumDecks();
+
+    // Auto-mix needs a pair of decks, and eight fill the window
+    static constexpr int minimumDecks = 2;
+    static constexpr int maximumDecks = 8;
+
+private:
+    OwnedArray<DJAudioPlayer> decks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckCollection)
+};
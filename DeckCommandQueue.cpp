@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.cpp
+    Created: 16 Oct 2026 9:12:40am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "DeckCommandQueue.h"
+
+/**
+ * Constructor that preallocates storage for the commands so that pushing and popping never allocates
+ *
+ * @param capacity                Maximum number of commands that can be pending at once
+ *
+ * @return                        None
+ */
+DeckCommandQueue::DeckCommandQueue(int capacity) : fifo(capacity), commands((size_t)capacity)
+{
+}
+
+/**
+ * Destructor for the command queue
+ *
+ * @param                         None
+ *
+ * @return                        None
+ */
+DeckCommandQueue::~DeckCommandQueue()
+{
+}
+
+/**
+ * Add a command to the queue, called only from the message thread
+ *
+ * @param type                    Kind of change to apply
+ * @param value                   Value associated with the change
+ *
+ * @return                        True if the command was queued, false if the queue is full
+ */
+bool DeckCommandQueue::push(Command::Type type, double value)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    // Queue is full, so the audio thread has stopped draining it
+    if (size1 + size2 == 0)
+    {
+        return false;
+    }
+
+    // Write into whichever block of the ring has a free slot
+    Command& slot = size1 > 0 ? commands[(size_t)start1] : commands[(size_t)start2];
+    slot.type = type;
+    slot.value = value;
+
+    // Publish the command to the audio thread
+    fifo.finishedWrite(1);
+    return true;
+}
+
+/**
+ * Remove the oldest pending command from the queue, called only from the audio thread
+ *
+ * @param command                 Command that receives the popped value
+ *
+ * @return                        True if a command was popped, false if the queue is empty
+ */
+bool DeckCommandQueue::pop(Command& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+    {
+        return false;
+    }
+
+    command = size1 > 0 ? commands[(size_t)start1] : commands[(size_t)start2];
+
+    // Release the slot back to the message thread
+    fifo.finishedRead(1);
+    return true;
+}
+
+/**
+ * Getter method that retrieves the number of commands waiting to be applied
+ *
+ * @param                         None
+ *
+ * @return                        Number of pending commands
+ */
+int DeckCommandQueue::getNumPending() const
+{
+    return fifo.getNumReady();
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.h
+    Created: 16 Oct 2026 9:12:40am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class DeckCommandQueue
+{
+public:
+    /** Parameter or transport change that is applied to a deck at the start of an audio block */
+    struct Command
+    {
+        enum class Type
+        {
+            setGain,
+            setTrim,
+            setSpeed,
+            setBandPassFrequency,
+            setLowPassFrequency,
+            setHighPassFrequency,
+            setKeyLock,
+            setResamplerQuality,
+            setLooping,
+            setQueueOverlap,
+            setLoopStart,
+            setLoopEnd,
+            exitLoop,
+            setPosition,
+            movePosition,
+            start,
+            stop
+        };
+
+        // Kind of change to apply
+        Type type;
+
+        // Gain, trim, ratio, frequency, switch state, quality, overlap, loop boundary or position in seconds depending on the command type
+        double value;
+    };
+
+    /**
+     * Constructor that preallocates storage for the commands so that pushing and popping never allocates
+     *
+     * @param capacity                Maximum number of commands that can be pending at once
+     *
+     * @return                        None
+     */
+    DeckCommandQueue(int capacity = 512);
+
+    /**
+     * Destructor for the command queue
+     *
+     * @param                         None
+     *
+     * @return                        None
+     */
+    ~DeckCommandQueue();
+
+    /**
+     * Add a command to the queue, called only from the message thread
+     *
+     * @param type                    Kind of change to apply
+     * @param value                   Value associated with the change
+     *
+     * @return                        True if the command was queued, false if the queue is full
+     */
+    bool push(Command::Type type, double value = 0.0);
+
+    /**
+     * Remove the oldest pending command from the queue, called only from the audio thread
+     *
+     * @param command                 Command that receives the popped value
+     *
+     * @return                        True if a command was popped, false if the queue is empty
+     */
+    bool pop(Command& command);
+
+    /**
+     * Getter method that retrieves the number of commands waiting to be applied
+     *
+     * @param                         None
+     *
+     * @return                        Number of pending commands
+     */
+    int getNumPending() const;
+
+private:
+    // Wait-free single producer, single consumer index management
+    AbstractFifo fifo;
+
+    // Preallocated command storage indexed by the FIFO
+    std::vector<Command> commands;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckCommandQueue)
+};
@@ -30,7 +30,10 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 	: player(_player),
 	waveformDisplay(formatManagerToUse, cacheToUse),
 	playlistComponent(_playlistComponent),
-	rotationAngle(0.0)
+	rotationAngle(0.0),
+	lastUnderrunCount(0),
+	lastSeekGapCount(0),
+	analysisPending(false)
 {
 	// Load transport and vinyl graphics from in-memory image file or cache
 	playButtonGraphic = ImageCache::getFromMemory(BinaryData::playButton_png, BinaryData::playButton_pngSize);
@@ -118,6 +121,53 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 	songPositionLabel.setJustificationType(Justification::bottomRight);
 	songPositionLabel.setFont(Font(11.0f));
 
+	// Add a toggle to the right of the 'DJ deck' label to play tracks fully decoded from memory
+	addAndMakeVisible(ramModeToggle);
+	ramModeToggle.setTooltip("Decode tracks into memory for instant seeking, applied to the next track loaded");
+
+	// Add a toggle beside it to keep the pitch of the track when the speed changes
+	addAndMakeVisible(keyLockToggle);
+	keyLockToggle.setTooltip("Time-stretch the track so that changing the speed does not change its pitch");
+
+	// Add a menu beside the toggles to trade resampling quality against CPU when the speed or sample rate changes
+	addAndMakeVisible(resamplerQualityBox);
+	for (auto quality : { Resampler::Quality::linear, Resampler::Quality::lagrange, Resampler::Quality::sinc })
+	{
+		resamplerQualityBox.addItem(Resampler::getQualityName(quality), (int)quality + 1);
+	}
+	resamplerQualityBox.setSelectedId((int)player->getResamplerQuality() + 1, dontSendNotification);
+	resamplerQualityBox.setTooltip("Linear is cheapest, Sinc has the least aliasing");
+	resamplerQualityBox.onChange = [this]
+	{ player->setResamplerQuality((Resampler::Quality)(resamplerQualityBox.getSelectedId() - 1)); };
+
+	// Add a menu beside the load buttons that assigns the deck to a side of the crossfader, where the item ID is the side plus one
+	addAndMakeVisible(crossfaderSideBox);
+	for (auto side : { MixerBus::Side::a, MixerBus::Side::b, MixerBus::Side::thru })
+	{
+		crossfaderSideBox.addItem(MixerBus::getSideName(side), (int)side + 1);
+	}
+	crossfaderSideBox.setSelectedId((int)player->getCrossfaderSide() + 1, dontSendNotification);
+	crossfaderSideBox.setTooltip("Side of the crossfader the deck is mixed on, where Thru ignores the crossfader");
+	crossfaderSideBox.onChange = [this]
+	{ player->setCrossfaderSide((MixerBus::Side)(crossfaderSideBox.getSelectedId() - 1)); };
+
+	// Add beat loop controls below the transport buttons, where the menu holds the auto loop length in beats
+	addAndMakeVisible(loopInButton);
+	addAndMakeVisible(loopOutButton);
+	addAndMakeVisible(autoLoopBox);
+	addAndMakeVisible(autoLoopButton);
+	addAndMakeVisible(halveLoopButton);
+	addAndMakeVisible(doubleLoopButton);
+	addAndMakeVisible(exitLoopButton);
+	for (auto lengthName : { "1/4", "1/2", "1", "2", "4", "8", "16", "32" })
+	{
+		autoLoopBox.addItem(lengthName, autoLoopBox.getNumItems() + 1);
+	}
+	autoLoopBox.setSelectedId(5, dontSendNotification);
+	loopInButton.setTooltip("Mark the start of a loop at the nearest beat");
+	loopOutButton.setTooltip("Close the loop at the nearest beat and start repeating it");
+	autoLoopButton.setTooltip("Repeat the number of beats in the menu from the nearest beat");
+
 	// Make sliders for frequency attention filters into rotary dials
 	bandPassSlider.setSliderStyle(Slider::SliderStyle::RotaryHorizontalVerticalDrag);
 	lowPassSlider.setSliderStyle(Slider::SliderStyle::RotaryHorizontalVerticalDrag);
@@ -199,6 +249,8 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 	// Register listeners to receive events when the state of sliders and buttons change
 	loadButton.addListener(this);
 	queueTrackButton.addListener(this);
+	ramModeToggle.addListener(this);
+	keyLockToggle.addListener(this);
 	volSlider.addListener(this);
 	speedSlider.addListener(this);
 	bandPassSlider.addListener(this);
@@ -210,6 +262,12 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 	playFirstCueButton.addListener(this);
 	playSecondCueButton.addListener(this);
 	playThirdCueButton.addListener(this);
+	loopInButton.addListener(this);
+	loopOutButton.addListener(this);
+	autoLoopButton.addListener(this);
+	halveLoopButton.addListener(this);
+	doubleLoopButton.addListener(this);
+	exitLoopButton.addListener(this);
 
 	// Ensure mouse events in the waveform display trigger changes in the waveform color before and after playhead
 	waveformDisplay.addChangeListener(this);
@@ -227,7 +285,7 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 	bandPassSlider.setValue(500.0);
 	bandPassSlider.setTextValueSuffix(" Hz");
 
-	lowPassSlider.setRange(20.0, 8000.0, 1);
+	lowPassSlider.setRange(20.0, 20000.0, 1);
 	lowPassSlider.setValue(20000.0);
 	lowPassSlider.setTextValueSuffix(" Hz");
 
@@ -237,7 +295,7 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 
 	// Enable double clicks to return to default dial value
 	bandPassSlider.setDoubleClickReturnValue(true, 500.0);
-	lowPassSlider.setDoubleClickReturnValue(true, 8000.0);
+	lowPassSlider.setDoubleClickReturnValue(true, 20000.0);
 	highPassSlider.setDoubleClickReturnValue(true, 20.0);
 	speedSlider.setDoubleClickReturnValue(true, 1.0);
 
@@ -280,17 +338,17 @@ void DeckGUI::paint(Graphics& g)
 	g.drawRect(Component::getWidth() * 35.85 / 42, Component::getHeight() / 13, Component::getWidth() / 8, Component::getHeight() / 13 * 3.8, 2);
 
 	// Draw transport controls in a line below the waveform display and gain control
-	g.drawImageWithin(playButtonGraphic, 25, 150, 35, 35, RectanglePlacement());
-	g.drawImageWithin(pauseButtonGraphic, 90, 150, 35, 35, RectanglePlacement());
-	g.drawImageWithin(stopButtonGraphic, 155, 150, 35, 35, RectanglePlacement());
-	g.drawImageWithin(rewindButtonGraphic, 25, 195, 35, 35, RectanglePlacement());
-	g.drawImageWithin(fastForwardButtonGraphic, 90, 195, 35, 35, RectanglePlacement());
-	g.drawImageWithin(loopButtonGraphic, 155, 195, 35, 35, RectanglePlacement());
+	g.drawImageWithin(playButtonGraphic, 25, 148, 35, 35, RectanglePlacement());
+	g.drawImageWithin(pauseButtonGraphic, 90, 148, 35, 35, RectanglePlacement());
+	g.drawImageWithin(stopButtonGraphic, 155, 148, 35, 35, RectanglePlacement());
+	g.drawImageWithin(rewindButtonGraphic, 25, 186, 35, 35, RectanglePlacement());
+	g.drawImageWithin(fastForwardButtonGraphic, 90, 186, 35, 35, RectanglePlacement());
+	g.drawImageWithin(loopButtonGraphic, 155, 186, 35, 35, RectanglePlacement());
 
 	// Draw play cue graphics in a vertical line to the right of the 'Cue' buttons
-	g.drawImageWithin(firstCuePlayer, 405, 150, 40, 23, RectanglePlacement());
-	g.drawImageWithin(secondCuePlayer, 405, 178, 40, 23, RectanglePlacement());
-	g.drawImageWithin(thirdCuePlayer, 405, 206, 40, 23, RectanglePlacement());
+	g.drawImageWithin(firstCuePlayer, 405, 148, 40, 22, RectanglePlacement());
+	g.drawImageWithin(secondCuePlayer, 405, 173, 40, 22, RectanglePlacement());
+	g.drawImageWithin(thirdCuePlayer, 405, 198, 40, 22, RectanglePlacement());
 
 	// Draw the vinyl to the right of the loaded audio track
 	g.drawImageWithin(vinylGraphic, 72, 14, 18, 18, RectanglePlacement());
@@ -313,29 +371,42 @@ void DeckGUI::resized()
 	double rowH = getHeight() / 13;
 
 	waveformDisplay.setBounds(10, rowH * 2, getWidth() * 0.83 - 10, rowH * 2.8);
-	playImageButton.setBounds(25, 150, 35, 35);
-	pauseImageButton.setBounds(90, 150, 35, 35);
-	stopImageButton.setBounds(155, 150, 35, 35);
-	rewindImageButton.setBounds(25, 195, 35, 35);
-	fastForwardImageButton.setBounds(90, 195, 35, 35);
-	loopImageButton.setBounds(155, 195, 35, 35);
-	playlistQueue.setBounds(225, 150, 130, 85);
+	playImageButton.setBounds(25, 148, 35, 35);
+	pauseImageButton.setBounds(90, 148, 35, 35);
+	stopImageButton.setBounds(155, 148, 35, 35);
+	rewindImageButton.setBounds(25, 186, 35, 35);
+	fastForwardImageButton.setBounds(90, 186, 35, 35);
+	loopImageButton.setBounds(155, 186, 35, 35);
+	playlistQueue.setBounds(225, 148, 130, 73);
 
 	// Position the 'Cue' buttons and cue marker icons to the right of the playlist queue
-	firstCueMarker.setBounds(365, 150, 40, 23);
-	secondCueMarker.setBounds(365, 178, 40, 23);
-	thirdCueMarker.setBounds(365, 206, 40, 23);
-	playFirstCueButton.setBounds(405, 150, 40, 23);
-	playSecondCueButton.setBounds(405, 178, 40, 23);
-	playThirdCueButton.setBounds(405, 206, 40, 23);
+	firstCueMarker.setBounds(365, 148, 40, 22);
+	secondCueMarker.setBounds(365, 173, 40, 22);
+	thirdCueMarker.setBounds(365, 198, 40, 22);
+	playFirstCueButton.setBounds(405, 148, 40, 22);
+	playSecondCueButton.setBounds(405, 173, 40, 22);
+	playThirdCueButton.setBounds(405, 198, 40, 22);
+
+	// Position the beat loop controls in a row below the transport buttons, clear of the dial labels
+	loopInButton.setBounds(25, 225, 45, 20);
+	loopOutButton.setBounds(75, 225, 45, 20);
+	autoLoopBox.setBounds(125, 225, 60, 20);
+	autoLoopButton.setBounds(190, 225, 50, 20);
+	halveLoopButton.setBounds(245, 225, 40, 20);
+	doubleLoopButton.setBounds(290, 225, 40, 20);
+	exitLoopButton.setBounds(335, 225, 50, 20);
 
 	volSlider.setBounds(getWidth() * 35.85 / 42, rowH, getWidth() / 8, rowH * 3.8);
 	bandPassSlider.setBounds(border, rowH * 8.8 + border, dialWidth, dialHeight);
 	lowPassSlider.setBounds(getWidth() / 4 + border, rowH * 8.8 + border, dialWidth, dialHeight);
 	highPassSlider.setBounds(getWidth() * 2 / 4 + border, rowH * 8.8 + border, dialWidth, dialHeight);
 	speedSlider.setBounds(getWidth() * 3 / 4 + border, rowH * 8.8 + border, dialWidth, dialHeight);
-	loadButton.setBounds(10, rowH * 11.6, getWidth() / 2 - 15, rowH * 1.2);
-	queueTrackButton.setBounds(getWidth() / 2 + 4, rowH * 11.6, getWidth() / 2 - 15, rowH * 1.2);
+	loadButton.setBounds(10, rowH * 11.6, getWidth() * 2 / 5 - 12, rowH * 1.2);
+	queueTrackButton.setBounds(getWidth() * 2 / 5 + 4, rowH * 11.6, getWidth() * 2 / 5 - 12, rowH * 1.2);
+	crossfaderSideBox.setBounds(getWidth() * 4 / 5, rowH * 11.6, getWidth() / 5 - 10, rowH * 1.2);
+	ramModeToggle.setBounds(getWidth() * 0.83 - 70, 12, 60, 22);
+	keyLockToggle.setBounds(getWidth() * 0.83 - 160, 12, 85, 22);
+	resamplerQualityBox.setBounds(getWidth() * 0.83 - 260, 12, 95, 22);
 }
 
 /**
@@ -359,17 +430,18 @@ void DeckGUI::buttonClicked(Button* button)
 	{
 		File selectedFile = playlistComponent->getSelectedPath();
 
-		// Load URL into audio player
-		player->loadURL(URL{ selectedFile });
-
-		// Display waveform of audio file
-		waveformDisplay.loadURL(URL{ selectedFile });
-
-		// Update audio track title
-		songTitleLabel.setText(selectedFile.getFileNameWithoutExtension(), dontSendNotification);
-
-		// Update audio track length
-		songLengthLabel.setText(playlistComponent->formatSongLength(playlistComponent->getSongLength(selectedFile)), dontSendNotification);
+		// Load URL into audio player without blocking the user interface
+		loadTrack(selectedFile);
+	}
+	if (button == &ramModeToggle)
+	{
+		// Takes effect when the next track is loaded
+		player->setRamMode(ramModeToggle.getToggleState());
+	}
+	if (button == &keyLockToggle)
+	{
+		// Applied on the audio thread from the current playhead
+		player->setKeyLock(keyLockToggle.getToggleState());
 	}
 	if (button == &queueTrackButton)
 	{
@@ -386,6 +458,10 @@ void DeckGUI::buttonClicked(Button* button)
 
 		// Queue track to be played
 		playlistQueue.enqueueTrack(selectedRowMetaData);
+		prepareQueuedTrack();
+
+		// Have the beat grid ready by the time the track is played, ahead of the rest of the library
+		playlistComponent->analyseTrack(File{ selectedPath }, AnalysisScheduler::Priority::queuedTrack);
 	}
 	if (button == &rewindImageButton)
 	{
@@ -408,6 +484,32 @@ void DeckGUI::buttonClicked(Button* button)
 		// Toggle looping
 		player->toggleAudioLoop();
 	}
+	if (button == &loopInButton)
+	{
+		player->setLoopIn();
+	}
+	if (button == &loopOutButton)
+	{
+		player->setLoopOut();
+	}
+	if (button == &autoLoopButton)
+	{
+		// Menu items double in length from a quarter of a beat
+		player->startAutoLoop(std::pow(2.0, autoLoopBox.getSelectedId() - 3));
+	}
+	if (button == &halveLoopButton)
+	{
+		// The audio thread keeps playing in time with the shorter loop
+		player->halveLoop();
+	}
+	if (button == &doubleLoopButton)
+	{
+		player->doubleLoop();
+	}
+	if (button == &exitLoopButton)
+	{
+		player->exitLoop();
+	}
 	if (button == &firstCueMarker)
 	{
 		// Insert yellow cue marker at current relative position in audio track
@@ -498,16 +600,12 @@ void DeckGUI::filesDropped(const StringArray& files, int x, int y)
 {
 	if (files.size() == 1)
 	{
-		player->loadURL(URL{ File{files[0]} });
+		loadTrack(File{ files[0] });
 	}
 }
 
 /**
- * Callback routine that gets called periodically to display the playhead location and track position to the user.
- *
- * If the track has completed and the track is set to loop, the audio track is restarted.
- *
- * When the current track ends, it plays queued tracks in order if the track is not set to loop.
+ * Callback routine that gets called periodically to display the playhead location and track position to the user
  *
  * @param                         None
  *
@@ -520,6 +618,32 @@ void DeckGUI::timerCallback()
 	waveformDisplay.setPositionRelative(positionRelative);
 	repaint();
 
+	// The audio thread only raises flags for the end of the track and the queued track taking over, which are picked up here
+	if (player->consumeTrackEvents())
+	{
+		handleTrackEvents();
+	}
+
+	// Pick up the beat grid and loudness once the analysis of the loaded track has finished
+	if (analysisPending)
+	{
+		double beatsPerMinute = 0.0;
+		double downbeatSeconds = 0.0;
+		double integratedLoudness = 0.0;
+		double truePeak = 0.0;
+
+		if (playlistComponent->getBeatGrid(loadedTrackFile, beatsPerMinute, downbeatSeconds))
+		{
+			player->setBeatGrid(beatsPerMinute, downbeatSeconds);
+			analysisPending = false;
+
+			if (playlistComponent->getLoudness(loadedTrackFile, integratedLoudness, truePeak))
+			{
+				player->setTrackLoudness(integratedLoudness, truePeak);
+			}
+		}
+	}
+
 	// Update the audio position indicator given a position change of at least a second
 	/*
 	if (player->getPositionRelative() >= -1e2 && songPositionLabel.getText().toStdString() != playlistComponent->formatSongLength(positionRelative * playlistComponent->getSongLength(File(playlistComponent->getSelectedTrack().absolutePath))))
@@ -529,27 +653,36 @@ void DeckGUI::timerCallback()
 	}
 	*/
 
-	// Determine if current track has ended and looping is not enabled
-	if (player->finishedPlaying() && !player->isLooping())
+	// Loops can only be resized or left while one is playing, and a new track clears the loop
+	const bool beatLoopActive = player->isBeatLoopActive();
+	halveLoopButton.setEnabled(beatLoopActive);
+	doubleLoopButton.setEnabled(beatLoopActive);
+	exitLoopButton.setEnabled(beatLoopActive);
+
+	// Report blocks that the disk streaming thread failed to read in time
+	ReadAheadAudioSource::Statistics streamingStatistics = player->getStreamingStatistics();
+
+	if (streamingStatistics.numUnderruns != lastUnderrunCount)
 	{
-		// Determine if there are tracks in queue
-		if (!playlistQueue.isEmpty())
+		if (streamingStatistics.numUnderruns > lastUnderrunCount)
 		{
-			// Get next track
-			File nextTrack = playlistQueue.dequeueTrack();
-
-			// Generate waveform and begin playing track
-			player->loadURL(URL{ nextTrack });
-			player->start();
+			Logger::writeToLog("Deck streaming underrun: " + String(streamingStatistics.numUnderruns) + " of "
+				+ String(streamingStatistics.numBlocks) + " blocks, " + String(streamingStatistics.numSamplesMissed) + " samples missed");
 		}
+
+		lastUnderrunCount = streamingStatistics.numUnderruns;
 	}
 
-	// Determine if the track has completed playing and if the track is set to loop
-	if (player->finishedPlaying() && player->isLooping())
+	// Seeks that the disk could not serve before the audio thread got there are reported apart from underruns
+	if (streamingStatistics.numSeekGaps != lastSeekGapCount)
 	{
-		// Loop the audio track
-		player->backToStart();
-		player->start();
+		if (streamingStatistics.numSeekGaps > lastSeekGapCount)
+		{
+			Logger::writeToLog("Deck seek gap: " + String(streamingStatistics.numSeekGaps) + " blocks, "
+				+ String(streamingStatistics.numSeekGapSamples) + " samples silenced after seeking");
+		}
+
+		lastSeekGapCount = streamingStatistics.numSeekGaps;
 	}
 }
 
@@ -568,6 +701,47 @@ void DeckGUI::changeListenerCallback(ChangeBroadcaster* source)
 	}
 }
 
+/**
+ * Follow the queued track once it has taken over, or load the next track in the queue once the loaded one has ended
+ *
+ * When the current track ends, it plays queued tracks in order. Looping tracks wrap around in the audio thread and never end.
+ *
+ * @param                         None
+ *
+ * @return                        None
+ */
+void DeckGUI::handleTrackEvents()
+{
+	// The queued track took over at the last sample of the previous one, so only the display has to catch up
+	if (player->advanceToNextTrack())
+	{
+		File nextTrack = playlistQueue.dequeueTrack();
+
+		waveformDisplay.loadURL(URL{ nextTrack });
+		songTitleLabel.setText(nextTrack.getFileNameWithoutExtension(), dontSendNotification);
+		songLengthLabel.setText(playlistComponent->formatSongLength(player->getSongLengthInSeconds()), dontSendNotification);
+
+		loadTrackAnalysis(nextTrack);
+		prepareQueuedTrack();
+	}
+	// Determine if the current track has ended, ignoring a stale flag once a new track is loading or playing
+	else if (player->finishedPlaying() && !player->isLoading())
+	{
+		// Show the playhead at the end of the track straight away
+		waveformDisplay.setPositionRelative(1.0);
+
+		// Determine if there are tracks in queue
+		if (!playlistQueue.isEmpty())
+		{
+			// Get next track
+			File nextTrack = playlistQueue.dequeueTrack();
+
+			// Generate waveform and begin playing track once it has loaded
+			loadTrack(nextTrack, true);
+		}
+	}
+}
+
 /**
  * Callback to determine whether this target is interested in the type of object being dragged
  *
@@ -592,13 +766,118 @@ void DeckGUI::itemDropped(const SourceDetails& dragSourceDetails)
 	// Convert absolute path of drag source into file
 	File dragSourceFile = File{ dragSourceDetails.description };
 
-	// Load URL into audio player
-	player->loadURL(URL{ dragSourceFile });
+	// Load URL into audio player without blocking the user interface
+	loadTrack(dragSourceFile);
+}
+
+/**
+ * Setter method that sets the resampler quality of the deck and shows it in the deck's quality menu
+ *
+ * @param quality                 Interpolator used for the speed and sample rate conversion
+ *
+ * @return                        None
+ */
+void DeckGUI::setResamplerQuality(Resampler::Quality quality)
+{
+	// The menu's change callback passes the quality on to the audio player
+	resamplerQualityBox.setSelectedId((int)quality + 1, sendNotificationSync);
+}
+
+/**
+ * Load an audio track into the deck in the background, showing a loading state until it is ready
+ *
+ * @param trackFile               Audio track to load
+ * @param startWhenLoaded         True if the track should begin playing once loaded
+ *
+ * @return                        None
+ */
+void DeckGUI::loadTrack(File trackFile, bool startWhenLoaded)
+{
+	// Show the loading state, a later load replaces this one
+	songTitleLabel.setText("Loading " + trackFile.getFileNameWithoutExtension() + "...", dontSendNotification);
+	songLengthLabel.setText("", dontSendNotification);
+
+	// Display waveform of audio file, which the thumbnail reads on its own thread
+	waveformDisplay.loadURL(URL{ trackFile });
+
+	Component::SafePointer<DeckGUI> safeThis(this);
+
+	player->loadURLAsync(URL{ trackFile }, [safeThis, trackFile, startWhenLoaded](bool loaded)
+		{
+			if (safeThis == nullptr)
+			{
+				return;
+			}
+
+			if (!loaded)
+			{
+				safeThis->songTitleLabel.setText("Could not load " + trackFile.getFileNameWithoutExtension(), dontSendNotification);
+				return;
+			}
+
+			// Update audio track title and length
+			safeThis->songTitleLabel.setText(trackFile.getFileNameWithoutExtension(), dontSendNotification);
+			safeThis->songLengthLabel.setText(safeThis->playlistComponent->formatSongLength(safeThis->player->getSongLengthInSeconds()), dontSendNotification);
+
+			safeThis->loadTrackAnalysis(trackFile);
+
+			if (startWhenLoaded)
+			{
+				safeThis->player->start();
+			}
+
+			safeThis->prepareQueuedTrack();
+		});
+}
 
-	// Display waveform of audio file
-	waveformDisplay.loadURL(URL{ dragSourceFile });
+/**
+ * Open the next queued track in the background so that it follows the loaded track without a gap
+ *
+ * @param                         None
+ *
+ * @return                        None
+ */
+void DeckGUI::prepareQueuedTrack()
+{
+	if (!playlistQueue.isEmpty())
+	{
+		player->prepareNextTrack(URL{ playlistQueue.peekTrack() });
+	}
+}
 
-	// Update audio track title and length
-	songTitleLabel.setText(dragSourceFile.getFileNameWithoutExtension(), dontSendNotification);
-	songLengthLabel.setText(playlistComponent->formatSongLength(playlistComponent->getSongLength(dragSourceFile)), dontSendNotification);
+/**
+ * Hand the beat grid and loudness trim of a track to the audio player if the library has analysed it, queueing the analysis otherwise
+ *
+ * @param trackFile               Audio track that has been loaded
+ *
+ * @return                        None
+ */
+void DeckGUI::loadTrackAnalysis(File trackFile)
+{
+	double beatsPerMinute = 0.0;
+	double downbeatSeconds = 0.0;
+	double integratedLoudness = 0.0;
+	double truePeak = 0.0;
+
+	loadedTrackFile = trackFile;
+	analysisPending = !playlistComponent->getBeatGrid(trackFile, beatsPerMinute, downbeatSeconds);
+
+	// An unanalysed track has no beat grid until the timer finds its analysis
+	player->setBeatGrid(beatsPerMinute, downbeatSeconds);
+
+	// ReplayGain tags give the trim of an unanalysed track straight away, otherwise it plays untrimmed until its analysis finishes
+	if (playlistComponent->getLoudness(trackFile, integratedLoudness, truePeak))
+	{
+		player->setTrackLoudness(integratedLoudness, truePeak);
+	}
+	else
+	{
+		player->setTrim(0.0);
+	}
+
+	// The loaded track is analysed before anything else
+	if (analysisPending)
+	{
+		playlistComponent->analyseTrack(trackFile, AnalysisScheduler::Priority::loadedTrack);
+	}
 }
@@ -178,9 +178,67 @@ public:
     */
     void itemDropped(const SourceDetails& dragSourceDetails) override;
 
+    /**
+    * Setter method that sets the resampler quality of the deck and shows it in the deck's quality menu
+    *
+    * @param quality                 Interpolator used for the speed and sample rate conversion
+    *
+    * @return                        None
+    */
+    void setResamplerQuality(Resampler::Quality quality);
+
 private:
+    /**
+    * Load an audio track into the deck in the background, showing a loading state until it is ready
+    *
+    * @param trackFile               Audio track to load
+    * @param startWhenLoaded         True if the track should begin playing once loaded
+    *
+    * @return                        None
+    */
+    void loadTrack(File trackFile, bool startWhenLoaded = false);
+
+    /**
+    * Open the next queued track in the background so that it follows the loaded track without a gap
+    *
+    * @param                         None
+    *
+    * @return                        None
+    */
+    void prepareQueuedTrack();
+
+    /**
+    * Hand the beat grid and loudness trim of a track to the audio player if the library has analysed it, queueing the analysis otherwise
+    *
+    * @param trackFile               Audio track that has been loaded
+    *
+    * @return                        None
+    */
+    void loadTrackAnalysis(File trackFile);
+
+    /**
+    * Follow the queued track once it has taken over, or load the next track in the queue once the loaded one has ended
+    *
+    * @param                         None
+    *
+    * @return                        None
+    */
+    void handleTrackEvents();
+
     TextButton loadButton{ "Load Deck" };
     TextButton queueTrackButton{ "Queue Track" };
+    ComboBox crossfaderSideBox;
+    ToggleButton ramModeToggle{ "RAM" };
+    ToggleButton keyLockToggle{ "Key Lock" };
+    ComboBox resamplerQualityBox;
+
+    TextButton loopInButton{ "In" };
+    TextButton loopOutButton{ "Out" };
+    ComboBox autoLoopBox;
+    TextButton autoLoopButton{ "Loop" };
+    TextButton halveLoopButton{ "/2" };
+    TextButton doubleLoopButton{ "x2" };
+    TextButton exitLoopButton{ "Exit" };
 
     TextButton firstCueMarker{ "Cue 1" };
     TextButton secondCueMarker{ "Cue 2" };
@@ -239,5 +297,13 @@ private:
 
     float rotationAngle;
 
+    // Underruns and seek gaps already reported for the loaded track
+    int64 lastUnderrunCount;
+    int64 lastSeekGapCount;
+
+    // Loaded track whose beat grid and loudness are still being analysed
+    File loadedTrackFile;
+    bool analysisPending;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckGUI)
 };
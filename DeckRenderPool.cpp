@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.cpp
+    Created: 16 Oct 2026 11:58:20pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "DeckRenderPool.h"
+
+constexpr int DeckRenderPool::maximumTasks;
+constexpr double DeckRenderPool::spinFraction;
+
+class DeckRenderPool::Worker : public Thread
+{
+public:
+    /**
+     * Constructor for one render worker, pinned to the core after the one its index would otherwise share with the caller
+     *
+     * @param _owner                      Pool that hands out the tasks
+     * @param index                       Position of the worker in the pool
+     *
+     * @return                            None
+     */
+    Worker(DeckRenderPool& _owner, int index)
+        : Thread("Deck render worker " + String(index + 1)), owner(_owner)
+    {
+        setAffinityMask((uint32)1 << ((index + 1) % jmin(32, SystemStats::getNumCpus())));
+    }
+
+    /**
+     * Destructor that waits for the worker to return
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~Worker() override
+    {
+        stopThread(2000);
+    }
+
+    /**
+     * Claim tasks as batches arrive, spinning only around the time the next batch is expected and sleeping the rest of each block
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            // A disabled pool costs nothing until it is enabled again
+            if (!owner.isEnabled())
+            {
+                wait(-1);
+                continue;
+            }
+
+            if (owner.runClaimedTasks())
+            {
+                continue;
+            }
+
+            // Time left until the next batch, from the interval the audio thread published with the last one
+            const int64 spinWindowTicks = owner.spinTicks.load(std::memory_order_relaxed);
+            const int64 ticksSinceBatch = Time::getHighResolutionTicks() - owner.lastBatchTicks.load(std::memory_order_relaxed);
+            const int64 ticksUntilBatch = owner.batchIntervalTicks.load(std::memory_order_relaxed) - ticksSinceBatch;
+            const double secondsUntilSpin = Time::highResolutionTicksToSeconds(ticksUntilBatch - spinWindowTicks);
+
+            if (secondsUntilSpin >= 0.001)
+            {
+                // Wake a little early rather than late, since sleeps only have millisecond resolution
+                wait((int)(secondsUntilSpin * 1000.0));
+            }
+            else if (ticksUntilBatch > -spinWindowTicks)
+            {
+                Thread::yield();
+            }
+            else
+            {
+                // The callback has stopped or is running late, so only poll until batches arrive again
+                wait(1);
+            }
+        }
+    }
+
+private:
+    DeckRenderPool& owner;
+};
+
+/**
+ * Constructor that starts the render workers, each pinned to its own core at the highest thread priority
+ *
+ * @param numWorkers                  Number of workers, limited to one less than the number of cores
+ *
+ * @return                            None
+ */
+DeckRenderPool::DeckRenderPool(int numWorkers)
+    : batchState(0), numCompleted(0), currentTask(nullptr), lastBatchTicks(0), batchIntervalTicks(0), blockPeriodTicks(0), spinTicks(0), enabled(false)
+{
+    const int numThreads = jlimit(0, SystemStats::getNumCpus() - 1, numWorkers);
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        workers.add(new Worker(*this, i));
+    }
+
+    // Workers compete with the audio thread itself, so they run at the same priority
+    for (auto* worker : workers)
+    {
+        worker->startThread(10);
+    }
+}
+
+/**
+ * Destructor that stops the render workers
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DeckRenderPool::~DeckRenderPool()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    workers.clear(true);
+}
+
+/**
+ * Setter method that sets the block period the workers time their spinning by, called before the audio thread starts
+ *
+ * @param samplesPerBlockExpected     Number of samples the audio device is expected to request per callback
+ * @param sampleRate                  Sample rate of the audio device
+ *
+ * @return                            None
+ */
+void DeckRenderPool::prepare(int samplesPerBlockExpected, double sampleRate)
+{
+    const double blockSeconds = sampleRate > 0.0 ? (double)samplesPerBlockExpected / sampleRate : 0.0;
+
+    blockPeriodTicks = Time::secondsToHighResolutionTicks(blockSeconds);
+    spinTicks = Time::secondsToHighResolutionTicks(blockSeconds * spinFraction);
+}
+
+/**
+ * Setter method that sets whether tasks are shared with the workers, which sleep while the pool is disabled
+ *
+ * @param shouldBeEnabled             True to render in parallel, false to run every task on the calling thread
+ *
+ * @return                            None
+ */
+void DeckRenderPool::setEnabled(bool shouldBeEnabled)
+{
+    enabled = shouldBeEnabled;
+
+    for (auto* worker : workers)
+    {
+        worker->notify();
+    }
+}
+
+/**
+ * Determine whether tasks are shared with the workers
+ *
+ * @param                             None
+ *
+ * @return                            True if the pool renders in parallel, false otherwise
+ */
+bool DeckRenderPool::isEnabled() const
+{
+    return enabled;
+}
+
+/**
+ * Getter method that retrieves the number of render workers
+ *
+ * @param                             None
+ *
+ * @return                            Number of workers, not counting the calling thread
+ */
+int DeckRenderPool::getNumWorkers() const
+{
+    return workers.size();
+}
+
+/**
+ * Run every task once and return when all of them have finished, without locking or sleeping, called on the audio thread
+ *
+ * @param task                        Work to run for each task index, which must outlive the call
+ * @param numTasks                    Number of tasks, at most maximumTasks
+ *
+ * @return                            None
+ */
+void DeckRenderPool::run(const Task& task, int numTasks)
+{
+    jassert(numTasks <= maximumTasks);
+
+    if (numTasks <= 0)
+    {
+        return;
+    }
+
+    // A single task gains nothing from the workers
+    if (!enabled || workers.isEmpty() || numTasks == 1)
+    {
+        for (int i = 0; i < numTasks; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    // Workers expect the next batch one interval after this one, which is shorter than the block period when rendering offline
+    const int64 nowTicks = Time::getHighResolutionTicks();
+    const int64 periodTicks = blockPeriodTicks.load(std::memory_order_relaxed);
+    const int64 intervalTicks = nowTicks - lastBatchTicks.load(std::memory_order_relaxed);
+
+    batchIntervalTicks.store(intervalTicks > 0 && intervalTicks < 2 * periodTicks ? intervalTicks : periodTicks, std::memory_order_relaxed);
+    lastBatchTicks.store(nowTicks, std::memory_order_relaxed);
+
+    // The previous batch has fully completed, so no worker still holds the task or the completion count
+    currentTask.store(&task, std::memory_order_relaxed);
+    numCompleted.store(0, std::memory_order_relaxed);
+
+    const uint64 batch = (batchState.load(std::memory_order_relaxed) >> 32) + 1;
+    batchState.store((batch << 32) | ((uint64)numTasks << 16), std::memory_order_release);
+
+    // The caller renders too, and takes every task no worker was awake to claim
+    runClaimedTasks();
+
+    // Only tasks a worker has already started remain, so the wait is bounded by the slowest deck
+    while (numCompleted.load(std::memory_order_acquire) < numTasks)
+    {
+    }
+}
+
+/**
+ * Claim and run tasks of the current batch until none are left
+ *
+ * @param                             None
+ *
+ * @return                            True if at least one task was run, false otherwise
+ */
+bool DeckRenderPool::runClaimedTasks()
+{
+    bool ranTask = false;
+    uint64 state = batchState.load(std::memory_order_acquire);
+
+    while (true)
+    {
+        const int numTasks = (int)((state >> 16) & 0xffff);
+        const int nextTask = (int)(state & 0xffff);
+
+        if (nextTask >= numTasks)
+        {
+            return ranTask;
+        }
+
+        // A claim made against an earlier batch fails here and is retried against the current one
+        if (batchState.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            (*currentTask.load(std::memory_order_relaxed))(nextTask);
+            numCompleted.fetch_add(1, std::memory_order_release);
+
+            ranTask = true;
+            state = batchState.load(std::memory_order_acquire);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.h
+    Created: 16 Oct 2026 11:58:20pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class DeckRenderPool
+{
+public:
+    /** Work for one deck, called with the index of the task on the audio thread or a worker */
+    typedef std::function<void(int taskIndex)> Task;
+
+    /**
+     * Constructor that starts the render workers, each pinned to its own core at the highest thread priority
+     *
+     * @param numWorkers                  Number of workers, limited to one less than the number of cores
+     *
+     * @return                            None
+     */
+    explicit DeckRenderPool(int numWorkers);
+
+    /**
+     * Destructor that stops the render workers
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~DeckRenderPool();
+
+    /**
+     * Setter method that sets the block period the workers time their spinning by, called before the audio thread starts
+     *
+     * @param samplesPerBlockExpected     Number of samples the audio device is expected to request per callback
+     * @param sampleRate                  Sample rate of the audio device
+     *
+     * @return                            None
+     */
+    void prepare(int samplesPerBlockExpected, double sampleRate);
+
+    /**
+     * Setter method that sets whether tasks are shared with the workers, which sleep while the pool is disabled
+     *
+     * @param shouldBeEnabled             True to render in parallel, false to run every task on the calling thread
+     *
+     * @return                            None
+     */
+    void setEnabled(bool shouldBeEnabled);
+
+    /**
+     * Determine whether tasks are shared with the workers
+     *
+     * @param                             None
+     *
+     * @return                            True if the pool renders in parallel, false otherwise
+     */
+    bool isEnabled() const;
+
+    /**
+     * Getter method that retrieves the number of render workers
+     *
+     * @param                             None
+     *
+     * @return                            Number of workers, not counting the calling thread
+     */
+    int getNumWorkers() const;
+
+    /**
+     * Run every task once and return when all of them have finished, without locking or sleeping, called on the audio thread
+     *
+     * @param task                        Work to run for each task index, which must outlive the call
+     * @param numTasks                    Number of tasks, at most maximumTasks
+     *
+     * @return                            None
+     */
+    void run(const Task& task, int numTasks);
+
+    // Largest number of tasks one call can run
+    static constexpr int maximumTasks = 0xffff;
+
+    // Share of the block period each worker spins on either side of the time the next batch is expected, sleeping otherwise
+    static constexpr double spinFraction = 0.125;
+
+private:
+    class Worker;
+
+    /**
+     * Claim and run tasks of the current batch until none are left
+     *
+     * @param                             None
+     *
+     * @return                            True if at least one task was run, false otherwise
+     */
+    bool runClaimedTasks();
+
+    // Batch number, task count and next unclaimed task packed together so a stale claim can never succeed
+    std::atomic<uint64> batchState;
+    std::atomic<int> numCompleted;
+    std::atomic<const Task*> currentTask;
+
+    // When the last batch arrived and how long after it the next one is expected, in high resolution ticks
+    std::atomic<int64> lastBatchTicks;
+    std::atomic<int64> batchIntervalTicks;
+    std::atomic<int64> blockPeriodTicks;
+    std::atomic<int64> spinTicks;
+
+    std::atomic<bool> enabled;
+
+    OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckRenderPool)
+};
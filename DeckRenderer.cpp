@@ -0,0 +1,1734 @@
+/*
+  ==============================================================================
+
+    DeckRenderer.cpp
+    Created: 16 Oct 2026 10:02:17am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "DeckRenderer.h"
+
+constexpr double DeckRenderer::lowPassNeutralFrequency;
+constexpr double DeckRenderer::highPassNeutralFrequency;
+constexpr double DeckRenderer::loopCrossfadeSeconds;
+constexpr double DeckRenderer::historySeconds;
+
+/**
+ * Constructor that initializes a stopped renderer with neutral speed, gain and filters
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DeckRenderer::DeckRenderer()
+    : source(nullptr),
+    sourceSerial(0),
+    sourceTag(0),
+    reportedSourceSerial(0),
+    sourceSampleRate(44100.0),
+    outputSampleRate(44100.0),
+    nextSource(nullptr),
+    nextSourceSampleRate(44100.0),
+    publishedNextSource(nullptr),
+    publishedNextSourceSampleRate(44100.0),
+    nextSourcePublished(false),
+    queueOverlapSeconds(0.0),
+    overlapStart(-1),
+    blockSize(512),
+    loopActive(false),
+    loopStart(0),
+    loopEnd(0),
+    loopCrossfadeLength(0),
+    jumpFrom(-1),
+    jumpTo(0),
+    jumpFadeLength(0),
+    jumpDips(false),
+    fadeInLength(0),
+    fadeInProgress(0),
+    historyStart(0),
+    historyEnd(0),
+    historyReadPosition(-1),
+    numBufferedSamples(0),
+    inputReadPosition(0.0),
+    speed(1.0),
+    speedRatio(1.0),
+    timeStretcher(std::make_unique<TimeStretcher>()),
+    keyLock(false),
+    timeStretcherSwapPending(false),
+    bandPassFrequency(0.0),
+    lowPassFrequency(lowPassNeutralFrequency),
+    highPassFrequency(highPassNeutralFrequency),
+    gain(1.0f),
+    trim(1.0f),
+    lastGain(0.0f),
+    playing(false),
+    stopRequested(false),
+    looping(false),
+    transportRequest(TransportRequest::none),
+    positionInSeconds(0.0),
+    lengthInSeconds(0.0),
+    playingFlag(false),
+    keyLockFlag(false),
+    loopActiveFlag(false),
+    endReached(false),
+    endOfTrackPending(false),
+    nextSourceStarted(false),
+    trackChangePending(false)
+{
+}
+
+/**
+ * Destructor for the renderer
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DeckRenderer::~DeckRenderer()
+{
+}
+
+/**
+ * Allocate the working buffers before fetching blocks of audio data
+ *
+ * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is rendered
+ * @param sampleRate                  Number of sound samples taken per second by the audio device
+ *
+ * @return                            None
+ */
+void DeckRenderer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    const RealtimeSafetyChecker::CheckedSpinLock::ScopedLockType lock(sourceLock);
+
+    // A queued track that no block has picked up yet is prepared with the rest
+    adoptPublishedNextSource();
+
+    blockSize = samplesPerBlockExpected;
+    outputSampleRate = sampleRate;
+
+    // Leave room for a few blocks of input so that fast speeds only need a couple of reads per block
+    inputBuffer.setSize(2, jmax(blockSize, 512) * 4 + 64);
+    resampledBuffer.setSize(1, jmax(blockSize, 512));
+    overlapBuffer.setSize(2, jmax(blockSize, 512));
+    resetInput();
+
+    setSpeed(speed);
+    updateFilters();
+
+    if (source != nullptr)
+    {
+        source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+
+    if (nextSource != nullptr)
+    {
+        nextSource->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+}
+
+/**
+ * Release the working buffers after playback has stopped
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::releaseResources()
+{
+    const RealtimeSafetyChecker::CheckedSpinLock::ScopedLockType lock(sourceLock);
+
+    adoptPublishedNextSource();
+
+    if (source != nullptr)
+    {
+        source->releaseResources();
+    }
+
+    if (nextSource != nullptr)
+    {
+        nextSource->releaseResources();
+    }
+
+    inputBuffer.setSize(2, 0);
+    overlapBuffer.setSize(2, 0);
+    numBufferedSamples = 0;
+    resetHistory();
+}
+
+/**
+ * Replace the positionable source that supplies the audio track, waiting for any block being rendered to finish
+ *
+ * @param newSource                   Prepared source to read from, or nullptr to unload the deck
+ * @param newSourceSampleRate         Sample rate of the audio track
+ * @param newSourceTag                Number the deck identifies the track by, reported back once the audio thread sees it
+ *
+ * @return                            None
+ */
+void DeckRenderer::setSource(PositionableAudioSource* newSource, double newSourceSampleRate, int newSourceTag)
+{
+    const double newRate = newSourceSampleRate > 0.0 ? newSourceSampleRate : outputSampleRate;
+
+    // Frame sizes follow the track's sample rate, so allocate the stretcher for it before taking the lock,
+    // and the stretcher it replaces is freed here after the lock is released
+    std::unique_ptr<TimeStretcher> preparedStretcher = std::make_unique<TimeStretcher>();
+    preparedStretcher->prepare(newRate);
+    std::unique_ptr<TimeStretcher> unusedNextStretcher;
+
+    // The history holds the longest loop at the track's own sample rate, and only a loaded deck needs one
+    AudioBuffer<float> preparedHistory(2, newSource != nullptr ? getHistoryLength(newRate) : 0);
+    AudioBuffer<float> unusedNextHistory;
+    AudioBuffer<float> unusedPublishedHistory;
+
+    const RealtimeSafetyChecker::CheckedSpinLock::ScopedLockType lock(sourceLock);
+
+    source = newSource;
+    sourceSampleRate = newRate;
+    std::swap(timeStretcher, preparedStretcher);
+    std::swap(historyBuffer, preparedHistory);
+    timeStretcherSwapPending = false;
+
+    ++sourceSerial;
+    sourceTag = newSourceTag;
+
+    // A track queued behind the previous one no longer follows on
+    nextSource = nullptr;
+    overlapStart = -1;
+    publishedNextSource = nullptr;
+    std::swap(unusedNextStretcher, publishedNextTimeStretcher);
+    std::swap(unusedNextHistory, nextHistoryBuffer);
+    std::swap(unusedPublishedHistory, publishedNextHistoryBuffer);
+    nextSourcePublished = false;
+
+    // Loop regions belong to the previous track, and so does everything in the history
+    loopActive = false;
+    loopActiveFlag = false;
+    jumpFrom = -1;
+    jumpDips = false;
+    fadeInProgress = fadeInLength;
+    resetHistory();
+
+    // The loop setting belongs to the deck, so it carries over to the new track
+    if (source != nullptr)
+    {
+        source->setLooping(looping);
+    }
+
+    // A new track always starts stopped at its beginning
+    playing = false;
+    stopRequested = false;
+    lastGain = 0.0f;
+
+    setSpeed(speed);
+    resetInput();
+
+    positionInSeconds = 0.0;
+    lengthInSeconds = source != nullptr ? (double)source->getTotalLength() / sourceSampleRate : 0.0;
+    playingFlag = false;
+    endReached = false;
+    endOfTrackPending = false;
+    nextSourceStarted = false;
+    trackChangePending = false;
+}
+
+/**
+ * Setter method that sets the track to continue into at the last sample of the loaded track, handed to the next block without
+ * waiting for one, or detached after waiting for any block being rendered to finish
+ *
+ * @param newNextSource               Prepared source, or nullptr to stop at the end of the loaded track
+ * @param newNextSourceSampleRate     Sample rate of the queued audio track
+ *
+ * @return                            None
+ */
+void DeckRenderer::setNextSource(PositionableAudioSource* newNextSource, double newNextSourceSampleRate)
+{
+    if (newNextSource == nullptr)
+    {
+        // The owner releases a detached source straight after this returns, so no block may still be reading it,
+        // and the stretchers are freed after the lock is released
+        std::unique_ptr<TimeStretcher> unusedStretcher;
+        std::unique_ptr<TimeStretcher> unusedPublishedStretcher;
+        AudioBuffer<float> unusedHistory;
+        AudioBuffer<float> unusedPublishedHistory;
+
+        const RealtimeSafetyChecker::CheckedSpinLock::ScopedLockType lock(sourceLock);
+
+        nextSource = nullptr;
+        overlapStart = -1;
+        std::swap(unusedStretcher, nextTimeStretcher);
+        std::swap(unusedHistory, nextHistoryBuffer);
+
+        publishedNextSource = nullptr;
+        std::swap(unusedPublishedStretcher, publishedNextTimeStretcher);
+        std::swap(unusedPublishedHistory, publishedNextHistoryBuffer);
+        nextSourcePublished = false;
+        return;
+    }
+
+    // The owner detaches a queued track before queuing another, which also clears a hand over that no block has picked up
+    jassert(!nextSourcePublished);
+
+    const double newRate = newNextSourceSampleRate > 0.0 ? newNextSourceSampleRate : outputSampleRate;
+
+    // Seeking and allocating happen here rather than in the block that adopts the source, which only lines it up with the overlap
+    newNextSource->setNextReadPosition(0);
+
+    std::unique_ptr<TimeStretcher> preparedStretcher = std::make_unique<TimeStretcher>();
+    preparedStretcher->prepare(newRate);
+
+    // With no queued track attached the audio thread cannot swap the history, so its size can be read here,
+    // and a history for the queued track is only allocated if its sample rate needs a different size
+    const int newHistoryLength = getHistoryLength(newRate);
+    AudioBuffer<float> preparedHistory(2, newHistoryLength != historyBuffer.getNumSamples() ? newHistoryLength : 0);
+
+    // Nothing can be switched to since the previous track was detached, so this cannot hide a switch from the owner
+    nextSourceStarted = false;
+
+    // The stretcher and history left over from the previous hand over are freed here when they go out of scope
+    publishedNextSource = newNextSource;
+    publishedNextSourceSampleRate = newRate;
+    std::swap(publishedNextTimeStretcher, preparedStretcher);
+    std::swap(publishedNextHistoryBuffer, preparedHistory);
+    nextSourcePublished = true;
+}
+
+/**
+ * Determine whether the audio thread has switched from the loaded track to the queued one
+ *
+ * @param                             None
+ *
+ * @return                            True if the last queued track is now playing and the previous source is no longer read, false otherwise
+ */
+bool DeckRenderer::hasStartedNextSource() const
+{
+    return nextSourceStarted;
+}
+
+/**
+ * Check whether the queued track has started since the last check, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            True exactly once for each switch to a queued track
+ */
+bool DeckRenderer::consumeTrackChange()
+{
+    return trackChangePending.exchange(false);
+}
+
+/**
+ * Setter method that sets how long the end of the loaded track overlaps the start of the queued track
+ *
+ * @param seconds                     Length of the equal power crossfade, or zero to switch at the last sample
+ *
+ * @return                            None
+ */
+void DeckRenderer::setQueueOverlap(double seconds)
+{
+    queueOverlapSeconds = jmax(0.0, seconds);
+}
+
+/**
+ * Apply the controller's changes, then read, resample, filter and apply gain to the next block of audio in one pass per channel
+ *
+ * @param bufferToFill                Buffer that must be filled with audio data
+ * @param controller                  Owner whose queued changes are applied first, or nullptr if nothing is queued
+ *
+ * @return                            None
+ */
+void DeckRenderer::render(const AudioSourceChannelInfo& bufferToFill, Controller* controller)
+{
+    // Never wait for the message thread, output silence for the block while a track is being swapped instead
+    const RealtimeSafetyChecker::CheckedSpinLock::ScopedTryLockType lock(sourceLock);
+
+    if (!lock.isLocked())
+    {
+        // Queued changes stay queued until a block gets the lock, so they never contend with a swap
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    // Report a new source before the changes queued behind it, so a control journal places the swap between the right two blocks
+    if (sourceSerial > reportedSourceSerial)
+    {
+        reportedSourceSerial = sourceSerial;
+
+        if (controller != nullptr)
+        {
+            controller->sourceChanged(sourceTag);
+        }
+    }
+
+    if (controller != nullptr)
+    {
+        controller->applyPendingCommands();
+    }
+
+    // A queued track handed over since the last block lines up with the loaded track from here
+    adoptPublishedNextSource();
+
+    // The mixer starts and stops decks in the middle of its own callback, which takes effect from this block
+    const TransportRequest request = transportRequest.exchange(TransportRequest::none);
+
+    if (request == TransportRequest::start)
+    {
+        start();
+    }
+    else if (request == TransportRequest::stop)
+    {
+        stop();
+    }
+
+    if (source == nullptr || !playing || bufferToFill.numSamples <= 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    // Ramp towards silence on the final block after a stop request
+    const float targetGain = stopRequested ? 0.0f : gain * trim;
+    const float gainStep = (targetGain - lastGain) / (float)bufferToFill.numSamples;
+
+    if (speed * sourceSampleRate / outputSampleRate > 1.0e-4)
+    {
+        int numProduced = 0;
+
+        while (numProduced < bufferToFill.numSamples)
+        {
+            numProduced += renderAvailable(bufferToFill,
+                numProduced,
+                bufferToFill.numSamples - numProduced,
+                lastGain + gainStep * (float)numProduced,
+                gainStep);
+
+            if (numProduced < bufferToFill.numSamples)
+            {
+                refillInput(bufferToFill.numSamples - numProduced);
+            }
+        }
+    }
+    else
+    {
+        // A stationary platter produces no sound
+        bufferToFill.clearActiveBufferRegion();
+    }
+
+    lastGain = targetGain;
+
+    if (stopRequested)
+    {
+        playing = false;
+        stopRequested = false;
+    }
+
+    // Source position of the next sample that will be interpolated
+    const int64 readPosition = getReadPosition();
+    double sourcePosition = (double)readPosition - (numBufferedSamples - inputReadPosition);
+
+    if (keyLock)
+    {
+        // Buffered input has already been stretched, so each sample stands for the speed in source samples
+        sourcePosition = (double)(readPosition - timeStretcher->getNumBufferedInputSamples())
+            - (numBufferedSamples - inputReadPosition) * speed;
+    }
+
+    // Samples from before the last wrap of a loop region may still be buffered after the read position has returned to its start
+    if (loopActive && sourcePosition < (double)loopStart && readPosition >= loopStart && readPosition < loopEnd)
+    {
+        sourcePosition += (double)(loopEnd - loopStart);
+    }
+    const int64 totalLength = source->getTotalLength();
+
+    // A looping source may already have wrapped around while samples from before the wrap are still buffered
+    if (looping && totalLength > 0)
+    {
+        sourcePosition = std::fmod(sourcePosition + (double)totalLength, (double)totalLength);
+    }
+
+    // Stop once the last sample of the track has been rendered, the rest of the block is already silent
+    if (sourcePosition >= (double)totalLength && !looping)
+    {
+        playing = false;
+        lastGain = 0.0f;
+        endReached = true;
+        endOfTrackPending = true;
+    }
+
+    positionInSeconds = jlimit(0.0, (double)totalLength, sourcePosition) / sourceSampleRate;
+    playingFlag = playing;
+}
+
+/**
+ * Begin playback from the current position, fading in over one block, called by the controller while render holds the source lock
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::start()
+{
+    if (source != nullptr && !playing)
+    {
+        endReached = false;
+        playing = true;
+        stopRequested = false;
+        lastGain = 0.0f;
+        playingFlag = true;
+    }
+}
+
+/**
+ * Stop playback at the current position, fading out over one block, called by the controller while render holds the source lock
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::stop()
+{
+    if (playing)
+    {
+        stopRequested = true;
+    }
+}
+
+/**
+ * Ask the next block rendered to begin playback, without waiting for the source lock, called on the audio thread
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::requestStart()
+{
+    transportRequest = TransportRequest::start;
+}
+
+/**
+ * Ask the next block rendered to stop playback with a fade, without waiting for the source lock, called on the audio thread
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::requestStop()
+{
+    transportRequest = TransportRequest::stop;
+}
+
+/**
+ * Determine whether the deck is currently producing audio
+ *
+ * @param                             None
+ *
+ * @return                            True if the deck is playing, false otherwise
+ */
+bool DeckRenderer::isPlaying() const
+{
+    return playingFlag;
+}
+
+/**
+ * Setter method that sets whether the track wraps around seamlessly at its last sample instead of ending, called by the controller while render holds the source lock
+ *
+ * @param shouldLoop                  True to loop the track, false to stop at its end
+ *
+ * @return                            None
+ */
+void DeckRenderer::setLooping(bool shouldLoop)
+{
+    if (shouldLoop == looping)
+    {
+        return;
+    }
+
+    looping = shouldLoop;
+
+    if (source != nullptr)
+    {
+        // A looping source reports its position within the track, so keep reading from there once looping stops,
+        // where a streamed track has been asked to read ahead from there before the command was queued
+        const int64 positionInTrack = source->getNextReadPosition();
+        source->setLooping(looping);
+
+        if (source->getNextReadPosition() != positionInTrack)
+        {
+            source->setNextReadPosition(positionInTrack);
+        }
+    }
+}
+
+/**
+ * Determine whether playback stopped because the last sample of the track was rendered, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            True if the playhead is at the end of the track, false otherwise
+ */
+bool DeckRenderer::hasReachedEnd() const
+{
+    return endReached;
+}
+
+/**
+ * Check whether the end of the track has been reached since the last check, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            True exactly once for each time the end of the track is reached
+ */
+bool DeckRenderer::consumeEndOfTrack()
+{
+    return endOfTrackPending.exchange(false);
+}
+
+/**
+ * Setter method that sets a region of the track that playback repeats, wrapping with a short crossfade at its end, called by the controller while render holds the source lock
+ *
+ * @param startSeconds                Start of the loop region in seconds
+ * @param endSeconds                  End of the loop region in seconds, ignored if it does not follow the start
+ *
+ * @return                            None
+ */
+void DeckRenderer::setLoopRegion(double startSeconds, double endSeconds)
+{
+    if (source == nullptr)
+    {
+        return;
+    }
+
+    const int64 totalLength = source->getTotalLength();
+    const int crossfadeLength = roundToInt(loopCrossfadeSeconds * sourceSampleRate);
+
+    // A loop must fit in the history along with the audio its wrap crossfades into
+    const int64 newLoopStart = jlimit((int64)0, totalLength, (int64)std::llround(startSeconds * sourceSampleRate));
+    const int64 newLoopEnd = jmin(totalLength, (int64)std::llround(endSeconds * sourceSampleRate),
+        newLoopStart + historyBuffer.getNumSamples() - 2 * crossfadeLength);
+
+    if (newLoopEnd <= newLoopStart)
+    {
+        return;
+    }
+
+    holdLoopWrap();
+
+    loopStart = newLoopStart;
+    loopEnd = newLoopEnd;
+    loopCrossfadeLength = (int)jmin((int64)crossfadeLength, (loopEnd - loopStart) / 4);
+    loopActive = true;
+    loopActiveFlag = true;
+
+    // Halving a loop, or closing it behind the read position, leaves the read position past the new wrap point
+    updateLoopJump();
+}
+
+/**
+ * Leave the loop region and continue playing through its end, called by the controller while render holds the source lock
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::clearLoopRegion()
+{
+    holdLoopWrap();
+
+    loopActive = false;
+    loopActiveFlag = false;
+
+    // Drop a jump back into the loop unless its crossfade has already begun
+    updateLoopJump();
+}
+
+/**
+ * Determine whether playback is repeating a loop region, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            True if a loop region is active, false otherwise
+ */
+bool DeckRenderer::isLoopRegionActive() const
+{
+    return loopActiveFlag;
+}
+
+/**
+ * Move the playhead to a position in the audio track, called by the controller while render holds the source lock
+ *
+ * @param posInSecs                   Position in seconds
+ *
+ * @return                            None
+ */
+void DeckRenderer::setPosition(double posInSecs)
+{
+    if (source != nullptr)
+    {
+        const int64 newPosition = (int64)(jmax(0.0, posInSecs) * sourceSampleRate);
+        seekReadPosition(newPosition);
+        resetInput();
+
+        positionInSeconds = (double)newPosition / sourceSampleRate;
+        endReached = false;
+
+        alignNextSource();
+    }
+}
+
+/**
+ * Getter method that retrieves the playhead position, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Position in seconds
+ */
+double DeckRenderer::getCurrentPosition() const
+{
+    return positionInSeconds;
+}
+
+/**
+ * Getter method that retrieves the length of the loaded audio track, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Length in seconds, or zero if no track is loaded
+ */
+double DeckRenderer::getLengthInSeconds() const
+{
+    return lengthInSeconds;
+}
+
+/**
+ * Setter method that sets the output gain, ramped over the next block to avoid clicks
+ *
+ * @param newGain                     Linear gain
+ *
+ * @return                            None
+ */
+void DeckRenderer::setGain(float newGain)
+{
+    gain = newGain;
+}
+
+/**
+ * Setter method that sets the trim applied before the gain to even out the loudness of tracks, ramped like the gain
+ *
+ * @param newTrim                     Linear gain
+ *
+ * @return                            None
+ */
+void DeckRenderer::setTrim(float newTrim)
+{
+    trim = newTrim;
+}
+
+/**
+ * Setter method that sets the playback speed, which also shifts the pitch unless key lock is enabled
+ *
+ * @param ratio                       Playback speed where 1.0 is the original speed
+ *
+ * @return                            None
+ */
+void DeckRenderer::setSpeed(double ratio)
+{
+    speed = ratio;
+    timeStretcher->setTempo(speed);
+
+    // Fold the sample rate conversion into the speed so that only one interpolation pass is needed,
+    // unless the time stretcher is already applying the speed
+    speedRatio = (keyLock ? 1.0 : speed) * sourceSampleRate / outputSampleRate;
+}
+
+/**
+ * Getter method that retrieves the playback speed, called on the audio thread
+ *
+ * @param                             None
+ *
+ * @return                            Playback speed where 1.0 is the original speed
+ */
+double DeckRenderer::getSpeed() const
+{
+    return speed;
+}
+
+/**
+ * Setter method that sets whether speed changes are time-stretched to keep the original pitch, called by the controller while render holds the source lock
+ *
+ * @param shouldLockKey               True to keep the pitch, false to let it follow the speed like a turntable
+ *
+ * @return                            None
+ */
+void DeckRenderer::setKeyLock(bool shouldLockKey)
+{
+    if (shouldLockKey == keyLock)
+    {
+        return;
+    }
+
+    keyLock = shouldLockKey;
+    keyLockFlag = keyLock;
+    setSpeed(speed);
+
+    // Input buffered for the other mode cannot be reused, so continue reading from the playhead
+    if (source != nullptr)
+    {
+        seekReadPosition((int64)(positionInSeconds * sourceSampleRate));
+        resetInput();
+        alignNextSource();
+    }
+}
+
+/**
+ * Determine whether speed changes keep the original pitch
+ *
+ * @param                             None
+ *
+ * @return                            True if key lock is enabled, false otherwise
+ */
+bool DeckRenderer::isKeyLockEnabled() const
+{
+    return keyLockFlag;
+}
+
+/**
+ * Setter method that sets the interpolator used for the speed and sample rate conversion
+ *
+ * @param quality                     Interpolator to use from the next block
+ *
+ * @return                            None
+ */
+void DeckRenderer::setResamplerQuality(Resampler::Quality quality)
+{
+    resampler.setQuality(quality);
+}
+
+/**
+ * Getter method that retrieves the interpolator used for the speed and sample rate conversion
+ *
+ * @param                             None
+ *
+ * @return                            Interpolator in use
+ */
+Resampler::Quality DeckRenderer::getResamplerQuality() const
+{
+    return resampler.getQuality();
+}
+
+/**
+ * Setter method that sets the centre frequency of the band pass stage
+ *
+ * @param frequency                   Centre frequency in Hz
+ *
+ * @return                            None
+ */
+void DeckRenderer::setBandPassFrequency(double frequency)
+{
+    bandPassFrequency = frequency;
+
+    // Set coefficients for a band pass filter
+    const bool shouldBeActive = bandPassFrequency > 0.0 && bandPassFrequency < outputSampleRate * 0.5;
+    setStage(bandPassStage, shouldBeActive ? IIRCoefficients::makeBandPass(outputSampleRate, bandPassFrequency) : IIRCoefficients(), shouldBeActive);
+}
+
+/**
+ * Setter method that sets the cut-off of the low pass stage, which is bypassed at or above the neutral frequency
+ *
+ * @param frequency                   Cut-off frequency in Hz
+ *
+ * @return                            None
+ */
+void DeckRenderer::setLowPassFrequency(double frequency)
+{
+    lowPassFrequency = frequency;
+
+    // Set coefficients for a low pass filter
+    const bool shouldBeActive = lowPassFrequency > 0.0 && lowPassFrequency < jmin(lowPassNeutralFrequency, outputSampleRate * 0.5);
+    setStage(lowPassStage, shouldBeActive ? IIRCoefficients::makeLowPass(outputSampleRate, lowPassFrequency) : IIRCoefficients(), shouldBeActive);
+}
+
+/**
+ * Setter method that sets the cut-off of the high pass stage, which is bypassed at or below the neutral frequency
+ *
+ * @param frequency                   Cut-off frequency in Hz
+ *
+ * @return                            None
+ */
+void DeckRenderer::setHighPassFrequency(double frequency)
+{
+    highPassFrequency = frequency;
+
+    // Set coefficients for a high pass filter
+    const bool shouldBeActive = highPassFrequency > highPassNeutralFrequency && highPassFrequency < outputSampleRate * 0.5;
+    setStage(highPassStage, shouldBeActive ? IIRCoefficients::makeHighPass(outputSampleRate, highPassFrequency) : IIRCoefficients(), shouldBeActive);
+}
+
+/**
+ * Set the coefficients of a filter stage, or bypass it when it has no audible effect
+ *
+ * @param stage                       Stage to update
+ * @param coefficients                Coefficients designed for the current sample rate
+ * @param shouldBeActive              False if the stage should be bypassed
+ *
+ * @return                            None
+ */
+void DeckRenderer::setStage(BiquadStage& stage, const IIRCoefficients& coefficients, bool shouldBeActive)
+{
+    // Start from silence when a bypassed stage is switched back in so stale state cannot cause a click
+    if (shouldBeActive && !stage.active)
+    {
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            stage.z1[channel] = 0.0f;
+            stage.z2[channel] = 0.0f;
+        }
+    }
+
+    if (shouldBeActive)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            stage.coefficients[i] = coefficients.coefficients[i];
+        }
+    }
+
+    stage.active = shouldBeActive;
+}
+
+/**
+ * Recalculate every filter stage after the sample rate changes
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::updateFilters()
+{
+    setBandPassFrequency(bandPassFrequency);
+    setLowPassFrequency(lowPassFrequency);
+    setHighPassFrequency(highPassFrequency);
+}
+
+/**
+ * Discard buffered input so that the next block reads from the current source position
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::resetInput()
+{
+    // Nothing buffered survives, so a stretcher waiting to take over after a switch between sample rates can start here
+    if (timeStretcherSwapPending)
+    {
+        std::swap(timeStretcher, pendingTimeStretcher);
+        timeStretcher->setTempo(speed);
+        timeStretcherSwapPending = false;
+    }
+
+    timeStretcher->reset();
+
+    if (inputBuffer.getNumSamples() == 0)
+    {
+        numBufferedSamples = 0;
+        return;
+    }
+
+    // Begin with silent history in front of the read position
+    inputBuffer.clear(0, Resampler::numHistorySamples);
+    numBufferedSamples = Resampler::numHistorySamples;
+    inputReadPosition = Resampler::numHistorySamples;
+}
+
+/**
+ * Read more audio from the source into the input buffer, keeping the history needed by the interpolator
+ *
+ * @param samplesStillRequired        Number of output samples that still have to be produced this block
+ *
+ * @return                            None
+ */
+void DeckRenderer::refillInput(int samplesStillRequired)
+{
+    // Shift the unread samples and their history to the front of the buffer
+    const int firstSampleToKeep = jmax(0, (int)inputReadPosition - Resampler::numHistorySamples);
+
+    // At high speeds the read position can step past every buffered sample, so read and discard the skipped input
+    if (firstSampleToKeep > numBufferedSamples)
+    {
+        const int numToSkip = jmin(firstSampleToKeep - numBufferedSamples, inputBuffer.getNumSamples());
+        readSource(0, numToSkip);
+    }
+
+    if (firstSampleToKeep > 0)
+    {
+        const int numToKeep = jmax(0, numBufferedSamples - firstSampleToKeep);
+
+        for (int channel = 0; channel < inputBuffer.getNumChannels(); ++channel)
+        {
+            float* samples = inputBuffer.getWritePointer(channel);
+            std::memmove(samples, samples + firstSampleToKeep, sizeof(float) * (size_t)numToKeep);
+        }
+
+        numBufferedSamples = numToKeep;
+        inputReadPosition -= firstSampleToKeep;
+    }
+
+    // Read just enough input for the rest of the block, limited by the space left in the buffer
+    const double lastReadPosition = inputReadPosition + (samplesStillRequired - 1) * speedRatio;
+    const int numRequired = (int)lastReadPosition + Resampler::numLookaheadSamples + 1 - numBufferedSamples;
+    const int numToRead = jlimit(1, inputBuffer.getNumSamples() - numBufferedSamples, numRequired);
+
+    readSource(numBufferedSamples, numToRead);
+    numBufferedSamples += numToRead;
+}
+
+/**
+ * Read the next samples of the track into the input buffer, through the time stretcher when key lock is enabled
+ *
+ * @param startSample                 First sample of the input buffer to write
+ * @param numSamples                  Number of samples to read
+ *
+ * @return                            None
+ */
+void DeckRenderer::readSource(int startSample, int numSamples)
+{
+    if (keyLock)
+    {
+        timeStretcher->process(splicedSource, inputBuffer, startSample, numSamples);
+    }
+    else
+    {
+        readTrack(AudioSourceChannelInfo(&inputBuffer, startSample, numSamples));
+    }
+}
+
+/**
+ * Read the next samples of the track, continuing into the queued track at its last sample and crossfading the overlap
+ *
+ * @param bufferToFill                Region of a buffer that receives the audio in its first two channels
+ *
+ * @return                            None
+ */
+void DeckRenderer::readTrack(const AudioSourceChannelInfo& bufferToFill)
+{
+    int numRead = 0;
+
+    while (numRead < bufferToFill.numSamples)
+    {
+        const int numRemaining = bufferToFill.numSamples - numRead;
+
+        // Loop regions and the jumps they make come first, nothing follows the track while it repeats a loop
+        if (loopActive || jumpFrom >= 0 || fadeInProgress < fadeInLength)
+        {
+            numRead += readLoopRegion(*bufferToFill.buffer, bufferToFill.startSample + numRead, numRemaining);
+            continue;
+        }
+
+        // A looping track never ends, so nothing follows it
+        if (nextSource == nullptr || looping)
+        {
+            readLoadedTrack(*bufferToFill.buffer, bufferToFill.startSample + numRead, numRemaining);
+            return;
+        }
+
+        const int64 position = getReadPosition();
+        const int64 totalLength = source->getTotalLength();
+
+        // Carry on from the exact sample after the last one of the loaded track
+        if (position >= totalLength)
+        {
+            switchToNextSource();
+            continue;
+        }
+
+        const int64 crossfadeStart = overlapStart >= 0 ? overlapStart : totalLength - getOverlapLength();
+
+        if (position < crossfadeStart)
+        {
+            const int numToRead = (int)jmin((int64)numRemaining, crossfadeStart - position);
+            readLoadedTrack(*bufferToFill.buffer, bufferToFill.startSample + numRead, numToRead);
+            numRead += numToRead;
+            continue;
+        }
+
+        // Fix the length of the crossfade once it begins so that later parameter changes cannot make it jump
+        if (overlapStart < 0)
+        {
+            overlapStart = position;
+        }
+
+        const int numToRead = (int)jmin((int64)numRemaining, totalLength - position, (int64)overlapBuffer.getNumSamples());
+        const int startSample = bufferToFill.startSample + numRead;
+
+        readLoadedTrack(*bufferToFill.buffer, startSample, numToRead);
+        nextSource->getNextAudioBlock(AudioSourceChannelInfo(&overlapBuffer, 0, numToRead));
+
+        // Equal power curves keep the loudness steady while two unrelated tracks overlap
+        const double overlapLength = (double)(totalLength - overlapStart);
+
+        for (int i = 0; i < numToRead; ++i)
+        {
+            const double angle = (double)(position + i - overlapStart) / overlapLength * MathConstants<double>::halfPi;
+            const float fadeOut = (float)std::cos(angle);
+            const float fadeIn = (float)std::sin(angle);
+
+            for (int channel = 0; channel < jmin(2, bufferToFill.buffer->getNumChannels()); ++channel)
+            {
+                float* samples = bufferToFill.buffer->getWritePointer(channel, startSample);
+                samples[i] = samples[i] * fadeOut + overlapBuffer.getSample(channel, i) * fadeIn;
+            }
+        }
+
+        numRead += numToRead;
+    }
+}
+
+/**
+ * Read the next samples of the loaded track up to the next loop wrap or jump, crossfading into the audio at the jump target
+ *
+ * @param buffer                      Buffer that receives the audio in its first two channels
+ * @param startSample                 First sample of the buffer to write
+ * @param numSamples                  Maximum number of samples to read
+ *
+ * @return                            Number of samples read, zero if the read position jumped instead
+ */
+int DeckRenderer::readLoopRegion(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int64 position = getReadPosition();
+
+    // The next discontinuity is either a scheduled jump or the wrap at the end of the loop
+    int64 from = -1;
+    int64 to = 0;
+    int fadeLength = 0;
+
+    if (jumpFrom >= 0)
+    {
+        from = jumpFrom;
+        to = jumpTo;
+        fadeLength = jumpFadeLength;
+    }
+    else if (loopActive && position <= loopEnd)
+    {
+        from = loopEnd;
+        to = loopStart;
+        fadeLength = loopCrossfadeLength;
+    }
+
+    if (from >= 0 && position >= from)
+    {
+        jumpFrom = -1;
+
+        if (jumpDips)
+        {
+            // Read the audio in front of the target into the history, so the next jump to it can crossfade instead of dipping
+            moveReadPosition(jmax((int64)0, to - fadeLength));
+
+            while (getReadPosition() < to)
+            {
+                readLoadedTrack(overlapBuffer, 0, (int)jmin((int64)overlapBuffer.getNumSamples(), to - getReadPosition()));
+            }
+
+            // Come back up from the silence the jump dipped into
+            jumpDips = false;
+            fadeInLength = fadeLength;
+            fadeInProgress = 0;
+        }
+        else
+        {
+            moveReadPosition(to);
+        }
+
+        // The loop may have been shortened behind the jump target while the crossfade was running
+        updateLoopJump();
+        return 0;
+    }
+
+    // Stop at the start of the crossfade, or at the jump once inside it
+    const int64 fadeStart = from - fadeLength;
+    int numToRead = jmin(numSamples, overlapBuffer.getNumSamples());
+
+    if (from >= 0)
+    {
+        numToRead = (int)jmin((int64)numToRead, position < fadeStart ? fadeStart - position : from - position);
+    }
+
+    readLoadedTrack(buffer, startSample, numToRead);
+
+    if (from >= 0 && position >= fadeStart)
+    {
+        // Crossfade into the audio leading up to the jump target, which carries on seamlessly once the jump is made
+        jumpDips = !historyContains(to - fadeLength, to);
+
+        if (!jumpDips)
+        {
+            copyFromHistory(overlapBuffer, 0, to - fadeLength + (position - fadeStart), numToRead);
+        }
+
+        for (int i = 0; i < numToRead; ++i)
+        {
+            const double angle = (double)(position + i - fadeStart) / (double)fadeLength * MathConstants<double>::halfPi;
+            const float fadeOut = (float)std::cos(angle);
+            const float fadeIn = jumpDips ? 0.0f : (float)std::sin(angle);
+
+            for (int channel = 0; channel < jmin(2, buffer.getNumChannels()); ++channel)
+            {
+                float* samples = buffer.getWritePointer(channel, startSample);
+                samples[i] = samples[i] * fadeOut + overlapBuffer.getSample(channel, i) * fadeIn;
+            }
+        }
+    }
+
+    if (fadeInProgress < fadeInLength)
+    {
+        const int numToFade = jmin(numToRead, fadeInLength - fadeInProgress);
+
+        for (int i = 0; i < numToFade; ++i)
+        {
+            const float fadeIn = (float)std::sin((double)(fadeInProgress + i) / (double)fadeInLength * MathConstants<double>::halfPi);
+
+            for (int channel = 0; channel < jmin(2, buffer.getNumChannels()); ++channel)
+            {
+                buffer.getWritePointer(channel, startSample)[i] *= fadeIn;
+            }
+        }
+
+        fadeInProgress += numToFade;
+    }
+
+    return numToRead;
+}
+
+/**
+ * Read the next samples of the loaded track, from the history while it is behind the source and from the source after that
+ *
+ * @param buffer                      Buffer that receives the audio in its first two channels
+ * @param startSample                 First sample of the buffer to write
+ * @param numSamples                  Number of samples to read
+ *
+ * @return                            None
+ */
+void DeckRenderer::readLoadedTrack(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // Replay the history until it catches up with the source
+    if (historyReadPosition >= 0)
+    {
+        const int numFromHistory = (int)jmin((int64)numSamples, historyEnd - historyReadPosition);
+        copyFromHistory(buffer, startSample, historyReadPosition, numFromHistory);
+
+        historyReadPosition += numFromHistory;
+        startSample += numFromHistory;
+        numSamples -= numFromHistory;
+
+        if (historyReadPosition >= historyEnd)
+        {
+            historyReadPosition = -1;
+        }
+
+        if (numSamples <= 0)
+        {
+            return;
+        }
+    }
+
+    const int64 position = source->getNextReadPosition();
+    source->getNextAudioBlock(AudioSourceChannelInfo(&buffer, startSample, numSamples));
+    const int64 newPosition = source->getNextReadPosition();
+
+    // A looping source that wrapped around breaks the history, which starts again from the new position
+    if (position != historyEnd || newPosition != position + numSamples || historyBuffer.getNumSamples() == 0)
+    {
+        historyStart = newPosition;
+        historyEnd = newPosition;
+        return;
+    }
+
+    // Record the samples in the circular history, which is indexed by track position
+    const int capacity = historyBuffer.getNumSamples();
+    const int writeIndex = (int)(position % capacity);
+    const int numBeforeWrap = jmin(numSamples, capacity - writeIndex);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        const int sourceChannel = jmin(channel, buffer.getNumChannels() - 1);
+        historyBuffer.copyFrom(channel, writeIndex, buffer, sourceChannel, startSample, numBeforeWrap);
+
+        if (numBeforeWrap < numSamples)
+        {
+            historyBuffer.copyFrom(channel, 0, buffer, sourceChannel, startSample + numBeforeWrap, numSamples - numBeforeWrap);
+        }
+    }
+
+    historyEnd = newPosition;
+    historyStart = jmax(historyStart, historyEnd - capacity);
+}
+
+/**
+ * Copy samples of the loaded track out of the history
+ *
+ * @param destination                 Buffer that receives the audio in its first two channels
+ * @param startSample                 First sample of the buffer to write
+ * @param position                    Position in the loaded track of the first sample to copy
+ * @param numSamples                  Number of samples to copy, all of which must be in the history
+ *
+ * @return                            None
+ */
+void DeckRenderer::copyFromHistory(AudioBuffer<float>& destination, int startSample, int64 position, int numSamples) const
+{
+    jassert(historyContains(position, position + numSamples));
+
+    if (numSamples <= 0)
+    {
+        return;
+    }
+
+    const int capacity = historyBuffer.getNumSamples();
+    const int readIndex = (int)(position % capacity);
+    const int numBeforeWrap = jmin(numSamples, capacity - readIndex);
+
+    for (int channel = 0; channel < jmin(2, destination.getNumChannels()); ++channel)
+    {
+        destination.copyFrom(channel, startSample, historyBuffer, channel, readIndex, numBeforeWrap);
+
+        if (numBeforeWrap < numSamples)
+        {
+            destination.copyFrom(channel, startSample + numBeforeWrap, historyBuffer, channel, 0, numSamples - numBeforeWrap);
+        }
+    }
+}
+
+/**
+ * Determine whether a range of the loaded track is held in the history
+ *
+ * @param start                       Position of the first sample
+ * @param end                         Position after the last sample
+ *
+ * @return                            True if every sample of the range can be replayed from memory, false otherwise
+ */
+bool DeckRenderer::historyContains(int64 start, int64 end) const
+{
+    return start >= historyStart && end <= historyEnd && start <= end;
+}
+
+/**
+ * Getter method that retrieves the position in the loaded track of the next sample read, which trails the source while the history is replayed
+ *
+ * @param                             None
+ *
+ * @return                            Position in samples
+ */
+int64 DeckRenderer::getReadPosition() const
+{
+    return historyReadPosition >= 0 ? historyReadPosition : source->getNextReadPosition();
+}
+
+/**
+ * Move the read position, replaying from the history if it holds the new position and seeking the source otherwise
+ *
+ * @param newPosition                 Position in samples of the loaded track
+ *
+ * @return                            None
+ */
+void DeckRenderer::moveReadPosition(int64 newPosition)
+{
+    if (newPosition >= historyStart && newPosition < historyEnd)
+    {
+        historyReadPosition = newPosition;
+    }
+    else if (newPosition == historyEnd)
+    {
+        // The source is already there
+        historyReadPosition = -1;
+    }
+    else
+    {
+        source->setNextReadPosition(newPosition);
+        resetHistory();
+    }
+}
+
+/**
+ * Move the read position after a seek, abandoning any jump or fade in progress
+ *
+ * @param newPosition                 Position in samples of the loaded track
+ *
+ * @return                            None
+ */
+void DeckRenderer::seekReadPosition(int64 newPosition)
+{
+    jumpFrom = -1;
+    jumpDips = false;
+    fadeInProgress = fadeInLength;
+
+    moveReadPosition(newPosition);
+
+    // Seeking out of an active loop lands in the same place of its next repetition
+    updateLoopJump();
+}
+
+/**
+ * Forget the history and start recording it again from the source position, called after the source changes
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::resetHistory()
+{
+    historyReadPosition = -1;
+    historyStart = source != nullptr ? source->getNextReadPosition() : 0;
+    historyEnd = historyStart;
+}
+
+/**
+ * Turn a loop wrap whose crossfade has already begun into a jump, so that changing or leaving the loop cannot cut it short
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::holdLoopWrap()
+{
+    if (!loopActive || jumpFrom >= 0 || source == nullptr)
+    {
+        return;
+    }
+
+    const int64 position = getReadPosition();
+
+    if (position > loopEnd - loopCrossfadeLength && position < loopEnd)
+    {
+        jumpFrom = loopEnd;
+        jumpTo = loopStart;
+        jumpFadeLength = loopCrossfadeLength;
+    }
+}
+
+/**
+ * Schedule a jump back into the loop region when the read position is already past the point where the wrap crossfade begins
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::updateLoopJump()
+{
+    if (source == nullptr)
+    {
+        return;
+    }
+
+    const int64 position = getReadPosition();
+
+    // A jump whose crossfade has begun always completes, and the loop takes over again where it lands
+    if (jumpFrom >= 0 && position > jumpFrom - jumpFadeLength)
+    {
+        return;
+    }
+
+    jumpFrom = -1;
+
+    if (!loopActive || position <= loopEnd - loopCrossfadeLength)
+    {
+        return;
+    }
+
+    // Too late to wrap at the loop end, so jump one crossfade ahead to the same place in the next repetition
+    const int64 loopLength = loopEnd - loopStart;
+    jumpFrom = position + loopCrossfadeLength;
+    jumpTo = loopStart + (jumpFrom - loopStart) % loopLength;
+    jumpFadeLength = loopCrossfadeLength;
+
+    // A target inside the wrap crossfade would cut it short, so wait for the next loop start instead
+    if (jumpTo > loopEnd - loopCrossfadeLength)
+    {
+        jumpFrom += loopEnd - jumpTo;
+        jumpTo = loopStart;
+    }
+}
+
+/**
+ * Make the queued track the loaded track, called on the audio thread once the last sample of the loaded track is read
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::switchToNextSource()
+{
+    source = nextSource;
+    nextSource = nullptr;
+    overlapStart = -1;
+
+    // A queued track at a sample rate that needs a different size of history brings its own
+    if (nextHistoryBuffer.getNumSamples() > 0)
+    {
+        std::swap(historyBuffer, nextHistoryBuffer);
+    }
+
+    resetHistory();
+
+    // The stretcher's frame size follows the sample rate, so one prepared for the queued track's rate takes over from it,
+    // straight away while it is idle, or at the next discontinuity while it is stretching across the splice so the switch stays gapless
+    if (nextSourceSampleRate != sourceSampleRate && nextTimeStretcher != nullptr)
+    {
+        if (keyLock)
+        {
+            std::swap(pendingTimeStretcher, nextTimeStretcher);
+            timeStretcherSwapPending = true;
+        }
+        else
+        {
+            std::swap(timeStretcher, nextTimeStretcher);
+        }
+    }
+
+    // Input of the previous track that is still buffered is converted at the new rate, which only matters if the rates differ
+    sourceSampleRate = nextSourceSampleRate;
+    setSpeed(speed);
+
+    source->setLooping(looping);
+    lengthInSeconds = (double)source->getTotalLength() / sourceSampleRate;
+
+    nextSourceStarted = true;
+    trackChangePending = true;
+}
+
+/**
+ * Take over a queued track handed over by the message thread, called with the source lock held
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::adoptPublishedNextSource()
+{
+    if (!nextSourcePublished)
+    {
+        return;
+    }
+
+    nextSource = publishedNextSource;
+    nextSourceSampleRate = publishedNextSourceSampleRate;
+
+    // The stretcher and history this replaces wait in the hand over until the message thread frees them
+    std::swap(nextTimeStretcher, publishedNextTimeStretcher);
+    std::swap(nextHistoryBuffer, publishedNextHistoryBuffer);
+    publishedNextSource = nullptr;
+
+    // The loaded track may already be inside the overlap, in which case the crossfade starts from the playhead
+    overlapStart = -1;
+    alignNextSource();
+
+    nextSourcePublished = false;
+}
+
+/**
+ * Getter method that retrieves the size of the history that holds the longest loop of a track, along with its wrap crossfade
+ *
+ * @param sampleRate                  Sample rate of the audio track
+ *
+ * @return                            Number of samples the history needs
+ */
+int DeckRenderer::getHistoryLength(double sampleRate)
+{
+    return (int)std::ceil((historySeconds + 2.0 * loopCrossfadeSeconds) * sampleRate);
+}
+
+/**
+ * Reposition the queued track to follow the loaded track after the playhead moves
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DeckRenderer::alignNextSource()
+{
+    if (nextSource == nullptr || source == nullptr)
+    {
+        return;
+    }
+
+    const int64 position = getReadPosition();
+
+    // Moving back out of the crossfade restarts the queued track, moving within it keeps both tracks in step
+    if (overlapStart < 0 || position < overlapStart)
+    {
+        overlapStart = -1;
+    }
+
+    const int64 target = overlapStart >= 0 ? position - overlapStart : 0;
+
+    // A streamed track that is already in place keeps what it has buffered
+    if (nextSource->getNextReadPosition() != target)
+    {
+        nextSource->setNextReadPosition(target);
+    }
+}
+
+/**
+ * Getter method that retrieves the number of samples at the end of the loaded track that overlap the queued track
+ *
+ * @param                             None
+ *
+ * @return                            Overlap in samples of the loaded track
+ */
+int64 DeckRenderer::getOverlapLength() const
+{
+    // Mixing tracks at different sample rates would play the queued one at the wrong pitch, so those switch at the last sample
+    if (nextSource == nullptr || nextSourceSampleRate != sourceSampleRate)
+    {
+        return 0;
+    }
+
+    // Never overlap more than half of either track
+    const int64 overlapLength = (int64)(queueOverlapSeconds * sourceSampleRate);
+    return jmin(overlapLength, source->getTotalLength() / 2, nextSource->getTotalLength() / 2);
+}
+
+/**
+ * Interpolate, filter and apply gain to as many output samples as the buffered input allows
+ *
+ * @param bufferToFill                Buffer that must be filled with audio data
+ * @param offset                      Number of samples already produced this block
+ * @param numSamples                  Number of samples still required this block
+ * @param gainStart                   Gain applied to the first produced sample
+ * @param gainStep                    Gain increment per produced sample
+ *
+ * @return                            Number of samples produced
+ */
+int DeckRenderer::renderAvailable(const AudioSourceChannelInfo& bufferToFill, int offset, int numSamples, float gainStart, float gainStep)
+{
+    // Every interpolator fits inside the history and lookahead of the widest one
+    const double available = numBufferedSamples - Resampler::numLookaheadSamples - inputReadPosition - 1.0e-9;
+
+    if (available <= 0.0)
+    {
+        return 0;
+    }
+
+    const int numToRender = jmin(numSamples, (int)std::ceil(available / speedRatio));
+
+    // Gather only the stages that change the signal so that bypassed stages cost nothing
+    BiquadStage* stages[3];
+    int numStages = 0;
+
+    if (bandPassStage.active)
+    {
+        stages[numStages++] = &bandPassStage;
+    }
+    if (lowPassStage.active)
+    {
+        stages[numStages++] = &lowPassStage;
+    }
+    if (highPassStage.active)
+    {
+        stages[numStages++] = &highPassStage;
+    }
+
+    const double startPosition = inputReadPosition;
+    const double ratio = speedRatio;
+    const int startIndex = (int)startPosition;
+
+    // At the original speed and sample rate the interpolator reduces to a copy
+    const bool isUnityRate = ratio == 1.0 && startPosition == (double)startIndex;
+
+    for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+    {
+        float* output = bufferToFill.buffer->getWritePointer(channel, bufferToFill.startSample + offset);
+
+        // Decks are stereo, so any further output channels stay silent
+        if (channel >= 2)
+        {
+            FloatVectorOperations::clear(output, numToRender);
+            continue;
+        }
+
+        const float* input = inputBuffer.getReadPointer(jmin(channel, inputBuffer.getNumChannels() - 1));
+
+        if (isUnityRate)
+        {
+            renderChannel([input, startIndex](int i) { return input[startIndex + i]; },
+                output, numToRender, stages, numStages, channel, gainStart, gainStep);
+        }
+        else
+        {
+            float* resampled = resampledBuffer.getWritePointer(0);
+            const int chunkSize = resampledBuffer.getNumSamples();
+
+            // Interpolate in chunks that stay in cache between the resampler and the filters
+            for (int done = 0; done < numToRender; done += chunkSize)
+            {
+                const int numInChunk = jmin(chunkSize, numToRender - done);
+                resampler.process(input, startPosition + done * ratio, ratio, resampled, numInChunk);
+
+                renderChannel([resampled](int i) { return resampled[i]; },
+                    output + done, numInChunk, stages, numStages, channel, gainStart + gainStep * (float)done, gainStep);
+            }
+        }
+    }
+
+    inputReadPosition += numToRender * speedRatio;
+    return numToRender;
+}
+
+/**
+ * Run the active filter stages and gain over one channel, pulling each input sample from the supplied reader
+ *
+ * @param readSample                  Callable returning the interpolated input for an output sample index
+ * @param output                      Destination for the rendered samples
+ * @param numSamples                  Number of samples to render
+ * @param stages                      Filter stages that are not bypassed
+ * @param numStages                   Number of filter stages that are not bypassed
+ * @param channel                     Channel whose filter state is used
+ * @param gainStart                   Gain applied to the first sample
+ * @param gainStep                    Gain increment per sample
+ *
+ * @return                            None
+ */
+template <typename SampleReader>
+void DeckRenderer::renderChannel(SampleReader readSample, float* output, int numSamples, BiquadStage** stages, int numStages,
+    int channel, float gainStart, float gainStep)
+{
+    // Keep the coefficients and state of the cascade in locals for the duration of the pass
+    float coefficients[3][5];
+    float z1[3];
+    float z2[3];
+
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            coefficients[stage][i] = stages[stage]->coefficients[i];
+        }
+
+        z1[stage] = stages[stage]->z1[channel];
+        z2[stage] = stages[stage]->z2[channel];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float sample = readSample(i);
+
+        // Band, low and high pass stages run back to back on the same sample
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            const float* c = coefficients[stage];
+            const float filtered = c[0] * sample + z1[stage];
+            z1[stage] = c[1] * sample - c[3] * filtered + z2[stage];
+            z2[stage] = c[2] * sample - c[4] * filtered;
+            sample = filtered;
+        }
+
+        output[i] = sample * (gainStart + gainStep * (float)i);
+    }
+
+    // Store the state back, flushing denormals like IIRFilter does
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        JUCE_SNAP_TO_ZERO(z1[stage]);
+        JUCE_SNAP_TO_ZERO(z2[stage]);
+
+        stages[stage]->z1[channel] = z1[stage];
+        stages[stage]->z2[channel] = z2[stage];
+    }
+}
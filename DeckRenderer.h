@@ -0,0 +1,765 @@
+/*
+  ==============================================================================
+
+    DeckRenderer.h
+    Created: 16 Oct 2026 10:02:17am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "RealtimeSafetyChecker.h"
+#include "Resampler.h"
+#include "TimeStretcher.h"
+
+using namespace juce;
+
+class DeckRenderer
+{
+public:
+    /** Owner of the deck that changes it from the audio thread, only ever called while render holds the source lock */
+    class Controller
+    {
+    public:
+        virtual ~Controller() = default;
+
+        /**
+         * Called before the first block rendered from a source set since the last block, ahead of any commands
+         *
+         * @param sourceTag                   Tag the source was set with
+         *
+         * @return                            None
+         */
+        virtual void sourceChanged(int sourceTag) = 0;
+
+        /**
+         * Apply every change queued for the deck through the renderer's setters and transport methods
+         *
+         * @param                             None
+         *
+         * @return                            None
+         */
+        virtual void applyPendingCommands() = 0;
+    };
+
+    /**
+     * Constructor that initializes a stopped renderer with neutral speed, gain and filters
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    DeckRenderer();
+
+    /**
+     * Destructor for the renderer
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~DeckRenderer();
+
+    /**
+     * Allocate the working buffers before fetching blocks of audio data
+     *
+     * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is rendered
+     * @param sampleRate                  Number of sound samples taken per second by the audio device
+     *
+     * @return                            None
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /**
+     * Release the working buffers after playback has stopped
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void releaseResources();
+
+    /**
+     * Replace the positionable source that supplies the audio track, waiting for any block being rendered to finish
+     *
+     * @param newSource                   Prepared source to read from, or nullptr to unload the deck
+     * @param sourceSampleRate            Sample rate of the audio track
+     * @param newSourceTag                Number the deck identifies the track by, reported back once the audio thread sees it
+     *
+     * @return                            None
+     */
+    void setSource(PositionableAudioSource* newSource, double sourceSampleRate, int newSourceTag = 0);
+
+    /**
+     * Setter method that sets the track to continue into at the last sample of the loaded track, handed to the next block without
+     * waiting for one, or detached after waiting for any block being rendered to finish
+     *
+     * @param newNextSource               Prepared source, or nullptr to stop at the end of the loaded track
+     * @param newNextSourceSampleRate     Sample rate of the queued audio track
+     *
+     * @return                            None
+     */
+    void setNextSource(PositionableAudioSource* newNextSource, double newNextSourceSampleRate);
+
+    /**
+     * Determine whether the audio thread has switched from the loaded track to the queued one
+     *
+     * @param                             None
+     *
+     * @return                            True if the last queued track is now playing and the previous source is no longer read, false otherwise
+     */
+    bool hasStartedNextSource() const;
+
+    /**
+     * Check whether the queued track has started since the last check, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            True exactly once for each switch to a queued track
+     */
+    bool consumeTrackChange();
+
+    /**
+     * Setter method that sets how long the end of the loaded track overlaps the start of the queued track
+     *
+     * @param seconds                     Length of the equal power crossfade, or zero to switch at the last sample
+     *
+     * @return                            None
+     */
+    void setQueueOverlap(double seconds);
+
+    /**
+     * Apply the controller's changes, then read, resample, filter and apply gain to the next block of audio in one pass per channel
+     *
+     * @param bufferToFill                Buffer that must be filled with audio data
+     * @param controller                  Owner whose queued changes are applied first, or nullptr if nothing is queued
+     *
+     * @return                            None
+     */
+    void render(const AudioSourceChannelInfo& bufferToFill, Controller* controller = nullptr);
+
+    /**
+     * Begin playback from the current position, fading in over one block, called by the controller while render holds the source lock
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void start();
+
+    /**
+     * Stop playback at the current position, fading out over one block, called by the controller while render holds the source lock
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void stop();
+
+    /**
+     * Ask the next block rendered to begin playback, without waiting for the source lock, called on the audio thread
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void requestStart();
+
+    /**
+     * Ask the next block rendered to stop playback with a fade, without waiting for the source lock, called on the audio thread
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void requestStop();
+
+    /**
+     * Determine whether the deck is currently producing audio
+     *
+     * @param                             None
+     *
+     * @return                            True if the deck is playing, false otherwise
+     */
+    bool isPlaying() const;
+
+    /**
+     * Setter method that sets whether the track wraps around seamlessly at its last sample instead of ending, called by the controller while render holds the source lock
+     *
+     * @param shouldLoop                  True to loop the track, false to stop at its end
+     *
+     * @return                            None
+     */
+    void setLooping(bool shouldLoop);
+
+    /**
+     * Determine whether playback stopped because the last sample of the track was rendered, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            True if the playhead is at the end of the track, false otherwise
+     */
+    bool hasReachedEnd() const;
+
+    /**
+     * Check whether the end of the track has been reached since the last check, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            True exactly once for each time the end of the track is reached
+     */
+    bool consumeEndOfTrack();
+
+    /**
+     * Setter method that sets a region of the track that playback repeats, wrapping with a short crossfade at its end, called by the controller while render holds the source lock
+     *
+     * @param startSeconds                Start of the loop region in seconds
+     * @param endSeconds                  End of the loop region in seconds, ignored if it does not follow the start
+     *
+     * @return                            None
+     */
+    void setLoopRegion(double startSeconds, double endSeconds);
+
+    /**
+     * Leave the loop region and continue playing through its end, called by the controller while render holds the source lock
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void clearLoopRegion();
+
+    /**
+     * Determine whether playback is repeating a loop region, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            True if a loop region is active, false otherwise
+     */
+    bool isLoopRegionActive() const;
+
+    /**
+     * Move the playhead to a position in the audio track, called by the controller while render holds the source lock
+     *
+     * @param posInSecs                   Position in seconds
+     *
+     * @return                            None
+     */
+    void setPosition(double posInSecs);
+
+    /**
+     * Getter method that retrieves the playhead position, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Position in seconds
+     */
+    double getCurrentPosition() const;
+
+    /**
+     * Getter method that retrieves the length of the loaded audio track, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Length in seconds, or zero if no track is loaded
+     */
+    double getLengthInSeconds() const;
+
+    /**
+     * Setter method that sets the output gain, ramped over the next block to avoid clicks
+     *
+     * @param newGain                     Linear gain
+     *
+     * @return                            None
+     */
+    void setGain(float newGain);
+
+    /**
+     * Setter method that sets the trim applied before the gain to even out the loudness of tracks, ramped like the gain
+     *
+     * @param newTrim                     Linear gain
+     *
+     * @return                            None
+     */
+    void setTrim(float newTrim);
+
+    /**
+     * Setter method that sets the playback speed, which also shifts the pitch unless key lock is enabled
+     *
+     * @param ratio                       Playback speed where 1.0 is the original speed
+     *
+     * @return                            None
+     */
+    void setSpeed(double ratio);
+
+    /**
+     * Getter method that retrieves the playback speed, called on the audio thread
+     *
+     * @param                             None
+     *
+     * @return                            Playback speed where 1.0 is the original speed
+     */
+    double getSpeed() const;
+
+    /**
+     * Setter method that sets whether speed changes are time-stretched to keep the original pitch, called by the controller while render holds the source lock
+     *
+     * @param shouldLockKey               True to keep the pitch, false to let it follow the speed like a turntable
+     *
+     * @return                            None
+     */
+    void setKeyLock(bool shouldLockKey);
+
+    /**
+     * Determine whether speed changes keep the original pitch
+     *
+     * @param                             None
+     *
+     * @return                            True if key lock is enabled, false otherwise
+     */
+    bool isKeyLockEnabled() const;
+
+    /**
+     * Setter method that sets the interpolator used for the speed and sample rate conversion
+     *
+     * @param quality                     Interpolator to use from the next block
+     *
+     * @return                            None
+     */
+    void setResamplerQuality(Resampler::Quality quality);
+
+    /**
+     * Getter method that retrieves the interpolator used for the speed and sample rate conversion
+     *
+     * @param                             None
+     *
+     * @return                            Interpolator in use
+     */
+    Resampler::Quality getResamplerQuality() const;
+
+    /**
+     * Setter method that sets the centre frequency of the band pass stage
+     *
+     * @param frequency                   Centre frequency in Hz
+     *
+     * @return                            None
+     */
+    void setBandPassFrequency(double frequency);
+
+    /**
+     * Setter method that sets the cut-off of the low pass stage, which is bypassed at or above the neutral frequency
+     *
+     * @param frequency                   Cut-off frequency in Hz
+     *
+     * @return                            None
+     */
+    void setLowPassFrequency(double frequency);
+
+    /**
+     * Setter method that sets the cut-off of the high pass stage, which is bypassed at or below the neutral frequency
+     *
+     * @param frequency                   Cut-off frequency in Hz
+     *
+     * @return                            None
+     */
+    void setHighPassFrequency(double frequency);
+
+    // Low pass cut-off at or above which the stage no longer audibly changes the signal
+    static constexpr double lowPassNeutralFrequency = 20000.0;
+
+    // High pass cut-off at or below which the stage no longer audibly changes the signal
+    static constexpr double highPassNeutralFrequency = 20.0;
+
+    // Length of the crossfade where a loop region wraps, short enough that the loop stays on the beat
+    static constexpr double loopCrossfadeSeconds = 0.005;
+
+    // Audio of the loaded track remembered behind the read position, enough for the longest beat loop of 32 beats down to 64 beats per minute
+    static constexpr double historySeconds = 30.0;
+
+private:
+    /** Transport change asked for outside the render critical section */
+    enum class TransportRequest
+    {
+        none,
+        start,
+        stop
+    };
+
+    /** Second order filter stage using the same transposed direct form II as IIRFilter */
+    struct BiquadStage
+    {
+        // Normalized coefficients b0, b1, b2, a1, a2
+        float coefficients[5] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+        // Filter state for the left and right channels
+        float z1[2] = { 0.0f, 0.0f };
+        float z2[2] = { 0.0f, 0.0f };
+
+        // Stage is skipped entirely when inactive
+        bool active = false;
+    };
+
+    /**
+     * Set the coefficients of a filter stage, or bypass it when it has no audible effect
+     *
+     * @param stage                       Stage to update
+     * @param coefficients                Coefficients designed for the current sample rate
+     * @param shouldBeActive              False if the stage should be bypassed
+     *
+     * @return                            None
+     */
+    void setStage(BiquadStage& stage, const IIRCoefficients& coefficients, bool shouldBeActive);
+
+    /**
+     * Recalculate every filter stage after the sample rate changes
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void updateFilters();
+
+    /**
+     * Discard buffered input so that the next block reads from the current source position
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void resetInput();
+
+    /**
+     * Read more audio from the source into the input buffer, keeping the history needed by the interpolator
+     *
+     * @param samplesStillRequired        Number of output samples that still have to be produced this block
+     *
+     * @return                            None
+     */
+    void refillInput(int samplesStillRequired);
+
+    /**
+     * Read the next samples of the track into the input buffer, through the time stretcher when key lock is enabled
+     *
+     * @param startSample                 First sample of the input buffer to write
+     * @param numSamples                  Number of samples to read
+     *
+     * @return                            None
+     */
+    void readSource(int startSample, int numSamples);
+
+    /**
+     * Read the next samples of the track, continuing into the queued track at its last sample and crossfading the overlap
+     *
+     * @param bufferToFill                Region of a buffer that receives the audio in its first two channels
+     *
+     * @return                            None
+     */
+    void readTrack(const AudioSourceChannelInfo& bufferToFill);
+
+    /**
+     * Read the next samples of the loaded track up to the next loop wrap or jump, crossfading into the audio at the jump target
+     *
+     * @param buffer                      Buffer that receives the audio in its first two channels
+     * @param startSample                 First sample of the buffer to write
+     * @param numSamples                  Maximum number of samples to read
+     *
+     * @return                            Number of samples read, zero if the read position jumped instead
+     */
+    int readLoopRegion(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /**
+     * Read the next samples of the loaded track, from the history while it is behind the source and from the source after that
+     *
+     * @param buffer                      Buffer that receives the audio in its first two channels
+     * @param startSample                 First sample of the buffer to write
+     * @param numSamples                  Number of samples to read
+     *
+     * @return                            None
+     */
+    void readLoadedTrack(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /**
+     * Copy samples of the loaded track out of the history
+     *
+     * @param destination                 Buffer that receives the audio in its first two channels
+     * @param startSample                 First sample of the buffer to write
+     * @param position                    Position in the loaded track of the first sample to copy
+     * @param numSamples                  Number of samples to copy, all of which must be in the history
+     *
+     * @return                            None
+     */
+    void copyFromHistory(AudioBuffer<float>& destination, int startSample, int64 position, int numSamples) const;
+
+    /**
+     * Determine whether a range of the loaded track is held in the history
+     *
+     * @param start                       Position of the first sample
+     * @param end                         Position after the last sample
+     *
+     * @return                            True if every sample of the range can be replayed from memory, false otherwise
+     */
+    bool historyContains(int64 start, int64 end) const;
+
+    /**
+     * Getter method that retrieves the position in the loaded track of the next sample read, which trails the source while the history is replayed
+     *
+     * @param                             None
+     *
+     * @return                            Position in samples
+     */
+    int64 getReadPosition() const;
+
+    /**
+     * Move the read position, replaying from the history if it holds the new position and seeking the source otherwise
+     *
+     * @param newPosition                 Position in samples of the loaded track
+     *
+     * @return                            None
+     */
+    void moveReadPosition(int64 newPosition);
+
+    /**
+     * Move the read position after a seek, abandoning any jump or fade in progress
+     *
+     * @param newPosition                 Position in samples of the loaded track
+     *
+     * @return                            None
+     */
+    void seekReadPosition(int64 newPosition);
+
+    /**
+     * Forget the history and start recording it again from the source position, called after the source changes
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void resetHistory();
+
+    /**
+     * Turn a loop wrap whose crossfade has already begun into a jump, so that changing or leaving the loop cannot cut it short
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void holdLoopWrap();
+
+    /**
+     * Schedule a jump back into the loop region when the read position is already past the point where the wrap crossfade begins
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void updateLoopJump();
+
+    /**
+     * Make the queued track the loaded track, called on the audio thread once the last sample of the loaded track is read
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void switchToNextSource();
+
+    /**
+     * Take over a queued track handed over by the message thread, called with the source lock held
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void adoptPublishedNextSource();
+
+    /**
+     * Getter method that retrieves the size of the history that holds the longest loop of a track, along with its wrap crossfade
+     *
+     * @param sampleRate                  Sample rate of the audio track
+     *
+     * @return                            Number of samples the history needs
+     */
+    static int getHistoryLength(double sampleRate);
+
+    /**
+     * Reposition the queued track to follow the loaded track after the playhead moves
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void alignNextSource();
+
+    /**
+     * Getter method that retrieves the number of samples at the end of the loaded track that overlap the queued track
+     *
+     * @param                             None
+     *
+     * @return                            Overlap in samples of the loaded track
+     */
+    int64 getOverlapLength() const;
+
+    /** Presents the loaded track followed by the queued track to the time stretcher as one continuous source */
+    struct SplicedSource : public PositionableAudioSource
+    {
+        SplicedSource(DeckRenderer& owner) : renderer(owner) {}
+
+        void prepareToPlay(int, double) override {}
+        void releaseResources() override {}
+        void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override { renderer.readTrack(bufferToFill); }
+
+        void setNextReadPosition(int64 newPosition) override { renderer.seekReadPosition(newPosition); }
+        int64 getNextReadPosition() const override { return renderer.getReadPosition(); }
+        int64 getTotalLength() const override { return renderer.source->getTotalLength(); }
+        bool isLooping() const override { return renderer.source->isLooping(); }
+
+        DeckRenderer& renderer;
+    };
+
+    /**
+     * Interpolate, filter and apply gain to as many output samples as the buffered input allows
+     *
+     * @param bufferToFill                Buffer that must be filled with audio data
+     * @param offset                      Number of samples already produced this block
+     * @param numSamples                  Number of samples still required this block
+     * @param gainStart                   Gain applied to the first produced sample
+     * @param gainStep                    Gain increment per produced sample
+     *
+     * @return                            Number of samples produced
+     */
+    int renderAvailable(const AudioSourceChannelInfo& bufferToFill, int offset, int numSamples, float gainStart, float gainStep);
+
+    /**
+     * Run the active filter stages and gain over one channel, pulling each input sample from the supplied reader
+     *
+     * @param readSample                  Callable returning the resampled input for an output sample index
+     * @param output                      Destination for the rendered samples
+     * @param numSamples                  Number of samples to render
+     * @param stages                      Filter stages that are not bypassed
+     * @param numStages                   Number of filter stages that are not bypassed
+     * @param channel                     Channel whose filter state is used
+     * @param gainStart                   Gain applied to the first sample
+     * @param gainStep                    Gain increment per sample
+     *
+     * @return                            None
+     */
+    template <typename SampleReader>
+    static void renderChannel(SampleReader readSample, float* output, int numSamples, BiquadStage** stages, int numStages,
+        int channel, float gainStart, float gainStep);
+
+    // Audio track supplier, swapped under the source lock, which the audio thread only ever try-locks
+    PositionableAudioSource* source;
+    RealtimeSafetyChecker::CheckedSpinLock sourceLock{ "DeckRenderer::sourceLock" };
+
+    // Counts every source set under the lock, with the caller's tag for the latest one
+    int sourceSerial;
+    int sourceTag;
+
+    // Last source reported to the controller, owned by the audio thread
+    int reportedSourceSerial;
+
+    double sourceSampleRate;
+    double outputSampleRate;
+
+    // Queued track that follows the loaded track, owned by the player until the switch is reported
+    PositionableAudioSource* nextSource;
+    double nextSourceSampleRate;
+
+    // Queued track handed over by the message thread, which only writes it while the flag is clear, until a block adopts it
+    PositionableAudioSource* publishedNextSource;
+    double publishedNextSourceSampleRate;
+    std::unique_ptr<TimeStretcher> publishedNextTimeStretcher;
+    AudioBuffer<float> publishedNextHistoryBuffer;
+    std::atomic<bool> nextSourcePublished;
+    SplicedSource splicedSource{ *this };
+
+    // Crossfade into the queued track, where overlapStart is the loaded track position it began at or -1 before then
+    double queueOverlapSeconds;
+    int64 overlapStart;
+    AudioBuffer<float> overlapBuffer;
+    int blockSize;
+
+    // Loop region in samples of the loaded track, wrapped with a crossfade of loopCrossfadeLength samples
+    bool loopActive;
+    int64 loopStart;
+    int64 loopEnd;
+    int loopCrossfadeLength;
+
+    // Jump made once the read position reaches jumpFrom, or -1 while the next jump is the wrap at the loop end
+    int64 jumpFrom;
+    int64 jumpTo;
+    int jumpFadeLength;
+
+    // Set when the audio in front of the jump target is not in the history, so the jump fades out and back in instead
+    bool jumpDips;
+    int fadeInLength;
+    int fadeInProgress;
+
+    // Samples read from the loaded track since the last discontinuity, so loops replay from memory instead of
+    // seeking a streamed source back behind its read ahead, and historyReadPosition is -1 unless it is being replayed;
+    // sized for each track's sample rate outside the lock, where the queued track's history is empty if it needs no other size
+    AudioBuffer<float> historyBuffer;
+    AudioBuffer<float> nextHistoryBuffer;
+    int64 historyStart;
+    int64 historyEnd;
+    int64 historyReadPosition;
+
+    // Input samples waiting to be interpolated, with the history the widest interpolator needs before the read position
+    AudioBuffer<float> inputBuffer;
+    int numBufferedSamples;
+    double inputReadPosition;
+
+    // Interpolates one channel at a time into the resampled buffer ahead of the filters
+    Resampler resampler;
+    AudioBuffer<float> resampledBuffer;
+
+    // Input samples consumed per output sample, combining the speed and the sample rate conversion
+    double speed;
+    double speedRatio;
+
+    // Changes the tempo before resampling when key lock is enabled, so the resampler only converts the sample rate,
+    // and is replaced with one prepared outside the lock whenever a track is set
+    std::unique_ptr<TimeStretcher> timeStretcher;
+    bool keyLock;
+
+    // Prepared for the queued track's sample rate outside the lock, then held as pending when a switch happens mid-stretch
+    // until the next discontinuity, so queueing another track cannot drop it
+    std::unique_ptr<TimeStretcher> nextTimeStretcher;
+    std::unique_ptr<TimeStretcher> pendingTimeStretcher;
+    bool timeStretcherSwapPending;
+
+    BiquadStage bandPassStage;
+    BiquadStage lowPassStage;
+    BiquadStage highPassStage;
+
+    double bandPassFrequency;
+    double lowPassFrequency;
+    double highPassFrequency;
+
+    float gain;
+    float trim;
+    float lastGain;
+
+    bool playing;
+    bool stopRequested;
+    bool looping;
+
+    // Latest transport change asked for by the mixer, applied by the next render that gets the lock
+    std::atomic<TransportRequest> transportRequest;
+
+    // Published for the message thread
+    std::atomic<double> positionInSeconds;
+    std::atomic<double> lengthInSeconds;
+    std::atomic<bool> playingFlag;
+    std::atomic<bool> keyLockFlag;
+    std::atomic<bool> loopActiveFlag;
+    std::atomic<bool> endReached;
+    std::atomic<bool> endOfTrackPending;
+    std::atomic<bool> nextSourceStarted;
+    std::atomic<bool> trackChangePending;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckRenderer)
+};
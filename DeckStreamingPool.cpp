@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    DeckStreamingPool.cpp
+    Created: 16 Oct 2026 2:20:51pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "DeckStreamingPool.h"
+
+/**
+ * Constructor that starts a single disk streaming thread shared by every deck
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DeckStreamingPool::DeckStreamingPool() : defaultReadAheadSeconds(4.0)
+{
+    setNumThreads(1);
+}
+
+/**
+ * Destructor that stops the streaming threads
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DeckStreamingPool::~DeckStreamingPool()
+{
+    for (auto* thread : threads)
+    {
+        thread->stopThread(2000);
+    }
+}
+
+/**
+ * Setter method that sets the number of disk streaming threads, idle threads are removed when shrinking
+ *
+ * @param numThreads                  Number of threads to keep, at least one
+ *
+ * @return                            None
+ */
+void DeckStreamingPool::setNumThreads(int numThreads)
+{
+    numThreads = jmax(1, numThreads);
+
+    while (threads.size() < numThreads)
+    {
+        auto* thread = threads.add(new TimeSliceThread("Deck Streaming " + String(threads.size() + 1)));
+
+        // Above normal priority so that disk reads keep up with the audio thread under UI load
+        thread->startThread(7);
+    }
+
+    // Threads that still serve a deck are kept until that deck loads another track
+    for (int i = threads.size(); --i >= 0 && threads.size() > numThreads;)
+    {
+        if (threads[i]->getNumClients() == 0)
+        {
+            threads[i]->stopThread(2000);
+            threads.remove(i);
+        }
+    }
+}
+
+/**
+ * Getter method that retrieves the number of disk streaming threads
+ *
+ * @param                             None
+ *
+ * @return                            Number of threads
+ */
+int DeckStreamingPool::getNumThreads() const
+{
+    return threads.size();
+}
+
+/**
+ * Pick the streaming thread with the fewest decks attached to it
+ *
+ * @param                             None
+ *
+ * @return                            Thread that a new deck source should be added to
+ */
+TimeSliceThread& DeckStreamingPool::getThreadForNewSource()
+{
+    TimeSliceThread* leastBusy = threads.getFirst();
+
+    for (auto* thread : threads)
+    {
+        if (thread->getNumClients() < leastBusy->getNumClients())
+        {
+            leastBusy = thread;
+        }
+    }
+
+    return *leastBusy;
+}
+
+/**
+ * Setter method that sets the default amount of audio each deck reads ahead of its playhead
+ *
+ * @param seconds                     Read ahead in seconds
+ *
+ * @return                            None
+ */
+void DeckStreamingPool::setDefaultReadAheadSeconds(double seconds)
+{
+    defaultReadAheadSeconds = jmax(0.1, seconds);
+}
+
+/**
+ * Getter method that retrieves the default amount of audio each deck reads ahead of its playhead
+ *
+ * @param                             None
+ *
+ * @return                            Read ahead in seconds
+ */
+double DeckStreamingPool::getDefaultReadAheadSeconds() const
+{
+    return defaultReadAheadSeconds;
+}
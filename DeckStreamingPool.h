@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    DeckStreamingPool.h
+    Created: 16 Oct 2026 2:20:51pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class DeckStreamingPool
+{
+public:
+    /**
+     * Constructor that starts a single disk streaming thread shared by every deck
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    DeckStreamingPool();
+
+    /**
+     * Destructor that stops the streaming threads
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~DeckStreamingPool();
+
+    /**
+     * Setter method that sets the number of disk streaming threads, idle threads are removed when shrinking
+     *
+     * @param numThreads                  Number of threads to keep, at least one
+     *
+     * @return                            None
+     */
+    void setNumThreads(int numThreads);
+
+    /**
+     * Getter method that retrieves the number of disk streaming threads
+     *
+     * @param                             None
+     *
+     * @return                            Number of threads
+     */
+    int getNumThreads() const;
+
+    /**
+     * Pick the streaming thread with the fewest decks attached to it
+     *
+     * @param                             None
+     *
+     * @return                            Thread that a new deck source should be added to
+     */
+    TimeSliceThread& getThreadForNewSource();
+
+    /**
+     * Setter method that sets the default amount of audio each deck reads ahead of its playhead
+     *
+     * @param seconds                     Read ahead in seconds
+     *
+     * @return                            None
+     */
+    void setDefaultReadAheadSeconds(double seconds);
+
+    /**
+     * Getter method that retrieves the default amount of audio each deck reads ahead of its playhead
+     *
+     * @param                             None
+     *
+     * @return                            Read ahead in seconds
+     */
+    double getDefaultReadAheadSeconds() const;
+
+private:
+    OwnedArray<TimeSliceThread> threads;
+    double defaultReadAheadSeconds;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckStreamingPool)
+};
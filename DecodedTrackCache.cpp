@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.cpp
+    Created: 16 Oct 2026 3:34:12pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackCache.h"
+
+/**
+ * Constructor for an empty cache with the default memory budget
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DecodedTrackCache::DecodedTrackCache() : memoryBudget((int64)1024 * 1024 * 1024), memoryUsage(0)
+{
+}
+
+/**
+ * Destructor for the cache
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+DecodedTrackCache::~DecodedTrackCache()
+{
+}
+
+/**
+ * Return the decoded audio of a track, decoding it first if it is not cached, called on a background thread
+ *
+ * @param audioFile                   Local audio file to decode
+ * @param formatManager               Format manager used to create a reader
+ * @param shouldCancel                Polled between chunks, decoding stops early if it returns true
+ * @param preferredReader             Reader to decode from instead of opening the file, such as a decoded copy, owned by this call
+ *
+ * @return                            Decoded track, or nullptr if the file cannot be read or decoding was cancelled
+ */
+DecodedTrackCache::DecodedTrack::Ptr DecodedTrackCache::getOrDecode(const File& audioFile, AudioFormatManager& formatManager, std::function<bool()> shouldCancel,
+    AudioFormatReader* preferredReader)
+{
+    std::unique_ptr<AudioFormatReader> reader(preferredReader);
+    const String key = createKey(audioFile);
+
+    {
+        const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType scopedLock(lock);
+
+        for (int i = 0; i < tracks.size(); ++i)
+        {
+            if (tracks[i]->key == key)
+            {
+                // Move the track to the most recently used end
+                DecodedTrack::Ptr track = tracks[i];
+                tracks.move(i, -1);
+                return track;
+            }
+        }
+    }
+
+    // Decoding a whole track waits on the disk for as long as it takes
+    RealtimeSafetyChecker::noteBlockingCall("DecodedTrackCache::getOrDecode");
+
+    if (reader == nullptr)
+    {
+        reader.reset(formatManager.createReaderFor(audioFile));
+    }
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->lengthInSamples > std::numeric_limits<int>::max())
+    {
+        return nullptr;
+    }
+
+    DecodedTrack::Ptr track = new DecodedTrack(key, reader->sampleRate);
+    const int numSamples = (int)reader->lengthInSamples;
+    track->audio.setSize(2, numSamples);
+
+    // Decode in chunks so that a newer load can cancel a long decode
+    const int chunkSize = 1 << 16;
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        if (shouldCancel != nullptr && shouldCancel())
+        {
+            return nullptr;
+        }
+
+        reader->read(&track->audio, start, jmin(chunkSize, numSamples - start), start, true, true);
+    }
+
+    {
+        const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType scopedLock(lock);
+
+        // Another deck may have decoded the same track in the meantime
+        for (int i = 0; i < tracks.size(); ++i)
+        {
+            if (tracks[i]->key == key)
+            {
+                return tracks[i];
+            }
+        }
+
+        tracks.add(track);
+        memoryUsage += track->getSizeInBytes();
+        evictToBudget();
+    }
+
+    return track;
+}
+
+/**
+ * Setter method that sets the memory the cache may keep, evicting the least recently used tracks if needed
+ *
+ * @param bytes                       Memory budget in bytes
+ *
+ * @return                            None
+ */
+void DecodedTrackCache::setMemoryBudget(int64 bytes)
+{
+    const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType scopedLock(lock);
+
+    memoryBudget = jmax((int64)0, bytes);
+    evictToBudget();
+}
+
+/**
+ * Getter method that retrieves the memory the cache may keep
+ *
+ * @param                             None
+ *
+ * @return                            Memory budget in bytes
+ */
+int64 DecodedTrackCache::getMemoryBudget() const
+{
+    const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType scopedLock(lock);
+    return memoryBudget;
+}
+
+/**
+ * Getter method that retrieves the memory held by cached tracks
+ *
+ * @param                             None
+ *
+ * @return                            Size in bytes
+ */
+int64 DecodedTrackCache::getMemoryUsage() const
+{
+    const RealtimeSafetyChecker::CheckedCriticalSection::ScopedLockType scopedLock(lock);
+    return memoryUsage;
+}
+
+/**
+ * Build the key that identifies a file, so that an edited file is decoded again
+ *
+ * @param audioFile                   Local audio file
+ *
+ * @return                            Key made of the path, size and modification time
+ */
+String DecodedTrackCache::createKey(const File& audioFile)
+{
+    return audioFile.getFullPathName() + "|" + String(audioFile.getSize()) + "|" + String(audioFile.getLastModificationTime().toMilliseconds());
+}
+
+/**
+ * Evict the least recently used tracks until the cache fits the memory budget, called with the lock held
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void DecodedTrackCache::evictToBudget()
+{
+    // Decks still playing an evicted track keep their own reference until they load another one
+    while (memoryUsage > memoryBudget && tracks.size() > 0)
+    {
+        memoryUsage -= tracks.getFirst()->getSizeInBytes();
+        tracks.remove(0);
+    }
+}
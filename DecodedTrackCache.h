@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.h
+    Created: 16 Oct 2026 3:34:12pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "RealtimeSafetyChecker.h"
+
+using namespace juce;
+
+class DecodedTrackCache
+{
+public:
+    /** Audio track decoded into memory, shared by the cache and every deck playing it */
+    class DecodedTrack : public ReferenceCountedObject
+    {
+    public:
+        using Ptr = ReferenceCountedObjectPtr<DecodedTrack>;
+
+        /**
+         * Constructor that takes ownership of fully decoded audio
+         *
+         * @param _key                    Cache key of the audio track
+         * @param _sampleRate             Sample rate of the decoded audio
+         *
+         * @return                        None
+         */
+        DecodedTrack(const String& _key, double _sampleRate) : key(_key), sampleRate(_sampleRate) {}
+
+        /**
+         * Getter method that retrieves the memory used by the decoded audio
+         *
+         * @param                         None
+         *
+         * @return                        Size in bytes
+         */
+        int64 getSizeInBytes() const { return (int64)audio.getNumChannels() * audio.getNumSamples() * (int64)sizeof(float); }
+
+        const String key;
+        const double sampleRate;
+        AudioBuffer<float> audio;
+    };
+
+    /**
+     * Constructor for an empty cache with the default memory budget
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    DecodedTrackCache();
+
+    /**
+     * Destructor for the cache
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~DecodedTrackCache();
+
+    /**
+     * Return the decoded audio of a track, decoding it first if it is not cached, called on a background thread
+     *
+     * @param audioFile                   Local audio file to decode
+     * @param formatManager               Format manager used to create a reader
+     * @param shouldCancel                Polled between chunks, decoding stops early if it returns true
+     * @param preferredReader             Reader to decode from instead of opening the file, such as a decoded copy, owned by this call
+     *
+     * @return                            Decoded track, or nullptr if the file cannot be read or decoding was cancelled
+     */
+    DecodedTrack::Ptr getOrDecode(const File& audioFile, AudioFormatManager& formatManager, std::function<bool()> shouldCancel,
+        AudioFormatReader* preferredReader = nullptr);
+
+    /**
+     * Setter method that sets the memory the cache may keep, evicting the least recently used tracks if needed
+     *
+     * @param bytes                       Memory budget in bytes
+     *
+     * @return                            None
+     */
+    void setMemoryBudget(int64 bytes);
+
+    /**
+     * Getter method that retrieves the memory the cache may keep
+     *
+     * @param                             None
+     *
+     * @return                            Memory budget in bytes
+     */
+    int64 getMemoryBudget() const;
+
+    /**
+     * Getter method that retrieves the memory held by cached tracks
+     *
+     * @param                             None
+     *
+     * @return                            Size in bytes
+     */
+    int64 getMemoryUsage() const;
+
+    /**
+     * Build the key that identifies a file, so that an edited file is decoded again
+     *
+     * @param audioFile                   Local audio file
+     *
+     * @return                            Key made of the path, size and modification time
+     */
+    static String createKey(const File& audioFile);
+
+private:
+    /**
+     * Evict the least recently used tracks until the cache fits the memory budget, called with the lock held
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void evictToBudget();
+
+    // Cached tracks ordered from least to most recently used
+    ReferenceCountedArray<DecodedTrack> tracks;
+    int64 memoryBudget;
+    int64 memoryUsage;
+
+    RealtimeSafetyChecker::CheckedCriticalSection lock{ "DecodedTrackCache::lock" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrackCache)
+};
@@ -0,0 +1,514 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 16 Oct 2026 11:26:43am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "EngineBenchmark.h"
+
+/**
+ * Constructor that configures the simulated audio device used for every measurement
+ *
+ * @param _sampleRate                 Output sample rate of the simulated audio device
+ * @param _blockSize                  Number of samples rendered per simulated audio callback
+ * @param _secondsPerCase             Seconds of audio rendered for each measurement
+ *
+ * @return                            None
+ */
+EngineBenchmark::EngineBenchmark(double _sampleRate, int _blockSize, double _secondsPerCase)
+    : sampleRate(_sampleRate), blockSize(_blockSize), secondsPerCase(_secondsPerCase)
+{
+    // Fill five seconds of stereo audio with repeatable noise
+    Random random(1234);
+    track.setSize(2, (int)(sampleRate * 5.0));
+
+    for (int channel = 0; channel < track.getNumChannels(); ++channel)
+    {
+        float* samples = track.getWritePointer(channel);
+
+        for (int i = 0; i < track.getNumSamples(); ++i)
+        {
+            samples[i] = random.nextFloat() * 2.0f - 1.0f;
+        }
+    }
+}
+
+/**
+ * Destructor for the benchmark
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+EngineBenchmark::~EngineBenchmark()
+{
+}
+
+/**
+ * Render the same looping noise track through the legacy source chain and the fused deck renderer, then
+ * through the fused deck renderer with and without key lock at speeds around the original tempo, then
+ * measure the throughput and aliasing of each resampler tier, then render sets of key locked decks
+ * one after another and in parallel, then measure the callback headroom of full mixes of 2, 4 and 8 decks
+ *
+ * @param                             None
+ *
+ * @return                            Report listing the CPU cost per deck of each pipeline as a percentage of real time
+ */
+String EngineBenchmark::run()
+{
+    // Neutral matches a freshly loaded deck, active moves every dial away from its default
+    const DeckSettings cases[] = {
+        { "neutral", 1.0, 0.0, DeckRenderer::lowPassNeutralFrequency, DeckRenderer::highPassNeutralFrequency, false },
+        { "active", 1.25, 500.0, 8000.0, 200.0, false }
+    };
+
+    String report;
+    report << "Deck render benchmark: " << sampleRate << " Hz, " << blockSize << " samples per block, "
+        << secondsPerCase << " s of audio per case" << newLine;
+
+    for (const auto& settings : cases)
+    {
+        const double legacy = measureLegacyChain(settings);
+        const double fused = measureDeckRenderer(settings);
+
+        report << settings.name.paddedRight(' ', 10)
+            << "legacy chain " << String(legacy, 3) << " % CPU per deck, "
+            << "fused renderer " << String(fused, 3) << " % CPU per deck";
+
+        if (fused > 0.0)
+        {
+            report << " (" << String(legacy / fused, 2) << "x)";
+        }
+
+        report << newLine;
+    }
+
+    // The legacy chain has no key lock, so the time stretcher is compared against the renderer on its own
+    TimeStretcher stretcher;
+    stretcher.prepare(sampleRate);
+
+    report << "Key lock: WSOLA with " << stretcher.getFrameSize() << " sample frames, one "
+        << stretcher.getFftSize() << " point cross-correlation every " << stretcher.getSynthesisHop() << " samples" << newLine;
+
+    const double keyLockSpeeds[] = { 0.9, 1.0, 1.1 };
+
+    for (const double speed : keyLockSpeeds)
+    {
+        const DeckSettings unlocked = { String(speed, 2) + "x", speed, 0.0,
+            DeckRenderer::lowPassNeutralFrequency, DeckRenderer::highPassNeutralFrequency, false };
+
+        DeckSettings locked = unlocked;
+        locked.keyLock = true;
+
+        const double withoutKeyLock = measureDeckRenderer(unlocked);
+        const double withKeyLock = measureDeckRenderer(locked);
+
+        report << unlocked.name.paddedRight(' ', 10)
+            << "fused renderer " << String(withoutKeyLock, 3) << " % CPU per deck, "
+            << "with key lock " << String(withKeyLock, 3) << " % CPU per deck" << newLine;
+    }
+
+    // A passband tone shows high frequency loss, a tone pushed past the Nyquist frequency shows aliasing
+    const double passbandFrequency = sampleRate * 10000.0 / 44100.0;
+    const double aliasingFrequency = sampleRate * 0.4;
+
+    report << "Resampler tiers: throughput at 1.1x, error of a " << String(passbandFrequency / 1000.0, 1) << " kHz tone at 0.9x, "
+        << "aliasing of a " << String(aliasingFrequency / 1000.0, 1) << " kHz tone at 1.5x" << newLine;
+
+    for (auto quality : { Resampler::Quality::linear, Resampler::Quality::lagrange, Resampler::Quality::sinc })
+    {
+        report << Resampler::getQualityName(quality).paddedRight(' ', 10)
+            << String(measureResamplerThroughput(quality), 1) << " M samples/s, "
+            << "passband error " << String(measureResamplerError(quality, passbandFrequency, 0.9), 1) << " dB, "
+            << "aliasing " << String(measureResamplerError(quality, aliasingFrequency, 1.5), 1) << " dB" << newLine;
+    }
+
+    // The parallel figure is the wall clock time of the block, which is what has to fit inside the audio callback
+    report << "Deck sets: key locked decks at 1.1x, one after another and on " << SystemStats::getNumCpus() << " cores" << newLine;
+
+    for (const int numDecks : { 2, 4 })
+    {
+        double serialDeckCpu = 0.0;
+        double parallelDeckCpu = 0.0;
+        const double serial = measureDeckSet(numDecks, false, serialDeckCpu);
+        const double parallel = measureDeckSet(numDecks, true, parallelDeckCpu);
+
+        report << (String(numDecks) + " decks").paddedRight(' ', 10)
+            << "serial " << String(serial, 3) << " % CPU (" << String(serialDeckCpu, 3) << " % per deck), "
+            << "parallel " << String(parallel, 3) << " % CPU (" << String(parallelDeckCpu, 3) << " % per deck)";
+
+        if (parallel > 0.0)
+        {
+            report << " (" << String(serial / parallel, 2) << "x)";
+        }
+
+        report << newLine;
+    }
+
+    // Headroom is what the slowest callback leaves of the period, since one late callback is enough to drop out
+    report << "Callback headroom: decks mixed at speeds from 0.96x to 1.08x with filters set and every other deck key locked" << newLine;
+
+    for (const int numDecks : { 2, 4, 8 })
+    {
+        for (const bool parallel : { false, true })
+        {
+            double worst = 0.0;
+            const double average = measureCallbackLoad(numDecks, parallel, worst);
+
+            report << (String(numDecks) + " decks").paddedRight(' ', 10)
+                << (parallel ? "parallel " : "serial   ")
+                << "average " << String(average, 2) << " %, "
+                << "worst " << String(worst, 2) << " %, "
+                << "headroom " << String(100.0 - worst, 2) << " % of the callback period" << newLine;
+        }
+    }
+
+    return report;
+}
+
+/**
+ * Measure the transport, resampler and three filter sources that each deck used to chain together
+ *
+ * @param settings                    Deck settings to render with
+ *
+ * @return                            CPU cost as a percentage of real time
+ */
+double EngineBenchmark::measureLegacyChain(const DeckSettings& settings)
+{
+    MemoryAudioSource memorySource(track, false, true);
+
+    AudioTransportSource transportSource;
+    ResamplingAudioSource resampleSource{ &transportSource, false, 2 };
+    IIRFilterAudioSource bandIIRFilterSource{ &resampleSource, false };
+    IIRFilterAudioSource lowIIRFilterSource{ &bandIIRFilterSource, false };
+    IIRFilterAudioSource highIIRFilterSource{ &lowIIRFilterSource, false };
+
+    transportSource.setSource(&memorySource, 0, nullptr, sampleRate);
+    highIIRFilterSource.prepareToPlay(blockSize, sampleRate);
+
+    // The chain has no bypass, so every stage that has been set keeps filtering
+    resampleSource.setResamplingRatio(settings.speed);
+
+    if (settings.bandPassFrequency > 0.0)
+    {
+        bandIIRFilterSource.setCoefficients(IIRCoefficients::makeBandPass(sampleRate, settings.bandPassFrequency));
+    }
+
+    lowIIRFilterSource.setCoefficients(IIRCoefficients::makeLowPass(sampleRate, settings.lowPassFrequency));
+    highIIRFilterSource.setCoefficients(IIRCoefficients::makeHighPass(sampleRate, settings.highPassFrequency));
+    transportSource.start();
+
+    const double cpu = measure([&highIIRFilterSource](const AudioSourceChannelInfo& info)
+        {
+            highIIRFilterSource.getNextAudioBlock(info);
+        });
+
+    highIIRFilterSource.releaseResources();
+    transportSource.setSource(nullptr);
+
+    return cpu;
+}
+
+/**
+ * Measure the fused deck renderer, time-stretching the track first if the settings enable key lock
+ *
+ * @param settings                    Deck settings to render with
+ *
+ * @return                            CPU cost as a percentage of real time
+ */
+double EngineBenchmark::measureDeckRenderer(const DeckSettings& settings)
+{
+    MemoryAudioSource memorySource(track, false, true);
+    memorySource.prepareToPlay(blockSize, sampleRate);
+
+    DeckRenderer renderer;
+    renderer.prepareToPlay(blockSize, sampleRate);
+    renderer.setSource(&memorySource, sampleRate);
+
+    renderer.setKeyLock(settings.keyLock);
+    renderer.setSpeed(settings.speed);
+
+    if (settings.bandPassFrequency > 0.0)
+    {
+        renderer.setBandPassFrequency(settings.bandPassFrequency);
+    }
+
+    renderer.setLowPassFrequency(settings.lowPassFrequency);
+    renderer.setHighPassFrequency(settings.highPassFrequency);
+    renderer.start();
+
+    const double cpu = measure([&renderer](const AudioSourceChannelInfo& info)
+        {
+            renderer.render(info);
+        });
+
+    renderer.setSource(nullptr, sampleRate);
+    renderer.releaseResources();
+
+    return cpu;
+}
+
+/**
+ * Measure how fast a resampler tier interpolates one channel of the noise track at 1.1x
+ *
+ * @param quality                     Resampler tier to measure
+ *
+ * @return                            Millions of output samples per second
+ */
+double EngineBenchmark::measureResamplerThroughput(Resampler::Quality quality)
+{
+    Resampler resampler;
+    resampler.setQuality(quality);
+
+    const double ratio = 1.1;
+    const int numInput = track.getNumSamples() - Resampler::numHistorySamples - Resampler::numLookaheadSamples - 1;
+    const int numOutput = (int)((numInput - 1) / ratio);
+
+    const float* input = track.getReadPointer(0) + Resampler::numHistorySamples;
+    HeapBlock<float> output((size_t)numOutput);
+
+    // Resample the whole track as many times as it takes to cover the configured amount of audio
+    const int numPasses = jmax(1, (int)(secondsPerCase * sampleRate / numOutput));
+
+    resampler.process(input, 0.0, ratio, output, numOutput);
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    for (int pass = 0; pass < numPasses; ++pass)
+    {
+        resampler.process(input, 0.0, ratio, output, numOutput);
+    }
+
+    const double elapsedSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+
+    return elapsedSeconds > 0.0 ? (double)numOutput * numPasses / elapsedSeconds / 1.0e6 : 0.0;
+}
+
+/**
+ * Resample a sine tone and measure how far the result is from the ideal band limited output
+ *
+ * @param quality                     Resampler tier to measure
+ * @param frequency                   Tone frequency in Hz
+ * @param ratio                       Input samples advanced per output sample
+ *
+ * @return                            Error relative to the tone in dB, where the ideal output is silence if the tone lands above the Nyquist frequency
+ */
+double EngineBenchmark::measureResamplerError(Resampler::Quality quality, double frequency, double ratio)
+{
+    Resampler resampler;
+    resampler.setQuality(quality);
+
+    // One second of tone with room for the interpolator on either side
+    const int numInput = (int)sampleRate + Resampler::numHistorySamples + Resampler::numLookaheadSamples + 1;
+    HeapBlock<float> input((size_t)numInput);
+    const double phaseStep = MathConstants<double>::twoPi * frequency / sampleRate;
+
+    for (int i = 0; i < numInput; ++i)
+    {
+        input[i] = (float)std::sin(phaseStep * (i - Resampler::numHistorySamples));
+    }
+
+    const int numOutput = (int)((sampleRate - 1.0) / ratio);
+    HeapBlock<float> output((size_t)numOutput);
+    resampler.process(input + Resampler::numHistorySamples, 0.0, ratio, output, numOutput);
+
+    // A tone that lands above the output Nyquist frequency should be removed entirely
+    const bool shouldPass = frequency * ratio < sampleRate * 0.5;
+    double errorEnergy = 0.0;
+    int numMeasured = 0;
+
+    // Skip the edges, where the kernels reach past the end of the tone
+    for (int i = 64; i < numOutput - 64; ++i)
+    {
+        const double ideal = shouldPass ? std::sin(phaseStep * i * ratio) : 0.0;
+        const double error = output[i] - ideal;
+        errorEnergy += error * error;
+        ++numMeasured;
+    }
+
+    // Relative to the energy of a full scale sine
+    const double relativeEnergy = errorEnergy / jmax(1, numMeasured) / 0.5;
+
+    return Decibels::gainToDecibels(std::sqrt(relativeEnergy), -200.0);
+}
+
+/**
+ * Measure a set of key locked decks rendered into separate buffers each block, as the mixer renders them
+ *
+ * @param numDecks                    Number of decks in the set
+ * @param parallel                    True to render the decks on a render pool, false to render them one after another
+ * @param deckCpu                     Receives the average CPU cost of one deck as a percentage of real time
+ *
+ * @return                            Wall clock cost of rendering the whole set as a percentage of real time
+ */
+double EngineBenchmark::measureDeckSet(int numDecks, bool parallel, double& deckCpu)
+{
+    OwnedArray<MemoryAudioSource> sources;
+    OwnedArray<DeckRenderer> renderers;
+    OwnedArray<AudioBuffer<float>> deckBuffers;
+
+    for (int deck = 0; deck < numDecks; ++deck)
+    {
+        auto* source = sources.add(new MemoryAudioSource(track, false, true));
+        source->prepareToPlay(blockSize, sampleRate);
+
+        auto* renderer = renderers.add(new DeckRenderer());
+        renderer->prepareToPlay(blockSize, sampleRate);
+        renderer->setSource(source, sampleRate);
+        renderer->setKeyLock(true);
+        renderer->setSpeed(1.1);
+        renderer->start();
+
+        deckBuffers.add(new AudioBuffer<float>(2, blockSize));
+    }
+
+    // The audio thread renders one deck itself, so the pool needs one worker fewer than there are decks
+    DeckRenderPool renderPool(numDecks - 1);
+    renderPool.prepare(blockSize, sampleRate);
+    renderPool.setEnabled(parallel);
+
+    std::atomic<int64> totalDeckTicks(0);
+
+    const DeckRenderPool::Task renderTask = [&](int deck)
+    {
+        const int64 startTicks = Time::getHighResolutionTicks();
+        renderers[deck]->render(AudioSourceChannelInfo(deckBuffers[deck], 0, blockSize));
+        totalDeckTicks += Time::getHighResolutionTicks() - startTicks;
+    };
+
+    const double cpu = measure([&](const AudioSourceChannelInfo&)
+        {
+            renderPool.run(renderTask, numDecks);
+        });
+
+    // The deck time counts the warm up blocks as well, which measure leaves out of its own figure
+    const int numBlocks = 64 + jmax(1, (int)(secondsPerCase * sampleRate / blockSize));
+    const double audioSeconds = (double)numBlocks * blockSize / sampleRate;
+    deckCpu = 100.0 * Time::highResolutionTicksToSeconds(totalDeckTicks.load()) / audioSeconds / numDecks;
+
+    for (auto* renderer : renderers)
+    {
+        renderer->setSource(nullptr, sampleRate);
+        renderer->releaseResources();
+    }
+
+    return cpu;
+}
+
+/**
+ * Render and mix a set of playing decks with mixed speeds, filters and key lock, as the audio callback does
+ *
+ * @param numDecks                    Number of decks, alternately assigned to sides A and B of the crossfader
+ * @param parallel                    True to render the decks on a render pool, false to render them one after another
+ * @param worstCpu                    Receives the cost of the slowest callback as a percentage of the callback period
+ *
+ * @return                            Average cost of a callback as a percentage of the callback period
+ */
+double EngineBenchmark::measureCallbackLoad(int numDecks, bool parallel, double& worstCpu)
+{
+    OwnedArray<MemoryAudioSource> sources;
+    OwnedArray<DeckRenderer> renderers;
+    OwnedArray<AudioBuffer<float>> deckBuffers;
+    HeapBlock<MixerBus::Input> inputs((size_t)numDecks);
+
+    for (int deck = 0; deck < numDecks; ++deck)
+    {
+        auto* source = sources.add(new MemoryAudioSource(track, false, true));
+        source->prepareToPlay(blockSize, sampleRate);
+
+        auto* renderer = renderers.add(new DeckRenderer());
+        renderer->prepareToPlay(blockSize, sampleRate);
+        renderer->setSource(source, sampleRate);
+        renderer->setKeyLock(deck % 2 == 1);
+        renderer->setSpeed(0.96 + 0.12 * deck / jmax(1, numDecks - 1));
+        renderer->setLowPassFrequency(12000.0);
+        renderer->setHighPassFrequency(60.0);
+        renderer->start();
+
+        inputs[deck].buffer = deckBuffers.add(new AudioBuffer<float>(2, blockSize));
+        inputs[deck].side = deck % 2 == 0 ? MixerBus::Side::a : MixerBus::Side::b;
+    }
+
+    MixerBus mixerBus;
+    mixerBus.prepare(blockSize);
+
+    // The crossfader sits in the middle, so every deck is heard
+    HeapBlock<float> positions((size_t)blockSize);
+    FloatVectorOperations::fill(positions, 0.5f, blockSize);
+
+    DeckRenderPool renderPool(numDecks - 1);
+    renderPool.prepare(blockSize, sampleRate);
+    renderPool.setEnabled(parallel);
+
+    const DeckRenderPool::Task renderTask = [&](int deck)
+    {
+        renderers[deck]->render(AudioSourceChannelInfo(deckBuffers[deck], 0, blockSize));
+    };
+
+    AudioBuffer<float> output(2, blockSize);
+    const int numBlocks = jmax(1, (int)(secondsPerCase * sampleRate / blockSize));
+    const double blockSeconds = blockSize / sampleRate;
+    double totalSeconds = 0.0;
+    worstCpu = 0.0;
+
+    for (int block = -64; block < numBlocks; ++block)
+    {
+        const int64 startTicks = Time::getHighResolutionTicks();
+
+        renderPool.run(renderTask, numDecks);
+        mixerBus.mix(inputs, numDecks, positions, output, 0, blockSize);
+
+        const double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+
+        // The first blocks only settle the caches and wake the workers
+        if (block >= 0)
+        {
+            totalSeconds += seconds;
+            worstCpu = jmax(worstCpu, 100.0 * seconds / blockSeconds);
+        }
+    }
+
+    for (auto* renderer : renderers)
+    {
+        renderer->setSource(nullptr, sampleRate);
+        renderer->releaseResources();
+    }
+
+    return 100.0 * totalSeconds / (numBlocks * blockSeconds);
+}
+
+/**
+ * Time the rendering of the configured amount of audio, after a short warm up
+ *
+ * @param renderBlock                 Callable that renders one block into the supplied channel info
+ *
+ * @return                            CPU cost as a percentage of real time
+ */
+template <typename BlockRenderer>
+double EngineBenchmark::measure(BlockRenderer renderBlock)
+{
+    AudioBuffer<float> buffer(2, blockSize);
+    const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+
+    // Let caches and branch predictors settle before timing
+    for (int block = 0; block < 64; ++block)
+    {
+        renderBlock(info);
+    }
+
+    const int numBlocks = jmax(1, (int)(secondsPerCase * sampleRate / blockSize));
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        renderBlock(info);
+    }
+
+    const double elapsedSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+    const double audioSeconds = (double)numBlocks * blockSize / sampleRate;
+
+    return 100.0 * elapsedSeconds / audioSeconds;
+}
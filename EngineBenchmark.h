@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.h
+    Created: 16 Oct 2026 11:26:43am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DeckRenderer.h"
+#include "DeckRenderPool.h"
+#include "MixerBus.h"
+
+using namespace juce;
+
+class EngineBenchmark
+{
+public:
+    /**
+     * Constructor that configures the simulated audio device used for every measurement
+     *
+     * @param _sampleRate                 Output sample rate of the simulated audio device
+     * @param _blockSize                  Number of samples rendered per simulated audio callback
+     * @param _secondsPerCase             Seconds of audio rendered for each measurement
+     *
+     * @return                            None
+     */
+    EngineBenchmark(double _sampleRate = 44100.0, int _blockSize = 512, double _secondsPerCase = 30.0);
+
+    /**
+     * Destructor for the benchmark
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~EngineBenchmark();
+
+    /**
+     * Render the same looping noise track through the legacy source chain and the fused deck renderer, then
+     * through the fused deck renderer with and without key lock at speeds around the original tempo, then
+     * measure the throughput and aliasing of each resampler tier, then render sets of key locked decks
+     * one after another and in parallel, then measure the callback headroom of full mixes of 2, 4 and 8 decks
+     *
+     * @param                             None
+     *
+     * @return                            Report listing the CPU cost per deck of each pipeline as a percentage of real time
+     */
+    String run();
+
+private:
+    /** Deck settings applied before a measurement */
+    struct DeckSettings
+    {
+        String name;
+        double speed;
+        double bandPassFrequency;
+        double lowPassFrequency;
+        double highPassFrequency;
+        bool keyLock;
+    };
+
+    /**
+     * Measure the transport, resampler and three filter sources that each deck used to chain together
+     *
+     * @param settings                    Deck settings to render with
+     *
+     * @return                            CPU cost as a percentage of real time
+     */
+    double measureLegacyChain(const DeckSettings& settings);
+
+    /**
+     * Measure the fused deck renderer, time-stretching the track first if the settings enable key lock
+     *
+     * @param settings                    Deck settings to render with
+     *
+     * @return                            CPU cost as a percentage of real time
+     */
+    double measureDeckRenderer(const DeckSettings& settings);
+
+    /**
+     * Measure how fast a resampler tier interpolates one channel of the noise track at 1.1x
+     *
+     * @param quality                     Resampler tier to measure
+     *
+     * @return                            Millions of output samples per second
+     */
+    double measureResamplerThroughput(Resampler::Quality quality);
+
+    /**
+     * Resample a sine tone and measure how far the result is from the ideal band limited output
+     *
+     * @param quality                     Resampler tier to measure
+     * @param frequency                   Tone frequency in Hz
+     * @param ratio                       Input samples advanced per output sample
+     *
+     * @return                            Error relative to the tone in dB, where the ideal output is silence if the tone lands above the Nyquist frequency
+     */
+    double measureResamplerError(Resampler::Quality quality, double frequency, double ratio);
+
+    /**
+     * Measure a set of key locked decks rendered into separate buffers each block, as the mixer renders them
+     *
+     * @param numDecks                    Number of decks in the set
+     * @param parallel                    True to render the decks on a render pool, false to render them one after another
+     * @param deckCpu                     Receives the average CPU cost of one deck as a percentage of real time
+     *
+     * @return                            Wall clock cost of rendering the whole set as a percentage of real time
+     */
+    double measureDeckSet(int numDecks, bool parallel, double& deckCpu);
+
+    /**
+     * Render and mix a set of playing decks with mixed speeds, filters and key lock, as the audio callback does
+     *
+     * @param numDecks                    Number of decks, alternately assigned to sides A and B of the crossfader
+     * @param parallel                    True to render the decks on a render pool, false to render them one after another
+     * @param worstCpu                    Receives the cost of the slowest callback as a percentage of the callback period
+     *
+     * @return                            Average cost of a callback as a percentage of the callback period
+     */
+    double measureCallbackLoad(int numDecks, bool parallel, double& worstCpu);
+
+    /**
+     * Time the rendering of the configured amount of audio, after a short warm up
+     *
+     * @param renderBlock                 Callable that renders one block into the supplied channel info
+     *
+     * @return                            CPU cost as a percentage of real time
+     */
+    template <typename BlockRenderer>
+    double measure(BlockRenderer renderBlock);
+
+    double sampleRate;
+    int blockSize;
+    double secondsPerCase;
+
+    // Stereo noise that stands in for a decoded audio track
+    AudioBuffer<float> track;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EngineBenchmark)
+};
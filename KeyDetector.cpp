@@ -0,0 +1,287 @@
+/*
+  ==============================================================================
+
+    KeyDetector.cpp
+    Created: 16 Oct 2026 9:41:12pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "KeyDetector.h"
+
+constexpr int KeyDetector::lowestNote;
+constexpr int KeyDetector::highestNote;
+
+// Krumhansl-Kessler ratings of how well each pitch class above the tonic fits a major and a minor key
+static constexpr double majorProfile[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+static constexpr double minorProfile[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+/**
+ * Measure how closely the chromagram follows a key profile rotated to a tonic
+ *
+ * @param chromagram                  Strength of each pitch class from C
+ * @param profile                     Key profile from the tonic
+ * @param tonic                       Pitch class of the tonic
+ *
+ * @return                            Pearson correlation between -1 and 1
+ */
+static double correlateWithProfile(const double* chromagram, const double* profile, int tonic)
+{
+    double chromaMean = 0.0;
+    double profileMean = 0.0;
+
+    for (int i = 0; i < 12; ++i)
+    {
+        chromaMean += chromagram[i] / 12.0;
+        profileMean += profile[i] / 12.0;
+    }
+
+    double covariance = 0.0;
+    double chromaVariance = 0.0;
+    double profileVariance = 0.0;
+
+    for (int i = 0; i < 12; ++i)
+    {
+        const double chromaDeviation = chromagram[(i + tonic) % 12] - chromaMean;
+        const double profileDeviation = profile[i] - profileMean;
+
+        covariance += chromaDeviation * profileDeviation;
+        chromaVariance += chromaDeviation * chromaDeviation;
+        profileVariance += profileDeviation * profileDeviation;
+    }
+
+    return chromaVariance > 0.0 ? covariance / std::sqrt(chromaVariance * profileVariance) : 0.0;
+}
+
+/**
+ * Constructor that initializes a detector that has not been prepared
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+KeyDetector::KeyDetector() : sampleRate(0.0), hopSize(0), numFrameSamples(0), firstNoteBin(0), lastNoteBin(-1), key(-1)
+{
+    std::fill(chromagram, chromagram + 12, 0.0);
+}
+
+/**
+ * Destructor for the key detector
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+KeyDetector::~KeyDetector()
+{
+}
+
+/**
+ * Allocate the frames and the table of note bins for a sample rate and discard the audio analysed so far
+ *
+ * @param newSampleRate               Sample rate of the audio track being analysed
+ *
+ * @return                            None
+ */
+void KeyDetector::prepare(double newSampleRate)
+{
+    // Frames of about a third of a second resolve the semitones of the lowest octave, half overlapped
+    const int fftOrder = roundToInt(std::log2((double)nextPowerOfTwo(roundToInt(newSampleRate * 0.4)))) - 1;
+
+    if (newSampleRate != sampleRate || fft == nullptr)
+    {
+        fft = std::make_unique<dsp::FFT>(fftOrder);
+
+        const int fftSize = fft->getSize();
+        const int numBins = fftSize / 2 + 1;
+        hopSize = fftSize / 2;
+
+        frame.allocate((size_t)fftSize, true);
+        window.allocate((size_t)fftSize, true);
+        spectrum.allocate((size_t)fftSize * 2, true);
+        binPitchClasses.allocate((size_t)numBins, true);
+
+        for (int i = 0; i < fftSize; ++i)
+        {
+            window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float)i / (float)fftSize);
+        }
+
+        // Assign each bin to the nearest note, keeping only the bins inside the note range
+        firstNoteBin = numBins;
+        lastNoteBin = -1;
+
+        for (int bin = 1; bin < numBins; ++bin)
+        {
+            const double frequency = bin * newSampleRate / fftSize;
+            const int note = roundToInt(69.0 + 12.0 * std::log2(frequency / 440.0));
+
+            if (note < lowestNote || note > highestNote)
+            {
+                binPitchClasses[bin] = -1;
+                continue;
+            }
+
+            binPitchClasses[bin] = note % 12;
+            firstNoteBin = jmin(firstNoteBin, bin);
+            lastNoteBin = jmax(lastNoteBin, bin);
+        }
+    }
+
+    sampleRate = newSampleRate;
+
+    // The first frame is padded with silence so that it ends after the first hop
+    const int fftSize = fft->getSize();
+    FloatVectorOperations::clear(frame, fftSize);
+    numFrameSamples = fftSize - hopSize;
+
+    std::fill(chromagram, chromagram + 12, 0.0);
+    key = -1;
+}
+
+/**
+ * Add the next samples of the track to the chromagram
+ *
+ * @param samples                     Mono samples following the ones already processed
+ * @param numSamples                  Number of samples
+ *
+ * @return                            None
+ */
+void KeyDetector::process(const float* samples, int numSamples)
+{
+    jassert(fft != nullptr);
+
+    const int fftSize = fft->getSize();
+
+    while (numSamples > 0)
+    {
+        const int numToCopy = jmin(numSamples, fftSize - numFrameSamples);
+        FloatVectorOperations::copy(frame + numFrameSamples, samples, numToCopy);
+        numFrameSamples += numToCopy;
+        samples += numToCopy;
+        numSamples -= numToCopy;
+
+        if (numFrameSamples < fftSize)
+        {
+            break;
+        }
+
+        FloatVectorOperations::multiply(spectrum, frame, window, fftSize);
+        FloatVectorOperations::clear(spectrum + fftSize, fftSize);
+        fft->performFrequencyOnlyForwardTransform(spectrum);
+
+        // Fold the note bins into the twelve pitch classes
+        float chroma[12] = {};
+
+        for (int bin = firstNoteBin; bin <= lastNoteBin; ++bin)
+        {
+            if (binPitchClasses[bin] >= 0)
+            {
+                chroma[binPitchClasses[bin]] += spectrum[bin];
+            }
+        }
+
+        // Every frame with sound counts the same, so loud passages cannot outweigh the rest of the track
+        const float strongest = FloatVectorOperations::findMaximum(chroma, 12);
+
+        if (strongest > 1.0e-3f)
+        {
+            for (int pitchClass = 0; pitchClass < 12; ++pitchClass)
+            {
+                chromagram[pitchClass] += chroma[pitchClass] / strongest;
+            }
+        }
+
+        // Keep the overlapping half of the frame for the next hop
+        std::memmove(frame, frame + hopSize, sizeof(float) * (size_t)(fftSize - hopSize));
+        numFrameSamples = fftSize - hopSize;
+    }
+}
+
+/**
+ * Match the chromagram of the whole track against the profile of every major and minor key
+ *
+ * @param                             None
+ *
+ * @return                            True if the track had enough tonal content to find a key, false otherwise
+ */
+bool KeyDetector::finish()
+{
+    double bestCorrelation = 0.0;
+    key = -1;
+
+    for (int tonic = 0; tonic < 12; ++tonic)
+    {
+        const double majorCorrelation = correlateWithProfile(chromagram, majorProfile, tonic);
+        const double minorCorrelation = correlateWithProfile(chromagram, minorProfile, tonic);
+
+        if (majorCorrelation > bestCorrelation)
+        {
+            bestCorrelation = majorCorrelation;
+            key = tonic;
+        }
+
+        if (minorCorrelation > bestCorrelation)
+        {
+            bestCorrelation = minorCorrelation;
+            key = tonic + 12;
+        }
+    }
+
+    return key >= 0;
+}
+
+/**
+ * Getter method that retrieves the key found by the last call to finish()
+ *
+ * @param                             None
+ *
+ * @return                            Pitch class of the tonic from 0 for C to 11 for B, plus 12 for minor keys
+ */
+int KeyDetector::getKey() const
+{
+    return key;
+}
+
+/**
+ * Name a key by its position on the Camelot wheel, where neighbouring numbers and letters mix harmonically
+ *
+ * @param key                         Pitch class of the tonic, plus 12 for minor keys
+ *
+ * @return                            Wheel position from 1A to 12B, where A is minor and B is major
+ */
+String KeyDetector::getCamelotName(int key)
+{
+    if (key < 0 || key >= 24)
+    {
+        return {};
+    }
+
+    // Minor keys share the number of their relative major, three semitones up, and C major is 8B
+    const bool minor = key >= 12;
+    const int majorTonic = minor ? (key + 3) % 12 : key;
+    const int number = (majorTonic * 7 + 7) % 12 + 1;
+
+    return String(number) + (minor ? "A" : "B");
+}
+
+/**
+ * Convert a Camelot key name to Open Key notation, the same wheel numbered from C major
+ *
+ * @param camelotName                 Wheel position from 1A to 12B
+ *
+ * @return                            Wheel position from 1d to 12m, where d is major and m is minor, or empty if the name is not valid
+ */
+String KeyDetector::getOpenKeyName(const String& camelotName)
+{
+    const int camelotNumber = camelotName.getIntValue();
+    const juce_wchar letter = camelotName.getLastCharacter();
+
+    if (camelotNumber < 1 || camelotNumber > 12 || (letter != 'A' && letter != 'B'))
+    {
+        return {};
+    }
+
+    // Open Key starts the wheel at C major, five steps on from Camelot
+    return String((camelotNumber + 4) % 12 + 1) + (letter == 'A' ? "m" : "d");
+}
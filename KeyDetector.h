@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    KeyDetector.h
+    Created: 16 Oct 2026 9:41:12pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class KeyDetector
+{
+public:
+    /**
+     * Constructor that initializes a detector that has not been prepared
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    KeyDetector();
+
+    /**
+     * Destructor for the key detector
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~KeyDetector();
+
+    /**
+     * Allocate the frames and the table of note bins for a sample rate and discard the audio analysed so far
+     *
+     * @param newSampleRate               Sample rate of the audio track being analysed
+     *
+     * @return                            None
+     */
+    void prepare(double newSampleRate);
+
+    /**
+     * Add the next samples of the track to the chromagram
+     *
+     * @param samples                     Mono samples following the ones already processed
+     * @param numSamples                  Number of samples
+     *
+     * @return                            None
+     */
+    void process(const float* samples, int numSamples);
+
+    /**
+     * Match the chromagram of the whole track against the profile of every major and minor key
+     *
+     * @param                             None
+     *
+     * @return                            True if the track had enough tonal content to find a key, false otherwise
+     */
+    bool finish();
+
+    /**
+     * Getter method that retrieves the key found by the last call to finish()
+     *
+     * @param                             None
+     *
+     * @return                            Pitch class of the tonic from 0 for C to 11 for B, plus 12 for minor keys
+     */
+    int getKey() const;
+
+    /**
+     * Name a key by its position on the Camelot wheel, where neighbouring numbers and letters mix harmonically
+     *
+     * @param key                         Pitch class of the tonic, plus 12 for minor keys
+     *
+     * @return                            Wheel position from 1A to 12B, where A is minor and B is major
+     */
+    static String getCamelotName(int key);
+
+    /**
+     * Convert a Camelot key name to Open Key notation, the same wheel numbered from C major
+     *
+     * @param camelotName                 Wheel position from 1A to 12B
+     *
+     * @return                            Wheel position from 1d to 12m, where d is major and m is minor, or empty if the name is not valid
+     */
+    static String getOpenKeyName(const String& camelotName);
+
+    // Range of notes folded into the chromagram, from C2 to B6
+    static constexpr int lowestNote = 36;
+    static constexpr int highestNote = 95;
+
+private:
+    double sampleRate;
+    int hopSize;
+
+    // Samples of the frame being collected, the most recent at the end
+    HeapBlock<float> frame;
+    int numFrameSamples;
+
+    // Working arrays for the transform, where the spectrum is twice the FFT size
+    std::unique_ptr<dsp::FFT> fft;
+    HeapBlock<float> window;
+    HeapBlock<float> spectrum;
+
+    // Pitch class of every FFT bin inside the note range, -1 outside it
+    HeapBlock<int> binPitchClasses;
+    int firstNoteBin;
+    int lastNoteBin;
+
+    // Sum over the track of each frame's chroma vector, normalized to its strongest pitch class
+    double chromagram[12];
+
+    int key;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeyDetector)
+};
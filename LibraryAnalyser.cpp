@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+    LibraryAnalyser.cpp
+    Created: 16 Oct 2026 7:20:37pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "LibraryAnalyser.h"
+#include "BeatAnalyser.h"
+#include "KeyDetector.h"
+#include "LoudnessMeter.h"
+
+/**
+ * Constructor that starts the analysis worker threads
+ *
+ * @param numThreads                  Number of worker threads, or zero for the --analysis-threads argument or every core but one
+ *
+ * @return                            None
+ */
+LibraryAnalyser::LibraryAnalyser(int numThreads) : analysisScheduler(numThreads > 0 ? numThreads : getDefaultNumThreads())
+{
+    formatManager.registerBasicFormats();
+}
+
+/**
+ * Destructor that cancels the analyses that have not finished
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+LibraryAnalyser::~LibraryAnalyser()
+{
+    analysisScheduler.cancelAllJobs();
+}
+
+/**
+ * Queue an audio track for analysis on a worker thread, or move it up the queue if it is already waiting
+ *
+ * @param audioFile                   Local audio file to analyse
+ * @param priority                    Priority of the analysis, where tracks loaded into a deck go first
+ *
+ * @return                            None
+ */
+void LibraryAnalyser::analyseTrack(const File& audioFile, AnalysisScheduler::Priority priority)
+{
+    const String path = audioFile.getFullPathName();
+
+    {
+        const ScopedLock scopedLock(lock);
+
+        // A track that is waiting only moves up the queue, and one that has finished is waiting for the message thread
+        if (pendingPaths.contains(path))
+        {
+            analysisScheduler.raisePriority(path, priority);
+            return;
+        }
+
+        pendingPaths.add(path);
+    }
+
+    analysisScheduler.addJob(path, priority, [this, audioFile](const std::function<bool()>& shouldCancel)
+        {
+            TrackAnalysis analysis = analyseFile(audioFile, shouldCancel);
+
+            if (!shouldCancel())
+            {
+                finishAnalysis(analysis);
+            }
+        });
+}
+
+/**
+ * Stop analysing an audio track, removing it from the queue or asking its worker to return early
+ *
+ * @param audioFile                   Local audio file that no longer needs analysing
+ *
+ * @return                            None
+ */
+void LibraryAnalyser::cancelTrack(const File& audioFile)
+{
+    const String path = audioFile.getFullPathName();
+
+    const ScopedLock scopedLock(lock);
+
+    if (analysisScheduler.cancelJob(path))
+    {
+        pendingPaths.removeString(path);
+    }
+}
+
+/**
+ * Remove the analyses that have finished since the last call, announced with a change message
+ *
+ * @param                             None
+ *
+ * @return                            Finished analyses, including the ones that failed
+ */
+Array<LibraryAnalyser::TrackAnalysis> LibraryAnalyser::takeFinishedAnalyses()
+{
+    const ScopedLock scopedLock(lock);
+
+    Array<TrackAnalysis> analyses;
+    analyses.swapWith(finishedAnalyses);
+
+    // Tracks stay pending until their results reach the message thread, so they are not queued again in between
+    for (const auto& analysis : analyses)
+    {
+        pendingPaths.removeString(analysis.file.getFullPathName());
+    }
+
+    return analyses;
+}
+
+/**
+ * Getter method that retrieves how many tracks are waiting, being analysed and finished, and how fast they are finishing
+ *
+ * @param                             None
+ *
+ * @return                            Progress of the tracks queued since the analyser was last idle
+ */
+AnalysisScheduler::Progress LibraryAnalyser::getProgress() const
+{
+    return analysisScheduler.getProgress();
+}
+
+/**
+ * Getter method that retrieves the number of analysis threads to start when none is given
+ *
+ * @param                             None
+ *
+ * @return                            Count from the --analysis-threads argument, or every core but one
+ */
+int LibraryAnalyser::getDefaultNumThreads()
+{
+    const StringArray arguments = JUCEApplicationBase::getCommandLineParameterArray();
+    const int argumentIndex = arguments.indexOf("--analysis-threads");
+
+    if (argumentIndex >= 0 && argumentIndex + 1 < arguments.size() && arguments[argumentIndex + 1].getIntValue() > 0)
+    {
+        return arguments[argumentIndex + 1].getIntValue();
+    }
+
+    return jmax(1, SystemStats::getNumCpus() - 1);
+}
+
+/**
+ * Decode an audio track once and run every analysis over it, called on a worker thread
+ *
+ * @param audioFile                   Local audio file to analyse
+ * @param shouldCancel                Polled between blocks, analysis stops early if it returns true
+ *
+ * @return                            Results of the analysis
+ */
+LibraryAnalyser::TrackAnalysis LibraryAnalyser::analyseFile(const File& audioFile, const std::function<bool()>& shouldCancel)
+{
+    TrackAnalysis analysis;
+    analysis.file = audioFile;
+
+    // Read the decoded copy of the track if the library cache has one, which skips the decoder
+    std::unique_ptr<AudioFormatReader> reader(pcmDiskCache->createMappedReader(audioFile));
+
+    if (reader == nullptr)
+    {
+        reader.reset(formatManager.createReaderFor(audioFile));
+    }
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+    {
+        return analysis;
+    }
+
+    BeatAnalyser beatAnalyser;
+    beatAnalyser.prepare(reader->sampleRate);
+
+    KeyDetector keyDetector;
+    keyDetector.prepare(reader->sampleRate);
+
+    const bool stereo = reader->numChannels > 1;
+
+    // Tracks tagged with ReplayGain already carry their loudness, so it is only measured for the rest
+    analysis.loudnessMeasured = LoudnessMeter::readReplayGainTags(audioFile, analysis.integratedLoudness, analysis.truePeak);
+
+    LoudnessMeter loudnessMeter;
+    loudnessMeter.prepare(reader->sampleRate, stereo ? 2 : 1);
+
+    // Mix each block down to mono before it is analysed, after the loudness of both channels has been measured
+    const int blockSize = 1 << 15;
+    AudioBuffer<float> block(2, blockSize);
+
+    for (int64 start = 0; start < reader->lengthInSamples; start += blockSize)
+    {
+        if (shouldCancel())
+        {
+            return analysis;
+        }
+
+        const int numSamples = (int)jmin((int64)blockSize, reader->lengthInSamples - start);
+        reader->read(&block, 0, numSamples, start, true, stereo);
+
+        if (!analysis.loudnessMeasured)
+        {
+            loudnessMeter.process(block.getArrayOfReadPointers(), numSamples);
+        }
+
+        if (stereo)
+        {
+            block.addFrom(0, 0, block, 1, 0, numSamples);
+            block.applyGain(0, 0, numSamples, 0.5f);
+        }
+
+        beatAnalyser.process(block.getReadPointer(0), numSamples);
+        keyDetector.process(block.getReadPointer(0), numSamples);
+    }
+
+    if (beatAnalyser.finish())
+    {
+        analysis.succeeded = true;
+        analysis.beatsPerMinute = beatAnalyser.getBeatsPerMinute();
+        analysis.downbeatSeconds = beatAnalyser.getDownbeatSeconds();
+    }
+
+    if (keyDetector.finish())
+    {
+        analysis.key = KeyDetector::getCamelotName(keyDetector.getKey());
+    }
+
+    if (!analysis.loudnessMeasured && loudnessMeter.finish())
+    {
+        analysis.loudnessMeasured = true;
+        analysis.integratedLoudness = loudnessMeter.getIntegratedLoudness();
+        analysis.truePeak = loudnessMeter.getTruePeak();
+    }
+
+    return analysis;
+}
+
+/**
+ * Publish the results of an analysis and announce them to the message thread, called on a worker thread
+ *
+ * @param analysis                    Results of the analysis
+ *
+ * @return                            None
+ */
+void LibraryAnalyser::finishAnalysis(const TrackAnalysis& analysis)
+{
+    {
+        const ScopedLock scopedLock(lock);
+
+        finishedAnalyses.add(analysis);
+    }
+
+    sendChangeMessage();
+}
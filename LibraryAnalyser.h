@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    LibraryAnalyser.h
+    Created: 16 Oct 2026 7:20:37pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "PcmDiskCache.h"
+#include "AnalysisScheduler.h"
+
+using namespace juce;
+
+class LibraryAnalyser : public ChangeBroadcaster
+{
+public:
+    /** Results of analysing one audio track */
+    struct TrackAnalysis
+    {
+        File file;
+        bool succeeded = false;
+
+        // Tempo at the original speed and the first downbeat the beat grid is anchored to
+        double beatsPerMinute = 0.0;
+        double downbeatSeconds = 0.0;
+
+        // Camelot name of the musical key, empty if the track has no clear key
+        String key;
+
+        // Integrated loudness in LUFS and true peak in dBTP, measured or read from ReplayGain tags
+        bool loudnessMeasured = false;
+        double integratedLoudness = 0.0;
+        double truePeak = 0.0;
+    };
+
+    /**
+     * Constructor that starts the analysis worker threads
+     *
+     * @param numThreads                  Number of worker threads, or zero for the --analysis-threads argument or every core but one
+     *
+     * @return                            None
+     */
+    explicit LibraryAnalyser(int numThreads = 0);
+
+    /**
+     * Destructor that cancels the analyses that have not finished
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~LibraryAnalyser() override;
+
+    /**
+     * Queue an audio track for analysis on a worker thread, or move it up the queue if it is already waiting
+     *
+     * @param audioFile                   Local audio file to analyse
+     * @param priority                    Priority of the analysis, where tracks loaded into a deck go first
+     *
+     * @return                            None
+     */
+    void analyseTrack(const File& audioFile, AnalysisScheduler::Priority priority);
+
+    /**
+     * Stop analysing an audio track, removing it from the queue or asking its worker to return early
+     *
+     * @param audioFile                   Local audio file that no longer needs analysing
+     *
+     * @return                            None
+     */
+    void cancelTrack(const File& audioFile);
+
+    /**
+     * Remove the analyses that have finished since the last call, announced with a change message
+     *
+     * @param                             None
+     *
+     * @return                            Finished analyses, including the ones that failed
+     */
+    Array<TrackAnalysis> takeFinishedAnalyses();
+
+    /**
+     * Getter method that retrieves how many tracks are waiting, being analysed and finished, and how fast they are finishing
+     *
+     * @param                             None
+     *
+     * @return                            Progress of the tracks queued since the analyser was last idle
+     */
+    AnalysisScheduler::Progress getProgress() const;
+
+    /**
+     * Getter method that retrieves the number of analysis threads to start when none is given
+     *
+     * @param                             None
+     *
+     * @return                            Count from the --analysis-threads argument, or every core but one
+     */
+    static int getDefaultNumThreads();
+
+private:
+    /**
+     * Decode an audio track once and run every analysis over it, called on a worker thread
+     *
+     * @param audioFile                   Local audio file to analyse
+     * @param shouldCancel                Polled between blocks, analysis stops early if it returns true
+     *
+     * @return                            Results of the analysis
+     */
+    TrackAnalysis analyseFile(const File& audioFile, const std::function<bool()>& shouldCancel);
+
+    /**
+     * Publish the results of an analysis and announce them to the message thread, called on a worker thread
+     *
+     * @param analysis                    Results of the analysis
+     *
+     * @return                            None
+     */
+    void finishAnalysis(const TrackAnalysis& analysis);
+
+    AudioFormatManager formatManager;
+
+    // Decoded copies are read instead of the original files when they exist
+    SharedResourcePointer<PcmDiskCache> pcmDiskCache;
+
+    // Paths of tracks queued or being analysed, and analyses waiting for the message thread
+    StringArray pendingPaths;
+    Array<TrackAnalysis> finishedAnalyses;
+    CriticalSection lock;
+
+    // Runs the analyses in priority order, destroyed first so no job outlives the analyser
+    AnalysisScheduler analysisScheduler;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryAnalyser)
+};
@@ -0,0 +1,395 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.cpp
+    Created: 16 Oct 2026 10:18:46pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+constexpr double LoudnessMeter::replayGainReferenceLoudness;
+constexpr int LoudnessMeter::maximumChannels;
+constexpr int LoudnessMeter::oversamplingFactor;
+constexpr int LoudnessMeter::tapsPerPhase;
+
+/**
+ * Find a tag by name in raw file bytes and read the number that follows it
+ *
+ * @param data                        Bytes read from the file
+ * @param key                         Tag name in lower case, matched in any case
+ * @param value                       Receives the number
+ *
+ * @return                            True if the tag was found with a number, false otherwise
+ */
+static bool findTagValue(const MemoryBlock& data, const char* key, double& value)
+{
+    const char* bytes = static_cast<const char*>(data.getData());
+    const size_t size = data.getSize();
+    const size_t keyLength = std::strlen(key);
+
+    const auto matchesKey = [](char byte, char keyCharacter)
+    {
+        return CharacterFunctions::toLowerCase((juce_wchar)(unsigned char)byte) == (juce_wchar)keyCharacter;
+    };
+    const auto isNumberCharacter = [](char byte)
+    {
+        return (byte >= '0' && byte <= '9') || byte == '-' || byte == '+' || byte == '.';
+    };
+
+    const size_t keyStart = (size_t)(std::search(bytes, bytes + size, key, key + keyLength, matchesKey) - bytes);
+
+    if (keyStart == size)
+    {
+        return false;
+    }
+
+    // Vorbis comments separate the value with '=', ID3v2 and APEv2 with a null and MP4 with the header of a data atom
+    const size_t searchEnd = jmin(size, keyStart + keyLength + 24);
+    const size_t valueStart = (size_t)(std::find_if(bytes + keyStart + keyLength, bytes + searchEnd, isNumberCharacter) - bytes);
+    const size_t valueEnd = (size_t)(std::find_if_not(bytes + valueStart, bytes + size, isNumberCharacter) - bytes);
+
+    const String text(bytes + valueStart, valueEnd - valueStart);
+
+    if (!text.containsAnyOf("0123456789"))
+    {
+        return false;
+    }
+
+    value = text.getDoubleValue();
+    return true;
+}
+
+/**
+ * Constructor that initializes a meter that has not been prepared
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+LoudnessMeter::LoudnessMeter()
+    : numChannels(0), stepLength(0), numStepSamples(0), stepEnergy(0.0), numSteps(0), interpolationGainLimit(0.0f), peakGain(0.0f), integratedLoudness(0.0)
+{
+    std::fill(&filterStates[0][0], &filterStates[0][0] + maximumChannels * 4, 0.0);
+    std::fill(recentStepEnergies, recentStepEnergies + 4, 0.0);
+    std::fill(&phaseCoefficients[0][0], &phaseCoefficients[0][0] + oversamplingFactor * tapsPerPhase, 0.0f);
+}
+
+/**
+ * Destructor for the loudness meter
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+LoudnessMeter::~LoudnessMeter()
+{
+}
+
+/**
+ * Design the weighting and oversampling filters for a sample rate and discard the audio measured so far
+ *
+ * @param sampleRate                  Sample rate of the audio track being measured
+ * @param _numChannels                Number of channels passed to process(), one for mono or two for stereo
+ *
+ * @return                            None
+ */
+void LoudnessMeter::prepare(double sampleRate, int _numChannels)
+{
+    numChannels = jlimit(1, maximumChannels, _numChannels);
+
+    // The BS.1770 head shelf, designed from its analog parameters so that it holds at every sample rate
+    {
+        const double k = std::tan(MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+        const double q = 0.7071752369554196;
+        const double highGain = std::pow(10.0, 3.999843853973347 / 20.0);
+        const double bandGain = std::pow(highGain, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        shelfCoefficients.b0 = (highGain + bandGain * k / q + k * k) / a0;
+        shelfCoefficients.b1 = 2.0 * (k * k - highGain) / a0;
+        shelfCoefficients.b2 = (highGain - bandGain * k / q + k * k) / a0;
+        shelfCoefficients.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelfCoefficients.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    // The BS.1770 high pass that leaves out the lowest frequencies
+    {
+        const double k = std::tan(MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+        const double q = 0.5003270373238773;
+        const double a0 = 1.0 + k / q + k * k;
+
+        highPassCoefficients.b0 = 1.0;
+        highPassCoefficients.b1 = -2.0;
+        highPassCoefficients.b2 = 1.0;
+        highPassCoefficients.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPassCoefficients.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    // Windowed sinc that interpolates between the samples, with the taps of each phase ordered from the oldest sample
+    const int numTaps = oversamplingFactor * tapsPerPhase;
+    const double centre = (numTaps - 1) * 0.5;
+    interpolationGainLimit = 0.0f;
+
+    for (int phase = 0; phase < oversamplingFactor; ++phase)
+    {
+        float phaseSum = 0.0f;
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            const int n = oversamplingFactor * (tapsPerPhase - 1 - tap) + phase;
+            const double x = (n - centre) / oversamplingFactor;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+            const double blackman = 0.42 - 0.5 * std::cos(MathConstants<double>::twoPi * (n + 0.5) / numTaps)
+                + 0.08 * std::cos(2.0 * MathConstants<double>::twoPi * (n + 0.5) / numTaps);
+
+            phaseCoefficients[phase][tap] = (float)(sinc * blackman);
+            phaseSum += phaseCoefficients[phase][tap];
+        }
+
+        // Each phase passes a constant signal unchanged
+        FloatVectorOperations::multiply(phaseCoefficients[phase], 1.0f / phaseSum, tapsPerPhase);
+
+        float absoluteSum = 0.0f;
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            absoluteSum += std::abs(phaseCoefficients[phase][tap]);
+        }
+
+        interpolationGainLimit = jmax(interpolationGainLimit, absoluteSum);
+    }
+
+    std::fill(&filterStates[0][0], &filterStates[0][0] + maximumChannels * 4, 0.0);
+
+    stepLength = jmax(1, roundToInt(sampleRate * 0.1));
+
+    // A step is the most that is processed at once, so the peak search never allocates
+    peakInput.allocate((size_t)(maximumChannels * (stepLength + tapsPerPhase)), true);
+    interpolated.allocate((size_t)stepLength, true);
+    peakGain = 0.0f;
+
+    numStepSamples = 0;
+    stepEnergy = 0.0;
+    std::fill(recentStepEnergies, recentStepEnergies + 4, 0.0);
+    numSteps = 0;
+
+    blockEnergies.clearQuick();
+    integratedLoudness = 0.0;
+}
+
+/**
+ * Measure the next samples of the track
+ *
+ * @param channelData                 One array of samples per prepared channel, following the ones already measured
+ * @param numSamples                  Number of samples in each channel
+ *
+ * @return                            None
+ */
+void LoudnessMeter::process(const float* const* channelData, int numSamples)
+{
+    jassert(numChannels > 0);
+
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        // Work up to the end of the current step so that the blocks line up with it
+        const int numToProcess = jmin(numSamples - offset, stepLength - numStepSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* samples = channelData[channel] + offset;
+            double* state = filterStates[channel];
+            double energy = 0.0;
+
+            for (int i = 0; i < numToProcess; ++i)
+            {
+                const double input = samples[i];
+
+                // Transposed direct form II keeps the state of both stages in double precision
+                const double shelved = shelfCoefficients.b0 * input + state[0];
+                state[0] = shelfCoefficients.b1 * input - shelfCoefficients.a1 * shelved + state[1];
+                state[1] = shelfCoefficients.b2 * input - shelfCoefficients.a2 * shelved;
+
+                const double weighted = highPassCoefficients.b0 * shelved + state[2];
+                state[2] = highPassCoefficients.b1 * shelved - highPassCoefficients.a1 * weighted + state[3];
+                state[3] = highPassCoefficients.b2 * shelved - highPassCoefficients.a2 * weighted;
+
+                energy += weighted * weighted;
+            }
+
+            // Both channels count the same towards the loudness
+            stepEnergy += energy;
+
+            // Each interpolated point is a sum of shifted copies of the input, so every phase is a few vectorized passes
+            float* peakSamples = peakInput + channel * (stepLength + tapsPerPhase);
+            FloatVectorOperations::copy(peakSamples + tapsPerPhase - 1, samples, numToProcess);
+
+            const Range<float> sampleRange = FloatVectorOperations::findMinAndMax(peakSamples, numToProcess + tapsPerPhase - 1);
+            const float samplePeak = jmax(-sampleRange.getStart(), sampleRange.getEnd());
+            peakGain = jmax(peakGain, samplePeak);
+
+            // No point between these samples can exceed the loudest of them by more than the filter gain, so quieter steps are skipped
+            for (int phase = 0; phase < oversamplingFactor && samplePeak * interpolationGainLimit > peakGain; ++phase)
+            {
+                FloatVectorOperations::multiply(interpolated, peakSamples, phaseCoefficients[phase][0], numToProcess);
+
+                for (int tap = 1; tap < tapsPerPhase; ++tap)
+                {
+                    FloatVectorOperations::addWithMultiply(interpolated, peakSamples + tap, phaseCoefficients[phase][tap], numToProcess);
+                }
+
+                const Range<float> interpolatedRange = FloatVectorOperations::findMinAndMax(interpolated, numToProcess);
+                peakGain = jmax(peakGain, -interpolatedRange.getStart(), interpolatedRange.getEnd());
+            }
+
+            // Keep the latest samples in front of the next step's input
+            std::memmove(peakSamples, peakSamples + numToProcess, sizeof(float) * (size_t)(tapsPerPhase - 1));
+        }
+
+        numStepSamples += numToProcess;
+        offset += numToProcess;
+
+        if (numStepSamples < stepLength)
+        {
+            break;
+        }
+
+        // A block is complete at every step once four steps have been summed
+        recentStepEnergies[numSteps % 4] = stepEnergy;
+        ++numSteps;
+        stepEnergy = 0.0;
+        numStepSamples = 0;
+
+        if (numSteps >= 4)
+        {
+            const double blockEnergy = recentStepEnergies[0] + recentStepEnergies[1] + recentStepEnergies[2] + recentStepEnergies[3];
+            blockEnergies.add(blockEnergy / (4.0 * stepLength));
+        }
+    }
+}
+
+/**
+ * Gate the loudness of the blocks measured over the whole track into its integrated loudness
+ *
+ * @param                             None
+ *
+ * @return                            True if any block was loud enough to pass the gates, false for silent or very short tracks
+ */
+bool LoudnessMeter::finish()
+{
+    // Blocks below -70 LUFS are left out, then blocks more than 10 LU below the loudness of the rest
+    const double absoluteGate = std::pow(10.0, (-70.0 + 0.691) / 10.0);
+    double gatedSum = 0.0;
+    int numGated = 0;
+
+    for (const double energy : blockEnergies)
+    {
+        if (energy > absoluteGate)
+        {
+            gatedSum += energy;
+            ++numGated;
+        }
+    }
+
+    if (numGated == 0)
+    {
+        return false;
+    }
+
+    const double relativeGate = gatedSum / numGated * 0.1;
+    double integratedSum = 0.0;
+    int numIntegrated = 0;
+
+    for (const double energy : blockEnergies)
+    {
+        if (energy > absoluteGate && energy > relativeGate)
+        {
+            integratedSum += energy;
+            ++numIntegrated;
+        }
+    }
+
+    integratedLoudness = -0.691 + 10.0 * std::log10(integratedSum / numIntegrated);
+    return true;
+}
+
+/**
+ * Getter method that retrieves the integrated loudness found by the last call to finish()
+ *
+ * @param                             None
+ *
+ * @return                            Integrated loudness in LUFS
+ */
+double LoudnessMeter::getIntegratedLoudness() const
+{
+    return integratedLoudness;
+}
+
+/**
+ * Getter method that retrieves the highest peak between samples measured so far
+ *
+ * @param                             None
+ *
+ * @return                            True peak in dBTP
+ */
+double LoudnessMeter::getTruePeak() const
+{
+    return Decibels::gainToDecibels((double)peakGain);
+}
+
+/**
+ * Read the loudness of a track from its ReplayGain tags, which needs no decode
+ *
+ * @param audioFile                   Local audio file to read
+ * @param integratedLoudness          Receives the integrated loudness in LUFS
+ * @param truePeak                    Receives the peak in dBTP, taken to be full scale if the track has no peak tag
+ *
+ * @return                            True if the track has a ReplayGain track gain tag, false otherwise
+ */
+bool LoudnessMeter::readReplayGainTags(const File& audioFile, double& integratedLoudness, double& truePeak)
+{
+    FileInputStream stream(audioFile);
+
+    if (stream.failedToOpen())
+    {
+        return false;
+    }
+
+    // ID3v2, FLAC and Ogg tags are at the start of the file and APEv2 tags at the end, so the audio is never read
+    const int headLength = 1 << 18;
+    const int tailLength = 1 << 16;
+
+    MemoryBlock head;
+    stream.readIntoMemoryBlock(head, headLength);
+
+    MemoryBlock tail;
+
+    if (stream.getTotalLength() > headLength)
+    {
+        stream.setPosition(jmax((int64)headLength, stream.getTotalLength() - tailLength));
+        stream.readIntoMemoryBlock(tail, tailLength);
+    }
+
+    double trackGain = 0.0;
+
+    if (!findTagValue(head, "replaygain_track_gain", trackGain) && !findTagValue(tail, "replaygain_track_gain", trackGain))
+    {
+        return false;
+    }
+
+    // The peak tag holds a linear sample peak
+    double trackPeak = 1.0;
+
+    if (!findTagValue(head, "replaygain_track_peak", trackPeak) && !findTagValue(tail, "replaygain_track_peak", trackPeak))
+    {
+        trackPeak = 1.0;
+    }
+
+    integratedLoudness = replayGainReferenceLoudness - trackGain;
+    truePeak = Decibels::gainToDecibels(trackPeak);
+    return true;
+}
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+    Created: 16 Oct 2026 10:18:46pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class LoudnessMeter
+{
+public:
+    /**
+     * Constructor that initializes a meter that has not been prepared
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    LoudnessMeter();
+
+    /**
+     * Destructor for the loudness meter
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~LoudnessMeter();
+
+    /**
+     * Design the weighting and oversampling filters for a sample rate and discard the audio measured so far
+     *
+     * @param sampleRate                  Sample rate of the audio track being measured
+     * @param _numChannels                Number of channels passed to process(), one for mono or two for stereo
+     *
+     * @return                            None
+     */
+    void prepare(double sampleRate, int _numChannels);
+
+    /**
+     * Measure the next samples of the track
+     *
+     * @param channelData                 One array of samples per prepared channel, following the ones already measured
+     * @param numSamples                  Number of samples in each channel
+     *
+     * @return                            None
+     */
+    void process(const float* const* channelData, int numSamples);
+
+    /**
+     * Gate the loudness of the blocks measured over the whole track into its integrated loudness
+     *
+     * @param                             None
+     *
+     * @return                            True if any block was loud enough to pass the gates, false for silent or very short tracks
+     */
+    bool finish();
+
+    /**
+     * Getter method that retrieves the integrated loudness found by the last call to finish()
+     *
+     * @param                             None
+     *
+     * @return                            Integrated loudness in LUFS
+     */
+    double getIntegratedLoudness() const;
+
+    /**
+     * Getter method that retrieves the highest peak between samples measured so far
+     *
+     * @param                             None
+     *
+     * @return                            True peak in dBTP
+     */
+    double getTruePeak() const;
+
+    /**
+     * Read the loudness of a track from its ReplayGain tags, which needs no decode
+     *
+     * @param audioFile                   Local audio file to read
+     * @param integratedLoudness          Receives the integrated loudness in LUFS
+     * @param truePeak                    Receives the peak in dBTP, taken to be full scale if the track has no peak tag
+     *
+     * @return                            True if the track has a ReplayGain track gain tag, false otherwise
+     */
+    static bool readReplayGainTags(const File& audioFile, double& integratedLoudness, double& truePeak);
+
+    // Loudness that a ReplayGain 2.0 track gain brings a track to
+    static constexpr double replayGainReferenceLoudness = -18.0;
+
+    // Stereo is the widest layout measured, further channels are left out by the caller
+    static constexpr int maximumChannels = 2;
+
+    // Interpolated points between samples searched for the true peak, and filter taps per point
+    static constexpr int oversamplingFactor = 4;
+    static constexpr int tapsPerPhase = 12;
+
+private:
+    /** Coefficients of a biquad filter normalized so that a0 is one */
+    struct BiquadCoefficients
+    {
+        double b0 = 1.0;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+    };
+
+    int numChannels;
+
+    // K-weighting, a high shelf for the head followed by a high pass, with two state values per stage and channel
+    BiquadCoefficients shelfCoefficients;
+    BiquadCoefficients highPassCoefficients;
+    double filterStates[maximumChannels][4];
+
+    // Weighted energy of the 100 ms step being summed and of the three before it, which make up a 400 ms block
+    int stepLength;
+    int numStepSamples;
+    double stepEnergy;
+    double recentStepEnergies[4];
+    int numSteps;
+
+    // Mean square of every 400 ms block, overlapped by 75%
+    Array<double> blockEnergies;
+
+    // Interpolation filter split into one phase per point, with the taps of each phase ordered from the oldest sample
+    float phaseCoefficients[oversamplingFactor][tapsPerPhase];
+
+    // Largest gain the filter can apply to any signal, the sum of the magnitudes of its taps
+    float interpolationGainLimit;
+
+    // Samples of each channel for one step, preceded by the last samples of the step before, and the points interpolated from them
+    HeapBlock<float> peakInput;
+    HeapBlock<float> interpolated;
+    float peakGain;
+
+    double integratedLoudness;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
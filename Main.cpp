@@ -1,5 +1,10 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
+#include "EngineBenchmark.h"
+#include "BenchmarkSuite.h"
+#include "AnalysisBenchmark.h"
+#include "OfflineMixRenderer.h"
+#include "RealtimeSafetyTest.h"
 
 class OtoDecksApplication : public JUCEApplication
 {
@@ -13,6 +18,57 @@ public:
     //==============================================================================
     void initialise(const String& commandLine) override
     {
+        StringArray arguments = StringArray::fromTokens(commandLine, true);
+
+        // Measure the deck render pipeline without opening a window or an audio device
+        if (arguments.contains("--benchmark"))
+        {
+            runBenchmark(arguments);
+            return;
+        }
+
+        // Time the deck, mixer, library and load paths and emit JSON that can be compared between builds
+        if (arguments.contains("--benchmark-suite"))
+        {
+            runBenchmarkSuite(arguments);
+            return;
+        }
+
+        // Measure how library analysis scales from one thread to every core
+        if (arguments.contains("--analysis-benchmark"))
+        {
+            runAnalysisBenchmark(arguments);
+            return;
+        }
+
+        // Render a scripted mix to a file as fast as the CPU allows, without an audio device
+        if (arguments.contains("--render"))
+        {
+            runOfflineRender(arguments);
+            return;
+        }
+
+        // Render a journaled session again, sample for sample, without an audio device
+        if (arguments.contains("--replay"))
+        {
+            runReplay(arguments);
+            return;
+        }
+
+        // Drive the decks through a scripted session and fail if the audio callback allocates, locks or blocks
+        if (arguments.contains("--rt-check"))
+        {
+#if OTODECKS_RT_CHECK
+            runRealtimeSafetyCheck(arguments);
+#else
+            // Release builds leave the allocation and lock hooks out, so there would be nothing to check with
+            std::cerr << "--rt-check needs a debug build or one that defines OTODECKS_RT_CHECK=1" << std::endl;
+            setApplicationReturnValue(1);
+            quit();
+#endif
+            return;
+        }
+
         mainWindow.reset(new MainWindow(getApplicationName()));
     }
 
@@ -20,6 +76,8 @@ public:
     {
         // Delete window
         mainWindow = nullptr;
+
+        realtimeSafetyTest = nullptr;
     }
 
     //==============================================================================
@@ -81,7 +139,233 @@ public:
     };
 
 private:
+    /**
+     * Run the deck render benchmark, print the report and quit
+     *
+     * @param arguments                   Command line arguments, optionally containing --benchmark-output followed by a file path
+     *
+     * @return                            None
+     */
+    void runBenchmark(const StringArray& arguments)
+    {
+        EngineBenchmark benchmark;
+        const String report = benchmark.run();
+
+        std::cout << report << std::flush;
+
+        // Optionally keep the report so runs can be compared later
+        const int outputIndex = arguments.indexOf("--benchmark-output");
+
+        if (outputIndex >= 0 && outputIndex + 1 < arguments.size())
+        {
+            File::getCurrentWorkingDirectory().getChildFile(arguments[outputIndex + 1].unquoted()).replaceWithText(report);
+        }
+
+        quit();
+    }
+
+    /**
+     * Run the micro and macro benchmark suite, print its JSON results and quit
+     *
+     * @param arguments                   Command line arguments, optionally containing --benchmark-library-sizes followed by
+     *                                    comma separated track counts and --benchmark-output followed by a file path
+     *
+     * @return                            None
+     */
+    void runBenchmarkSuite(const StringArray& arguments)
+    {
+        // Libraries of ten thousand, a hundred thousand and a million tracks are timed unless other sizes are given
+        Array<int> librarySizes{ 10000, 100000, 1000000 };
+        const int sizesIndex = arguments.indexOf("--benchmark-library-sizes");
+
+        if (sizesIndex >= 0 && sizesIndex + 1 < arguments.size())
+        {
+            librarySizes.clear();
+
+            for (const auto& size : StringArray::fromTokens(arguments[sizesIndex + 1].unquoted(), ",", ""))
+            {
+                if (size.getIntValue() > 0)
+                {
+                    librarySizes.add(size.getIntValue());
+                }
+            }
+        }
+
+        BenchmarkSuite benchmark(librarySizes);
+        const String results = benchmark.run();
+
+        std::cout << results << std::endl;
+
+        // Optionally keep the results so builds can be compared later
+        const int outputIndex = arguments.indexOf("--benchmark-output");
+
+        if (outputIndex >= 0 && outputIndex + 1 < arguments.size())
+        {
+            File::getCurrentWorkingDirectory().getChildFile(arguments[outputIndex + 1].unquoted()).replaceWithText(results);
+        }
+
+        quit();
+    }
+
+    /**
+     * Run the analysis scaling benchmark, print the report and quit
+     *
+     * @param arguments                   Command line arguments, optionally containing --analysis-benchmark-folder followed by a
+     *                                    folder of tracks and --benchmark-output followed by a file path
+     *
+     * @return                            None
+     */
+    void runAnalysisBenchmark(const StringArray& arguments)
+    {
+        // Synthetic tracks are generated unless a folder of real ones is given
+        const int folderIndex = arguments.indexOf("--analysis-benchmark-folder");
+        File trackFolder;
+
+        if (folderIndex >= 0 && folderIndex + 1 < arguments.size())
+        {
+            trackFolder = File::getCurrentWorkingDirectory().getChildFile(arguments[folderIndex + 1].unquoted());
+        }
+
+        AnalysisBenchmark benchmark(trackFolder);
+        const String report = benchmark.run();
+
+        std::cout << report << std::flush;
+
+        // Optionally keep the report so runs can be compared later
+        const int outputIndex = arguments.indexOf("--benchmark-output");
+
+        if (outputIndex >= 0 && outputIndex + 1 < arguments.size())
+        {
+            File::getCurrentWorkingDirectory().getChildFile(arguments[outputIndex + 1].unquoted()).replaceWithText(report);
+        }
+
+        quit();
+    }
+
+    /**
+     * Render the mix described by a script to a WAV or FLAC file, print how fast it rendered and quit
+     *
+     * @param arguments                   Command line arguments, containing --render followed by a script file and optionally
+     *                                    --render-output followed by the file to write, which defaults to the script name as a WAV
+     *
+     * @return                            None
+     */
+    void runOfflineRender(const StringArray& arguments)
+    {
+        const int scriptIndex = arguments.indexOf("--render");
+        const File scriptFile = File::getCurrentWorkingDirectory().getChildFile(arguments[scriptIndex + 1].unquoted());
+
+        File outputFile = scriptFile.withFileExtension("wav");
+        const int outputIndex = arguments.indexOf("--render-output");
+
+        if (outputIndex >= 0 && outputIndex + 1 < arguments.size())
+        {
+            outputFile = File::getCurrentWorkingDirectory().getChildFile(arguments[outputIndex + 1].unquoted());
+        }
+
+        OfflineMixRenderer renderer(DeckCollection::getDefaultNumDecks());
+        const bool rendered = renderer.loadScript(scriptFile) && renderer.render(outputFile);
+
+        if (rendered)
+        {
+            std::cout << renderer.getReport() << "Written to " << outputFile.getFullPathName() << std::endl;
+        }
+        else
+        {
+            std::cerr << "Render failed: " << renderer.getError() << std::endl;
+        }
+
+        setApplicationReturnValue(rendered ? 0 : 1);
+        quit();
+    }
+
+    /**
+     * Replay the control journal of a session through the offline renderer into a WAV or FLAC file, print how fast it rendered and quit
+     *
+     * @param arguments                   Command line arguments, containing --replay followed by a journal file and optionally
+     *                                    --render-output followed by the file to write, which defaults to the journal name as a WAV
+     *
+     * @return                            None
+     */
+    void runReplay(const StringArray& arguments)
+    {
+        const int journalIndex = arguments.indexOf("--replay");
+        const File journalFile = File::getCurrentWorkingDirectory().getChildFile(arguments[journalIndex + 1].unquoted());
+
+        File outputFile = journalFile.withFileExtension("wav");
+        const int outputIndex = arguments.indexOf("--render-output");
+
+        if (outputIndex >= 0 && outputIndex + 1 < arguments.size())
+        {
+            outputFile = File::getCurrentWorkingDirectory().getChildFile(arguments[outputIndex + 1].unquoted());
+        }
+
+        ControlJournal::Contents journal;
+        String error;
+        bool rendered = false;
+
+        // The renderer is set up as the session's audio device was, since every block has to match
+        if (ControlJournal::readFile(journalFile, journal, error))
+        {
+            OfflineMixRenderer renderer(journal.numDecks, journal.sampleRate, journal.blockSize);
+            rendered = renderer.loadJournal(journal) && renderer.render(outputFile);
+
+            if (rendered)
+            {
+                std::cout << renderer.getReport() << "Written to " << outputFile.getFullPathName() << std::endl;
+            }
+            else
+            {
+                error = renderer.getError();
+            }
+        }
+
+        if (!rendered)
+        {
+            std::cerr << "Replay failed: " << error << std::endl;
+        }
+        else if (!journal.finished || journal.numDroppedEvents > 0)
+        {
+            std::cerr << "Warning: the journal " << (journal.finished ? "lost " + String(journal.numDroppedEvents) + " events" : "was not closed by the session")
+                << ", so the replay may not match it" << std::endl;
+        }
+
+        setApplicationReturnValue(rendered ? 0 : 1);
+        quit();
+    }
+
+#if OTODECKS_RT_CHECK
+    /**
+     * Run the real-time safety test on the message loop, then print the report and quit with a failure code if it found violations
+     *
+     * @param arguments                   Command line arguments, optionally containing --rt-check-output followed by a file path
+     *
+     * @return                            None
+     */
+    void runRealtimeSafetyCheck(const StringArray& arguments)
+    {
+        // Queued tracks and background loads finish through the message loop, so the test runs while it does
+        realtimeSafetyTest.reset(new RealtimeSafetyTest([this, arguments](const String& report, bool passed)
+            {
+                std::cout << report << std::flush;
+
+                const int outputIndex = arguments.indexOf("--rt-check-output");
+
+                if (outputIndex >= 0 && outputIndex + 1 < arguments.size())
+                {
+                    File::getCurrentWorkingDirectory().getChildFile(arguments[outputIndex + 1].unquoted()).replaceWithText(report);
+                }
+
+                setApplicationReturnValue(passed ? 0 : 1);
+                quit();
+            }));
+
+        realtimeSafetyTest->start();
+    }
+#endif
+
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<RealtimeSafetyTest> realtimeSafetyTest;
 };
 
 //==============================================================================
@@ -9,10 +9,47 @@
  */
 MainComponent::MainComponent()
 {
-    setSize(900, 650);
+    // Create the deck interfaces first, since each one installs the dial look and feel that the typeface below is set on
+    for (int i = 0; i < deckCollection.getNumDecks(); ++i)
+    {
+        deckGUIs.add(new DeckGUI(&deckCollection.getDeck(i), formatManager, thumbCache, &playlistComponent));
+    }
+
+    // Each row of decks beyond the first adds the height of a deck to the window
+    const int numDeckRows = (deckCollection.getNumDecks() + getNumDeckColumns() - 1) / getNumDeckColumns();
+    setSize(450 * getNumDeckColumns(), roundToInt(65.0 * (10.0 + 5.9 * (numDeckRows - 1))));
 
     LookAndFeel::getDefaultLookAndFeel().setDefaultSansSerifTypefaceName("Garamond");
 
+    // Render the decks on their own cores if asked to on the command line, before the audio device starts
+    autoMixEngine.setParallelRendering(JUCEApplicationBase::getCommandLineParameterArray().contains("--parallel-decks"));
+
+    // Watch the audio callback for allocations, locks and blocking calls during a real session, reported when the app closes
+    RealtimeSafetyChecker::setEnabled(JUCEApplicationBase::getCommandLineParameterArray().contains("--rt-monitor"));
+
+    // Journal the session from its first sample, before the audio device starts, if asked to on the command line
+    const File journalFile = ControlJournal::getDefaultJournalFile();
+
+    if (journalFile != File())
+    {
+        controlJournal.reset(new ControlJournal(deckCollection.getNumDecks()));
+
+        if (controlJournal->start(journalFile))
+        {
+            autoMixEngine.setControlJournal(controlJournal.get());
+
+            for (int i = 0; i < deckCollection.getNumDecks(); ++i)
+            {
+                deckCollection.getDeck(i).setControlJournal(controlJournal.get(), i);
+            }
+        }
+        else
+        {
+            Logger::writeToLog("The session is not journaled: " + controlJournal->getError());
+            controlJournal.reset();
+        }
+    }
+
     // Some platforms require permissions to open input channels so request that here
     if (RuntimePermissions::isRequired(RuntimePermissions::recordAudio) && !RuntimePermissions::isGranted(RuntimePermissions::recordAudio))
     {
@@ -26,9 +63,11 @@ MainComponent::MainComponent()
         setAudioChannels(0, 2);
     }
 
-    // Set up user interface component of both DJ decks
-    addAndMakeVisible(deckGUI1);
-    addAndMakeVisible(deckGUI2);
+    // Set up user interface component of every DJ deck
+    for (auto* deckGUI : deckGUIs)
+    {
+        addAndMakeVisible(deckGUI);
+    }
 
     // Set up library component
     addAndMakeVisible(playlistComponent);
@@ -67,6 +106,11 @@ MainComponent::MainComponent()
     importLibraryButton.addListener(this);
     importLibraryButton.setColour(TextButton::ColourIds::buttonColourId, Colour(186, 5, 5));
 
+    // Set up the 'Build Cache' button
+    addAndMakeVisible(buildCacheButton);
+    buildCacheButton.addListener(this);
+    buildCacheButton.setColour(TextButton::ColourIds::buttonColourId, Colour(22, 22, 22));
+
     // Add label to 'Import Track' button
     addAndMakeVisible(loadTracksLabel);
     loadTracksLabel.setText("Load Audio", dontSendNotification);
@@ -88,6 +132,13 @@ MainComponent::MainComponent()
     loadPlaylistLabel.setJustificationType(Justification::bottomLeft);
     loadPlaylistLabel.setFont(Font(11.0f, Font::bold));
 
+    // Add label to 'Build Cache' button
+    addAndMakeVisible(buildCacheLabel);
+    buildCacheLabel.setText("Decode Library", dontSendNotification);
+    buildCacheLabel.attachToComponent(&buildCacheButton, false);
+    buildCacheLabel.setJustificationType(Justification::bottomLeft);
+    buildCacheLabel.setFont(Font(11.0f, Font::bold));
+
     // Set up cross-fade mixer
     addAndMakeVisible(crossFadeComponent);
     crossFadeComponent.addListener(this);
@@ -98,6 +149,9 @@ MainComponent::MainComponent()
     crossFadeComponent.setSliderStyle(Slider::SliderStyle::ThreeValueHorizontal);
     crossFadeComponent.setMaxValue(1.0, dontSendNotification);
 
+    // Start with both decks audible, matching the crossfader position of the mixer
+    crossFadeComponent.setValue(autoMixEngine.getCrossfaderPosition(), dontSendNotification);
+
     // Add label to emphasize cross-fade component
     addAndMakeVisible(crossFadeLabel);
     crossFadeLabel.setJustificationType(Justification::centred);
@@ -105,6 +159,126 @@ MainComponent::MainComponent()
     crossFadeLabel.attachToComponent(&crossFadeComponent, false);
     crossFadeLabel.setFont(Font(15.0f, Font::bold));
 
+    // Set up the resampler menu that applies one quality to both decks
+    addAndMakeVisible(resamplerQualityBox);
+    for (auto quality : { Resampler::Quality::linear, Resampler::Quality::lagrange, Resampler::Quality::sinc })
+    {
+        resamplerQualityBox.addItem(Resampler::getQualityName(quality), (int)quality + 1);
+    }
+    resamplerQualityBox.setSelectedId((int)Resampler::Quality::lagrange + 1, dontSendNotification);
+    resamplerQualityBox.setTooltip("Resampling quality of both decks");
+    resamplerQualityBox.onChange = [this]
+    {
+        const Resampler::Quality quality = (Resampler::Quality)(resamplerQualityBox.getSelectedId() - 1);
+        for (auto* deckGUI : deckGUIs)
+        {
+            deckGUI->setResamplerQuality(quality);
+        }
+    };
+
+    // Add label to the left of the resampler menu
+    addAndMakeVisible(resamplerQualityLabel);
+    resamplerQualityLabel.setText("Resampler", dontSendNotification);
+    resamplerQualityLabel.attachToComponent(&resamplerQualityBox, true);
+    resamplerQualityLabel.setJustificationType(Justification::right);
+    resamplerQualityLabel.setFont(Font(11.0f, Font::bold));
+
+    // Set up the menu that chooses how queued tracks follow on, where the item ID is the overlap in seconds plus one
+    addAndMakeVisible(queueOverlapBox);
+    queueOverlapBox.addItem("Gapless", 1);
+    for (int seconds : { 1, 2, 4, 8 })
+    {
+        queueOverlapBox.addItem(String(seconds) + " s overlap", seconds + 1);
+    }
+    queueOverlapBox.setSelectedId(1, dontSendNotification);
+    queueOverlapBox.setTooltip("Crossfade between the end of a track and the next queued track on both decks");
+    queueOverlapBox.onChange = [this]
+    {
+        const double seconds = queueOverlapBox.getSelectedId() - 1;
+        for (int i = 0; i < deckCollection.getNumDecks(); ++i)
+        {
+            deckCollection.getDeck(i).setQueueOverlapSeconds(seconds);
+        }
+    };
+
+    // Add label to the left of the queue overlap menu
+    addAndMakeVisible(queueOverlapLabel);
+    queueOverlapLabel.setText("Queue", dontSendNotification);
+    queueOverlapLabel.attachToComponent(&queueOverlapBox, true);
+    queueOverlapLabel.setJustificationType(Justification::right);
+    queueOverlapLabel.setFont(Font(11.0f, Font::bold));
+
+    // Set up auto-mix, which starts the other deck and moves the crossfader as the audible track nears its end
+    addAndMakeVisible(autoMixToggle);
+    autoMixToggle.addListener(this);
+    autoMixToggle.setTooltip("Mix into the other deck automatically at the end of each track");
+
+    // Set up the transition length menu, counted in beats of the outgoing deck or in seconds
+    addAndMakeVisible(transitionLengthBox);
+    transitionLengthBox.addItem("4 beats", 1);
+    transitionLengthBox.addItem("8 beats", 2);
+    transitionLengthBox.addItem("16 beats", 3);
+    transitionLengthBox.addItem("32 beats", 4);
+    transitionLengthBox.addItem("5 s", 5);
+    transitionLengthBox.addItem("10 s", 6);
+    transitionLengthBox.addItem("20 s", 7);
+    transitionLengthBox.setSelectedId(3, dontSendNotification);
+    transitionLengthBox.setTooltip("Length of each auto-mix transition");
+    transitionLengthBox.onChange = [this]
+    {
+        const int id = transitionLengthBox.getSelectedId();
+
+        if (id <= 4)
+        {
+            autoMixEngine.setTransitionLength(4 << (id - 1), true);
+        }
+        else
+        {
+            autoMixEngine.setTransitionLength(5 << (id - 5), false);
+        }
+    };
+
+    // Set up the button that starts a transition straight away
+    addAndMakeVisible(mixNowButton);
+    mixNowButton.addListener(this);
+    mixNowButton.setColour(TextButton::ColourIds::buttonColourId, Colour(22, 22, 22));
+
+    // Set up the crossfade curve menu, where the item ID is the curve plus one
+    addAndMakeVisible(crossfadeCurveBox);
+    for (auto curve : { MixerBus::Curve::linear, MixerBus::Curve::equalPower, MixerBus::Curve::cut })
+    {
+        crossfadeCurveBox.addItem(MixerBus::getCurveName(curve), (int)curve + 1);
+    }
+    crossfadeCurveBox.setSelectedId((int)autoMixEngine.getCrossfadeCurve() + 1, dontSendNotification);
+    crossfadeCurveBox.setTooltip("Shape of the crossfade between the decks");
+    crossfadeCurveBox.onChange = [this]
+    {
+        autoMixEngine.setCrossfadeCurve((MixerBus::Curve)(crossfadeCurveBox.getSelectedId() - 1));
+    };
+
+    // Set up the label that reports the background analysis of the library
+    addAndMakeVisible(analysisProgressLabel);
+    analysisProgressLabel.setFont(Font(11.0f, Font::bold));
+    analysisProgressLabel.setJustificationType(Justification::centred);
+    analysisProgressLabel.setMinimumHorizontalScale(0.7f);
+
+    // Set up the button that swaps the library for the audio callback timing, and the hidden panel it shows
+    addAndMakeVisible(diagnosticsButton);
+    diagnosticsButton.addListener(this);
+    diagnosticsButton.setClickingTogglesState(true);
+    diagnosticsButton.setColour(TextButton::ColourIds::buttonColourId, Colour(22, 22, 22));
+    diagnosticsButton.setTooltip("Show how long the audio callback takes against its deadline");
+    addChildComponent(diagnosticsComponent);
+
+    // Set up the button that records the set as it is heard
+    addAndMakeVisible(recordButton);
+    recordButton.addListener(this);
+    recordButton.setColour(TextButton::ColourIds::buttonColourId, Colour(22, 22, 22));
+    recordButton.setTooltip("Record the master output to " + MasterRecorder::getDefaultRecordingFile().getParentDirectory().getFullPathName());
+
+    // Follow the crossfader while a transition moves it
+    startTimerHz(30);
+
     // Register JUCE audio formats
     formatManager.registerBasicFormats();
 }
@@ -120,6 +294,18 @@ MainComponent::~MainComponent()
 {
     // This shuts down the audio device and clears the audio source.
     shutdownAudio();
+
+    // Close the journal once no callback can add to it, so its end marks the last sample the session played
+    if (controlJournal != nullptr)
+    {
+        controlJournal->stop();
+    }
+
+    if (RealtimeSafetyChecker::isEnabled())
+    {
+        RealtimeSafetyChecker::setEnabled(false);
+        Logger::writeToLog(RealtimeSafetyChecker::getReport());
+    }
 }
 
 /**
@@ -132,16 +318,14 @@ MainComponent::~MainComponent()
  */
 void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
+    // Measure every callback against the period of the new settings
+    callbackLoadMonitor.prepare(sampleRate, samplesPerBlockExpected);
+
     // Move audio players into prepared state
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    deckCollection.prepareToPlay(samplesPerBlockExpected, sampleRate);
 
     // Move mixer into prepared state
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    // Add input audio sources to be mixed
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
+    autoMixEngine.prepareToPlay(samplesPerBlockExpected, sampleRate);
 }
 
 /**
@@ -153,7 +337,16 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
  */
 void MainComponent::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
 {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    // Everything below here runs on the audio thread, which the real-time safety checker watches
+    const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+
+    // Time the whole block against its deadline, the mixer times its own stages and decks
+    const CallbackLoadMonitor::ScopedBlockTimer blockTimer(callbackLoadMonitor, bufferToFill.numSamples);
+
+    autoMixEngine.getNextAudioBlock(bufferToFill);
+
+    // Copy the finished master output for the recorder's disk thread, dropping the block rather than waiting if it has fallen behind
+    masterRecorder.writeBlock(bufferToFill);
 }
 
 /**
@@ -166,10 +359,9 @@ void MainComponent::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill
 void MainComponent::releaseResources()
 {
     // This will be called when the audio device stops, or when it is being restarted due to a setting change
-    player1.releaseResources();
-    player2.releaseResources();
+    deckCollection.releaseResources();
 
-    mixerSource.releaseResources();
+    autoMixEngine.releaseResources();
 }
 
 /**
@@ -193,14 +385,50 @@ void MainComponent::paint(Graphics& g)
  */
 void MainComponent::resized()
 {
-    deckGUI1.setBounds(0, 0, getWidth() / 2, getHeight() * 5.9 / 10);
-    deckGUI2.setBounds(getWidth() / 2, 0, getWidth() / 2, getHeight() * 5.9 / 10);
-    crossFadeComponent.setBounds(15, getHeight() * 6.43 / 10, getWidth() - 30, getHeight() * 0.3 / 10);
-    searchInput.setBounds(5, getHeight() * 7.07 / 10, getWidth() / 4, getHeight() * .4 / 10);
-    importTracksButton.setBounds(10 + getWidth() / 4, getHeight() * 7.07 / 10, getWidth() / 4.2, getHeight() * .4 / 10);
-    exportLibraryButton.setBounds(15 + getWidth() / 4 + getWidth() / 4.2, getHeight() * 7.07 / 10, getWidth() / 4.2, getHeight() * .4 / 10);
-    importLibraryButton.setBounds(20 + getWidth() / 4 + getWidth() * 2 / 4.2, getHeight() * 7.07 / 10, getWidth() / 4.2, getHeight() * .4 / 10);
-    playlistComponent.Component::setBounds(0, getHeight() * 7.6 / 10, getWidth(), getHeight() * 2.9 / 10);
+    // The controls below the decks keep the proportions of a two deck window, moved down by each extra row of decks
+    const int numColumns = getNumDeckColumns();
+    const int numRows = (deckCollection.getNumDecks() + numColumns - 1) / numColumns;
+    const double rowUnit = getHeight() / (10.0 + 5.9 * (numRows - 1));
+    const double top = rowUnit * 5.9 * (numRows - 1);
+
+    for (int i = 0; i < deckGUIs.size(); ++i)
+    {
+        deckGUIs[i]->setBounds(getWidth() * (i % numColumns) / numColumns, rowUnit * 5.9 * (i / numColumns), getWidth() / numColumns, rowUnit * 5.9);
+    }
+
+    crossFadeComponent.setBounds(15, top + rowUnit * 6.43, getWidth() - 30, rowUnit * 0.3);
+    resamplerQualityBox.setBounds(getWidth() - 15 - getWidth() / 8, top + rowUnit * 5.95, getWidth() / 8, rowUnit * .35);
+    autoMixToggle.setBounds(15, top + rowUnit * 5.95, getWidth() / 10, rowUnit * .35);
+    transitionLengthBox.setBounds(20 + getWidth() / 10, top + rowUnit * 5.95, getWidth() / 10, rowUnit * .35);
+    mixNowButton.setBounds(25 + getWidth() / 5, top + rowUnit * 5.95, getWidth() / 10, rowUnit * .35);
+    crossfadeCurveBox.setBounds(30 + getWidth() * 3 / 10, top + rowUnit * 5.95, getWidth() / 10, rowUnit * .35);
+    analysisProgressLabel.setBounds(35 + getWidth() * 2 / 5, top + rowUnit * 5.95, getWidth() / 9, rowUnit * .35);
+
+    // The timing and record buttons share the space left before the queue menu
+    const int diagnosticsX = 40 + getWidth() * 2 / 5 + getWidth() / 9;
+    const int buttonWidth = (getWidth() * 3 / 4 - 100 - diagnosticsX) / 2;
+    diagnosticsButton.setBounds(diagnosticsX, top + rowUnit * 5.95, buttonWidth, rowUnit * .35);
+    recordButton.setBounds(diagnosticsX + buttonWidth + 5, top + rowUnit * 5.95, buttonWidth, rowUnit * .35);
+    queueOverlapBox.setBounds(getWidth() - 90 - getWidth() / 4, top + rowUnit * 5.95, getWidth() / 8, rowUnit * .35);
+    searchInput.setBounds(5, top + rowUnit * 7.07, getWidth() / 4, rowUnit * .4);
+    importTracksButton.setBounds(10 + getWidth() / 4, top + rowUnit * 7.07, getWidth() / 5.6, rowUnit * .4);
+    exportLibraryButton.setBounds(15 + getWidth() / 4 + getWidth() / 5.6, top + rowUnit * 7.07, getWidth() / 5.6, rowUnit * .4);
+    importLibraryButton.setBounds(20 + getWidth() / 4 + getWidth() * 2 / 5.6, top + rowUnit * 7.07, getWidth() / 5.6, rowUnit * .4);
+    buildCacheButton.setBounds(25 + getWidth() / 4 + getWidth() * 3 / 5.6, top + rowUnit * 7.07, getWidth() / 5.6, rowUnit * .4);
+    playlistComponent.Component::setBounds(0, top + rowUnit * 7.6, getWidth(), rowUnit * 2.9);
+    diagnosticsComponent.setBounds(0, top + rowUnit * 7.6, getWidth(), rowUnit * 2.9);
+}
+
+/**
+ * Getter method that retrieves the number of decks placed side by side
+ *
+ * @param                         None
+ *
+ * @return                        Two columns for up to four decks, four columns otherwise
+ */
+int MainComponent::getNumDeckColumns() const
+{
+    return deckCollection.getNumDecks() <= 4 ? 2 : 4;
 }
 
 /**
@@ -212,17 +440,17 @@ void MainComponent::resized()
  */
 void MainComponent::sliderValueChanged(Slider* slider)
 {
-    // Perform linear cross fade
+    // Perform cross fade
     if (slider == &crossFadeComponent)
     {
-        // Reduce gain of one audio player by a relative amount and increase gain of another player proportionally
-        player1.setGain(1 - slider->getValue());
-        player2.setGain(slider->getValue());
+        // Reduce gain of one audio player and increase gain of the other along the selected curve,
+        // applied per sample on the master bus so that it leaves each deck's volume alone
+        autoMixEngine.setCrossfaderPosition(slider->getValue());
     }
 }
 
 /**
- * Called when the 'Import Track', 'Export Library', or 'Import Library' buttons are clicked
+ * Called when the 'Import Track', 'Export Library', 'Import Library', 'Timing' or 'Rec' buttons are clicked
  *
  * @param                         Button base class
  *
@@ -255,4 +483,99 @@ void MainComponent::buttonClicked(Button* button)
     {
         playlistComponent.importLibrary();
     }
+    else if (button == &autoMixToggle)
+    {
+        autoMixEngine.setAutoMixEnabled(autoMixToggle.getToggleState());
+    }
+    else if (button == &mixNowButton)
+    {
+        autoMixEngine.startTransition();
+    }
+    else if (button == &diagnosticsButton)
+    {
+        // The panel covers the library, which keeps its state underneath
+        diagnosticsComponent.setVisible(diagnosticsButton.getToggleState());
+    }
+    else if (button == &recordButton)
+    {
+        if (masterRecorder.isRecording())
+        {
+            masterRecorder.stop();
+
+            // Dropped blocks are gaps in the file, so say how many there were
+            AlertWindow::showMessageBoxAsync(AlertWindow::InfoIcon, "Recording Saved",
+                String(masterRecorder.getRecordedSeconds() / 60.0, 1) + " minutes written to " + masterRecorder.getFile().getFullPathName()
+                + ", " + String(masterRecorder.getNumDroppedBlocks()) + " blocks dropped");
+        }
+        else if (!masterRecorder.start(MasterRecorder::getDefaultRecordingFile(), callbackLoadMonitor.getSampleRate()))
+        {
+            AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Recording Failed", masterRecorder.getError());
+        }
+
+        recordButton.setColour(TextButton::ColourIds::buttonColourId, masterRecorder.isRecording() ? Colour(202, 38, 39) : Colour(22, 22, 22));
+
+        if (!masterRecorder.isRecording())
+        {
+            recordButton.setTooltip("Record the master output to " + MasterRecorder::getDefaultRecordingFile().getParentDirectory().getFullPathName());
+        }
+    }
+    else if (button == &buildCacheButton)
+    {
+        // Decode every library track once so that later loads, seeks and waveforms skip the decoder
+        PcmCacheBuilder cacheBuilder(playlistComponent.getLibraryFiles(), formatManager);
+
+        if (cacheBuilder.runThread())
+        {
+            AlertWindow::showMessageBoxAsync(AlertWindow::InfoIcon, "Build Cache",
+                String(cacheBuilder.getNumBuilt()) + " tracks decoded, " + String(cacheBuilder.getNumFailed()) + " could not be read");
+        }
+    }
+}
+
+/**
+ * Callback routine that gets called periodically to show the crossfader moving during a transition, the analysis progress and the recording time
+ *
+ * @param                         None
+ *
+ * @return                        None
+ */
+void MainComponent::timerCallback()
+{
+    // Leave the slider alone while the user is dragging it
+    if (!crossFadeComponent.isMouseButtonDown())
+    {
+        crossFadeComponent.setValue(autoMixEngine.getCrossfaderPosition(), dontSendNotification);
+    }
+
+    // Auto-mix needs one deck on each side of the crossfader, and the audio thread turns it off when that is no longer the case
+    const bool canMix = autoMixEngine.hasOneDeckPerSide();
+    autoMixToggle.setEnabled(canMix);
+    autoMixToggle.setToggleState(autoMixEngine.isAutoMixEnabled(), dontSendNotification);
+    mixNowButton.setEnabled(canMix);
+
+    // Count the tracks analysed out of those added since the analysers were last idle
+    const AnalysisScheduler::Progress progress = playlistComponent.getAnalysisProgress();
+    const int numPending = progress.numQueued + progress.numRunning;
+    String text;
+
+    if (numPending > 0)
+    {
+        text = "Analysing " + String(progress.numFinished) + "/" + String(progress.numFinished + numPending)
+            + ", " + String(progress.jobsPerSecond, 1) + "/s";
+    }
+    else if (progress.numFinished > 0)
+    {
+        text = "Analysed " + String(progress.numFinished) + ", " + String(progress.jobsPerSecond, 1) + "/s";
+    }
+
+    analysisProgressLabel.setText(text, dontSendNotification);
+
+    // Show how long the set has been recorded for and whether the disk has kept up
+    if (masterRecorder.isRecording())
+    {
+        const int seconds = (int)masterRecorder.getRecordedSeconds();
+        recordButton.setTooltip("Recording " + String(seconds / 3600) + ":" + String(seconds / 60 % 60).paddedLeft('0', 2) + ":"
+            + String(seconds % 60).paddedLeft('0', 2) + " to " + masterRecorder.getFile().getFullPathName()
+            + ", " + String(masterRecorder.getNumDroppedBlocks()) + " blocks dropped");
+    }
 }
\ No newline at end of file
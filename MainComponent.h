@@ -1,15 +1,23 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
-#include "DJAudioPlayer.h"
+#include "AutoMixEngine.h"
+#include "CallbackDiagnosticsComponent.h"
+#include "CallbackLoadMonitor.h"
+#include "ControlJournal.h"
+#include "DeckCollection.h"
 #include "DeckGUI.h"
+#include "MasterRecorder.h"
 #include "PlaylistComponent.h"
+#include "PcmCacheBuilder.h"
+#include "RealtimeSafetyChecker.h"
 
 using namespace juce;
 
 class MainComponent : public AudioAppComponent,
     public Slider::Listener,
-    public Button::Listener
+    public Button::Listener,
+    public Timer
 {
 public:
     /**
@@ -87,7 +95,7 @@ public:
     void sliderValueChanged(Slider* slider) override;
 
     /**
-    * Called when the 'Import Track', 'Export Library', or 'Import Library' buttons are clicked
+    * Called when the 'Import Track', 'Export Library', 'Import Library', 'Timing' or 'Rec' buttons are clicked
     *
     * @param                         Button base class
     *
@@ -95,7 +103,25 @@ public:
     */
     void buttonClicked(Button* button) override;
 
+    /**
+     * Callback routine that gets called periodically to show the crossfader moving during a transition, the analysis progress and the recording time
+     *
+     * @param                         None
+     *
+     * @return                        None
+     */
+    void timerCallback() override;
+
 private:
+    /**
+     * Getter method that retrieves the number of decks placed side by side
+     *
+     * @param                         None
+     *
+     * @return                        Two columns for up to four decks, four columns otherwise
+     */
+    int getNumDeckColumns() const;
+
     Slider crossFadeComponent;
 
     Label crossFadeLabel;
@@ -105,23 +131,54 @@ private:
     Label loadTracksLabel;
     Label savePlaylistLabel;
     Label loadPlaylistLabel;
+    Label buildCacheLabel;
 
     TextButton importTracksButton{ "Import Tracks" };
     TextButton exportLibraryButton{ "Export Library" };
     TextButton importLibraryButton{ "Import Library" };
+    TextButton buildCacheButton{ "Build Cache" };
+
+    ComboBox resamplerQualityBox;
+    Label resamplerQualityLabel;
+
+    ComboBox queueOverlapBox;
+    Label queueOverlapLabel;
+
+    ToggleButton autoMixToggle{ "Auto Mix" };
+    ComboBox transitionLengthBox;
+    TextButton mixNowButton{ "Mix Now" };
+    ComboBox crossfadeCurveBox;
+
+    // Shows how far the background analysis of the library has got
+    Label analysisProgressLabel;
+
+    // Shows the audio callback timing in place of the library while it is toggled on
+    TextButton diagnosticsButton{ "Timing" };
+
+    // Starts and stops recording the master output, red while recording
+    TextButton recordButton{ "Rec" };
 
     PlaylistComponent playlistComponent{ &searchInput };
 
     AudioFormatManager formatManager;
     AudioThumbnailCache thumbCache{ 100 };
 
-    DJAudioPlayer player1{ formatManager };
-    DeckGUI deckGUI1{ &player1, formatManager, thumbCache, &playlistComponent };
+    // Every deck and its interface, where the --decks argument sets how many there are
+    DeckCollection deckCollection{ formatManager, DeckCollection::getDefaultNumDecks() };
+    OwnedArray<DeckGUI> deckGUIs;
+
+    // Mixes every deck through the crossfader and runs scheduled transitions in the audio callback
+    AutoMixEngine autoMixEngine{ deckCollection };
+
+    // Times every audio callback against its deadline, read by the diagnostics panel
+    CallbackLoadMonitor callbackLoadMonitor;
+    CallbackDiagnosticsComponent diagnosticsComponent{ callbackLoadMonitor, autoMixEngine, deckCollection, deviceManager };
 
-    DJAudioPlayer player2{ formatManager };
-    DeckGUI deckGUI2{ &player2, formatManager, thumbCache, &playlistComponent };
+    // Records the master output after the crossfader and master gain
+    MasterRecorder masterRecorder;
 
-    MixerAudioSource mixerSource;
+    // Records every control change of the session so it can be replayed offline, when the --journal argument is given
+    std::unique_ptr<ControlJournal> controlJournal;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
\ No newline at end of file
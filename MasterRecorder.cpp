@@ -0,0 +1,280 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.cpp
+    Created: 17 Oct 2026 5:03:48am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "MasterRecorder.h"
+
+constexpr int MasterRecorder::fifoSamples;
+
+/**
+ * Constructor for a recorder that is not recording
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+MasterRecorder::MasterRecorder()
+    : activeWriter(nullptr),
+      numWritersInUse(0),
+      recordingSampleRate(0.0),
+      numSamplesRecorded(0),
+      numDroppedBlocks(0),
+      numDroppedSamples(0)
+{
+}
+
+/**
+ * Destructor that finishes any recording in progress
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+MasterRecorder::~MasterRecorder()
+{
+    stop();
+}
+
+/**
+ * Start recording the master output into a WAV or FLAC file, chosen by the file's extension, called on the message thread
+ *
+ * @param outputFile                  File to write, replaced if it exists
+ * @param sampleRate                  Sample rate of the audio device
+ *
+ * @return                            True if recording started, false otherwise with the reason in getError
+ */
+bool MasterRecorder::start(const File& outputFile, double sampleRate)
+{
+    stop();
+    error.clear();
+
+    if (sampleRate <= 0.0)
+    {
+        error = "The audio device has not started";
+        return false;
+    }
+
+    std::unique_ptr<AudioFormat> format;
+
+    if (outputFile.hasFileExtension("flac"))
+    {
+        format.reset(new FlacAudioFormat());
+    }
+    else if (outputFile.hasFileExtension("wav"))
+    {
+        format.reset(new WavAudioFormat());
+    }
+    else
+    {
+        error = "Sets are recorded to .wav or .flac files, not " + outputFile.getFileName();
+        return false;
+    }
+
+    outputFile.getParentDirectory().createDirectory();
+    outputFile.deleteFile();
+    std::unique_ptr<FileOutputStream> outputStream(outputFile.createOutputStream());
+
+    if (outputStream == nullptr)
+    {
+        error = "Could not write to " + outputFile.getFullPathName();
+        return false;
+    }
+
+    // WAV switches to RF64 once it passes 4 GB, so a recording of several hours stays readable
+    std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(outputStream.get(), sampleRate, 2, 24, {}, 0));
+
+    if (writer == nullptr)
+    {
+        error = format->getFormatName() + " cannot be written at " + String(sampleRate) + " Hz";
+        return false;
+    }
+
+    // The writer now owns the stream, and the threaded writer owns the writer
+    outputStream.release();
+
+    writerThread.startThread(3);
+    threadedWriter.reset(new AudioFormatWriter::ThreadedWriter(writer.release(), writerThread, fifoSamples));
+
+    file = outputFile;
+    recordingSampleRate = sampleRate;
+    numSamplesRecorded = 0;
+    numDroppedBlocks = 0;
+    numDroppedSamples = 0;
+
+    // Publish the writer last, once everything the audio thread reads is in place
+    activeWriter = threadedWriter.get();
+
+    return true;
+}
+
+/**
+ * Stop recording and write out everything still in the FIFO, called on the message thread
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void MasterRecorder::stop()
+{
+    if (threadedWriter == nullptr)
+    {
+        return;
+    }
+
+    // Hide the writer from new callbacks, then wait out any callback that picked it up before it was hidden
+    activeWriter = nullptr;
+
+    while (numWritersInUse > 0)
+    {
+        Thread::yield();
+    }
+
+    // Deleting the threaded writer drains the FIFO into the file and finishes its header
+    threadedWriter.reset();
+    writerThread.stopThread(4000);
+}
+
+/**
+ * Copy a block of the master output into the FIFO, called on the audio thread, which it never blocks
+ *
+ * @param bufferToFill                Block the mixer has just rendered
+ *
+ * @return                            None
+ */
+void MasterRecorder::writeBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    ++numWritersInUse;
+
+    AudioFormatWriter::ThreadedWriter* writer = activeWriter;
+
+    if (writer != nullptr && bufferToFill.numSamples > 0)
+    {
+        // A mono device is recorded on both channels
+        const int numChannels = bufferToFill.buffer->getNumChannels();
+        const float* channels[2] = {
+            bufferToFill.buffer->getReadPointer(0, bufferToFill.startSample),
+            bufferToFill.buffer->getReadPointer(jmin(1, numChannels - 1), bufferToFill.startSample)
+        };
+
+        // A full FIFO means the disk has fallen behind, so the block is counted and dropped rather than waited for
+        if (writer->write(channels, bufferToFill.numSamples))
+        {
+            numSamplesRecorded.fetch_add(bufferToFill.numSamples, std::memory_order_relaxed);
+        }
+        else
+        {
+            numDroppedBlocks.fetch_add(1, std::memory_order_relaxed);
+            numDroppedSamples.fetch_add(bufferToFill.numSamples, std::memory_order_relaxed);
+        }
+    }
+
+    --numWritersInUse;
+}
+
+/**
+ * Determine whether the master output is being recorded
+ *
+ * @param                             None
+ *
+ * @return                            True while recording, false otherwise
+ */
+bool MasterRecorder::isRecording() const
+{
+    return threadedWriter != nullptr;
+}
+
+/**
+ * Getter method that retrieves the file being recorded, or the last one recorded
+ *
+ * @param                             None
+ *
+ * @return                            Recording file
+ */
+File MasterRecorder::getFile() const
+{
+    return file;
+}
+
+/**
+ * Getter method that retrieves how much audio has reached the FIFO since recording started
+ *
+ * @param                             None
+ *
+ * @return                            Length of the recording in seconds
+ */
+double MasterRecorder::getRecordedSeconds() const
+{
+    return recordingSampleRate > 0.0 ? numSamplesRecorded / recordingSampleRate : 0.0;
+}
+
+/**
+ * Getter method that retrieves the number of blocks dropped because the FIFO was full
+ *
+ * @param                             None
+ *
+ * @return                            Number of dropped blocks since recording started
+ */
+int64 MasterRecorder::getNumDroppedBlocks() const
+{
+    return numDroppedBlocks;
+}
+
+/**
+ * Getter method that retrieves the number of samples dropped because the FIFO was full
+ *
+ * @param                             None
+ *
+ * @return                            Number of dropped samples per channel since recording started
+ */
+int64 MasterRecorder::getNumDroppedSamples() const
+{
+    return numDroppedSamples;
+}
+
+/**
+ * Getter method that retrieves why recording last failed to start
+ *
+ * @param                             None
+ *
+ * @return                            Description of the failure, or an empty string
+ */
+String MasterRecorder::getError() const
+{
+    return error;
+}
+
+/**
+ * Getter method that retrieves a new file to record a set into
+ *
+ * @param                             None
+ *
+ * @return                            Timestamped file in the --record-folder argument or the music folder, in the --record-format argument or WAV
+ */
+File MasterRecorder::getDefaultRecordingFile()
+{
+    const StringArray arguments = JUCEApplicationBase::getCommandLineParameterArray();
+    File folder = File::getSpecialLocation(File::userMusicDirectory).getChildFile("OtoDecks Recordings");
+    String extension = ".wav";
+
+    const int folderIndex = arguments.indexOf("--record-folder");
+
+    if (folderIndex >= 0 && folderIndex + 1 < arguments.size())
+    {
+        folder = File::getCurrentWorkingDirectory().getChildFile(arguments[folderIndex + 1].unquoted());
+    }
+
+    const int formatIndex = arguments.indexOf("--record-format");
+
+    if (formatIndex >= 0 && formatIndex + 1 < arguments.size() && arguments[formatIndex + 1].equalsIgnoreCase("flac"))
+    {
+        extension = ".flac";
+    }
+
+    return folder.getNonexistentChildFile("Set " + Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S"), extension, false);
+}
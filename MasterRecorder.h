@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.h
+    Created: 17 Oct 2026 5:03:48am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class MasterRecorder
+{
+public:
+    // Samples per channel the FIFO holds, about six seconds at 44.1 kHz, so a slow disk is ridden out without growing memory
+    static constexpr int fifoSamples = 1 << 18;
+
+    /**
+     * Constructor for a recorder that is not recording
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    MasterRecorder();
+
+    /**
+     * Destructor that finishes any recording in progress
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~MasterRecorder();
+
+    /**
+     * Start recording the master output into a WAV or FLAC file, chosen by the file's extension, called on the message thread
+     *
+     * @param outputFile                  File to write, replaced if it exists
+     * @param sampleRate                  Sample rate of the audio device
+     *
+     * @return                            True if recording started, false otherwise with the reason in getError
+     */
+    bool start(const File& outputFile, double sampleRate);
+
+    /**
+     * Stop recording and write out everything still in the FIFO, called on the message thread
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void stop();
+
+    /**
+     * Copy a block of the master output into the FIFO, called on the audio thread, which it never blocks
+     *
+     * @param bufferToFill                Block the mixer has just rendered
+     *
+     * @return                            None
+     */
+    void writeBlock(const AudioSourceChannelInfo& bufferToFill);
+
+    /**
+     * Determine whether the master output is being recorded
+     *
+     * @param                             None
+     *
+     * @return                            True while recording, false otherwise
+     */
+    bool isRecording() const;
+
+    /**
+     * Getter method that retrieves the file being recorded, or the last one recorded
+     *
+     * @param                             None
+     *
+     * @return                            Recording file
+     */
+    File getFile() const;
+
+    /**
+     * Getter method that retrieves how much audio has reached the FIFO since recording started
+     *
+     * @param                             None
+     *
+     * @return                            Length of the recording in seconds
+     */
+    double getRecordedSeconds() const;
+
+    /**
+     * Getter method that retrieves the number of blocks dropped because the FIFO was full
+     *
+     * @param                             None
+     *
+     * @return                            Number of dropped blocks since recording started
+     */
+    int64 getNumDroppedBlocks() const;
+
+    /**
+     * Getter method that retrieves the number of samples dropped because the FIFO was full
+     *
+     * @param                             None
+     *
+     * @return                            Number of dropped samples per channel since recording started
+     */
+    int64 getNumDroppedSamples() const;
+
+    /**
+     * Getter method that retrieves why recording last failed to start
+     *
+     * @param                             None
+     *
+     * @return                            Description of the failure, or an empty string
+     */
+    String getError() const;
+
+    /**
+     * Getter method that retrieves a new file to record a set into
+     *
+     * @param                             None
+     *
+     * @return                            Timestamped file in the --record-folder argument or the music folder, in the --record-format argument or WAV
+     */
+    static File getDefaultRecordingFile();
+
+private:
+    // Encodes the FIFO on its own thread, so the audio thread only ever copies into memory
+    TimeSliceThread writerThread{ "Master Recorder" };
+    std::unique_ptr<AudioFormatWriter::ThreadedWriter> threadedWriter;
+
+    // Writer the audio thread sees, and how many callbacks are using it, so it is only deleted once none are
+    std::atomic<AudioFormatWriter::ThreadedWriter*> activeWriter;
+    std::atomic<int> numWritersInUse;
+
+    File file;
+    double recordingSampleRate;
+    String error;
+
+    // Written only by the audio thread and read by the message thread
+    std::atomic<int64> numSamplesRecorded;
+    std::atomic<int64> numDroppedBlocks;
+    std::atomic<int64> numDroppedSamples;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MasterRecorder)
+};
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    MemoryTrackSource.cpp
+    Created: 16 Oct 2026 3:58:40pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "MemoryTrackSource.h"
+
+/**
+ * Constructor that plays a decoded track straight from memory
+ *
+ * @param _track                      Decoded track, kept alive for as long as this source exists
+ *
+ * @return                            None
+ */
+MemoryTrackSource::MemoryTrackSource(DecodedTrackCache::DecodedTrack::Ptr _track)
+    : track(_track), position(0), looping(false)
+{
+    jassert(track != nullptr);
+}
+
+/**
+ * Destructor for the memory source
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+MemoryTrackSource::~MemoryTrackSource()
+{
+}
+
+/**
+ * Nothing needs preparing because the whole track is already decoded
+ *
+ * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is fetched
+ * @param sampleRate                  Number of sound samples taken per second
+ *
+ * @return                            None
+ */
+void MemoryTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+}
+
+/**
+ * Nothing needs releasing because the decoded track is owned by the cache and the decks
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void MemoryTrackSource::releaseResources()
+{
+}
+
+/**
+ * Copy the next block from the decoded track, wrapping around when looping
+ *
+ * @param bufferToFill                Buffer that must be filled with audio data
+ *
+ * @return                            None
+ */
+void MemoryTrackSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const AudioBuffer<float>& audio = track->audio;
+    const int64 totalLength = audio.getNumSamples();
+
+    int64 readPosition = position;
+    int numWritten = 0;
+
+    while (numWritten < bufferToFill.numSamples)
+    {
+        if (looping && totalLength > 0)
+        {
+            readPosition %= totalLength;
+        }
+
+        // Past the end of a track that does not loop there is only silence
+        if (readPosition < 0 || readPosition >= totalLength)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + numWritten, bufferToFill.numSamples - numWritten);
+            readPosition += bufferToFill.numSamples - numWritten;
+            break;
+        }
+
+        const int numToCopy = (int)jmin((int64)(bufferToFill.numSamples - numWritten), totalLength - readPosition);
+
+        for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+        {
+            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + numWritten, audio, jmin(channel, audio.getNumChannels() - 1), (int)readPosition, numToCopy);
+        }
+
+        numWritten += numToCopy;
+        readPosition += numToCopy;
+    }
+
+    position = readPosition;
+}
+
+/**
+ * Move the playhead, which is only a memory offset
+ *
+ * @param newPosition                 Position in samples
+ *
+ * @return                            None
+ */
+void MemoryTrackSource::setNextReadPosition(int64 newPosition)
+{
+    position = newPosition;
+}
+
+/**
+ * Getter method that retrieves the position of the next sample that will be returned
+ *
+ * @param                             None
+ *
+ * @return                            Position in samples
+ */
+int64 MemoryTrackSource::getNextReadPosition() const
+{
+    return position;
+}
+
+/**
+ * Getter method that retrieves the length of the decoded track
+ *
+ * @param                             None
+ *
+ * @return                            Length in samples
+ */
+int64 MemoryTrackSource::getTotalLength() const
+{
+    return track->audio.getNumSamples();
+}
+
+/**
+ * Determine whether the source wraps around at the end of the track
+ *
+ * @param                             None
+ *
+ * @return                            True if the source loops, false otherwise
+ */
+bool MemoryTrackSource::isLooping() const
+{
+    return looping;
+}
+
+/**
+ * Setter method that sets whether the source wraps around at the end of the track
+ *
+ * @param shouldLoop                  True if the source should loop
+ *
+ * @return                            None
+ */
+void MemoryTrackSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+}
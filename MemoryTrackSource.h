@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    MemoryTrackSource.h
+    Created: 16 Oct 2026 3:58:40pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DecodedTrackCache.h"
+
+using namespace juce;
+
+class MemoryTrackSource : public PositionableAudioSource
+{
+public:
+    /**
+     * Constructor that plays a decoded track straight from memory
+     *
+     * @param _track                      Decoded track, kept alive for as long as this source exists
+     *
+     * @return                            None
+     */
+    MemoryTrackSource(DecodedTrackCache::DecodedTrack::Ptr _track);
+
+    /**
+     * Destructor for the memory source
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~MemoryTrackSource() override;
+
+    /**
+     * Nothing needs preparing because the whole track is already decoded
+     *
+     * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is fetched
+     * @param sampleRate                  Number of sound samples taken per second
+     *
+     * @return                            None
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * Nothing needs releasing because the decoded track is owned by the cache and the decks
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void releaseResources() override;
+
+    /**
+     * Copy the next block from the decoded track, wrapping around when looping
+     *
+     * @param bufferToFill                Buffer that must be filled with audio data
+     *
+     * @return                            None
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    /**
+     * Move the playhead, which is only a memory offset
+     *
+     * @param newPosition                 Position in samples
+     *
+     * @return                            None
+     */
+    void setNextReadPosition(int64 newPosition) override;
+
+    /**
+     * Getter method that retrieves the position of the next sample that will be returned
+     *
+     * @param                             None
+     *
+     * @return                            Position in samples
+     */
+    int64 getNextReadPosition() const override;
+
+    /**
+     * Getter method that retrieves the length of the decoded track
+     *
+     * @param                             None
+     *
+     * @return                            Length in samples
+     */
+    int64 getTotalLength() const override;
+
+    /**
+     * Determine whether the source wraps around at the end of the track
+     *
+     * @param                             None
+     *
+     * @return                            True if the source loops, false otherwise
+     */
+    bool isLooping() const override;
+
+    /**
+     * Setter method that sets whether the source wraps around at the end of the track
+     *
+     * @param shouldLoop                  True if the source should loop
+     *
+     * @return                            None
+     */
+    void setLooping(bool shouldLoop) override;
+
+private:
+    DecodedTrackCache::DecodedTrack::Ptr track;
+    std::atomic<int64> position;
+    std::atomic<bool> looping;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MemoryTrackSource)
+};
@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+    MixerBus.cpp
+    Created: 16 Oct 2026 6:03:19pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "MixerBus.h"
+
+constexpr int MixerBus::curveTableSize;
+
+/**
+ * Evaluate the cosine of an angle between zero and a right angle with a Taylor series usable in constant expressions
+ *
+ * @param x                           Angle in radians
+ *
+ * @return                            Cosine of the angle
+ */
+static constexpr double constexprCosine(double x)
+{
+    double term = 1.0;
+    double sum = 1.0;
+
+    // Terms up to the power of twenty are well beyond float precision over a quarter turn
+    for (int n = 1; n <= 10; ++n)
+    {
+        term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+        sum += term;
+    }
+
+    return sum;
+}
+
+/**
+ * Build the gain table of side A for a crossfade curve at compile time
+ *
+ * @param curve                       Curve to tabulate
+ *
+ * @return                            Gain at each of the table positions
+ */
+static constexpr MixerBus::CurveTable makeCurveTable(MixerBus::Curve curve)
+{
+    MixerBus::CurveTable table{};
+
+    // Width of the region at each end where a cut curve fades, which is short enough to sound like a switch
+    const double cutWidth = 1.0 / 32.0;
+
+    for (int i = 0; i <= MixerBus::curveTableSize; ++i)
+    {
+        const double position = (double)i / MixerBus::curveTableSize;
+        double gain = 1.0 - position;
+
+        if (curve == MixerBus::Curve::equalPower)
+        {
+            // The powers of the two sides always add up to one, so uncorrelated tracks keep a steady loudness
+            gain = constexprCosine(position * 1.57079632679489661923);
+        }
+        else if (curve == MixerBus::Curve::cut)
+        {
+            // Both sides stay at full gain until the crossfader is almost at the other end
+            gain = position < 1.0 - cutWidth ? 1.0 : (1.0 - position) / cutWidth;
+        }
+
+        table.gains[i] = (float)gain;
+    }
+
+    return table;
+}
+
+// Generated by the compiler, so nothing is computed when the application starts
+static constexpr MixerBus::CurveTable curveTables[] = {
+    makeCurveTable(MixerBus::Curve::linear),
+    makeCurveTable(MixerBus::Curve::equalPower),
+    makeCurveTable(MixerBus::Curve::cut)
+};
+
+/**
+ * Constructor that initializes an equal power bus at unity master gain
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+MixerBus::MixerBus() : curve(Curve::equalPower), masterGain(1.0f), lastMasterGain(1.0f)
+{
+}
+
+/**
+ * Destructor for the mixer bus
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+MixerBus::~MixerBus()
+{
+}
+
+/**
+ * Allocate the per-sample gain arrays for the largest section that will be mixed
+ *
+ * @param maximumSectionSize          Largest number of samples passed to a single call to mix()
+ *
+ * @return                            None
+ */
+void MixerBus::prepare(int maximumSectionSize)
+{
+    gainBuffer.setSize(3, maximumSectionSize);
+    lastMasterGain = masterGain;
+}
+
+/**
+ * Release the per-sample gain arrays
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void MixerBus::release()
+{
+    gainBuffer.setSize(3, 0);
+}
+
+/**
+ * Setter method that sets the crossfade curve, which takes effect from the next section
+ *
+ * @param newCurve                    Curve to use
+ *
+ * @return                            None
+ */
+void MixerBus::setCurve(Curve newCurve)
+{
+    curve = newCurve;
+}
+
+/**
+ * Getter method that retrieves the crossfade curve
+ *
+ * @param                             None
+ *
+ * @return                            Curve in use
+ */
+MixerBus::Curve MixerBus::getCurve() const
+{
+    return curve;
+}
+
+/**
+ * Setter method that sets the master gain, ramped over the next section to avoid clicks
+ *
+ * @param newGain                     Linear gain applied to the whole mix
+ *
+ * @return                            None
+ */
+void MixerBus::setMasterGain(float newGain)
+{
+    masterGain = jmax(0.0f, newGain);
+}
+
+/**
+ * Sum the inputs into the output with crossfader and master gains evaluated for every sample
+ *
+ * @param inputs                      Deck outputs to mix, each holding at least numSamples samples
+ * @param numInputs                   Number of deck outputs
+ * @param positions                   Crossfader position for every sample, from zero for side A only to one for side B only
+ * @param output                      Buffer that receives the mix
+ * @param startSample                 First sample of the output to write
+ * @param numSamples                  Number of samples to mix, at most the prepared section size
+ *
+ * @return                            None
+ */
+void MixerBus::mix(const Input* inputs, int numInputs, const float* positions, AudioBuffer<float>& output, int startSample, int numSamples)
+{
+    jassert(numSamples <= gainBuffer.getNumSamples());
+
+    const float* table = curveTables[(int)curve.load()].gains;
+
+    float* gainsA = gainBuffer.getWritePointer((int)Side::a);
+    float* gainsB = gainBuffer.getWritePointer((int)Side::b);
+    float* gainsThru = gainBuffer.getWritePointer((int)Side::thru);
+
+    // Ramp the master gain across the section
+    const float targetMasterGain = masterGain;
+    const float masterGainStep = (targetMasterGain - lastMasterGain) / (float)numSamples;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float master = lastMasterGain + masterGainStep * (float)(i + 1);
+
+        // Side B reads the side A table from the other end
+        const float scaledPosition = jlimit(0.0f, 1.0f, positions[i]) * (float)curveTableSize;
+        const int indexA = jmin((int)scaledPosition, curveTableSize - 1);
+        const float fractionA = scaledPosition - (float)indexA;
+        const float mirroredPosition = (float)curveTableSize - scaledPosition;
+        const int indexB = jmin((int)mirroredPosition, curveTableSize - 1);
+        const float fractionB = mirroredPosition - (float)indexB;
+
+        gainsA[i] = (table[indexA] + (table[indexA + 1] - table[indexA]) * fractionA) * master;
+        gainsB[i] = (table[indexB] + (table[indexB + 1] - table[indexB]) * fractionB) * master;
+        gainsThru[i] = master;
+    }
+
+    lastMasterGain = targetMasterGain;
+
+    // One multiply and accumulate pass per input and channel, with no intermediate mix buffer
+    for (int channel = 0; channel < output.getNumChannels(); ++channel)
+    {
+        float* destination = output.getWritePointer(channel, startSample);
+
+        // Decks are stereo, so any further output channels stay silent
+        if (channel >= 2 || numInputs == 0)
+        {
+            FloatVectorOperations::clear(destination, numSamples);
+            continue;
+        }
+
+        for (int input = 0; input < numInputs; ++input)
+        {
+            const AudioBuffer<float>& buffer = *inputs[input].buffer;
+            const float* source = buffer.getReadPointer(jmin(channel, buffer.getNumChannels() - 1));
+            const float* gains = gainBuffer.getReadPointer((int)inputs[input].side);
+
+            if (input == 0)
+            {
+                FloatVectorOperations::multiply(destination, source, gains, numSamples);
+            }
+            else
+            {
+                FloatVectorOperations::addWithMultiply(destination, source, gains, numSamples);
+            }
+        }
+    }
+}
+
+/**
+ * Getter method that retrieves the display name of a crossfade curve
+ *
+ * @param curve                       Curve to name
+ *
+ * @return                            Name shown in menus
+ */
+String MixerBus::getCurveName(Curve curve)
+{
+    switch (curve)
+    {
+    case Curve::linear:
+        return "Linear";
+    case Curve::cut:
+        return "Cut";
+    case Curve::equalPower:
+    default:
+        return "Equal Power";
+    }
+}
+
+/**
+ * Getter method that retrieves the display name of a crossfader side
+ *
+ * @param side                        Side to name
+ *
+ * @return                            Name shown in menus
+ */
+String MixerBus::getSideName(Side side)
+{
+    switch (side)
+    {
+    case Side::b:
+        return "B";
+    case Side::thru:
+        return "Thru";
+    case Side::a:
+    default:
+        return "A";
+    }
+}
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    MixerBus.h
+    Created: 16 Oct 2026 6:03:19pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class MixerBus
+{
+public:
+    /** Shapes of the gain applied to each side as the crossfader moves across */
+    enum class Curve
+    {
+        linear = 0,
+        equalPower,
+        cut
+    };
+
+    /** Side of the crossfader a deck is assigned to, where thru decks ignore the crossfader */
+    enum class Side
+    {
+        a = 0,
+        b,
+        thru
+    };
+
+    /** Deck output rendered for the current section, read from its first two channels */
+    struct Input
+    {
+        const AudioBuffer<float>* buffer;
+        Side side;
+    };
+
+    /**
+     * Constructor that initializes an equal power bus at unity master gain
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    MixerBus();
+
+    /**
+     * Destructor for the mixer bus
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~MixerBus();
+
+    /**
+     * Allocate the per-sample gain arrays for the largest section that will be mixed
+     *
+     * @param maximumSectionSize          Largest number of samples passed to a single call to mix()
+     *
+     * @return                            None
+     */
+    void prepare(int maximumSectionSize);
+
+    /**
+     * Release the per-sample gain arrays
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void release();
+
+    /**
+     * Setter method that sets the crossfade curve, which takes effect from the next section
+     *
+     * @param newCurve                    Curve to use
+     *
+     * @return                            None
+     */
+    void setCurve(Curve newCurve);
+
+    /**
+     * Getter method that retrieves the crossfade curve
+     *
+     * @param                             None
+     *
+     * @return                            Curve in use
+     */
+    Curve getCurve() const;
+
+    /**
+     * Setter method that sets the master gain, ramped over the next section to avoid clicks
+     *
+     * @param newGain                     Linear gain applied to the whole mix
+     *
+     * @return                            None
+     */
+    void setMasterGain(float newGain);
+
+    /**
+     * Sum the inputs into the output with crossfader and master gains evaluated for every sample
+     *
+     * @param inputs                      Deck outputs to mix, each holding at least numSamples samples
+     * @param numInputs                   Number of deck outputs
+     * @param positions                   Crossfader position for every sample, from zero for side A only to one for side B only
+     * @param output                      Buffer that receives the mix
+     * @param startSample                 First sample of the output to write
+     * @param numSamples                  Number of samples to mix, at most the prepared section size
+     *
+     * @return                            None
+     */
+    void mix(const Input* inputs, int numInputs, const float* positions, AudioBuffer<float>& output, int startSample, int numSamples);
+
+    /**
+     * Getter method that retrieves the display name of a crossfade curve
+     *
+     * @param curve                       Curve to name
+     *
+     * @return                            Name shown in menus
+     */
+    static String getCurveName(Curve curve);
+
+    /**
+     * Getter method that retrieves the display name of a crossfader side
+     *
+     * @param side                        Side to name
+     *
+     * @return                            Name shown in menus
+     */
+    static String getSideName(Side side);
+
+    // Crossfader positions between the entries of each curve table are interpolated
+    static constexpr int curveTableSize = 256;
+
+    /** Gain of side A from crossfader position zero to one, where side B uses the same table mirrored */
+    struct CurveTable
+    {
+        float gains[curveTableSize + 1];
+    };
+
+private:
+    std::atomic<Curve> curve;
+
+    std::atomic<float> masterGain;
+    float lastMasterGain;
+
+    // Gains for sides A and B and for thru inputs at every sample of the section, master gain included
+    AudioBuffer<float> gainBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerBus)
+};
@@ -0,0 +1,660 @@
+/*
+  ==============================================================================
+
+    OfflineMixRenderer.cpp
+    Created: 17 Oct 2026 3:41:09am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "OfflineMixRenderer.h"
+
+/**
+ * Constructor that prepares the decks and the mixer as an audio device with the given settings would
+ *
+ * @param numDecks                    Number of decks the script can address
+ * @param _sampleRate                 Sample rate of the rendered mix
+ * @param _blockSize                  Largest number of samples rendered per block
+ *
+ * @return                            None
+ */
+OfflineMixRenderer::OfflineMixRenderer(int numDecks, double _sampleRate, int _blockSize)
+    : sampleRate(_sampleRate),
+      blockSize(_blockSize),
+      deckCollection(formatManager, numDecks),
+      autoMixEngine(deckCollection),
+      endSamplePosition(0),
+      callbackSize(0),
+      journalTransitionLength(0.0),
+      journalLengthInBeats(false),
+      numSamplesRendered(0),
+      renderSeconds(0.0)
+{
+    formatManager.registerBasicFormats();
+
+    // Tracks are decoded into memory on load, so no block ever waits for a streaming thread and every render is identical
+    for (int i = 0; i < deckCollection.getNumDecks(); ++i)
+    {
+        deckCollection.getDeck(i).setRamMode(true);
+    }
+
+    deckCollection.prepareToPlay(blockSize, sampleRate);
+    autoMixEngine.prepareToPlay(blockSize, sampleRate);
+
+    // Parallel rendering changes how fast the mix renders but not a single sample of it
+    autoMixEngine.setParallelRendering(JUCEApplicationBase::getCommandLineParameterArray().contains("--parallel-decks"));
+}
+
+/**
+ * Destructor that releases the decks and the mixer
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+OfflineMixRenderer::~OfflineMixRenderer()
+{
+    autoMixEngine.releaseResources();
+    deckCollection.releaseResources();
+}
+
+/**
+ * Read a timeline from a script file, resolving track paths relative to the script's folder
+ *
+ * @param scriptFile                  Script with one event per line
+ *
+ * @return                            True if every line was understood, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::loadScript(const File& scriptFile)
+{
+    if (!scriptFile.existsAsFile())
+    {
+        error = "Script " + scriptFile.getFullPathName() + " does not exist";
+        return false;
+    }
+
+    return parseScript(scriptFile.loadFileAsString(), scriptFile.getParentDirectory());
+}
+
+/**
+ * Read a timeline of events, each line holding a time in seconds, a deck number or 'mixer', an action and its value
+ *
+ * @param script                      Text of the script, where blank lines and lines starting with # are ignored
+ * @param baseFolder                  Folder that relative track paths are resolved against
+ *
+ * @return                            True if every line was understood, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::parseScript(const String& script, const File& baseFolder)
+{
+    // Actions that take a value, and the deck actions that take none
+    static const StringArray deckActions{ "load", "position", "gain", "speed", "lowpass", "highpass", "bandpass",
+        "keylock", "trim", "bpm", "loop", "side", "resampler" };
+    static const StringArray deckActionsWithoutValue{ "play", "stop", "exitloop" };
+    static const StringArray mixerActions{ "crossfader", "curve", "transition", "gain", "automix" };
+
+    events.clear();
+    endSamplePosition = 0;
+    callbackSize = 0;
+    error.clear();
+
+    const StringArray lines = StringArray::fromLines(script);
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        const String line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+
+        if (line.isEmpty())
+        {
+            continue;
+        }
+
+        // Quoted values keep their spaces, so track paths can contain them
+        const StringArray tokens = StringArray::fromTokens(line, true);
+        const String lineName = "Line " + String(i + 1) + ": ";
+
+        if (!tokens[0].containsOnly("0123456789.") || tokens[0].getDoubleValue() < 0.0)
+        {
+            error = lineName + "expected a time in seconds, found '" + tokens[0] + "'";
+            return false;
+        }
+
+        const int64 samplePosition = (int64)std::llround(tokens[0].getDoubleValue() * sampleRate);
+
+        if (tokens[1] == "end")
+        {
+            endSamplePosition = jmax(endSamplePosition, samplePosition);
+            continue;
+        }
+
+        Event event;
+        event.samplePosition = samplePosition;
+        event.action = tokens[2].toLowerCase();
+        event.value = tokens[3].unquoted();
+        event.number = event.value.getDoubleValue();
+        event.lineNumber = i + 1;
+
+        if (tokens[1] == "mixer")
+        {
+            if (!mixerActions.contains(event.action))
+            {
+                error = lineName + "unknown mixer action '" + tokens[2] + "'";
+                return false;
+            }
+        }
+        else
+        {
+            // Decks are numbered from one as they are in the window
+            event.deck = tokens[1].getIntValue() - 1;
+
+            if (!tokens[1].containsOnly("0123456789") || event.deck < 0 || event.deck >= deckCollection.getNumDecks())
+            {
+                error = lineName + "expected 'mixer' or a deck from 1 to " + String(deckCollection.getNumDecks()) + ", found '" + tokens[1] + "'";
+                return false;
+            }
+
+            if (!deckActions.contains(event.action) && !deckActionsWithoutValue.contains(event.action))
+            {
+                error = lineName + "unknown deck action '" + tokens[2] + "'";
+                return false;
+            }
+        }
+
+        if (event.value.isEmpty() && !deckActionsWithoutValue.contains(event.action))
+        {
+            error = lineName + "'" + event.action + "' needs a value";
+            return false;
+        }
+
+        // Tracks are found next to the script unless the path is absolute
+        if (event.action == "load")
+        {
+            event.value = baseFolder.getChildFile(event.value).getFullPathName();
+        }
+
+        events.push_back(event);
+    }
+
+    if (endSamplePosition <= 0)
+    {
+        error = "The script needs an 'end' line giving the length of the mix, such as '300 end'";
+        return false;
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const Event& first, const Event& second)
+        {
+            return first.samplePosition < second.samplePosition;
+        });
+
+    return true;
+}
+
+/**
+ * Replace the timeline with a session read back from a control journal, rendered in blocks of the sizes its audio device asked for
+ *
+ * @param journal                     Session journaled with as many decks, and at the sample rate and block size, this renderer was made with
+ *
+ * @return                            True if every event can be replayed, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::loadJournal(const ControlJournal::Contents& journal)
+{
+    events.clear();
+    endSamplePosition = journal.endSamplePosition;
+    callbackSize = 0;
+    error.clear();
+
+    if (journal.numDecks != deckCollection.getNumDecks() || journal.sampleRate != sampleRate || journal.blockSize != blockSize)
+    {
+        error = "The journal was recorded with " + String(journal.numDecks) + " decks at " + String(journal.sampleRate) + " Hz in blocks of "
+            + String(journal.blockSize) + " samples, so it has to be replayed with the same settings";
+        return false;
+    }
+
+    for (const auto& journalEvent : journal.events)
+    {
+        Event event;
+        event.samplePosition = journalEvent.samplePosition;
+        event.deck = journalEvent.deck;
+        event.number = journalEvent.value;
+        event.commandType = journalEvent.commandType;
+
+        // Journaled events become the script actions that make the same change, or the few actions only a journal uses
+        switch (journalEvent.type)
+        {
+        case ControlJournal::EventType::sampleRate:
+            event.action = "samplerate";
+            break;
+        case ControlJournal::EventType::preparedBlockSize:
+            event.action = "prepare";
+            break;
+        case ControlJournal::EventType::blockSize:
+            event.action = "blocksize";
+            break;
+        case ControlJournal::EventType::load:
+            event.action = "load";
+            event.value = journal.tracks[(int)journalEvent.value];
+            break;
+        case ControlJournal::EventType::command:
+            event.action = "command";
+            break;
+        case ControlJournal::EventType::crossfader:
+            event.action = "crossfader";
+            break;
+        case ControlJournal::EventType::autoMix:
+            event.action = "automix";
+            event.value = journalEvent.value != 0.0 ? "on" : "off";
+            break;
+        case ControlJournal::EventType::transitionLength:
+            event.action = "transitionlength";
+            break;
+        case ControlJournal::EventType::transitionInBeats:
+            event.action = "transitionbeats";
+            break;
+        case ControlJournal::EventType::transitionStart:
+            event.action = "starttransition";
+            break;
+        case ControlJournal::EventType::curve:
+            event.action = "curve";
+            event.value = MixerBus::getCurveName((MixerBus::Curve)(int)journalEvent.value);
+            break;
+        case ControlJournal::EventType::masterGain:
+            event.action = "gain";
+            break;
+        case ControlJournal::EventType::side:
+            event.action = "side";
+            event.value = MixerBus::getSideName((MixerBus::Side)(int)journalEvent.value);
+            break;
+        case ControlJournal::EventType::beatsPerMinute:
+            event.action = "bpm";
+            break;
+        default:
+            continue;
+        }
+
+        if (event.action == "load" && event.value.isEmpty())
+        {
+            return failEvent(event, "the journal has no track " + String((int)journalEvent.value));
+        }
+
+        events.push_back(event);
+    }
+
+    if (endSamplePosition <= 0)
+    {
+        error = "The journal ends before the first block was played";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Render the timeline as fast as the CPU allows into a WAV or FLAC file, chosen by the file's extension
+ *
+ * @param outputFile                  File to write, replaced if it exists
+ *
+ * @return                            True if the whole mix was written, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::render(const File& outputFile)
+{
+    std::unique_ptr<AudioFormat> format;
+
+    if (outputFile.hasFileExtension("flac"))
+    {
+        format.reset(new FlacAudioFormat());
+    }
+    else if (outputFile.hasFileExtension("wav"))
+    {
+        format.reset(new WavAudioFormat());
+    }
+    else
+    {
+        error = "Mixes are rendered to .wav or .flac files, not " + outputFile.getFileName();
+        return false;
+    }
+
+    outputFile.deleteFile();
+    std::unique_ptr<FileOutputStream> outputStream(outputFile.createOutputStream());
+
+    if (outputStream == nullptr)
+    {
+        error = "Could not write to " + outputFile.getFullPathName();
+        return false;
+    }
+
+    std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(outputStream.get(), sampleRate, 2, 24, {}, 0));
+
+    if (writer == nullptr)
+    {
+        error = format->getFormatName() + " cannot be written at " + String(sampleRate) + " Hz";
+        return false;
+    }
+
+    // The writer now owns the stream, and finishes the file when it is deleted
+    outputStream.release();
+
+    return render(*writer);
+}
+
+/**
+ * Render the timeline as fast as the CPU allows into a writer
+ *
+ * @param writer                      Writer that receives every block of the mix
+ *
+ * @return                            True if the whole mix was written, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::render(AudioFormatWriter& writer)
+{
+    AudioBuffer<float> buffer(2, blockSize);
+    size_t nextEvent = 0;
+    int64 position = 0;
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    while (position < endSamplePosition)
+    {
+        // Events are applied between blocks, and the decks and mixer pick them up on the first sample of the next one
+        while (nextEvent < events.size() && events[nextEvent].samplePosition <= position)
+        {
+            if (!applyEvent(events[nextEvent++]))
+            {
+                return false;
+            }
+        }
+
+        // Blocks end early at the next event, so every event lands on the sample the script asks for, and a journal's blocks match the session's
+        int64 blockEnd = jmin(position + (callbackSize > 0 ? callbackSize : blockSize), endSamplePosition);
+
+        if (nextEvent < events.size())
+        {
+            blockEnd = jmin(blockEnd, events[nextEvent].samplePosition);
+        }
+
+        const int numSamples = (int)(blockEnd - position);
+
+        // Audio devices can ask for more than they were prepared for, which the mixer splits into sections
+        if (numSamples > buffer.getNumSamples())
+        {
+            buffer.setSize(2, numSamples);
+        }
+
+        buffer.clear();
+        autoMixEngine.getNextAudioBlock(AudioSourceChannelInfo(&buffer, 0, numSamples));
+
+        if (!writer.writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        {
+            error = "Writing the mix failed after " + String(position / sampleRate, 1) + " s";
+            return false;
+        }
+
+        position = blockEnd;
+    }
+
+    numSamplesRendered = position;
+    renderSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+
+    return true;
+}
+
+/**
+ * Getter method that retrieves why loading, parsing or rendering last failed
+ *
+ * @param                             None
+ *
+ * @return                            Description of the failure, or an empty string
+ */
+String OfflineMixRenderer::getError() const
+{
+    return error;
+}
+
+/**
+ * Describe the last render, including how much faster than real time it ran
+ *
+ * @param                             None
+ *
+ * @return                            Report of the rendered length, wall clock time and speed
+ */
+String OfflineMixRenderer::getReport() const
+{
+    const double mixSeconds = numSamplesRendered / sampleRate;
+
+    String report;
+    report << "Rendered " << String(mixSeconds, 1) << " s of audio from " << deckCollection.getNumDecks() << " decks at "
+        << sampleRate << " Hz in " << String(renderSeconds, 2) << " s, "
+        << String(renderSeconds > 0.0 ? mixSeconds / renderSeconds : 0.0, 1) << "x real time"
+        << (autoMixEngine.isParallelRendering() ? " with parallel decks" : "") << newLine;
+
+    return report;
+}
+
+/**
+ * Apply one event to its deck or to the mixer, between two blocks
+ *
+ * @param event                       Event to apply
+ *
+ * @return                            True if the event was applied, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::applyEvent(const Event& event)
+{
+    if (event.deck < 0)
+    {
+        return applyMixerEvent(event);
+    }
+
+    return applyDeckEvent(deckCollection.getDeck(event.deck), event);
+}
+
+/**
+ * Apply one event to a deck
+ *
+ * @param player                      Deck the event addresses
+ * @param event                       Event to apply
+ *
+ * @return                            True if the event was applied, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::applyDeckEvent(DJAudioPlayer& player, const Event& event)
+{
+    const double number = event.number;
+
+    if (event.action == "load")
+    {
+        // Loads are synchronous here, so the track is decoded before the next block is rendered
+        const File track(event.value);
+
+        if (!track.existsAsFile())
+        {
+            return failEvent(event, "track " + track.getFullPathName() + " does not exist");
+        }
+
+        player.loadURL(URL(track));
+
+        if (player.getSongLengthInSeconds() <= 0.0)
+        {
+            return failEvent(event, "track " + track.getFullPathName() + " could not be read");
+        }
+    }
+    else if (event.action == "command")
+    {
+        // The deck applied the command at the start of the block, which is where the replay is now
+        DeckCommandQueue::Command command;
+        command.type = (DeckCommandQueue::Command::Type)event.commandType;
+        command.value = number;
+        player.applyJournaledCommand(command);
+    }
+    else if (event.action == "play")
+    {
+        player.start();
+    }
+    else if (event.action == "stop")
+    {
+        player.stop();
+    }
+    else if (event.action == "position")
+    {
+        player.setPosition(number);
+    }
+    else if (event.action == "gain")
+    {
+        player.setGain(number);
+    }
+    else if (event.action == "speed")
+    {
+        player.setSpeed(number);
+    }
+    else if (event.action == "lowpass")
+    {
+        player.setLowPassFrequency(number);
+    }
+    else if (event.action == "highpass")
+    {
+        player.setHighPassFrequency(number);
+    }
+    else if (event.action == "bandpass")
+    {
+        player.setBandPassFrequency(number);
+    }
+    else if (event.action == "keylock")
+    {
+        player.setKeyLock(event.value == "on");
+    }
+    else if (event.action == "trim")
+    {
+        player.setTrim(number);
+    }
+    else if (event.action == "bpm")
+    {
+        // An optional second value after a comma places the first downbeat, in seconds
+        player.setBeatGrid(number, event.value.fromFirstOccurrenceOf(",", false, false).getDoubleValue());
+    }
+    else if (event.action == "loop")
+    {
+        player.startAutoLoop(number);
+    }
+    else if (event.action == "exitloop")
+    {
+        player.exitLoop();
+    }
+    else if (event.action == "side")
+    {
+        for (auto side : { MixerBus::Side::a, MixerBus::Side::b, MixerBus::Side::thru })
+        {
+            if (event.value.equalsIgnoreCase(MixerBus::getSideName(side)))
+            {
+                player.setCrossfaderSide(side);
+                return true;
+            }
+        }
+
+        return failEvent(event, "expected side A, B or Thru");
+    }
+    else if (event.action == "resampler")
+    {
+        for (auto quality : { Resampler::Quality::linear, Resampler::Quality::lagrange, Resampler::Quality::sinc })
+        {
+            if (event.value.equalsIgnoreCase(Resampler::getQualityName(quality)))
+            {
+                player.setResamplerQuality(quality);
+                return true;
+            }
+        }
+
+        return failEvent(event, "unknown resampler quality '" + event.value + "'");
+    }
+
+    return true;
+}
+
+/**
+ * Apply one event to the mixer
+ *
+ * @param event                       Event to apply
+ *
+ * @return                            True if the event was applied, false otherwise with the reason in getError
+ */
+bool OfflineMixRenderer::applyMixerEvent(const Event& event)
+{
+    const double number = event.number;
+
+    if (event.action == "crossfader")
+    {
+        autoMixEngine.setCrossfaderPosition(number);
+    }
+    else if (event.action == "gain")
+    {
+        autoMixEngine.setMasterGain((float)number);
+    }
+    else if (event.action == "transition")
+    {
+        // Transitions move between the first two decks over the given number of seconds
+        autoMixEngine.setTransitionLength(number, false);
+        autoMixEngine.startTransition();
+    }
+    else if (event.action == "automix")
+    {
+        autoMixEngine.setAutoMixEnabled(event.value == "on");
+    }
+    else if (event.action == "transitionlength")
+    {
+        journalTransitionLength = number;
+        autoMixEngine.setTransitionLength(journalTransitionLength, journalLengthInBeats);
+    }
+    else if (event.action == "transitionbeats")
+    {
+        journalLengthInBeats = number != 0.0;
+        autoMixEngine.setTransitionLength(journalTransitionLength, journalLengthInBeats);
+    }
+    else if (event.action == "starttransition")
+    {
+        autoMixEngine.startTransition();
+    }
+    else if (event.action == "blocksize")
+    {
+        callbackSize = (int)number;
+    }
+    else if (event.action == "samplerate")
+    {
+        if (number != sampleRate)
+        {
+            return failEvent(event, "the audio device changed to " + String(number) + " Hz, which a render at " + String(sampleRate) + " Hz cannot follow");
+        }
+    }
+    else if (event.action == "prepare")
+    {
+        // Restarting the audio device resets every deck's renderer, so the replay does the same at the same sample
+        deckCollection.releaseResources();
+        autoMixEngine.releaseResources();
+        deckCollection.prepareToPlay((int)number, sampleRate);
+        autoMixEngine.prepareToPlay((int)number, sampleRate);
+    }
+    else if (event.action == "curve")
+    {
+        for (auto curve : { MixerBus::Curve::linear, MixerBus::Curve::equalPower, MixerBus::Curve::cut })
+        {
+            if (event.value.removeCharacters(" ").equalsIgnoreCase(MixerBus::getCurveName(curve).removeCharacters(" ")))
+            {
+                autoMixEngine.setCrossfadeCurve(curve);
+                return true;
+            }
+        }
+
+        return failEvent(event, "expected curve linear, equalpower or cut");
+    }
+
+    return true;
+}
+
+/**
+ * Record why an event could not be applied
+ *
+ * @param event                       Event that failed
+ * @param reason                      What went wrong
+ *
+ * @return                            False, so callers can return the result directly
+ */
+bool OfflineMixRenderer::failEvent(const Event& event, const String& reason)
+{
+    const String location = event.lineNumber > 0 ? "Line " + String(event.lineNumber) : "Sample " + String(event.samplePosition);
+    error = location + ": " + event.action + " failed, " + reason;
+    return false;
+}
@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    OfflineMixRenderer.h
+    Created: 17 Oct 2026 3:41:09am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AutoMixEngine.h"
+#include "ControlJournal.h"
+#include "DeckCollection.h"
+
+using namespace juce;
+
+class OfflineMixRenderer
+{
+public:
+    /**
+     * Constructor that prepares the decks and the mixer as an audio device with the given settings would
+     *
+     * @param numDecks                    Number of decks the script can address
+     * @param _sampleRate                 Sample rate of the rendered mix
+     * @param _blockSize                  Largest number of samples rendered per block
+     *
+     * @return                            None
+     */
+    OfflineMixRenderer(int numDecks = 2, double _sampleRate = 44100.0, int _blockSize = 512);
+
+    /**
+     * Destructor that releases the decks and the mixer
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~OfflineMixRenderer();
+
+    /**
+     * Read a timeline from a script file, resolving track paths relative to the script's folder
+     *
+     * @param scriptFile                  Script with one event per line
+     *
+     * @return                            True if every line was understood, false otherwise with the reason in getError
+     */
+    bool loadScript(const File& scriptFile);
+
+    /**
+     * Read a timeline of events, each line holding a time in seconds, a deck number or 'mixer', an action and its value
+     *
+     * @param script                      Text of the script, where blank lines and lines starting with # are ignored
+     * @param baseFolder                  Folder that relative track paths are resolved against
+     *
+     * @return                            True if every line was understood, false otherwise with the reason in getError
+     */
+    bool parseScript(const String& script, const File& baseFolder);
+
+    /**
+     * Replace the timeline with a session read back from a control journal, rendered in blocks of the sizes its audio device asked for
+     *
+     * @param journal                     Session journaled with as many decks, and at the sample rate and block size, this renderer was made with
+     *
+     * @return                            True if every event can be replayed, false otherwise with the reason in getError
+     */
+    bool loadJournal(const ControlJournal::Contents& journal);
+
+    /**
+     * Render the timeline as fast as the CPU allows into a WAV or FLAC file, chosen by the file's extension
+     *
+     * @param outputFile                  File to write, replaced if it exists
+     *
+     * @return                            True if the whole mix was written, false otherwise with the reason in getError
+     */
+    bool render(const File& outputFile);
+
+    /**
+     * Render the timeline as fast as the CPU allows into a writer
+     *
+     * @param writer                      Writer that receives every block of the mix
+     *
+     * @return                            True if the whole mix was written, false otherwise with the reason in getError
+     */
+    bool render(AudioFormatWriter& writer);
+
+    /**
+     * Getter method that retrieves why loading, parsing or rendering last failed
+     *
+     * @param                             None
+     *
+     * @return                            Description of the failure, or an empty string
+     */
+    String getError() const;
+
+    /**
+     * Describe the last render, including how much faster than real time it ran
+     *
+     * @param                             None
+     *
+     * @return                            Report of the rendered length, wall clock time and speed
+     */
+    String getReport() const;
+
+private:
+    /** Change made to one deck or to the mixer at a point on the timeline */
+    struct Event
+    {
+        int64 samplePosition = 0;
+        int deck = -1;
+        String action;
+        String value;
+
+        // Value as a number, read from the script or taken from the journal at full precision
+        double number = 0.0;
+
+        // Deck command type of a journaled command
+        int commandType = 0;
+
+        // Line of the script the event came from, or zero for a journaled event
+        int lineNumber = 0;
+    };
+
+    /**
+     * Apply one event to its deck or to the mixer, between two blocks
+     *
+     * @param event                       Event to apply
+     *
+     * @return                            True if the event was applied, false otherwise with the reason in getError
+     */
+    bool applyEvent(const Event& event);
+
+    /**
+     * Apply one event to a deck
+     *
+     * @param player                      Deck the event addresses
+     * @param event                       Event to apply
+     *
+     * @return                            True if the event was applied, false otherwise with the reason in getError
+     */
+    bool applyDeckEvent(DJAudioPlayer& player, const Event& event);
+
+    /**
+     * Apply one event to the mixer
+     *
+     * @param event                       Event to apply
+     *
+     * @return                            True if the event was applied, false otherwise with the reason in getError
+     */
+    bool applyMixerEvent(const Event& event);
+
+    /**
+     * Record why an event could not be applied
+     *
+     * @param event                       Event that failed
+     * @param reason                      What went wrong
+     *
+     * @return                            False, so callers can return the result directly
+     */
+    bool failEvent(const Event& event, const String& reason);
+
+    const double sampleRate;
+    const int blockSize;
+
+    AudioFormatManager formatManager;
+    DeckCollection deckCollection;
+    AutoMixEngine autoMixEngine;
+
+    // Timeline sorted by position, where events at the same position keep the order of the script
+    std::vector<Event> events;
+    int64 endSamplePosition;
+
+    // Samples per block the journaled audio device asked for, or zero to render blocks of the prepared size
+    int callbackSize;
+
+    // Transition length last set by a journal, which journals the length and its unit separately
+    double journalTransitionLength;
+    bool journalLengthInBeats;
+
+    String error;
+
+    // Results of the last render
+    int64 numSamplesRendered;
+    double renderSeconds;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineMixRenderer)
+};
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    PcmCacheBuilder.cpp
+    Created: 16 Oct 2026 5:06:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "PcmCacheBuilder.h"
+
+/**
+ * Constructor for a cancellable progress window that decodes a list of audio tracks into the PCM cache
+ *
+ * @param _audioFiles                 Audio tracks to decode
+ * @param _formatManager              Format manager used to read the audio tracks
+ *
+ * @return                            None
+ */
+PcmCacheBuilder::PcmCacheBuilder(const Array<File>& _audioFiles, AudioFormatManager& _formatManager)
+    : ThreadWithProgressWindow("Building Track Cache", true, true),
+    audioFiles(_audioFiles),
+    formatManager(_formatManager),
+    numBuilt(0),
+    numFailed(0)
+{
+}
+
+/**
+ * Destructor for the cache builder
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+PcmCacheBuilder::~PcmCacheBuilder()
+{
+}
+
+/**
+ * Decode every audio track that is not cached yet, called on the background thread
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void PcmCacheBuilder::run()
+{
+    for (int i = 0; i < audioFiles.size(); ++i)
+    {
+        if (threadShouldExit())
+        {
+            return;
+        }
+
+        const File& audioFile = audioFiles.getReference(i);
+
+        setProgress((double)i / audioFiles.size());
+        setStatusMessage("Decoding " + audioFile.getFileName());
+
+        // Tracks that are already cached cost only a file lookup
+        if (pcmDiskCache->isCached(audioFile))
+        {
+            continue;
+        }
+
+        if (pcmDiskCache->buildCacheFile(audioFile, formatManager, [this] { return threadShouldExit(); }))
+        {
+            ++numBuilt;
+        }
+        else if (!threadShouldExit())
+        {
+            ++numFailed;
+        }
+    }
+
+    setProgress(1.0);
+}
+
+/**
+ * Getter method that retrieves the number of tracks that were decoded by this run
+ *
+ * @param                             None
+ *
+ * @return                            Number of tracks decoded
+ */
+int PcmCacheBuilder::getNumBuilt() const
+{
+    return numBuilt;
+}
+
+/**
+ * Getter method that retrieves the number of tracks that could not be decoded
+ *
+ * @param                             None
+ *
+ * @return                            Number of tracks that failed
+ */
+int PcmCacheBuilder::getNumFailed() const
+{
+    return numFailed;
+}
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    PcmCacheBuilder.h
+    Created: 16 Oct 2026 5:06:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "PcmDiskCache.h"
+
+using namespace juce;
+
+class PcmCacheBuilder : public ThreadWithProgressWindow
+{
+public:
+    /**
+     * Constructor for a cancellable progress window that decodes a list of audio tracks into the PCM cache
+     *
+     * @param _audioFiles                 Audio tracks to decode
+     * @param _formatManager              Format manager used to read the audio tracks
+     *
+     * @return                            None
+     */
+    PcmCacheBuilder(const Array<File>& _audioFiles, AudioFormatManager& _formatManager);
+
+    /**
+     * Destructor for the cache builder
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~PcmCacheBuilder() override;
+
+    /**
+     * Decode every audio track that is not cached yet, called on the background thread
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void run() override;
+
+    /**
+     * Getter method that retrieves the number of tracks that were decoded by this run
+     *
+     * @param                             None
+     *
+     * @return                            Number of tracks decoded
+     */
+    int getNumBuilt() const;
+
+    /**
+     * Getter method that retrieves the number of tracks that could not be decoded
+     *
+     * @param                             None
+     *
+     * @return                            Number of tracks that failed
+     */
+    int getNumFailed() const;
+
+private:
+    Array<File> audioFiles;
+    AudioFormatManager& formatManager;
+
+    SharedResourcePointer<PcmDiskCache> pcmDiskCache;
+
+    int numBuilt;
+    int numFailed;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PcmCacheBuilder)
+};
@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    PcmDiskCache.cpp
+    Created: 16 Oct 2026 4:41:27pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "PcmDiskCache.h"
+#include "DecodedTrackCache.h"
+
+/**
+ * Constructor that creates the cache directory in the user application data folder
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+PcmDiskCache::PcmDiskCache()
+    : cacheDirectory(File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("OtoDecks").getChildFile("PcmCache"))
+{
+    cacheDirectory.createDirectory();
+}
+
+/**
+ * Destructor for the cache
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+PcmDiskCache::~PcmDiskCache()
+{
+}
+
+/**
+ * Find the decoded copy of an audio track
+ *
+ * @param audioFile                   Original audio track
+ *
+ * @return                            Decoded copy, or a non-existent file if the track has not been cached
+ */
+File PcmDiskCache::getCachedFile(const File& audioFile) const
+{
+    // Same path, size and modification time key as the in-memory cache, so an edited track is decoded again
+    const String key = DecodedTrackCache::createKey(audioFile);
+
+    return cacheDirectory.getChildFile(String::toHexString(key.hashCode64()) + ".wav");
+}
+
+/**
+ * Determine whether an audio track has a decoded copy
+ *
+ * @param audioFile                   Original audio track
+ *
+ * @return                            True if the track has been cached, false otherwise
+ */
+bool PcmDiskCache::isCached(const File& audioFile) const
+{
+    return getCachedFile(audioFile).existsAsFile();
+}
+
+/**
+ * Decode an audio track to a float WAV file in the cache directory, called on a background thread
+ *
+ * @param audioFile                   Original audio track
+ * @param formatManager               Format manager used to create a reader for the original track
+ * @param shouldCancel                Polled between chunks, the partial file is discarded if it returns true
+ *
+ * @return                            True if the track is cached, false if it could not be decoded or was cancelled
+ */
+bool PcmDiskCache::buildCacheFile(const File& audioFile, AudioFormatManager& formatManager, std::function<bool()> shouldCancel)
+{
+    const File cachedFile = getCachedFile(audioFile);
+
+    if (cachedFile.existsAsFile())
+    {
+        return true;
+    }
+
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+    {
+        return false;
+    }
+
+    // Write next to the final file and only move it into place once it is complete
+    TemporaryFile temporaryFile(cachedFile);
+    const int numChannels = (int)jlimit(1u, 2u, reader->numChannels);
+
+    {
+        std::unique_ptr<FileOutputStream> outputStream(temporaryFile.getFile().createOutputStream());
+
+        if (outputStream == nullptr)
+        {
+            return false;
+        }
+
+        // 32 bit WAV files hold floats, which the memory mapped WAV reader can return without conversion
+        WavAudioFormat wavFormat;
+        std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), reader->sampleRate, (unsigned int)numChannels, 32, {}, 0));
+
+        if (writer == nullptr)
+        {
+            return false;
+        }
+
+        // The writer now owns the stream
+        outputStream.release();
+
+        const int chunkSize = 1 << 16;
+        AudioBuffer<float> chunk(numChannels, chunkSize);
+
+        for (int64 start = 0; start < reader->lengthInSamples; start += chunkSize)
+        {
+            if (shouldCancel != nullptr && shouldCancel())
+            {
+                return false;
+            }
+
+            const int numSamples = (int)jmin((int64)chunkSize, reader->lengthInSamples - start);
+            reader->read(&chunk, 0, numSamples, start, true, numChannels > 1);
+
+            if (!writer->writeFromAudioSampleBuffer(chunk, 0, numSamples))
+            {
+                return false;
+            }
+        }
+    }
+
+    return temporaryFile.overwriteTargetFileWithTemporary();
+}
+
+/**
+ * Open the decoded copy of an audio track as a memory mapped reader, so seeking costs nothing
+ *
+ * @param audioFile                   Original audio track
+ *
+ * @return                            Reader owned by the caller, or nullptr if the track has not been cached
+ */
+AudioFormatReader* PcmDiskCache::createMappedReader(const File& audioFile) const
+{
+    const File cachedFile = getCachedFile(audioFile);
+
+    if (!cachedFile.existsAsFile())
+    {
+        return nullptr;
+    }
+
+    WavAudioFormat wavFormat;
+    std::unique_ptr<MemoryMappedAudioFormatReader> reader(wavFormat.createMemoryMappedReader(cachedFile));
+
+    // Map the whole file so that every read is a memory copy, the operating system pages it in on demand
+    if (reader == nullptr || !reader->mapEntireFile())
+    {
+        return nullptr;
+    }
+
+    return reader.release();
+}
+
+/**
+ * Getter method that retrieves the directory holding the decoded copies
+ *
+ * @param                             None
+ *
+ * @return                            Cache directory
+ */
+File PcmDiskCache::getCacheDirectory() const
+{
+    return cacheDirectory;
+}
+
+/**
+ * Delete every decoded copy
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void PcmDiskCache::clear()
+{
+    for (const auto& cachedFile : cacheDirectory.findChildFiles(File::findFiles, false, "*.wav"))
+    {
+        cachedFile.deleteFile();
+    }
+}
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    PcmDiskCache.h
+    Created: 16 Oct 2026 4:41:27pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class PcmDiskCache
+{
+public:
+    /**
+     * Constructor that creates the cache directory in the user application data folder
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    PcmDiskCache();
+
+    /**
+     * Destructor for the cache
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~PcmDiskCache();
+
+    /**
+     * Find the decoded copy of an audio track
+     *
+     * @param audioFile                   Original audio track
+     *
+     * @return                            Decoded copy, or a non-existent file if the track has not been cached
+     */
+    File getCachedFile(const File& audioFile) const;
+
+    /**
+     * Determine whether an audio track has a decoded copy
+     *
+     * @param audioFile                   Original audio track
+     *
+     * @return                            True if the track has been cached, false otherwise
+     */
+    bool isCached(const File& audioFile) const;
+
+    /**
+     * Decode an audio track to a float WAV file in the cache directory, called on a background thread
+     *
+     * @param audioFile                   Original audio track
+     * @param formatManager               Format manager used to create a reader for the original track
+     * @param shouldCancel                Polled between chunks, the partial file is discarded if it returns true
+     *
+     * @return                            True if the track is cached, false if it could not be decoded or was cancelled
+     */
+    bool buildCacheFile(const File& audioFile, AudioFormatManager& formatManager, std::function<bool()> shouldCancel = nullptr);
+
+    /**
+     * Open the decoded copy of an audio track as a memory mapped reader, so seeking costs nothing
+     *
+     * @param audioFile                   Original audio track
+     *
+     * @return                            Reader owned by the caller, or nullptr if the track has not been cached
+     */
+    AudioFormatReader* createMappedReader(const File& audioFile) const;
+
+    /**
+     * Getter method that retrieves the directory holding the decoded copies
+     *
+     * @param                             None
+     *
+     * @return                            Cache directory
+     */
+    File getCacheDirectory() const;
+
+    /**
+     * Delete every decoded copy
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void clear();
+
+private:
+    File cacheDirectory;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PcmDiskCache)
+};
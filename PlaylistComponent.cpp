@@ -11,6 +11,8 @@
 #include <JuceHeader.h>
 #include "PlaylistComponent.h"
 #include "DataSorter.h"
+#include "KeyDetector.h"
+#include "LoudnessMeter.h"
 
 /**
  * Constructor that initializes the library component
@@ -18,16 +20,20 @@
  * Restore library tracks from last session and set up library headers
  *
  * @param searchInput             Input entered into search box
+ * @param _libraryFile            XML file the library is restored from and saved to
  *
  * @return                        None
  */
-PlaylistComponent::PlaylistComponent(Label* searchInput) : userSearchInput(searchInput), uniqueTrackID(1)
+PlaylistComponent::PlaylistComponent(Label* searchInput, const File& _libraryFile)
+    : userSearchInput(searchInput), uniqueTrackID(1), libraryFile(_libraryFile)
 {
     // Set up column headers
     tableComponent.getHeader().addColumn("#", 1, 20);
     tableComponent.getHeader().addColumn("Track Title", 2, 176);
     tableComponent.getHeader().addColumn("Duration", 3, 176);
     tableComponent.getHeader().addColumn("Audio Format", 4, 176);
+    tableComponent.getHeader().addColumn("BPM", 7, 80);
+    tableComponent.getHeader().addColumn("Key", 8, 80);
     tableComponent.getHeader().addColumn("Load Audio", 5, 176);
     tableComponent.getHeader().addColumn("Delete Audio", 6, 176);
 
@@ -36,6 +42,9 @@ PlaylistComponent::PlaylistComponent(Label* searchInput) : userSearchInput(searc
 
     Component::addAndMakeVisible(tableComponent);
 
+    // Receive tempo and beat grid results from the analysis threads
+    libraryAnalyser.addChangeListener(this);
+
     if (playlistLibrary == nullptr)
     {
         playlistLibrary.reset(new XmlElement("TrackMetaData"));
@@ -43,7 +52,7 @@ PlaylistComponent::PlaylistComponent(Label* searchInput) : userSearchInput(searc
 
     if (getNumRows() == 0)
     {
-        restoreLibrary(File{ "C:/Users/Admin/Downloads/juce-6.1.6-windows/JUCE/modules/NewProject/Source/playlist.xml" });
+        restoreLibrary(libraryFile);
     }
 }
 
@@ -56,6 +65,7 @@ PlaylistComponent::PlaylistComponent(Label* searchInput) : userSearchInput(searc
  */
 PlaylistComponent::~PlaylistComponent()
 {
+    libraryAnalyser.removeChangeListener(this);
 }
 
 /**
@@ -99,7 +109,9 @@ double PlaylistComponent::getSongLength(File audioFile)
 {
     double trackLengthInSeconds = 0;
     formatManager.registerBasicFormats();
-    URL audioURL = URL{ audioFile };
+
+    // Compressed formats such as MP3 may have to be scanned in full to find their length, a decoded copy does not
+    URL audioURL = URL{ pcmDiskCache->isCached(audioFile) ? pcmDiskCache->getCachedFile(audioFile) : audioFile };
 
     // Determine song length based on total samples and sample rate
     AudioFormatReader* audioFormatReader = formatManager.createReaderFor(audioURL.createInputStream(false));
@@ -168,6 +180,25 @@ std::string PlaylistComponent::getSelectedTrackName()
     return tableComponent.getNumSelectedRows() != 0 ? metaData[tableComponent.getSelectedRow()].title : "";
 }
 
+/**
+ * Retrieve every track in the library as a file
+ *
+ * @param                         None
+ *
+ * @return                        Files of all tracks in the library
+ */
+Array<File> PlaylistComponent::getLibraryFiles()
+{
+    Array<File> libraryFiles;
+
+    for (const auto& track : metaData)
+    {
+        libraryFiles.add(File{ track.absolutePath });
+    }
+
+    return libraryFiles;
+}
+
 /**
  * Retrieve the track that is selected in the library
  *
@@ -299,6 +330,24 @@ void PlaylistComponent::paintCell(Graphics& g,
                     Justification::centred,
                     true);
             }
+            if (columnId == 7)
+            {
+                g.drawText(metaData[rowNumber].bpm,
+                    1, 0,
+                    width - 4, height,
+                    Justification::centred,
+                    true);
+            }
+            if (columnId == 8 && !metaData[rowNumber].key.empty())
+            {
+                // Show the Open Key name beside the Camelot name the column is sorted by
+                String camelotName = metaData[rowNumber].key;
+                g.drawText(camelotName + " / " + KeyDetector::getOpenKeyName(camelotName),
+                    1, 0,
+                    width - 4, height,
+                    Justification::centred,
+                    true);
+            }
         }
     }
     else
@@ -338,6 +387,24 @@ void PlaylistComponent::paintCell(Graphics& g,
                     Justification::centred,
                     true);
             }
+            if (columnId == 7)
+            {
+                g.drawText(searchResultData[rowNumber].bpm,
+                    1, 0,
+                    width - 4, height,
+                    Justification::centred,
+                    true);
+            }
+            if (columnId == 8 && !searchResultData[rowNumber].key.empty())
+            {
+                // Show the Open Key name beside the Camelot name the column is sorted by
+                String camelotName = searchResultData[rowNumber].key;
+                g.drawText(camelotName + " / " + KeyDetector::getOpenKeyName(camelotName),
+                    1, 0,
+                    width - 4, height,
+                    Justification::centred,
+                    true);
+            }
         }
     }
 }
@@ -411,16 +478,28 @@ void PlaylistComponent::buttonClicked(Button* button)
         bool beginDecrement;
         auto decrementIterator = nullptr;
 
+        std::string deletedPath;
+
         // Delete the track from the unfiltered vector of tracks
         for (auto iterator = metaData.begin(); iterator != metaData.end(); ++iterator)
         {
             if (std::to_string(id) == String(iterator->customId).toStdString())
             {
+                deletedPath = iterator->absolutePath;
                 metaData.erase(iterator);
                 break;
             }
         }
 
+        // Stop analysing a track that has left the library, unless another row still holds it
+        auto remainingTrack = std::find_if(metaData.begin(), metaData.end(),
+            [&deletedPath](const trackMetaData& track) { return track.absolutePath == deletedPath; });
+
+        if (!deletedPath.empty() && remainingTrack == metaData.end())
+        {
+            libraryAnalyser.cancelTrack(File{ deletedPath });
+        }
+
         // Decrement the unique identifier for each struct after the deleted element to prevent ID to row number discrepancies
         for (auto decrementIterator = metaData.begin(); decrementIterator != metaData.end(); ++decrementIterator)
         {
@@ -449,7 +528,7 @@ void PlaylistComponent::buttonClicked(Button* button)
         playlistLibrary->removeChildElement(childToRemove, true);
 
         // Update playlist stored in XML file
-        playlistLibrary->writeTo(File{ "C:/Users/Admin/Downloads/juce-6.1.6-windows/JUCE/modules/NewProject/Source/playlist.xml" });
+        playlistLibrary->writeTo(libraryFile);
 
         // Update UI to remove deleted track
         tableComponent.updateContent();
@@ -480,6 +559,17 @@ void PlaylistComponent::processFile(File file, int id)
     trackMetaData.format = fileFormat.toStdString();
     trackMetaData.absolutePath = absolutePath.toStdString();
 
+    // Reuse the analysis of a track that was analysed before it was added
+    auto analysedTrack = analysedTracks.find(trackMetaData.absolutePath);
+    const bool analysed = analysedTrack != analysedTracks.end();
+
+    if (analysed)
+    {
+        trackMetaData.bpm = analysedTrack->second.succeeded ? String(analysedTrack->second.beatsPerMinute, 2).toStdString() : "";
+        trackMetaData.downbeat = analysedTrack->second.succeeded ? String(analysedTrack->second.downbeatSeconds, 4).toStdString() : "";
+        trackMetaData.key = analysedTrack->second.key.toStdString();
+    }
+
     if (id != -1)
     {
         metaData[id] = trackMetaData;
@@ -498,6 +588,15 @@ void PlaylistComponent::processFile(File file, int id)
     track->setAttribute("format", fileFormat.toStdString());
     track->setAttribute("absolutePath", absolutePath.toStdString());
 
+    if (analysed)
+    {
+        track->setAttribute("bpm", trackMetaData.bpm);
+        track->setAttribute("downbeat", trackMetaData.downbeat);
+        track->setAttribute("key", trackMetaData.key);
+        track->setAttribute("loudness", analysedTrack->second.loudnessMeasured ? String(analysedTrack->second.integratedLoudness, 1) : String());
+        track->setAttribute("truePeak", analysedTrack->second.loudnessMeasured ? String(analysedTrack->second.truePeak, 2) : String());
+    }
+
     auto* existingElement = playlistLibrary->getChildByAttribute("customId", std::to_string(id));
 
     if (id == -1 || !existingElement)
@@ -512,7 +611,10 @@ void PlaylistComponent::processFile(File file, int id)
     }
 
     // Write document to a file as UTF-8
-    playlistLibrary->writeTo(File{ "C:/Users/Admin/Downloads/juce-6.1.6-windows/JUCE/modules/NewProject/Source/playlist.xml" });
+    playlistLibrary->writeTo(libraryFile);
+
+    // Find the tempo in the background, the library is written again once it is known
+    analyseTrack(file);
 
     // Update UI
     tableComponent.updateContent();
@@ -570,6 +672,12 @@ void PlaylistComponent::restoreLibrary(File libraryToBeRestored)
 
     playlistLibrary = playlistXMLDocument.getDocumentElement();
 
+    // A library that does not exist yet or cannot be parsed starts out empty
+    if (playlistLibrary == nullptr)
+    {
+        playlistLibrary.reset(new XmlElement("TrackMetaData"));
+    }
+
     // Clear internal representation of audio meta data
     metaData.clear();
 
@@ -591,6 +699,26 @@ void PlaylistComponent::restoreLibrary(File libraryToBeRestored)
             String length = element->getStringAttribute("length");
             String format = element->getStringAttribute("format");
             String absolutePath = element->getStringAttribute("absolutePath");
+            String bpm = element->getStringAttribute("bpm");
+            String downbeat = element->getStringAttribute("downbeat");
+            String key = element->getStringAttribute("key");
+            String loudness = element->getStringAttribute("loudness");
+            String truePeak = element->getStringAttribute("truePeak");
+
+            // Tracks analysed in an earlier session are never analysed again, unless they were analysed before keys and loudness were measured
+            if (element->hasAttribute("bpm") && element->hasAttribute("key") && element->hasAttribute("loudness"))
+            {
+                LibraryAnalyser::TrackAnalysis analysis;
+                analysis.file = File{ absolutePath };
+                analysis.succeeded = bpm.isNotEmpty();
+                analysis.beatsPerMinute = bpm.getDoubleValue();
+                analysis.downbeatSeconds = downbeat.getDoubleValue();
+                analysis.key = key;
+                analysis.loudnessMeasured = loudness.isNotEmpty();
+                analysis.integratedLoudness = loudness.getDoubleValue();
+                analysis.truePeak = truePeak.getDoubleValue();
+                analysedTracks[absolutePath.toStdString()] = analysis;
+            }
 
             // Create a track record from the  XML element to store internally
             restoreChildTrack.customId = customTrackId.toStdString();
@@ -598,15 +726,21 @@ void PlaylistComponent::restoreLibrary(File libraryToBeRestored)
             restoreChildTrack.length = length.toStdString();
             restoreChildTrack.format = format.toStdString();
             restoreChildTrack.absolutePath = absolutePath.toStdString();
+            restoreChildTrack.bpm = bpm.toStdString();
+            restoreChildTrack.downbeat = downbeat.toStdString();
+            restoreChildTrack.key = key.toStdString();
 
             // Store track record internally
             metaData.push_back(restoreChildTrack);
-
-            // Update XML playlist file
-            playlistLibrary->writeTo(File{ "C:/Users/Admin/Downloads/juce-6.1.6-windows/JUCE/modules/NewProject/Source/playlist.xml" });
         }
+
+        // Update XML playlist file once the identifiers are renumbered, rather than once per track
+        playlistLibrary->writeTo(libraryFile);
     }
 
+    // Analyse the tracks that are new to this library in the background
+    analyseLibrary();
+
     // Update UI
     tableComponent.updateContent();
     Component::repaint();
@@ -661,6 +795,9 @@ void PlaylistComponent::sortOrderChanged(int newSortColumnId, bool isForwards)
             String length = element->getStringAttribute("length");
             String format = element->getStringAttribute("format");
             String absolutePath = element->getStringAttribute("absolutePath");
+            String bpm = element->getStringAttribute("bpm");
+            String downbeat = element->getStringAttribute("downbeat");
+            String key = element->getStringAttribute("key");
 
             // Create a track record from the XML element to store internally
             restoreChildTrack.customId = customTrackId.toStdString();
@@ -668,6 +805,9 @@ void PlaylistComponent::sortOrderChanged(int newSortColumnId, bool isForwards)
             restoreChildTrack.length = length.toStdString();
             restoreChildTrack.format = format.toStdString();
             restoreChildTrack.absolutePath = absolutePath.toStdString();
+            restoreChildTrack.bpm = bpm.toStdString();
+            restoreChildTrack.downbeat = downbeat.toStdString();
+            restoreChildTrack.key = key.toStdString();
 
             // Add sorted track to playlist
             metaData.push_back(restoreChildTrack);
@@ -705,9 +845,206 @@ String PlaylistComponent::getAttributeNameForColumnId(int columnId)
     {
         columnAttribute = "format";
     }
+    else if (columnHeader == "BPM")
+    {
+        columnAttribute = "bpm";
+    }
+    else if (columnHeader == "Key")
+    {
+        columnAttribute = "key";
+    }
     else
     {
         columnAttribute = "columnId";
     }
     return columnAttribute;
+}
+
+/**
+ * Queue a track for tempo, beat grid, key and loudness analysis unless it has already been analysed
+ *
+ * @param audioFile               Audio track file
+ * @param priority                Priority of the analysis, where tracks loaded into a deck go first
+ *
+ * @return                        None
+ */
+void PlaylistComponent::analyseTrack(File audioFile, AnalysisScheduler::Priority priority)
+{
+    if (analysedTracks.count(audioFile.getFullPathName().toStdString()) == 0)
+    {
+        libraryAnalyser.analyseTrack(audioFile, priority);
+    }
+}
+
+/**
+ * Getter method that retrieves the progress and throughput of the library analysis
+ *
+ * @param                         None
+ *
+ * @return                        Progress of the tracks queued since the analysis was last idle
+ */
+AnalysisScheduler::Progress PlaylistComponent::getAnalysisProgress() const
+{
+    return libraryAnalyser.getProgress();
+}
+
+/**
+ * Retrieve the beat grid of an analysed track without analysing it again
+ *
+ * @param audioFile               Audio track file
+ * @param beatsPerMinute          Receives the tempo at the original speed, or zero if no tempo was found
+ * @param downbeatSeconds         Receives the time of the first downbeat
+ *
+ * @return                        True if the track has been analysed, false otherwise
+ */
+bool PlaylistComponent::getBeatGrid(File audioFile, double& beatsPerMinute, double& downbeatSeconds)
+{
+    auto analysedTrack = analysedTracks.find(audioFile.getFullPathName().toStdString());
+
+    if (analysedTrack == analysedTracks.end())
+    {
+        return false;
+    }
+
+    beatsPerMinute = analysedTrack->second.beatsPerMinute;
+    downbeatSeconds = analysedTrack->second.downbeatSeconds;
+    return true;
+}
+
+/**
+ * Retrieve the loudness of a track from its analysis, or from its ReplayGain tags if it has not been analysed yet
+ *
+ * @param audioFile               Audio track file
+ * @param integratedLoudness      Receives the integrated loudness in LUFS
+ * @param truePeak                Receives the true peak in dBTP
+ *
+ * @return                        True if the loudness of the track is known, false otherwise
+ */
+bool PlaylistComponent::getLoudness(File audioFile, double& integratedLoudness, double& truePeak)
+{
+    auto analysedTrack = analysedTracks.find(audioFile.getFullPathName().toStdString());
+
+    if (analysedTrack == analysedTracks.end())
+    {
+        // Reading the tags needs no decode, so a tagged track is trimmed as soon as it loads
+        return LoudnessMeter::readReplayGainTags(audioFile, integratedLoudness, truePeak);
+    }
+
+    if (!analysedTrack->second.loudnessMeasured)
+    {
+        return false;
+    }
+
+    integratedLoudness = analysedTrack->second.integratedLoudness;
+    truePeak = analysedTrack->second.truePeak;
+    return true;
+}
+
+/**
+ * Store finished analyses in the library and persist them
+ *
+ * @param source                  ChangeBroadcaster that triggered the callback
+ *
+ * @return                        None
+ */
+void PlaylistComponent::changeListenerCallback(ChangeBroadcaster* source)
+{
+    if (source != &libraryAnalyser)
+    {
+        return;
+    }
+
+    Array<LibraryAnalyser::TrackAnalysis> analyses = libraryAnalyser.takeFinishedAnalyses();
+
+    for (const auto& analysis : analyses)
+    {
+        const std::string absolutePath = analysis.file.getFullPathName().toStdString();
+        analysedTracks[absolutePath] = analysis;
+
+        // A track without a steady beat is stored with an empty tempo, so it is not analysed again either
+        const std::string bpm = analysis.succeeded ? String(analysis.beatsPerMinute, 2).toStdString() : "";
+        const std::string downbeat = analysis.succeeded ? String(analysis.downbeatSeconds, 4).toStdString() : "";
+        const std::string key = analysis.key.toStdString();
+        const String loudness = analysis.loudnessMeasured ? String(analysis.integratedLoudness, 1) : String();
+        const String truePeak = analysis.loudnessMeasured ? String(analysis.truePeak, 2) : String();
+
+        // Update every row of the track, in the library and in the search results
+        for (auto& track : metaData)
+        {
+            if (track.absolutePath == absolutePath)
+            {
+                track.bpm = bpm;
+                track.downbeat = downbeat;
+                track.key = key;
+            }
+        }
+        for (auto& track : searchResultData)
+        {
+            if (track.absolutePath == absolutePath)
+            {
+                track.bpm = bpm;
+                track.downbeat = downbeat;
+                track.key = key;
+            }
+        }
+
+        for (XmlElement* element : playlistLibrary->getChildWithTagNameIterator("Track"))
+        {
+            if (element->getStringAttribute("absolutePath").toStdString() == absolutePath)
+            {
+                element->setAttribute("bpm", bpm);
+                element->setAttribute("downbeat", downbeat);
+                element->setAttribute("key", key);
+                element->setAttribute("loudness", loudness);
+                element->setAttribute("truePeak", truePeak);
+            }
+        }
+    }
+
+    if (analyses.isEmpty())
+    {
+        return;
+    }
+
+    // Write the library once for every batch of results
+    playlistLibrary->writeTo(libraryFile);
+
+    // Update UI
+    tableComponent.updateContent();
+    Component::repaint();
+}
+
+/**
+ * Queue every library track that has not been analysed yet
+ *
+ * @param                         None
+ *
+ * @return                        None
+ */
+void PlaylistComponent::analyseLibrary()
+{
+    for (const auto& track : metaData)
+    {
+        analyseTrack(File{ track.absolutePath });
+    }
+}
+
+/**
+ * Getter method that retrieves the library file to use when none is given
+ *
+ * @param                         None
+ *
+ * @return                        File from the --library argument, or the library of the last session
+ */
+File PlaylistComponent::getDefaultLibraryFile()
+{
+    const StringArray arguments = JUCEApplicationBase::getCommandLineParameterArray();
+    const int argumentIndex = arguments.indexOf("--library");
+
+    if (argumentIndex >= 0 && argumentIndex + 1 < arguments.size())
+    {
+        return File::getCurrentWorkingDirectory().getChildFile(arguments[argumentIndex + 1].unquoted());
+    }
+
+    return File{ "C:/Users/Admin/Downloads/juce-6.1.6-windows/JUCE/modules/NewProject/Source/playlist.xml" };
 }
\ No newline at end of file
@@ -11,8 +11,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PcmDiskCache.h"
+#include "LibraryAnalyser.h"
 #include <vector>
 #include <string>
+#include <map>
 
 using namespace juce;
 
@@ -21,7 +24,8 @@ class PlaylistComponent : public juce::Component,
     public Button::Listener,
     public AudioFormatManager,
     public Label,
-    public DragAndDropContainer
+    public DragAndDropContainer,
+    public ChangeListener
 {
 public:
     /**
@@ -30,10 +34,11 @@ public:
      * Restore library tracks from last session and set up library headers
      *
      * @param searchInput             Input entered into search box
+     * @param _libraryFile            XML file the library is restored from and saved to
      *
      * @return                        None
      */
-    PlaylistComponent(Label* searchInput);
+    PlaylistComponent(Label* searchInput, const File& _libraryFile = getDefaultLibraryFile());
 
     /**
      * Destructor that cleans up after object is deallocated
@@ -79,6 +84,15 @@ public:
 
         // Absolute path of track in file system
         std::string absolutePath;
+
+        // Tempo found by analysis, empty until the track has been analysed or if no tempo was found
+        std::string bpm;
+
+        // Time of the first downbeat in seconds, which anchors the beat grid
+        std::string downbeat;
+
+        // Camelot name of the musical key, empty until the track has been analysed or if no key was found
+        std::string key;
     };
 
     /**
@@ -117,6 +131,15 @@ public:
     */
     std::string getSelectedTrackName();
 
+    /**
+    * Retrieve every track in the library as a file
+    *
+    * @param                         None
+    *
+    * @return                        Files of all tracks in the library
+    */
+    Array<File> getLibraryFiles();
+
     /**
     * Retrieve the track that is selected in the library
     *
@@ -266,7 +289,75 @@ public:
     */
     String getAttributeNameForColumnId(int columnId);
 
+    /**
+    * Queue a track for tempo, beat grid, key and loudness analysis unless it has already been analysed
+    *
+    * @param audioFile               Audio track file
+    * @param priority                Priority of the analysis, where tracks loaded into a deck go first
+    *
+    * @return                        None
+    */
+    void analyseTrack(File audioFile, AnalysisScheduler::Priority priority = AnalysisScheduler::Priority::library);
+
+    /**
+    * Getter method that retrieves the progress and throughput of the library analysis
+    *
+    * @param                         None
+    *
+    * @return                        Progress of the tracks queued since the analysis was last idle
+    */
+    AnalysisScheduler::Progress getAnalysisProgress() const;
+
+    /**
+    * Retrieve the beat grid of an analysed track without analysing it again
+    *
+    * @param audioFile               Audio track file
+    * @param beatsPerMinute          Receives the tempo at the original speed, or zero if no tempo was found
+    * @param downbeatSeconds         Receives the time of the first downbeat
+    *
+    * @return                        True if the track has been analysed, false otherwise
+    */
+    bool getBeatGrid(File audioFile, double& beatsPerMinute, double& downbeatSeconds);
+
+    /**
+    * Retrieve the loudness of a track from its analysis, or from its ReplayGain tags if it has not been analysed yet
+    *
+    * @param audioFile               Audio track file
+    * @param integratedLoudness      Receives the integrated loudness in LUFS
+    * @param truePeak                Receives the true peak in dBTP
+    *
+    * @return                        True if the loudness of the track is known, false otherwise
+    */
+    bool getLoudness(File audioFile, double& integratedLoudness, double& truePeak);
+
+    /**
+    * Store finished analyses in the library and persist them
+    *
+    * @param source                  ChangeBroadcaster that triggered the callback
+    *
+    * @return                        None
+    */
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
+    /**
+    * Getter method that retrieves the library file to use when none is given
+    *
+    * @param                         None
+    *
+    * @return                        File from the --library argument, or the library of the last session
+    */
+    static File getDefaultLibraryFile();
+
 private:
+    /**
+    * Queue every library track that has not been analysed yet
+    *
+    * @param                         None
+    *
+    * @return                        None
+    */
+    void analyseLibrary();
+
     TableListBox tableComponent;
 
     std::vector<trackMetaData> metaData;
@@ -274,11 +365,23 @@ private:
 
     std::unique_ptr<XmlElement> playlistLibrary;
 
+    // Where the library is kept between sessions
+    File libraryFile;
+
     int uniqueTrackID;
 
     Label* userSearchInput;
 
     AudioFormatManager formatManager;
 
+    // Decoded copies of tracks, whose lengths are read from a WAV header instead of a full decode
+    SharedResourcePointer<PcmDiskCache> pcmDiskCache;
+
+    // Analysed tracks by absolute path, including tracks loaded into a deck from outside the library
+    std::map<std::string, LibraryAnalyser::TrackAnalysis> analysedTracks;
+
+    // Finds the tempo and beat grid of tracks on worker threads
+    LibraryAnalyser libraryAnalyser;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaylistComponent)
 };
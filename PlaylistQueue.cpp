@@ -206,6 +206,18 @@ File PlaylistQueue::dequeueTrack()
     return nextTrackToPlay;
 }
 
+/**
+ * Getter method that retrieves the next track in the queue without removing it
+ *
+ * @param                         None
+ *
+ * @return                        Audio track that will be dequeued next
+ */
+File PlaylistQueue::peekTrack()
+{
+    return audioTrackQueue.front();
+}
+
 /**
  * Determine if there are any tracks queued up
  *
@@ -107,6 +107,15 @@ public:
     */
     File dequeueTrack();
 
+    /**
+    * Getter method that retrieves the next track in the queue without removing it
+    *
+    * @param                         None
+    *
+    * @return                        Audio track that will be dequeued next
+    */
+    File peekTrack();
+
     /**
     * Determine if there are any tracks queued up
     *
@@ -0,0 +1,636 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.cpp
+    Created: 16 Oct 2026 1:48:05pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "ReadAheadAudioSource.h"
+#include "RealtimeSafetyChecker.h"
+
+/**
+ * Constructor that wraps a source whose reads may block, such as a file on a slow disk
+ *
+ * @param _source                     Source to read ahead of, owned by this object
+ * @param _backgroundThread           Shared thread that fills the buffer
+ * @param _numberOfSamplesToBuffer    Size of the read ahead buffer in samples
+ * @param _numberOfChannels           Number of channels to buffer
+ *
+ * @return                            None
+ */
+ReadAheadAudioSource::ReadAheadAudioSource(PositionableAudioSource* _source, TimeSliceThread& _backgroundThread, int _numberOfSamplesToBuffer, int _numberOfChannels)
+    : source(_source),
+    backgroundThread(_backgroundThread),
+    numberOfSamplesToBuffer(jmax(1024, _numberOfSamplesToBuffer)),
+    numberOfChannels(_numberOfChannels),
+    bufferValidStart(0),
+    bufferValidEnd(0),
+    cueValidStart(0),
+    cueValidEnd(0),
+    cueRequestPosition(-1),
+    nextPlayPos(0),
+    repositionPending(false),
+    seekGapPending(false),
+    wasSourceLooping(false),
+    isPrepared(false),
+    numBlocks(0),
+    numUnderruns(0),
+    numSamplesMissed(0),
+    numSeekGaps(0),
+    numSeekGapSamples(0)
+{
+    jassert(source != nullptr);
+}
+
+/**
+ * Destructor that detaches the source from the background thread before deleting it
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+ReadAheadAudioSource::~ReadAheadAudioSource()
+{
+    releaseResources();
+}
+
+/**
+ * Allocate the read ahead buffer and start filling it on the background thread
+ *
+ * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is fetched
+ * @param sampleRate                  Number of sound samples taken per second
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // Stop the background thread touching the buffer while it is reallocated
+    backgroundThread.removeTimeSliceClient(this);
+
+    const int bufferSizeNeeded = jmax(samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
+
+    if (bufferSizeNeeded != buffer.getNumSamples())
+    {
+        buffer.setSize(numberOfChannels, bufferSizeNeeded);
+    }
+
+    buffer.clear();
+
+    // Hold enough after a seek to cover the time the background thread takes to refill from there
+    cueBuffer.setSize(numberOfChannels, jmax(samplesPerBlockExpected * 8, 32768));
+    cueBuffer.clear();
+
+    source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+        bufferValidStart = 0;
+        bufferValidEnd = 0;
+        cueValidStart = 0;
+        cueValidEnd = 0;
+    }
+
+    cueRequestPosition = -1;
+
+    isPrepared = true;
+    backgroundThread.addTimeSliceClient(this);
+}
+
+/**
+ * Stop filling the buffer and release it
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::releaseResources()
+{
+    // Waits for a chunk that is being read to finish
+    backgroundThread.removeTimeSliceClient(this);
+
+    if (isPrepared)
+    {
+        source->releaseResources();
+        isPrepared = false;
+    }
+
+    buffer.setSize(numberOfChannels, 0);
+    cueBuffer.setSize(numberOfChannels, 0);
+}
+
+/**
+ * Copy the next block from the read ahead buffer without touching the disk, filling any missing part with silence
+ *
+ * @param bufferToFill                Buffer that must be filled with audio data
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const int64 start = nextPlayPos;
+    const int64 end = start + bufferToFill.numSamples;
+    int64 ringStart, ringEnd, cueStart, cueEnd;
+
+    {
+        // The background thread only holds the lock to publish a new range, never while reading from disk
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+
+        ringStart = jlimit(start, end, bufferValidStart);
+        ringEnd = jlimit(start, end, bufferValidEnd);
+        cueStart = jlimit(start, end, cueValidStart);
+        cueEnd = jlimit(start, end, cueValidEnd);
+
+        if (ringStart == start && ringEnd == end)
+        {
+            copyToBlock(bufferToFill, 0, buffer, (int)(start % buffer.getNumSamples()), bufferToFill.numSamples);
+        }
+        else
+        {
+            // Silence the parts of the block that have not been read yet
+            bufferToFill.clearActiveBufferRegion();
+
+            // Straight after a seek the audio read ahead of it covers what the circular buffer does not hold yet
+            if (cueStart < cueEnd)
+            {
+                copyToBlock(bufferToFill, (int)(cueStart - start), cueBuffer, (int)(cueStart - cueValidStart), (int)(cueEnd - cueStart));
+            }
+
+            if (ringStart < ringEnd)
+            {
+                copyToBlock(bufferToFill, (int)(ringStart - start), buffer, (int)(ringStart % buffer.getNumSamples()), (int)(ringEnd - ringStart));
+            }
+        }
+
+        nextPlayPos = end;
+    }
+
+    // Samples past the end of a track that does not loop are expected to be silent
+    int64 expectedEnd = end;
+
+    if (!isLooping())
+    {
+        expectedEnd = jlimit(start, end, getTotalLength());
+    }
+
+    const int64 ringCovered = jmax((int64)0, jmin(ringEnd, expectedEnd) - ringStart);
+    const int64 cueCovered = jmax((int64)0, jmin(cueEnd, expectedEnd) - cueStart);
+    const int64 bothCovered = jmax((int64)0, jmin(ringEnd, cueEnd, expectedEnd) - jmax(ringStart, cueStart));
+    const int64 numMissed = (expectedEnd - start) - (ringCovered + cueCovered - bothCovered);
+
+    ++numBlocks;
+
+    if (numMissed == 0)
+    {
+        seekGapPending = false;
+    }
+    else if (seekGapPending)
+    {
+        // The disk has not caught up with a seek yet, which is counted apart from a refill that fell behind
+        ++numSeekGaps;
+        numSeekGapSamples += numMissed;
+    }
+    else
+    {
+        ++numUnderruns;
+        numSamplesMissed += numMissed;
+    }
+}
+
+/**
+ * Move the playhead and have the background thread refill from the new position on its next time slice
+ *
+ * @param newPosition                 Position in samples
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::setNextReadPosition(int64 newPosition)
+{
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+        nextPlayPos = newPosition;
+    }
+
+    // Seeks are made on the audio thread, so the background thread picks this up on its next time slice rather than being woken
+    repositionPending = true;
+    seekGapPending = true;
+}
+
+/**
+ * Getter method that retrieves the position of the next sample that will be returned
+ *
+ * @param                             None
+ *
+ * @return                            Position in samples
+ */
+int64 ReadAheadAudioSource::getNextReadPosition() const
+{
+    const int64 position = nextPlayPos;
+    const int64 totalLength = source->getTotalLength();
+
+    // Positions keep increasing while a looping source wraps around
+    return isLooping() && totalLength > 0 ? position % totalLength : position;
+}
+
+/**
+ * Getter method that retrieves the length of the wrapped source
+ *
+ * @param                             None
+ *
+ * @return                            Length in samples
+ */
+int64 ReadAheadAudioSource::getTotalLength() const
+{
+    return source->getTotalLength();
+}
+
+/**
+ * Determine whether the wrapped source loops
+ *
+ * @param                             None
+ *
+ * @return                            True if the wrapped source loops, false otherwise
+ */
+bool ReadAheadAudioSource::isLooping() const
+{
+    return source->isLooping();
+}
+
+/**
+ * Setter method that sets whether the wrapped source loops, keeping the buffered audio before the end of the track
+ *
+ * @param shouldLoop                  True if the wrapped source should loop
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::setLooping(bool shouldLoop)
+{
+    source->setLooping(shouldLoop);
+}
+
+/**
+ * Block the calling thread until a number of samples ahead of the playhead are buffered, for offline use
+ *
+ * @param numSamples                  Number of samples that must be buffered
+ * @param timeoutMilliseconds         Maximum time to wait
+ *
+ * @return                            True if the samples were buffered in time, false otherwise
+ */
+bool ReadAheadAudioSource::waitUntilBuffered(int numSamples, int timeoutMilliseconds)
+{
+    const uint32 endTime = Time::getMillisecondCounter() + (uint32)timeoutMilliseconds;
+
+    for (;;)
+    {
+        const int64 start = nextPlayPos;
+        int64 end = start + jmin(numSamples, buffer.getNumSamples() - 4);
+
+        // Nothing past the end of the track will ever be buffered
+        if (!isLooping())
+        {
+            end = jmin(end, getTotalLength());
+        }
+
+        {
+            const SpinLock::ScopedLockType lock(bufferRangeLock);
+
+            if (bufferValidStart <= start && bufferValidEnd >= end)
+            {
+                return true;
+            }
+        }
+
+        const int64 remaining = (int64)endTime - (int64)Time::getMillisecondCounter();
+
+        if (remaining <= 0)
+        {
+            return false;
+        }
+
+        backgroundThread.moveToFrontOfQueue(this);
+
+        RealtimeSafetyChecker::noteBlockingCall("ReadAheadAudioSource::waitUntilBuffered");
+        bufferReadyEvent.wait((int)jmin((int64)50, remaining));
+    }
+}
+
+/**
+ * Block the calling thread until the audio at a position the playhead is about to jump to has been read, so the
+ * jump plays straight away instead of leaving a gap until the background thread catches up
+ *
+ * @param position                    Position in samples that the playhead will move to
+ * @param timeoutMilliseconds         Maximum time to wait
+ *
+ * @return                            True if the audio at the position is ready, false otherwise
+ */
+bool ReadAheadAudioSource::prepareSeek(int64 position, int timeoutMilliseconds)
+{
+    if (!isPrepared)
+    {
+        return false;
+    }
+
+    int64 end = position + cueBuffer.getNumSamples();
+
+    // Nothing past the end of the track will ever be read
+    if (!isLooping())
+    {
+        end = jmin(end, getTotalLength());
+    }
+
+    if (position >= end)
+    {
+        return true;
+    }
+
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+
+        // A jump within what is already buffered needs no reading
+        if ((bufferValidStart <= position && bufferValidEnd >= end) || (cueValidStart <= position && cueValidEnd >= end))
+        {
+            return true;
+        }
+    }
+
+    cueRequestPosition = position;
+    backgroundThread.moveToFrontOfQueue(this);
+
+    const uint32 endTime = Time::getMillisecondCounter() + (uint32)timeoutMilliseconds;
+
+    for (;;)
+    {
+        {
+            const SpinLock::ScopedLockType lock(bufferRangeLock);
+
+            if (cueValidStart == position && cueValidEnd > position)
+            {
+                return true;
+            }
+        }
+
+        const int64 remaining = (int64)endTime - (int64)Time::getMillisecondCounter();
+
+        if (remaining <= 0)
+        {
+            return false;
+        }
+
+        RealtimeSafetyChecker::noteBlockingCall("ReadAheadAudioSource::prepareSeek");
+        bufferReadyEvent.wait((int)jmin((int64)50, remaining));
+    }
+}
+
+/**
+ * Getter method that retrieves the buffer health counters, safe to call from any thread
+ *
+ * @param                             None
+ *
+ * @return                            Counters gathered since the source was created or last reset
+ */
+ReadAheadAudioSource::Statistics ReadAheadAudioSource::getStatistics() const
+{
+    Statistics statistics;
+    statistics.numBlocks = numBlocks;
+    statistics.numUnderruns = numUnderruns;
+    statistics.numSamplesMissed = numSamplesMissed;
+    statistics.numSeekGaps = numSeekGaps;
+    statistics.numSeekGapSamples = numSeekGapSamples;
+
+    const int64 position = nextPlayPos;
+
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+        statistics.numSamplesBuffered = (int)jmax((int64)0, bufferValidEnd - jmax(position, bufferValidStart));
+    }
+
+    return statistics;
+}
+
+/**
+ * Reset the underrun counters to zero
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::resetStatistics()
+{
+    numBlocks = 0;
+    numUnderruns = 0;
+    numSamplesMissed = 0;
+    numSeekGaps = 0;
+    numSeekGapSamples = 0;
+}
+
+/**
+ * Read the next section of the wrapped source into the buffer, called on the background thread
+ *
+ * @param                             None
+ *
+ * @return                            Milliseconds to wait before this is called again
+ */
+int ReadAheadAudioSource::useTimeSlice()
+{
+    const int64 cuePosition = cueRequestPosition.exchange(-1);
+
+    // The message thread is waiting for a seek to be read, which comes before topping up the circular buffer
+    if (cuePosition >= 0)
+    {
+        readCueSection(cuePosition);
+        return 0;
+    }
+
+    const bool repositioned = repositionPending.exchange(false);
+
+    // Read the first chunks after a seek back to back, otherwise keep reading while there is space
+    if (readNextBufferChunk())
+    {
+        return repositioned ? 0 : 1;
+    }
+
+    // A seek on the audio thread cannot wake this thread, so check back often enough that it waits a few milliseconds at most
+    return repositionPending ? 0 : 5;
+}
+
+/**
+ * Work out which part of the buffer is stale and refill it from the wrapped source
+ *
+ * @param                             None
+ *
+ * @return                            True if anything was read, false if the buffer is already full
+ */
+bool ReadAheadAudioSource::readNextBufferChunk()
+{
+    // Read in modest chunks so that several decks sharing a thread are all served in turn
+    const int maxChunkSize = 4096;
+
+    int64 newValidStart, newValidEnd, sectionToReadStart, sectionToReadEnd;
+
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+
+        if (wasSourceLooping != isLooping())
+        {
+            wasSourceLooping = isLooping();
+
+            // Only the audio past the end of the track changes, so keep what is buffered before it to avoid an underrun
+            bufferValidEnd = jmin(bufferValidEnd, source->getTotalLength());
+
+            if (bufferValidStart >= bufferValidEnd)
+            {
+                bufferValidStart = 0;
+                bufferValidEnd = 0;
+            }
+
+            cueValidEnd = jmin(cueValidEnd, source->getTotalLength());
+
+            if (cueValidStart >= cueValidEnd)
+            {
+                cueValidStart = 0;
+                cueValidEnd = 0;
+            }
+        }
+
+        newValidStart = jmax((int64)0, nextPlayPos.load());
+        newValidEnd = newValidStart + buffer.getNumSamples() - 4;
+        sectionToReadStart = 0;
+        sectionToReadEnd = 0;
+
+        if (newValidStart < bufferValidStart || newValidStart >= bufferValidEnd)
+        {
+            // The playhead jumped outside the buffered range, so start again from the playhead
+            newValidEnd = jmin(newValidEnd, newValidStart + maxChunkSize);
+            sectionToReadStart = newValidStart;
+            sectionToReadEnd = newValidEnd;
+            bufferValidStart = 0;
+            bufferValidEnd = 0;
+        }
+        else if (std::abs((int)(newValidStart - bufferValidStart)) > 512 || std::abs((int)(newValidEnd - bufferValidEnd)) > 512)
+        {
+            // Top up the buffer after the samples that have already been played
+            newValidEnd = jmin(newValidEnd, bufferValidEnd + maxChunkSize);
+            sectionToReadStart = bufferValidEnd;
+            sectionToReadEnd = newValidEnd;
+            bufferValidStart = newValidStart;
+            bufferValidEnd = jmin(bufferValidEnd, newValidEnd);
+        }
+    }
+
+    if (sectionToReadStart == sectionToReadEnd)
+    {
+        return false;
+    }
+
+    // The section being read lies outside the published range, so the audio thread never copies it
+    const int bufferIndexStart = (int)(sectionToReadStart % buffer.getNumSamples());
+    const int bufferIndexEnd = (int)(sectionToReadEnd % buffer.getNumSamples());
+
+    if (bufferIndexStart < bufferIndexEnd)
+    {
+        readBufferSection(buffer, sectionToReadStart, (int)(sectionToReadEnd - sectionToReadStart), bufferIndexStart);
+    }
+    else
+    {
+        const int initialSize = buffer.getNumSamples() - bufferIndexStart;
+
+        readBufferSection(buffer, sectionToReadStart, initialSize, bufferIndexStart);
+        readBufferSection(buffer, sectionToReadStart + initialSize, (int)(sectionToReadEnd - sectionToReadStart) - initialSize, 0);
+    }
+
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+        bufferValidStart = newValidStart;
+        bufferValidEnd = newValidEnd;
+    }
+
+    bufferReadyEvent.signal();
+    return true;
+}
+
+/**
+ * Read the section at a position the message thread is about to seek to into the cue buffer
+ *
+ * @param position                    Position in samples of the first sample to read
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::readCueSection(int64 position)
+{
+    int length = cueBuffer.getNumSamples();
+
+    if (!isLooping())
+    {
+        length = (int)jlimit((int64)0, (int64)length, getTotalLength() - position);
+    }
+
+    // Stop the audio thread copying the previous section while it is overwritten
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+        cueValidStart = 0;
+        cueValidEnd = 0;
+    }
+
+    if (length > 0)
+    {
+        readBufferSection(cueBuffer, position, length, 0);
+    }
+
+    {
+        const SpinLock::ScopedLockType lock(bufferRangeLock);
+        cueValidStart = position;
+        cueValidEnd = position + length;
+    }
+
+    bufferReadyEvent.signal();
+}
+
+/**
+ * Read a contiguous range of the wrapped source into a buffer
+ *
+ * @param destination                 Buffer the samples are written to
+ * @param start                       Position in samples of the first sample to read
+ * @param length                      Number of samples to read
+ * @param bufferOffset                Index in the buffer at which the samples are written
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::readBufferSection(AudioBuffer<float>& destination, int64 start, int length, int bufferOffset)
+{
+    if (source->getNextReadPosition() != start)
+    {
+        source->setNextReadPosition(start);
+    }
+
+    source->getNextAudioBlock(AudioSourceChannelInfo(&destination, bufferOffset, length));
+}
+
+/**
+ * Copy samples into part of a block, wrapping around the end of the buffer they are copied from
+ *
+ * @param bufferToFill                Block being filled
+ * @param blockOffset                 Index in the block of the first sample to write
+ * @param from                        Buffer to copy from
+ * @param fromIndex                   Index in the buffer of the first sample to copy
+ * @param numSamples                  Number of samples to copy
+ *
+ * @return                            None
+ */
+void ReadAheadAudioSource::copyToBlock(const AudioSourceChannelInfo& bufferToFill, int blockOffset, const AudioBuffer<float>& from, int fromIndex, int numSamples) const
+{
+    const int firstPart = jmin(numSamples, from.getNumSamples() - fromIndex);
+
+    for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+    {
+        const int sourceChannel = jmin(channel, numberOfChannels - 1);
+
+        bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + blockOffset, from, sourceChannel, fromIndex, firstPart);
+
+        if (firstPart < numSamples)
+        {
+            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + blockOffset + firstPart, from, sourceChannel, 0, numSamples - firstPart);
+        }
+    }
+}
@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.h
+    Created: 16 Oct 2026 1:48:05pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class ReadAheadAudioSource : public PositionableAudioSource,
+                             private TimeSliceClient
+{
+public:
+    /** Buffer health counters gathered by the audio thread */
+    struct Statistics
+    {
+        // Number of blocks requested by the audio thread
+        int64 numBlocks = 0;
+
+        // Number of blocks that were not fully buffered in time
+        int64 numUnderruns = 0;
+
+        // Number of samples replaced by silence because they were not buffered in time
+        int64 numSamplesMissed = 0;
+
+        // Number of blocks after a seek that played silence until the new position was read
+        int64 numSeekGaps = 0;
+
+        // Number of samples replaced by silence after a seek
+        int64 numSeekGapSamples = 0;
+
+        // Number of samples currently buffered ahead of the playhead
+        int numSamplesBuffered = 0;
+    };
+
+    /**
+     * Constructor that wraps a source whose reads may block, such as a file on a slow disk
+     *
+     * @param _source                     Source to read ahead of, owned by this object
+     * @param _backgroundThread           Shared thread that fills the buffer
+     * @param _numberOfSamplesToBuffer    Size of the read ahead buffer in samples
+     * @param _numberOfChannels           Number of channels to buffer
+     *
+     * @return                            None
+     */
+    ReadAheadAudioSource(PositionableAudioSource* _source, TimeSliceThread& _backgroundThread, int _numberOfSamplesToBuffer, int _numberOfChannels = 2);
+
+    /**
+     * Destructor that detaches the source from the background thread before deleting it
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~ReadAheadAudioSource() override;
+
+    /**
+     * Allocate the read ahead buffer and start filling it on the background thread
+     *
+     * @param samplesPerBlockExpected     Number of samples that will be requested each time a block is fetched
+     * @param sampleRate                  Number of sound samples taken per second
+     *
+     * @return                            None
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * Stop filling the buffer and release it
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void releaseResources() override;
+
+    /**
+     * Copy the next block from the read ahead buffer without touching the disk, filling any missing part with silence
+     *
+     * @param bufferToFill                Buffer that must be filled with audio data
+     *
+     * @return                            None
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    /**
+     * Move the playhead and have the background thread refill from the new position on its next time slice
+     *
+     * @param newPosition                 Position in samples
+     *
+     * @return                            None
+     */
+    void setNextReadPosition(int64 newPosition) override;
+
+    /**
+     * Getter method that retrieves the position of the next sample that will be returned
+     *
+     * @param                             None
+     *
+     * @return                            Position in samples
+     */
+    int64 getNextReadPosition() const override;
+
+    /**
+     * Getter method that retrieves the length of the wrapped source
+     *
+     * @param                             None
+     *
+     * @return                            Length in samples
+     */
+    int64 getTotalLength() const override;
+
+    /**
+     * Determine whether the wrapped source loops
+     *
+     * @param                             None
+     *
+     * @return                            True if the wrapped source loops, false otherwise
+     */
+    bool isLooping() const override;
+
+    /**
+     * Setter method that sets whether the wrapped source loops, keeping the buffered audio before the end of the track
+     *
+     * @param shouldLoop                  True if the wrapped source should loop
+     *
+     * @return                            None
+     */
+    void setLooping(bool shouldLoop) override;
+
+    /**
+     * Block the calling thread until a number of samples ahead of the playhead are buffered, for offline use
+     *
+     * @param numSamples                  Number of samples that must be buffered
+     * @param timeoutMilliseconds         Maximum time to wait
+     *
+     * @return                            True if the samples were buffered in time, false otherwise
+     */
+    bool waitUntilBuffered(int numSamples, int timeoutMilliseconds);
+
+    /**
+     * Block the calling thread until the audio at a position the playhead is about to jump to has been read, so the
+     * jump plays straight away instead of leaving a gap until the background thread catches up
+     *
+     * @param position                    Position in samples that the playhead will move to
+     * @param timeoutMilliseconds         Maximum time to wait
+     *
+     * @return                            True if the audio at the position is ready, false otherwise
+     */
+    bool prepareSeek(int64 position, int timeoutMilliseconds);
+
+    /**
+     * Getter method that retrieves the buffer health counters, safe to call from any thread
+     *
+     * @param                             None
+     *
+     * @return                            Counters gathered since the source was created or last reset
+     */
+    Statistics getStatistics() const;
+
+    /**
+     * Reset the underrun counters to zero
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void resetStatistics();
+
+private:
+    /**
+     * Read the next section of the wrapped source into the buffer, called on the background thread
+     *
+     * @param                             None
+     *
+     * @return                            Milliseconds to wait before this is called again
+     */
+    int useTimeSlice() override;
+
+    /**
+     * Work out which part of the buffer is stale and refill it from the wrapped source
+     *
+     * @param                             None
+     *
+     * @return                            True if anything was read, false if the buffer is already full
+     */
+    bool readNextBufferChunk();
+
+    /**
+     * Read the section at a position the message thread is about to seek to into the cue buffer
+     *
+     * @param position                    Position in samples of the first sample to read
+     *
+     * @return                            None
+     */
+    void readCueSection(int64 position);
+
+    /**
+     * Read a contiguous range of the wrapped source into a buffer
+     *
+     * @param destination                 Buffer the samples are written to
+     * @param start                       Position in samples of the first sample to read
+     * @param length                      Number of samples to read
+     * @param bufferOffset                Index in the buffer at which the samples are written
+     *
+     * @return                            None
+     */
+    void readBufferSection(AudioBuffer<float>& destination, int64 start, int length, int bufferOffset);
+
+    /**
+     * Copy samples into part of a block, wrapping around the end of the buffer they are copied from
+     *
+     * @param bufferToFill                Block being filled
+     * @param blockOffset                 Index in the block of the first sample to write
+     * @param from                        Buffer to copy from
+     * @param fromIndex                   Index in the buffer of the first sample to copy
+     * @param numSamples                  Number of samples to copy
+     *
+     * @return                            None
+     */
+    void copyToBlock(const AudioSourceChannelInfo& bufferToFill, int blockOffset, const AudioBuffer<float>& from, int fromIndex, int numSamples) const;
+
+    std::unique_ptr<PositionableAudioSource> source;
+    TimeSliceThread& backgroundThread;
+    int numberOfSamplesToBuffer;
+    int numberOfChannels;
+
+    // Circular buffer indexed by source position modulo its size
+    AudioBuffer<float> buffer;
+
+    // Range of source positions that hold valid samples, only held briefly by either thread
+    mutable SpinLock bufferRangeLock;
+    int64 bufferValidStart;
+    int64 bufferValidEnd;
+
+    // Section read ahead of a seek, played until the circular buffer has caught up with the new position
+    AudioBuffer<float> cueBuffer;
+    int64 cueValidStart;
+    int64 cueValidEnd;
+
+    // Position the message thread is waiting for the cue buffer to hold, or -1 when there is none
+    std::atomic<int64> cueRequestPosition;
+
+    std::atomic<int64> nextPlayPos;
+
+    // Set by a seek, including one made on the audio thread, until the background thread has served it
+    std::atomic<bool> repositionPending;
+
+    // Set by a seek until the audio thread plays its first fully buffered block, so the silence before it is not an underrun
+    std::atomic<bool> seekGapPending;
+
+    bool wasSourceLooping;
+    bool isPrepared;
+
+    WaitableEvent bufferReadyEvent;
+
+    std::atomic<int64> numBlocks;
+    std::atomic<int64> numUnderruns;
+    std::atomic<int64> numSamplesMissed;
+    std::atomic<int64> numSeekGaps;
+    std::atomic<int64> numSeekGapSamples;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadAudioSource)
+};
@@ -0,0 +1,392 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyChecker.cpp
+    Created: 17 Oct 2026 1:12:40am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyChecker.h"
+#include <cstdlib>
+#include <new>
+
+constexpr int RealtimeSafetyChecker::maximumRecords;
+
+// Plain values with constant initialisers, so the allocator hook can read them before any constructor has run
+static std::atomic<bool> checkerEnabled{ false };
+static thread_local int realtimeDepth = 0;
+
+#if OTODECKS_RT_CHECK
+static thread_local bool recordingViolation = false;
+#endif
+
+/**
+ * Constructor that marks the calling thread as rendering audio
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+RealtimeSafetyChecker::ScopedRealtimeSection::ScopedRealtimeSection()
+{
+    ++realtimeDepth;
+}
+
+/**
+ * Destructor that ends the section on the calling thread
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+RealtimeSafetyChecker::ScopedRealtimeSection::~ScopedRealtimeSection()
+{
+    --realtimeDepth;
+}
+
+/**
+ * Setter method that starts or stops recording violations, leaving the recorded ones in place, which does nothing unless OTODECKS_RT_CHECK is set
+ *
+ * @param shouldCheck                 True to record violations made in real-time sections, false to ignore them
+ *
+ * @return                            None
+ */
+void RealtimeSafetyChecker::setEnabled(bool shouldCheck)
+{
+#if OTODECKS_RT_CHECK
+    // Create the state before any audio thread can need it
+    getState();
+
+    checkerEnabled = shouldCheck;
+#else
+    ignoreUnused(shouldCheck);
+#endif
+}
+
+/**
+ * Determine whether violations are being recorded
+ *
+ * @param                             None
+ *
+ * @return                            True if violations are recorded, false otherwise
+ */
+bool RealtimeSafetyChecker::isEnabled()
+{
+    return checkerEnabled;
+}
+
+/**
+ * Determine whether the calling thread is inside a real-time section
+ *
+ * @param                             None
+ *
+ * @return                            True if the thread is rendering audio, false otherwise
+ */
+bool RealtimeSafetyChecker::isInRealtimeSection()
+{
+    return realtimeDepth > 0;
+}
+
+/**
+ * Record a violation with the call stack that made it, if checking is enabled and the calling thread is rendering audio
+ *
+ * @param type                        Kind of call that was made
+ * @param description                 What was called, which must be a string literal or outlive the checker
+ *
+ * @return                            None
+ */
+void RealtimeSafetyChecker::noteViolation(Violation type, const char* description)
+{
+#if !OTODECKS_RT_CHECK
+    ignoreUnused(type, description);
+#else
+    // Checked first and without locking, since every allocation in the application passes through here
+    if (!checkerEnabled.load(std::memory_order_relaxed) || realtimeDepth == 0 || recordingViolation)
+    {
+        return;
+    }
+
+    // Capturing the stack and storing the record allocate too, which must not be recorded in turn
+    recordingViolation = true;
+
+    {
+        const String stackTrace = SystemStats::getStackBacktrace();
+        const String key = String((int)type) + ":" + description + ":" + stackTrace;
+
+        State& state = getState();
+        const ScopedLock scopedLock(state.lock);
+
+        ++state.numViolations;
+
+        auto found = state.records.find(key);
+
+        if (found != state.records.end())
+        {
+            ++found->second.count;
+        }
+        else if ((int)state.records.size() < maximumRecords)
+        {
+            Record& record = state.records[key];
+            record.type = type;
+            record.description = description;
+            record.stackTrace = stackTrace;
+            record.count = 1;
+        }
+        else
+        {
+            ++state.numDropped;
+        }
+    }
+
+    recordingViolation = false;
+#endif
+}
+
+/**
+ * Record a call that can wait on the disk, another thread or the operating system
+ *
+ * @param description                 What was called, which must be a string literal or outlive the checker
+ *
+ * @return                            None
+ */
+void RealtimeSafetyChecker::noteBlockingCall(const char* description)
+{
+    noteViolation(Violation::blockingCall, description);
+}
+
+/**
+ * Getter method that retrieves the number of violations recorded since the last reset
+ *
+ * @param                             None
+ *
+ * @return                            Number of violations, counting repeats from the same call stack
+ */
+int RealtimeSafetyChecker::getNumViolations()
+{
+    State& state = getState();
+    const ScopedLock scopedLock(state.lock);
+
+    return state.numViolations;
+}
+
+/**
+ * Describe every recorded violation, grouped by call stack with the most frequent first
+ *
+ * @param                             None
+ *
+ * @return                            Report listing the kind, count and call stack of each violation
+ */
+String RealtimeSafetyChecker::getReport()
+{
+    std::vector<Record> records;
+    int numViolations;
+    int numDropped;
+
+    {
+        State& state = getState();
+        const ScopedLock scopedLock(state.lock);
+
+        for (const auto& entry : state.records)
+        {
+            records.push_back(entry.second);
+        }
+
+        numViolations = state.numViolations;
+        numDropped = state.numDropped;
+    }
+
+    String report;
+
+    if (numViolations == 0)
+    {
+        return report << "Real-time safety: no allocations, lock acquisitions or blocking calls in the audio callback" << newLine;
+    }
+
+    report << "Real-time safety: " << numViolations << " violations from " << (int)records.size() << " call stacks" << newLine;
+
+    if (numDropped > 0)
+    {
+        report << numDropped << " further violations came from call stacks past the first " << maximumRecords << newLine;
+    }
+
+    std::stable_sort(records.begin(), records.end(), [](const Record& first, const Record& second)
+        {
+            return first.count > second.count;
+        });
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        report << newLine << "#" << (int)(i + 1) << " " << getViolationName(records[i].type) << ": " << records[i].description
+            << ", " << records[i].count << (records[i].count == 1 ? " time" : " times") << newLine;
+
+        // Indent the stack so the records stand out from each other
+        StringArray frames = StringArray::fromLines(records[i].stackTrace.trimEnd());
+
+        for (const auto& frame : frames)
+        {
+            report << "    " << frame << newLine;
+        }
+    }
+
+    return report;
+}
+
+/**
+ * Forget every recorded violation
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void RealtimeSafetyChecker::reset()
+{
+    State& state = getState();
+    const ScopedLock scopedLock(state.lock);
+
+    state.records.clear();
+    state.numViolations = 0;
+    state.numDropped = 0;
+}
+
+/**
+ * Getter method that retrieves the display name of a kind of violation
+ *
+ * @param type                        Kind of violation
+ *
+ * @return                            Name of the kind of violation
+ */
+String RealtimeSafetyChecker::getViolationName(Violation type)
+{
+    switch (type)
+    {
+    case Violation::allocation:
+        return "Heap allocation";
+    case Violation::deallocation:
+        return "Heap deallocation";
+    case Violation::lockAcquisition:
+        return "Lock acquisition";
+    case Violation::blockingCall:
+        return "Blocking call";
+    }
+
+    return {};
+}
+
+/**
+ * Getter method that retrieves the recorded violations, created on first use so the allocator hook can run during static initialisation
+ *
+ * @param                             None
+ *
+ * @return                            Shared state of the checker
+ */
+RealtimeSafetyChecker::State& RealtimeSafetyChecker::getState()
+{
+    static State state;
+    return state;
+}
+
+#if OTODECKS_RT_CHECK
+
+// The global allocation functions are replaced so every allocation in the process, including those made inside JUCE
+// and the standard library, is seen by the checker; outside real-time sections they cost one relaxed load
+static void* allocateChecked(std::size_t size)
+{
+    // Give the new handler a chance to free memory before giving up, as the standard allocation functions do
+    for (;;)
+    {
+        if (void* memory = std::malloc(size > 0 ? size : 1))
+        {
+            return memory;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+
+        if (handler == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        handler();
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    RealtimeSafetyChecker::noteViolation(RealtimeSafetyChecker::Violation::allocation, "operator new");
+    return allocateChecked(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    RealtimeSafetyChecker::noteViolation(RealtimeSafetyChecker::Violation::allocation, "operator new[]");
+    return allocateChecked(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeSafetyChecker::noteViolation(RealtimeSafetyChecker::Violation::allocation, "operator new");
+
+    try
+    {
+        return allocateChecked(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeSafetyChecker::noteViolation(RealtimeSafetyChecker::Violation::allocation, "operator new[]");
+
+    try
+    {
+        return allocateChecked(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+void operator delete(void* memory) noexcept
+{
+    if (memory != nullptr)
+    {
+        RealtimeSafetyChecker::noteViolation(RealtimeSafetyChecker::Violation::deallocation, "operator delete");
+        std::free(memory);
+    }
+}
+
+void operator delete[](void* memory) noexcept
+{
+    if (memory != nullptr)
+    {
+        RealtimeSafetyChecker::noteViolation(RealtimeSafetyChecker::Violation::deallocation, "operator delete[]");
+        std::free(memory);
+    }
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    operator delete[](memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    operator delete[](memory);
+}
+
+#endif
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyChecker.h
+    Created: 17 Oct 2026 1:12:40am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <map>
+
+using namespace juce;
+
+// Checking replaces the global allocation functions and reports every blocking lock acquisition, which costs something on
+// every allocation in the process, so it is only built into debug builds unless the build defines OTODECKS_RT_CHECK itself
+#ifndef OTODECKS_RT_CHECK
+ #if JUCE_DEBUG
+  #define OTODECKS_RT_CHECK 1
+ #else
+  #define OTODECKS_RT_CHECK 0
+ #endif
+#endif
+
+class RealtimeSafetyChecker
+{
+public:
+    /** Kind of call that can stall the thread it is made on */
+    enum class Violation
+    {
+        allocation,
+        deallocation,
+        lockAcquisition,
+        blockingCall
+    };
+
+    /** Marks the calling thread as rendering audio for as long as it exists, so nested sections are counted */
+    class ScopedRealtimeSection
+    {
+    public:
+        /**
+         * Constructor that marks the calling thread as rendering audio
+         *
+         * @param                             None
+         *
+         * @return                            None
+         */
+        ScopedRealtimeSection();
+
+        /**
+         * Destructor that ends the section on the calling thread
+         *
+         * @param                             None
+         *
+         * @return                            None
+         */
+        ~ScopedRealtimeSection();
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+    };
+
+    /** CriticalSection or SpinLock that reports every blocking acquisition made in a real-time section, while try-locks, which never wait, pass unreported */
+    template <typename LockType>
+    class CheckedLock
+    {
+    public:
+        /**
+         * Constructor that names the lock in the report
+         *
+         * @param _name                       Name of the lock, which must outlive it
+         *
+         * @return                            None
+         */
+        explicit CheckedLock(const char* _name) : name(_name)
+        {
+        }
+
+        /**
+         * Acquire the lock, waiting for any other thread to release it
+         *
+         * @param                             None
+         *
+         * @return                            None
+         */
+        void enter() const
+        {
+#if OTODECKS_RT_CHECK
+            RealtimeSafetyChecker::noteViolation(Violation::lockAcquisition, name);
+#endif
+            lock.enter();
+        }
+
+        /**
+         * Acquire the lock only if no other thread holds it
+         *
+         * @param                             None
+         *
+         * @return                            True if the lock was acquired, false otherwise
+         */
+        bool tryEnter() const
+        {
+            return lock.tryEnter();
+        }
+
+        /**
+         * Release the lock
+         *
+         * @param                             None
+         *
+         * @return                            None
+         */
+        void exit() const
+        {
+            lock.exit();
+        }
+
+        typedef GenericScopedLock<CheckedLock> ScopedLockType;
+        typedef GenericScopedTryLock<CheckedLock> ScopedTryLockType;
+
+    private:
+        LockType lock;
+        const char* name;
+
+        JUCE_DECLARE_NON_COPYABLE(CheckedLock)
+    };
+
+    typedef CheckedLock<CriticalSection> CheckedCriticalSection;
+    typedef CheckedLock<SpinLock> CheckedSpinLock;
+
+    /**
+     * Setter method that starts or stops recording violations, leaving the recorded ones in place, which does nothing unless OTODECKS_RT_CHECK is set
+     *
+     * @param shouldCheck                 True to record violations made in real-time sections, false to ignore them
+     *
+     * @return                            None
+     */
+    static void setEnabled(bool shouldCheck);
+
+    /**
+     * Determine whether violations are being recorded
+     *
+     * @param                             None
+     *
+     * @return                            True if violations are recorded, false otherwise
+     */
+    static bool isEnabled();
+
+    /**
+     * Determine whether the calling thread is inside a real-time section
+     *
+     * @param                             None
+     *
+     * @return                            True if the thread is rendering audio, false otherwise
+     */
+    static bool isInRealtimeSection();
+
+    /**
+     * Record a violation with the call stack that made it, if checking is enabled and the calling thread is rendering audio
+     *
+     * @param type                        Kind of call that was made
+     * @param description                 What was called, which must be a string literal or outlive the checker
+     *
+     * @return                            None
+     */
+    static void noteViolation(Violation type, const char* description);
+
+    /**
+     * Record a call that can wait on the disk, another thread or the operating system
+     *
+     * @param description                 What was called, which must be a string literal or outlive the checker
+     *
+     * @return                            None
+     */
+    static void noteBlockingCall(const char* description);
+
+    /**
+     * Getter method that retrieves the number of violations recorded since the last reset
+     *
+     * @param                             None
+     *
+     * @return                            Number of violations, counting repeats from the same call stack
+     */
+    static int getNumViolations();
+
+    /**
+     * Describe every recorded violation, grouped by call stack with the most frequent first
+     *
+     * @param                             None
+     *
+     * @return                            Report listing the kind, count and call stack of each violation
+     */
+    static String getReport();
+
+    /**
+     * Forget every recorded violation
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    static void reset();
+
+private:
+    /**
+     * Getter method that retrieves the display name of a kind of violation
+     *
+     * @param type                        Kind of violation
+     *
+     * @return                            Name of the kind of violation
+     */
+    static String getViolationName(Violation type);
+
+    /** Violations made from one call stack */
+    struct Record
+    {
+        Violation type = Violation::allocation;
+        const char* description = "";
+        String stackTrace;
+        int count = 0;
+    };
+
+    /** Violations recorded so far, keyed by kind, description and call stack and guarded by the lock */
+    struct State
+    {
+        CriticalSection lock;
+        std::map<String, Record> records;
+        int numViolations = 0;
+        int numDropped = 0;
+    };
+
+    /**
+     * Getter method that retrieves the recorded violations, created on first use so the allocator hook can run during static initialisation
+     *
+     * @param                             None
+     *
+     * @return                            Shared state of the checker
+     */
+    static State& getState();
+
+    // Distinct call stacks kept, after which further stacks are only counted
+    static constexpr int maximumRecords = 64;
+
+    RealtimeSafetyChecker() = delete;
+};
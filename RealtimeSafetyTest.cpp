@@ -0,0 +1,357 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyTest.cpp
+    Created: 17 Oct 2026 1:40:05am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyTest.h"
+
+constexpr double RealtimeSafetyTest::sampleRate;
+constexpr int RealtimeSafetyTest::blockSize;
+constexpr double RealtimeSafetyTest::secondsPerTrack;
+
+class RealtimeSafetyTest::AudioThread : public Thread
+{
+public:
+    /**
+     * Constructor for the thread standing in for the audio device
+     *
+     * @param _engine                     Mixer called for every block
+     *
+     * @return                            None
+     */
+    explicit AudioThread(AutoMixEngine& _engine)
+        : Thread("Simulated audio"), engine(_engine), buffer(2, blockSize)
+    {
+    }
+
+    /**
+     * Destructor that waits for the block being rendered to return
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~AudioThread() override
+    {
+        stopThread(4000);
+    }
+
+    /**
+     * Render one block per device period until the thread is asked to exit
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void run() override
+    {
+        const double blockMilliseconds = 1000.0 * blockSize / sampleRate;
+        double nextBlockMilliseconds = Time::getMillisecondCounterHiRes();
+
+        while (!threadShouldExit())
+        {
+            engine.getNextAudioBlock(AudioSourceChannelInfo(buffer));
+
+            // Wait for the next period outside the real-time section, catching up straight away if a block ran late
+            nextBlockMilliseconds += blockMilliseconds;
+            const double remainingMilliseconds = nextBlockMilliseconds - Time::getMillisecondCounterHiRes();
+
+            if (remainingMilliseconds >= 1.0)
+            {
+                wait((int)remainingMilliseconds);
+            }
+        }
+    }
+
+private:
+    AutoMixEngine& engine;
+    AudioBuffer<float> buffer;
+};
+
+/**
+ * Constructor that prepares two decks and the mixer as the audio device would
+ *
+ * @param _onFinished                 Called once every step has run
+ *
+ * @return                            None
+ */
+RealtimeSafetyTest::RealtimeSafetyTest(FinishedCallback _onFinished)
+    : onFinished(std::move(_onFinished)),
+      deckCollection(formatManager, 2),
+      autoMixEngine(deckCollection),
+      nextStep(0),
+      startMilliseconds(0.0),
+      numViolationsLogged(0)
+{
+    formatManager.registerBasicFormats();
+
+    deckCollection.prepareToPlay(blockSize, sampleRate);
+    autoMixEngine.prepareToPlay(blockSize, sampleRate);
+}
+
+/**
+ * Destructor that stops the simulated audio thread and deletes the test tracks
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+RealtimeSafetyTest::~RealtimeSafetyTest()
+{
+    stopTimer();
+    audioThread = nullptr;
+
+    RealtimeSafetyChecker::setEnabled(false);
+
+    autoMixEngine.releaseResources();
+    deckCollection.releaseResources();
+
+    if (trackFolder != File())
+    {
+        trackFolder.deleteRecursively();
+    }
+}
+
+/**
+ * Write the test tracks, start rendering on the simulated audio thread and run the script on the message thread
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void RealtimeSafetyTest::start()
+{
+    if (!writeTestTracks())
+    {
+        onFinished("Real-time safety check: the test tracks could not be written" + String(newLine), false);
+        return;
+    }
+
+    addSteps();
+
+    // Only what happens from here on counts, setting up the decks above is allowed to allocate
+    RealtimeSafetyChecker::reset();
+    RealtimeSafetyChecker::setEnabled(true);
+
+    audioThread.reset(new AudioThread(autoMixEngine));
+    audioThread->startThread(9);
+
+    startMilliseconds = Time::getMillisecondCounterHiRes();
+    startTimer(20);
+}
+
+/**
+ * Write short stereo tracks of a tone over a steady kick, each at a different pitch
+ *
+ * @param                             None
+ *
+ * @return                            True if every track was written, false otherwise
+ */
+bool RealtimeSafetyTest::writeTestTracks()
+{
+    const int numSamples = (int)(secondsPerTrack * sampleRate);
+    const int samplesPerBeat = (int)(sampleRate * 60.0 / 120.0);
+
+    trackFolder = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("OtoDecksRealtimeSafetyTest", "");
+
+    if (trackFolder.createDirectory().failed())
+    {
+        trackFolder = File();
+        return false;
+    }
+
+    AudioBuffer<float> buffer(2, numSamples);
+
+    for (int trackIndex = 0; trackIndex < 3; ++trackIndex)
+    {
+        const double frequency = 220.0 * std::pow(2.0, trackIndex * 4 / 12.0);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double beatTime = (i % samplesPerBeat) / sampleRate;
+
+            const double sample = 0.2 * std::sin(MathConstants<double>::twoPi * frequency * i / sampleRate)
+                + 0.5 * std::exp(-beatTime * 30.0) * std::sin(MathConstants<double>::twoPi * 55.0 * beatTime);
+
+            buffer.setSample(0, i, (float)sample);
+            buffer.setSample(1, i, (float)sample);
+        }
+
+        const File track = trackFolder.getChildFile("track" + String(trackIndex + 1) + ".wav");
+        std::unique_ptr<FileOutputStream> outputStream(track.createOutputStream());
+
+        if (outputStream == nullptr)
+        {
+            return false;
+        }
+
+        WavAudioFormat wavFormat;
+        std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), sampleRate, 2, 16, {}, 0));
+
+        if (writer == nullptr)
+        {
+            return false;
+        }
+
+        // The writer now owns the stream
+        outputStream.release();
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        {
+            return false;
+        }
+
+        tracks.add(track);
+    }
+
+    return true;
+}
+
+/**
+ * Build the script of loads, seeks, parameter changes and transitions the decks go through
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void RealtimeSafetyTest::addSteps()
+{
+    DJAudioPlayer& deckA = deckCollection.getDeck(0);
+    DJAudioPlayer& deckB = deckCollection.getDeck(1);
+    const URL trackA(tracks[0]);
+    const URL trackB(tracks[1]);
+    const URL trackC(tracks[2]);
+
+    steps = {
+        { 0.0, "Load deck A from disk and deck B into memory", [&deckA, &deckB, trackA, trackB]
+            {
+                deckA.loadURL(trackA);
+                deckB.setRamMode(true);
+                deckB.loadURLAsync(trackB);
+            } },
+        { 0.5, "Start deck A", [&deckA] { deckA.start(); } },
+        { 1.0, "Change gain, speed and filters", [&deckA]
+            {
+                deckA.setGain(0.8);
+                deckA.setSpeed(1.05);
+                deckA.setLowPassFrequency(8000.0);
+                deckA.setHighPassFrequency(120.0);
+                deckA.setBandPassFrequency(1000.0);
+            } },
+        { 1.5, "Lock the key and switch to the sinc resampler", [&deckA]
+            {
+                deckA.setKeyLock(true);
+                deckA.setResamplerQuality(Resampler::Quality::sinc);
+                deckA.setTrim(-3.0);
+            } },
+        { 2.0, "Seek forward, back and to the middle", [&deckA]
+            {
+                deckA.movePositionForward();
+                deckA.movePositionBack();
+                deckA.setPositionRelative(0.5);
+            } },
+        { 2.5, "Start a four beat loop and halve it", [&deckA]
+            {
+                deckA.setBeatGrid(120.0, 0.0);
+                deckA.startAutoLoop(4.0);
+                deckA.halveLoop();
+            } },
+        { 3.0, "Exit the loop and queue the next track", [&deckA, trackC]
+            {
+                deckA.exitLoop();
+                deckA.setQueueOverlapSeconds(1.0);
+                deckA.prepareNextTrack(trackC);
+            } },
+        { 3.5, "Seek near the end so the queued track takes over", [&deckA]
+            {
+                deckA.setPosition(deckA.getSongLengthInSeconds() - 1.5);
+            } },
+        { 5.5, "Start deck B and mix over to it", [this, &deckB]
+            {
+                deckB.setKeyLock(true);
+                deckB.setSpeed(0.97);
+                autoMixEngine.setTransitionLength(2.0, false);
+                autoMixEngine.startTransition();
+            } },
+        { 8.0, "Move the crossfader by hand and load deck A while deck B plays", [this, &deckA, trackA]
+            {
+                autoMixEngine.setCrossfaderPosition(0.5);
+                deckA.setRamMode(true);
+                deckA.loadURLAsync(trackA, [&deckA](bool) { deckA.start(); });
+            } },
+        { 9.5, "Stop both decks", [&deckA, &deckB]
+            {
+                deckA.stop();
+                deckB.stop();
+            } },
+        { 10.0, "Finish", nullptr }
+    };
+}
+
+/**
+ * Run the steps that are due and hand queued tracks over as the decks' own interfaces would
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void RealtimeSafetyTest::timerCallback()
+{
+    for (int i = 0; i < deckCollection.getNumDecks(); ++i)
+    {
+        deckCollection.getDeck(i).advanceToNextTrack();
+    }
+
+    const double elapsedSeconds = (Time::getMillisecondCounterHiRes() - startMilliseconds) / 1000.0;
+
+    while (nextStep < steps.size() && steps[nextStep].atSeconds <= elapsedSeconds)
+    {
+        const Step& step = steps[nextStep++];
+
+        // Violations are put down to the step before, since the audio thread only acts on a change after it is made
+        const int numViolations = RealtimeSafetyChecker::getNumViolations();
+
+        if (!stepLog.isEmpty())
+        {
+            stepLog << ", " << (numViolations - numViolationsLogged) << " violations" << newLine;
+        }
+
+        numViolationsLogged = numViolations;
+
+        if (step.action == nullptr)
+        {
+            finish();
+            return;
+        }
+
+        stepLog << String(step.atSeconds, 1).paddedLeft(' ', 5) << " s  " << step.description;
+        step.action();
+    }
+}
+
+/**
+ * Stop rendering and report the violations recorded while the script ran
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void RealtimeSafetyTest::finish()
+{
+    stopTimer();
+    audioThread = nullptr;
+
+    RealtimeSafetyChecker::setEnabled(false);
+
+    String report;
+    report << "Real-time safety check: two decks, " << blockSize << " sample blocks at " << sampleRate << " Hz" << newLine
+        << stepLog << newLine
+        << RealtimeSafetyChecker::getReport();
+
+    onFinished(report, RealtimeSafetyChecker::getNumViolations() == 0);
+}
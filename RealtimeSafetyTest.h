@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyTest.h
+    Created: 17 Oct 2026 1:40:05am
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AutoMixEngine.h"
+#include "DeckCollection.h"
+#include "RealtimeSafetyChecker.h"
+
+using namespace juce;
+
+class RealtimeSafetyTest : private Timer
+{
+public:
+    /** Called on the message thread once the script has run, with the report and whether the callback stayed clean */
+    typedef std::function<void(const String& report, bool passed)> FinishedCallback;
+
+    /**
+     * Constructor that prepares two decks and the mixer as the audio device would
+     *
+     * @param _onFinished                 Called once every step has run
+     *
+     * @return                            None
+     */
+    explicit RealtimeSafetyTest(FinishedCallback _onFinished);
+
+    /**
+     * Destructor that stops the simulated audio thread and deletes the test tracks
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~RealtimeSafetyTest() override;
+
+    /**
+     * Write the test tracks, start rendering on the simulated audio thread and run the script on the message thread
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void start();
+
+private:
+    class AudioThread;
+
+    /** Action taken on the message thread once the script has been running for a given time */
+    struct Step
+    {
+        double atSeconds;
+        String description;
+        std::function<void()> action;
+    };
+
+    /**
+     * Write short stereo tracks of a tone over a steady kick, each at a different pitch
+     *
+     * @param                             None
+     *
+     * @return                            True if every track was written, false otherwise
+     */
+    bool writeTestTracks();
+
+    /**
+     * Build the script of loads, seeks, parameter changes and transitions the decks go through
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void addSteps();
+
+    /**
+     * Run the steps that are due and hand queued tracks over as the decks' own interfaces would
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void timerCallback() override;
+
+    /**
+     * Stop rendering and report the violations recorded while the script ran
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void finish();
+
+    FinishedCallback onFinished;
+
+    AudioFormatManager formatManager;
+    DeckCollection deckCollection;
+    AutoMixEngine autoMixEngine;
+
+    // Calls the mixer at the pace of an audio device
+    std::unique_ptr<AudioThread> audioThread;
+
+    // Tracks loaded by the script, written to a folder that is deleted afterwards
+    File trackFolder;
+    Array<File> tracks;
+
+    std::vector<Step> steps;
+    size_t nextStep;
+    double startMilliseconds;
+
+    // Steps in the order they ran, with the violations each one let through
+    String stepLog;
+    int numViolationsLogged;
+
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int blockSize = 512;
+    static constexpr double secondsPerTrack = 8.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeSafetyTest)
+};
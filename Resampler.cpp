@@ -0,0 +1,328 @@
+/*
+  ==============================================================================
+
+    Resampler.cpp
+    Created: 16 Oct 2026 4:05:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "Resampler.h"
+
+constexpr int Resampler::numSincTaps;
+constexpr int Resampler::numHistorySamples;
+constexpr int Resampler::numLookaheadSamples;
+constexpr int Resampler::SincTable::numPhases;
+constexpr int Resampler::SincTable::numBands;
+
+/**
+ * Evaluate the zeroth order modified Bessel function of the first kind used by the Kaiser window
+ *
+ * @param x                           Argument
+ *
+ * @return                            Function value
+ */
+static double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+
+    // The power series converges quickly for the window's range of arguments
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x * 0.5 / k) * (x * 0.5 / k);
+        sum += term;
+    }
+
+    return sum;
+}
+
+/**
+ * Constructor that designs every kernel phase for every ratio band
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+Resampler::SincTable::SincTable()
+{
+    // Kaiser shape parameter giving around 60 dB of stop band rejection
+    const double beta = 6.0;
+    const double halfWidth = numSincTaps / 2;
+    const int numKernelsPerBand = numPhases + 1;
+
+    kernels.resize((size_t)(numBands * numKernelsPerBand * numSincTaps));
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        // Each band covers half as much again as the previous one, and the last covers every faster ratio
+        bandRatios[band] = std::pow(1.5, band);
+
+        // Keep the transition band just below the Nyquist frequency of the slower of the input and the output
+        const double cutoff = 0.46 / bandRatios[band];
+
+        for (int phase = 0; phase < numKernelsPerBand; ++phase)
+        {
+            const double fraction = (double)phase / numPhases;
+            float* kernel = kernels.data() + (size_t)((band * numKernelsPerBand + phase) * numSincTaps);
+            double sum = 0.0;
+
+            for (int tap = 0; tap < numSincTaps; ++tap)
+            {
+                // Distance from the read position to the input sample under this tap
+                const double distance = (tap - numHistorySamples) - fraction;
+                const double sincArgument = 2.0 * cutoff * distance;
+                const double sinc = std::abs(sincArgument) < 1.0e-9 ? 1.0 : std::sin(MathConstants<double>::pi * sincArgument) / (MathConstants<double>::pi * sincArgument);
+
+                const double windowPosition = jlimit(-1.0, 1.0, distance / halfWidth);
+                const double window = besselI0(beta * std::sqrt(1.0 - windowPosition * windowPosition)) / besselI0(beta);
+
+                const double coefficient = 2.0 * cutoff * sinc * window;
+                kernel[tap] = (float)coefficient;
+                sum += coefficient;
+            }
+
+            // Pass DC at unity gain for every phase so that the kernels do not add ripple
+            for (int tap = 0; tap < numSincTaps; ++tap)
+            {
+                kernel[tap] = (float)(kernel[tap] / sum);
+            }
+        }
+    }
+}
+
+/**
+ * Getter method that retrieves the band whose cut-off suits a ratio
+ *
+ * @param ratio                       Input samples advanced per output sample
+ *
+ * @return                            Index of the band to use
+ */
+int Resampler::SincTable::getBandForRatio(double ratio) const
+{
+    for (int band = 0; band < numBands - 1; ++band)
+    {
+        if (ratio <= bandRatios[band])
+        {
+            return band;
+        }
+    }
+
+    return numBands - 1;
+}
+
+/**
+ * Getter method that retrieves the kernel for a band and phase
+ *
+ * @param band                        Ratio band
+ * @param phase                       Phase index from zero to numPhases inclusive
+ *
+ * @return                            Pointer to numSincTaps coefficients
+ */
+const float* Resampler::SincTable::getKernel(int band, int phase) const
+{
+    return kernels.data() + (size_t)((band * (numPhases + 1) + phase) * numSincTaps);
+}
+
+/**
+ * Constructor that initializes a resampler with third order Lagrange interpolation
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+Resampler::Resampler() : quality(Quality::lagrange)
+{
+}
+
+/**
+ * Destructor for the resampler
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+Resampler::~Resampler()
+{
+}
+
+/**
+ * Setter method that sets the interpolator used by the next call to process()
+ *
+ * @param newQuality                  Interpolator to use
+ *
+ * @return                            None
+ */
+void Resampler::setQuality(Quality newQuality)
+{
+    quality = newQuality;
+}
+
+/**
+ * Getter method that retrieves the interpolator in use
+ *
+ * @param                             None
+ *
+ * @return                            Interpolator in use
+ */
+Resampler::Quality Resampler::getQuality() const
+{
+    return quality;
+}
+
+/**
+ * Interpolate a run of output samples from one channel of input
+ *
+ * @param input                       Input samples, readable from numHistorySamples before to numLookaheadSamples after every read position
+ * @param startPosition               Fractional input position of the first output sample
+ * @param ratio                       Input samples advanced per output sample
+ * @param output                      Destination for the interpolated samples
+ * @param numSamples                  Number of samples to produce
+ *
+ * @return                            None
+ */
+void Resampler::process(const float* input, double startPosition, double ratio, float* output, int numSamples) const
+{
+    switch (quality.load())
+    {
+    case Quality::linear:
+        processLinear(input, startPosition, ratio, output, numSamples);
+        break;
+    case Quality::sinc:
+        processSinc(input, startPosition, ratio, output, numSamples);
+        break;
+    case Quality::lagrange:
+    default:
+        processLagrange(input, startPosition, ratio, output, numSamples);
+        break;
+    }
+}
+
+/**
+ * Getter method that retrieves the display name of an interpolator
+ *
+ * @param quality                     Interpolator to name
+ *
+ * @return                            Name shown in menus and benchmark reports
+ */
+String Resampler::getQualityName(Quality quality)
+{
+    switch (quality)
+    {
+    case Quality::linear:
+        return "Linear";
+    case Quality::sinc:
+        return "Sinc";
+    case Quality::lagrange:
+    default:
+        return "Lagrange";
+    }
+}
+
+/**
+ * Interpolate between neighbouring samples on a straight line
+ *
+ * @param input                       Input samples
+ * @param startPosition               Fractional input position of the first output sample
+ * @param ratio                       Input samples advanced per output sample
+ * @param output                      Destination for the interpolated samples
+ * @param numSamples                  Number of samples to produce
+ *
+ * @return                            None
+ */
+void Resampler::processLinear(const float* input, double startPosition, double ratio, float* output, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double position = startPosition + i * ratio;
+        const int index = (int)position;
+        const float fraction = (float)(position - index);
+
+        output[i] = input[index] + (input[index + 1] - input[index]) * fraction;
+    }
+}
+
+/**
+ * Interpolate between four neighbouring samples with a third order Lagrange polynomial
+ *
+ * @param input                       Input samples
+ * @param startPosition               Fractional input position of the first output sample
+ * @param ratio                       Input samples advanced per output sample
+ * @param output                      Destination for the interpolated samples
+ * @param numSamples                  Number of samples to produce
+ *
+ * @return                            None
+ */
+void Resampler::processLagrange(const float* input, double startPosition, double ratio, float* output, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double position = startPosition + i * ratio;
+        const int index = (int)position;
+        const float fraction = (float)(position - index);
+
+        const float previous = input[index - 1];
+        const float current = input[index];
+        const float next = input[index + 1];
+        const float afterNext = input[index + 2];
+
+        const float c1 = next - previous * (1.0f / 3.0f) - current * 0.5f - afterNext * (1.0f / 6.0f);
+        const float c2 = 0.5f * (previous + next) - current;
+        const float c3 = (1.0f / 6.0f) * (afterNext - previous) + 0.5f * (current - next);
+
+        output[i] = ((c3 * fraction + c2) * fraction + c1) * fraction + current;
+    }
+}
+
+/**
+ * Convolve the input with the windowed-sinc kernel for each fractional position
+ *
+ * @param input                       Input samples
+ * @param startPosition               Fractional input position of the first output sample
+ * @param ratio                       Input samples advanced per output sample
+ * @param output                      Destination for the interpolated samples
+ * @param numSamples                  Number of samples to produce
+ *
+ * @return                            None
+ */
+void Resampler::processSinc(const float* input, double startPosition, double ratio, float* output, int numSamples) const
+{
+    const SincTable& table = *sincTable;
+    const int band = table.getBandForRatio(ratio);
+
+    float kernel[numSincTaps];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double position = startPosition + i * ratio;
+        const int index = (int)position;
+
+        // Blend the two stored phases either side of the fractional position
+        const float phasePosition = (float)(position - index) * SincTable::numPhases;
+        const int phase = jmin((int)phasePosition, SincTable::numPhases - 1);
+        const float phaseFraction = phasePosition - (float)phase;
+
+        const float* lower = table.getKernel(band, phase);
+        const float* upper = lower + numSincTaps;
+        const float* samples = input + index - numHistorySamples;
+
+        // Fixed length loops with independent accumulators so the compiler can keep them in SIMD registers
+        for (int tap = 0; tap < numSincTaps; ++tap)
+        {
+            kernel[tap] = lower[tap] + (upper[tap] - lower[tap]) * phaseFraction;
+        }
+
+        float sums[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        for (int tap = 0; tap < numSincTaps; tap += 4)
+        {
+            sums[0] += kernel[tap] * samples[tap];
+            sums[1] += kernel[tap + 1] * samples[tap + 1];
+            sums[2] += kernel[tap + 2] * samples[tap + 2];
+            sums[3] += kernel[tap + 3] * samples[tap + 3];
+        }
+
+        output[i] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+}
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    Resampler.h
+    Created: 16 Oct 2026 4:05:52pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class Resampler
+{
+public:
+    /** Interpolators that trade CPU cost against aliasing and high frequency loss */
+    enum class Quality
+    {
+        linear = 0,
+        lagrange,
+        sinc
+    };
+
+    /**
+     * Constructor that initializes a resampler with third order Lagrange interpolation
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    Resampler();
+
+    /**
+     * Destructor for the resampler
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~Resampler();
+
+    /**
+     * Setter method that sets the interpolator used by the next call to process()
+     *
+     * @param newQuality                  Interpolator to use
+     *
+     * @return                            None
+     */
+    void setQuality(Quality newQuality);
+
+    /**
+     * Getter method that retrieves the interpolator in use
+     *
+     * @param                             None
+     *
+     * @return                            Interpolator in use
+     */
+    Quality getQuality() const;
+
+    /**
+     * Interpolate a run of output samples from one channel of input
+     *
+     * @param input                       Input samples, readable from numHistorySamples before to numLookaheadSamples after every read position
+     * @param startPosition               Fractional input position of the first output sample
+     * @param ratio                       Input samples advanced per output sample
+     * @param output                      Destination for the interpolated samples
+     * @param numSamples                  Number of samples to produce
+     *
+     * @return                            None
+     */
+    void process(const float* input, double startPosition, double ratio, float* output, int numSamples) const;
+
+    /**
+     * Getter method that retrieves the display name of an interpolator
+     *
+     * @param quality                     Interpolator to name
+     *
+     * @return                            Name shown in menus and benchmark reports
+     */
+    static String getQualityName(Quality quality);
+
+    // Taps in each polyphase windowed-sinc kernel
+    static constexpr int numSincTaps = 32;
+
+    // Input samples read before and after the integer part of a read position by the widest interpolator
+    static constexpr int numHistorySamples = numSincTaps / 2 - 1;
+    static constexpr int numLookaheadSamples = numSincTaps / 2;
+
+    /** Kaiser windowed-sinc kernels for a range of ratios, shared by every resampler */
+    struct SincTable
+    {
+        /**
+         * Constructor that designs every kernel phase for every ratio band
+         *
+         * @param                         None
+         *
+         * @return                        None
+         */
+        SincTable();
+
+        /**
+         * Getter method that retrieves the band whose cut-off suits a ratio
+         *
+         * @param ratio                   Input samples advanced per output sample
+         *
+         * @return                        Index of the band to use
+         */
+        int getBandForRatio(double ratio) const;
+
+        /**
+         * Getter method that retrieves the kernel for a band and phase
+         *
+         * @param band                    Ratio band
+         * @param phase                   Phase index from zero to numPhases inclusive
+         *
+         * @return                        Pointer to numSincTaps coefficients
+         */
+        const float* getKernel(int band, int phase) const;
+
+        // Fractional positions are split into this many phases and interpolated between neighbouring kernels
+        static constexpr int numPhases = 256;
+        static constexpr int numBands = 6;
+
+        // Highest ratio covered by each band, beyond which the cut-off is lowered to keep aliasing out
+        double bandRatios[numBands];
+
+        std::vector<float> kernels;
+    };
+
+private:
+    /**
+     * Interpolate between neighbouring samples on a straight line
+     *
+     * @param input                       Input samples
+     * @param startPosition               Fractional input position of the first output sample
+     * @param ratio                       Input samples advanced per output sample
+     * @param output                      Destination for the interpolated samples
+     * @param numSamples                  Number of samples to produce
+     *
+     * @return                            None
+     */
+    static void processLinear(const float* input, double startPosition, double ratio, float* output, int numSamples);
+
+    /**
+     * Interpolate between four neighbouring samples with a third order Lagrange polynomial
+     *
+     * @param input                       Input samples
+     * @param startPosition               Fractional input position of the first output sample
+     * @param ratio                       Input samples advanced per output sample
+     * @param output                      Destination for the interpolated samples
+     * @param numSamples                  Number of samples to produce
+     *
+     * @return                            None
+     */
+    static void processLagrange(const float* input, double startPosition, double ratio, float* output, int numSamples);
+
+    /**
+     * Convolve the input with the windowed-sinc kernel for each fractional position
+     *
+     * @param input                       Input samples
+     * @param startPosition               Fractional input position of the first output sample
+     * @param ratio                       Input samples advanced per output sample
+     * @param output                      Destination for the interpolated samples
+     * @param numSamples                  Number of samples to produce
+     *
+     * @return                            None
+     */
+    void processSinc(const float* input, double startPosition, double ratio, float* output, int numSamples) const;
+
+    std::atomic<Quality> quality;
+
+    // Designed once on the message thread and shared by every deck
+    SharedResourcePointer<SincTable> sincTable;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Resampler)
+};
@@ -0,0 +1,425 @@
+/*
+  ==============================================================================
+
+    TimeStretcher.cpp
+    Created: 16 Oct 2026 2:41:08pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#include "TimeStretcher.h"
+
+constexpr double TimeStretcher::minimumTempo;
+constexpr double TimeStretcher::maximumTempo;
+
+/**
+ * Constructor that initializes an unprepared stretcher at the original tempo
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+TimeStretcher::TimeStretcher()
+    : frameSize(0),
+    synthesisHop(0),
+    searchRadius(0),
+    tempo(1.0),
+    inputBufferStart(0),
+    numInputSamples(0),
+    nominalPosition(0.0),
+    framePosition(0),
+    hasPreviousFrame(false),
+    outputReadPosition(0)
+{
+}
+
+/**
+ * Destructor for the time stretcher
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+TimeStretcher::~TimeStretcher()
+{
+}
+
+/**
+ * Choose the frame size for a sample rate and allocate every working buffer, then reset the stretcher
+ *
+ * @param sampleRate                  Sample rate of the audio track being stretched
+ *
+ * @return                            None
+ */
+void TimeStretcher::prepare(double sampleRate)
+{
+    // Frames of around 20 ms are long enough to hold a bass period and short enough to keep transients tight
+    const int newFrameSize = jlimit(256, 4096, nextPowerOfTwo(roundToInt(sampleRate * 0.02)));
+
+    if (newFrameSize != frameSize || fft == nullptr)
+    {
+        frameSize = newFrameSize;
+        synthesisHop = frameSize / 2;
+        searchRadius = frameSize / 4;
+
+        // Every candidate frame in the search range fits in one transform without wrapping around
+        const int searchLength = frameSize + 2 * searchRadius;
+        fft = std::make_unique<dsp::FFT>(roundToInt(std::log2((double)nextPowerOfTwo(searchLength))));
+
+        templateSpectrum.allocate((size_t)fft->getSize() * 2, true);
+        searchSpectrum.allocate((size_t)fft->getSize() * 2, true);
+        searchEnergy.allocate((size_t)(2 * searchRadius + 1), true);
+
+        window.allocate((size_t)frameSize, true);
+
+        for (int i = 0; i < frameSize; ++i)
+        {
+            window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float)i / (float)frameSize);
+        }
+
+        // Room for the search range, the previous frame's continuation and the largest analysis hop
+        const int maximumHop = (int)std::ceil(maximumTempo * synthesisHop);
+        inputBuffer.setSize(2, 2 * frameSize + 2 * searchRadius + synthesisHop + maximumHop);
+        overlapBuffer.setSize(2, frameSize);
+    }
+
+    reset();
+}
+
+/**
+ * Discard buffered input and output so that the next block starts from the current source position
+ *
+ * @param                             None
+ *
+ * @return                            None
+ */
+void TimeStretcher::reset()
+{
+    inputBufferStart = 0;
+    numInputSamples = 0;
+    nominalPosition = 0.0;
+    framePosition = 0;
+    hasPreviousFrame = false;
+
+    // The first frame fades in from silence, and nothing is ready to output until it has been added
+    overlapBuffer.clear();
+    outputReadPosition = synthesisHop;
+}
+
+/**
+ * Setter method that sets the tempo, which takes effect from the next frame
+ *
+ * @param ratio                       Input samples consumed per output sample, where 1.0 is the original tempo
+ *
+ * @return                            None
+ */
+void TimeStretcher::setTempo(double ratio)
+{
+    tempo = jlimit(minimumTempo, maximumTempo, ratio);
+}
+
+/**
+ * Produce stretched audio, reading as much input from the source as the tempo requires
+ *
+ * @param source                      Source to read from, which must not be repositioned without calling reset()
+ * @param destination                 Buffer that receives the stretched audio in its first two channels
+ * @param startSample                 First sample of the destination to write
+ * @param numSamples                  Number of samples to produce
+ *
+ * @return                            None
+ */
+void TimeStretcher::process(PositionableAudioSource& source, AudioBuffer<float>& destination, int startSample, int numSamples)
+{
+    jassert(fft != nullptr);
+
+    int numProduced = 0;
+
+    while (numProduced < numSamples)
+    {
+        if (outputReadPosition >= synthesisHop)
+        {
+            renderNextFrame(source);
+        }
+
+        // Copy out the part of the overlap buffer that no later frame will add to
+        const int numToCopy = jmin(numSamples - numProduced, synthesisHop - outputReadPosition);
+
+        for (int channel = 0; channel < jmin(2, destination.getNumChannels()); ++channel)
+        {
+            destination.copyFrom(channel, startSample + numProduced, overlapBuffer, channel, outputReadPosition, numToCopy);
+        }
+
+        outputReadPosition += numToCopy;
+        numProduced += numToCopy;
+    }
+}
+
+/**
+ * Getter method that retrieves how far the source has been read beyond the input heard at the next output sample
+ *
+ * @param                             None
+ *
+ * @return                            Number of input samples read ahead of the playhead
+ */
+int TimeStretcher::getNumBufferedInputSamples() const
+{
+    if (!hasPreviousFrame)
+    {
+        return numInputSamples;
+    }
+
+    // Within a frame the input plays back at its original rate from the start of the frame
+    return (int)jmax((int64)0, inputBufferStart + numInputSamples - (framePosition + outputReadPosition));
+}
+
+/**
+ * Getter method that retrieves the number of samples in each windowed frame
+ *
+ * @param                             None
+ *
+ * @return                            Frame size in samples
+ */
+int TimeStretcher::getFrameSize() const
+{
+    return frameSize;
+}
+
+/**
+ * Getter method that retrieves the number of output samples produced by each frame
+ *
+ * @param                             None
+ *
+ * @return                            Synthesis hop in samples
+ */
+int TimeStretcher::getSynthesisHop() const
+{
+    return synthesisHop;
+}
+
+/**
+ * Getter method that retrieves the number of points in each cross-correlation FFT
+ *
+ * @param                             None
+ *
+ * @return                            FFT size
+ */
+int TimeStretcher::getFftSize() const
+{
+    return fft != nullptr ? fft->getSize() : 0;
+}
+
+/**
+ * Window the next frame of input into the overlap buffer, aligned with the previous frame
+ *
+ * @param source                      Source to read more input from
+ *
+ * @return                            None
+ */
+void TimeStretcher::renderNextFrame(PositionableAudioSource& source)
+{
+    // Shift out the samples that have already been output and open up a silent tail for the new frame
+    const int numOverlapping = frameSize - synthesisHop;
+
+    for (int channel = 0; channel < overlapBuffer.getNumChannels(); ++channel)
+    {
+        float* samples = overlapBuffer.getWritePointer(channel);
+        std::memmove(samples, samples + synthesisHop, sizeof(float) * (size_t)numOverlapping);
+        FloatVectorOperations::clear(samples + numOverlapping, synthesisHop);
+    }
+
+    const int64 nominalStart = (int64)(nominalPosition + 0.5);
+    int64 frameStart = nominalStart;
+
+    if (hasPreviousFrame)
+    {
+        // Search around the nominal start for the frame that best continues the previous one
+        const int64 searchStart = jmax(inputBufferStart, nominalStart - searchRadius);
+        const int64 templateStart = framePosition + synthesisHop;
+
+        readInputUpTo(source, jmax(searchStart + frameSize + 2 * searchRadius, templateStart + frameSize));
+        frameStart = findBestFramePosition(searchStart, templateStart);
+    }
+    else
+    {
+        readInputUpTo(source, frameStart + frameSize);
+    }
+
+    // Overlap-add the windowed frame onto the tail of the previous one
+    const int offset = (int)(frameStart - inputBufferStart);
+
+    for (int channel = 0; channel < overlapBuffer.getNumChannels(); ++channel)
+    {
+        FloatVectorOperations::addWithMultiply(overlapBuffer.getWritePointer(channel), inputBuffer.getReadPointer(channel, offset), window, frameSize);
+    }
+
+    framePosition = frameStart;
+    hasPreviousFrame = true;
+    outputReadPosition = 0;
+
+    // The analysis hop is the synthesis hop scaled by the tempo
+    nominalPosition += tempo * synthesisHop;
+
+    // Keep only the input that the next template and search range can reach
+    const int64 nextNominalStart = (int64)(nominalPosition + 0.5);
+    discardInputBefore(source, jmin(framePosition + synthesisHop, nextNominalStart - searchRadius));
+}
+
+/**
+ * Find the start of the input frame within the search range that best continues the previous frame
+ *
+ * @param searchStart                 Absolute input position of the first candidate
+ * @param templateStart               Absolute input position that naturally follows the previous frame
+ *
+ * @return                            Absolute input position of the best candidate
+ */
+int64 TimeStretcher::findBestFramePosition(int64 searchStart, int64 templateStart)
+{
+    const int fftSize = fft->getSize();
+    const int numCandidates = 2 * searchRadius + 1;
+
+    // Zero padded mono copies of the template and the search range
+    FloatVectorOperations::clear(templateSpectrum, fftSize * 2);
+    FloatVectorOperations::clear(searchSpectrum, fftSize * 2);
+    mixDownInput(templateSpectrum, templateStart, frameSize);
+    mixDownInput(searchSpectrum, searchStart, frameSize + numCandidates - 1);
+
+    // Energy under each candidate frame, so that loud passages are not favoured over well aligned ones
+    double energy = 0.0;
+
+    for (int i = 0; i < frameSize; ++i)
+    {
+        energy += (double)searchSpectrum[i] * searchSpectrum[i];
+    }
+
+    searchEnergy[0] = energy;
+
+    for (int candidate = 1; candidate < numCandidates; ++candidate)
+    {
+        const double entering = searchSpectrum[candidate + frameSize - 1];
+        const double leaving = searchSpectrum[candidate - 1];
+        energy += entering * entering - leaving * leaving;
+        searchEnergy[candidate] = jmax(0.0, energy);
+    }
+
+    fft->performRealOnlyForwardTransform(templateSpectrum);
+    fft->performRealOnlyForwardTransform(searchSpectrum);
+
+    // Multiply the search spectrum by the conjugate of the template spectrum to correlate them
+    for (int bin = 0; bin < fftSize; ++bin)
+    {
+        const float searchReal = searchSpectrum[bin * 2];
+        const float searchImag = searchSpectrum[bin * 2 + 1];
+        const float templateReal = templateSpectrum[bin * 2];
+        const float templateImag = templateSpectrum[bin * 2 + 1];
+
+        searchSpectrum[bin * 2] = searchReal * templateReal + searchImag * templateImag;
+        searchSpectrum[bin * 2 + 1] = searchImag * templateReal - searchReal * templateImag;
+    }
+
+    fft->performRealOnlyInverseTransform(searchSpectrum);
+
+    // Pick the candidate with the highest normalized correlation
+    int bestCandidate = 0;
+    double bestScore = -std::numeric_limits<double>::max();
+
+    for (int candidate = 0; candidate < numCandidates; ++candidate)
+    {
+        const double score = searchSpectrum[candidate] / std::sqrt(searchEnergy[candidate] + 1.0e-9);
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestCandidate = candidate;
+        }
+    }
+
+    return searchStart + bestCandidate;
+}
+
+/**
+ * Read from the source until the input buffer reaches an absolute input position
+ *
+ * @param source                      Source to read from
+ * @param endPosition                 Absolute input position that must be buffered
+ *
+ * @return                            None
+ */
+void TimeStretcher::readInputUpTo(PositionableAudioSource& source, int64 endPosition)
+{
+    const int numRequired = (int)(endPosition - inputBufferStart) - numInputSamples;
+
+    if (numRequired <= 0)
+    {
+        return;
+    }
+
+    // The buffer is sized in prepare() for the largest analysis hop, so this never runs out of room
+    jassert(numInputSamples + numRequired <= inputBuffer.getNumSamples());
+    const int numToRead = jmin(numRequired, inputBuffer.getNumSamples() - numInputSamples);
+
+    source.getNextAudioBlock(AudioSourceChannelInfo(&inputBuffer, numInputSamples, numToRead));
+    numInputSamples += numToRead;
+}
+
+/**
+ * Drop input before an absolute input position, reading and discarding any of it that has not been buffered yet
+ *
+ * @param source                      Source to read from
+ * @param position                    First absolute input position to keep
+ *
+ * @return                            None
+ */
+void TimeStretcher::discardInputBefore(PositionableAudioSource& source, int64 position)
+{
+    const int64 numToDrop = position - inputBufferStart;
+
+    if (numToDrop <= 0)
+    {
+        return;
+    }
+
+    if (numToDrop < numInputSamples)
+    {
+        const int numToKeep = numInputSamples - (int)numToDrop;
+
+        for (int channel = 0; channel < inputBuffer.getNumChannels(); ++channel)
+        {
+            float* samples = inputBuffer.getWritePointer(channel);
+            std::memmove(samples, samples + numToDrop, sizeof(float) * (size_t)numToKeep);
+        }
+
+        numInputSamples = numToKeep;
+    }
+    else
+    {
+        // At fast tempos the next frame can start beyond the buffered input, so read and discard the skipped input
+        int64 numToSkip = numToDrop - numInputSamples;
+
+        while (numToSkip > 0)
+        {
+            const int numToRead = (int)jmin((int64)inputBuffer.getNumSamples(), numToSkip);
+            source.getNextAudioBlock(AudioSourceChannelInfo(&inputBuffer, 0, numToRead));
+            numToSkip -= numToRead;
+        }
+
+        numInputSamples = 0;
+    }
+
+    inputBufferStart = position;
+}
+
+/**
+ * Fill a mono working array with the sum of both channels of buffered input
+ *
+ * @param destination                 Array to fill
+ * @param position                    Absolute input position of the first sample
+ * @param numSamples                  Number of samples to mix down
+ *
+ * @return                            None
+ */
+void TimeStretcher::mixDownInput(float* destination, int64 position, int numSamples) const
+{
+    const int offset = (int)(position - inputBufferStart);
+    FloatVectorOperations::add(destination, inputBuffer.getReadPointer(0, offset), inputBuffer.getReadPointer(1, offset), numSamples);
+}
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    TimeStretcher.h
+    Created: 16 Oct 2026 2:41:08pm
+    Author:  Jonathan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+using namespace juce;
+
+class TimeStretcher
+{
+public:
+    /**
+     * Constructor that initializes an unprepared stretcher at the original tempo
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    TimeStretcher();
+
+    /**
+     * Destructor for the time stretcher
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    ~TimeStretcher();
+
+    /**
+     * Choose the frame size for a sample rate and allocate every working buffer, then reset the stretcher
+     *
+     * @param sampleRate                  Sample rate of the audio track being stretched
+     *
+     * @return                            None
+     */
+    void prepare(double sampleRate);
+
+    /**
+     * Discard buffered input and output so that the next block starts from the current source position
+     *
+     * @param                             None
+     *
+     * @return                            None
+     */
+    void reset();
+
+    /**
+     * Setter method that sets the tempo, which takes effect from the next frame
+     *
+     * @param ratio                       Input samples consumed per output sample, where 1.0 is the original tempo
+     *
+     * @return                            None
+     */
+    void setTempo(double ratio);
+
+    /**
+     * Produce stretched audio, reading as much input from the source as the tempo requires
+     *
+     * @param source                      Source to read from, which must not be repositioned without calling reset()
+     * @param destination                 Buffer that receives the stretched audio in its first two channels
+     * @param startSample                 First sample of the destination to write
+     * @param numSamples                  Number of samples to produce
+     *
+     * @return                            None
+     */
+    void process(PositionableAudioSource& source, AudioBuffer<float>& destination, int startSample, int numSamples);
+
+    /**
+     * Getter method that retrieves how far the source has been read beyond the input heard at the next output sample
+     *
+     * @param                             None
+     *
+     * @return                            Number of input samples read ahead of the playhead
+     */
+    int getNumBufferedInputSamples() const;
+
+    /**
+     * Getter method that retrieves the number of samples in each windowed frame
+     *
+     * @param                             None
+     *
+     * @return                            Frame size in samples
+     */
+    int getFrameSize() const;
+
+    /**
+     * Getter method that retrieves the number of output samples produced by each frame
+     *
+     * @param                             None
+     *
+     * @return                            Synthesis hop in samples
+     */
+    int getSynthesisHop() const;
+
+    /**
+     * Getter method that retrieves the number of points in each cross-correlation FFT
+     *
+     * @param                             None
+     *
+     * @return                            FFT size
+     */
+    int getFftSize() const;
+
+    // Tempo range supported without growing the input buffer
+    static constexpr double minimumTempo = 0.05;
+    static constexpr double maximumTempo = 8.0;
+
+private:
+    /**
+     * Window the next frame of input into the overlap buffer, aligned with the previous frame
+     *
+     * @param source                      Source to read more input from
+     *
+     * @return                            None
+     */
+    void renderNextFrame(PositionableAudioSource& source);
+
+    /**
+     * Find the start of the input frame within the search range that best continues the previous frame
+     *
+     * @param searchStart                 Absolute input position of the first candidate
+     * @param templateStart               Absolute input position that naturally follows the previous frame
+     *
+     * @return                            Absolute input position of the best candidate
+     */
+    int64 findBestFramePosition(int64 searchStart, int64 templateStart);
+
+    /**
+     * Read from the source until the input buffer reaches an absolute input position
+     *
+     * @param source                      Source to read from
+     * @param endPosition                 Absolute input position that must be buffered
+     *
+     * @return                            None
+     */
+    void readInputUpTo(PositionableAudioSource& source, int64 endPosition);
+
+    /**
+     * Drop input before an absolute input position, reading and discarding any of it that has not been buffered yet
+     *
+     * @param source                      Source to read from
+     * @param position                    First absolute input position to keep
+     *
+     * @return                            None
+     */
+    void discardInputBefore(PositionableAudioSource& source, int64 position);
+
+    /**
+     * Fill a mono working array with the sum of both channels of buffered input
+     *
+     * @param destination                 Array to fill
+     * @param position                    Absolute input position of the first sample
+     * @param numSamples                  Number of samples to mix down
+     *
+     * @return                            None
+     */
+    void mixDownInput(float* destination, int64 position, int numSamples) const;
+
+    int frameSize;
+    int synthesisHop;
+    int searchRadius;
+
+    double tempo;
+
+    // Buffered input, where inputBufferStart is the absolute input position of the first sample
+    AudioBuffer<float> inputBuffer;
+    int64 inputBufferStart;
+    int numInputSamples;
+
+    // Absolute input position where the next frame would start without alignment
+    double nominalPosition;
+
+    // Absolute input position of the frame currently being output
+    int64 framePosition;
+    bool hasPreviousFrame;
+
+    // Overlapping windowed frames, where the first synthesisHop samples are complete once a frame is added
+    AudioBuffer<float> overlapBuffer;
+    int outputReadPosition;
+
+    // Periodic Hann window that sums to one at an overlap of one half
+    HeapBlock<float> window;
+
+    // Cross-correlation working arrays, each twice the FFT size for the interleaved complex spectrum
+    std::unique_ptr<dsp::FFT> fft;
+    HeapBlock<float> templateSpectrum;
+    HeapBlock<float> searchSpectrum;
+    HeapBlock<double> searchEnergy;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretcher)
+};
@@ -194,7 +194,16 @@ void WaveformDisplay::resized()
 void WaveformDisplay::loadURL(URL audioURL)
 {
     audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
+
+    // Draw from the decoded copy of the track if the library cache has one
+    if (audioURL.isLocalFile() && pcmDiskCache->isCached(audioURL.getLocalFile()))
+    {
+        fileLoaded = audioThumb.setSource(new FileInputSource(pcmDiskCache->getCachedFile(audioURL.getLocalFile())));
+    }
+    else
+    {
+        fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
+    }
     if (fileLoaded)
     {
         repaint();
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "PcmDiskCache.h"
 
 using namespace juce;
 
@@ -169,6 +170,9 @@ public:
 private:
     AudioThumbnail audioThumb;
 
+    // Decoded copies of tracks, which are much faster to draw than compressed originals
+    SharedResourcePointer<PcmDiskCache> pcmDiskCache;
+
     bool fileLoaded;
 
     double positionRelative;